@@ -70,17 +70,10 @@ time warp info and AudioIOListener and whether the playback is looped.
 #include <math.h>
 #include <stdlib.h>
 #include <algorithm>
+#include <iterator>
 #include <numeric>
 #include <optional>
 
-#ifdef __WXMSW__
-#include <malloc.h>
-#endif
-
-#ifdef HAVE_ALLOCA_H
-#include <alloca.h>
-#endif
-
 #include "portaudio.h"
 #ifdef __WXMSW__
 #include "pa_win_wasapi.h"
@@ -112,6 +105,7 @@ time warp info and AudioIOListener and whether the playback is looped.
 #include "RealtimeEffectManager.h"
 #include "QualitySettings.h"
 #include "BasicUI.h"
+#include "Tracing.h"
 
 #include "Gain.h"
 
@@ -842,6 +836,8 @@ int AudioIO::StartStream(const TransportSequences &sequences,
 
    mLostSamples = 0;
    mLostCaptureIntervals.clear();
+   mCaptureBufferSize = 0;
+   mCaptureHighWater.store(0, std::memory_order_relaxed);
    mDetectDropouts =
       gPrefs->Read( WarningDialogKey(wxT("DropoutDetected")), true ) != 0;
    auto cleanup = finally ( [this] { ClearRecordingException(); } );
@@ -1359,7 +1355,49 @@ bool AudioIO::AllocateBuffers(
                   std::make_unique<Resample>(true, mFactor, mFactor);
                   // constant rate resampling
             }
+            mCaptureBufferSize = captureBufferSize;
+
+            if (!mCaptureSequences.empty())
+               // Let the writer fall behind by as much as the ring buffers
+               // hold, before the ring buffers must hold the rest
+               mCaptureWriter = std::make_unique<CaptureWriter>(
+                  [this](CaptureWriter::Batch &&batch){
+                     AppendCaptured(std::move(batch)); },
+                  captureBufferSize * mNumCaptureChannels);
+
+            // Resampling and copying a few channels costs less than handing
+            // them to another thread
+            constexpr size_t MinChannelsPerThread = 4;
+            const auto nThreads = std::min<size_t>(
+               std::max(1u, std::thread::hardware_concurrency()),
+               mNumCaptureChannels / MinChannelsPerThread);
+            if (nThreads > 1)
+               mCaptureWorkers = std::make_unique<ChannelWorkers>(nThreads);
          }
+
+         // Scratch memory for the realtime threads, so that they need not
+         // allocate or use the stack for buffers.  PortAudio chooses the
+         // size of each callback, so allow for the larger of the device
+         // latency and a generous bound.  Any excess is still served, but
+         // from the heap.
+         constexpr size_t MaxCallbackFrames = 8192;
+         // Channels of one effect processor, beyond those of the device
+         constexpr size_t MaxEffectChannels = 32;
+         const auto maxFrames =
+            std::max(MaxCallbackFrames, mHardwarePlaybackLatencyFrames);
+         const size_t maxChannels =
+            std::max<size_t>(mNumCaptureChannels, mNumPlaybackChannels);
+         // See FillOutputBuffers and AudioCallback
+         mCallbackArena.Reserve(
+            RealtimeArena::Needed<float *>(mNumPlaybackChannels) +
+            mNumPlaybackChannels * RealtimeArena::Needed<float>(maxFrames) +
+            RealtimeArena::Needed<float>(maxFrames * maxChannels) +
+            RealtimeArena::Needed<float>(maxFrames * mNumPlaybackChannels));
+         // See TransformPlayBuffers, RealtimeEffectManager::Process, and
+         // RealtimeEffectState::Process
+         mTransformArena.Reserve(
+            3 * RealtimeArena::Needed<float *>(mNumPlaybackChannels) +
+            2 * RealtimeArena::Needed<float *>(MaxEffectChannels));
       }
       catch(std::bad_alloc&)
       {
@@ -1396,6 +1434,8 @@ void AudioIO::StartStreamCleanup(bool bOnlyBuffers)
    mScratchBuffers.clear();
    mScratchPointers.clear();
    mPlaybackMixers.clear();
+   mCaptureWriter.reset();
+   mCaptureWorkers.reset();
    mCaptureBuffers.clear();
    mResample.clear();
    mPlaybackSchedule.mTimeQueue.Clear();
@@ -1547,6 +1587,11 @@ void AudioIO::StopStream()
       ProcessOnceAndWait();
    }
 
+   // Wait for the last of the captured samples to be appended, before the
+   // sequences are flushed
+   mCaptureWriter.reset();
+   mCaptureWorkers.reset();
+
    // No longer need effects processing. This must be done after the stream is stopped
    // to prevent the callback from being invoked after the effects are finalized.
    mpTransportState.reset();
@@ -1800,6 +1845,7 @@ double AudioIO::GetStreamTime()
 //! Sits in a thread loop reading and writing audio.
 void AudioIO::AudioThread(std::atomic<bool> &finish)
 {
+   Tracing::SetThreadName("Audio");
    enum class State { eUndefined, eOnce, eLoopRunning, eDoNothing, eMonitoring } lastState = State::eUndefined;
    AudioIO *const gAudioIO = AudioIO::Get();
    while (!finish.load(std::memory_order_acquire)) {
@@ -1873,6 +1919,15 @@ size_t AudioIoCallback::MinValue(
          return std::min(value, (pBuffer.get()->*pmf)()); });
 }
 
+size_t AudioIoCallback::MaxValue(
+   const RingBuffers &buffers, size_t (RingBuffer::*pmf)() const)
+{
+   return std::accumulate(buffers.begin(), buffers.end(),
+      size_t{ 0 },
+      [pmf](auto value, auto &pBuffer){
+         return std::max(value, (pBuffer.get()->*pmf)()); });
+}
+
 size_t AudioIO::GetCommonlyFreePlayback()
 {
    auto commonlyAvail = MinValue(mPlaybackBuffers, &RingBuffer::AvailForPut);
@@ -1901,12 +1956,14 @@ size_t AudioIO::GetCommonlyAvailCapture()
 // (which communicates with the audio device).
 void AudioIO::SequenceBufferExchange()
 {
+   TRACE_SCOPE("audio", "SequenceBufferExchange");
    FillPlayBuffers();
    DrainRecordBuffers();
 }
 
 void AudioIO::FillPlayBuffers()
 {
+   TRACE_SCOPE("audio", "FillPlayBuffers");
    std::optional<RealtimeEffects::ProcessingScope> pScope;
    if (mpTransportState && mpTransportState->mpRealtimeInitialization)
       pScope.emplace(
@@ -2052,15 +2109,18 @@ bool AudioIO::ProcessPlaybackSlices(
    return progress;
 }
 
-#define stackAllocate(T, count) static_cast<T*>(alloca(count * sizeof(T)))
-
 void AudioIO::TransformPlayBuffers(
    std::optional<RealtimeEffects::ProcessingScope> &pScope)
 {
    // Transform written but un-flushed samples in the RingBuffers in-place.
 
+   // Realtime effects must not allocate; this detects any that do, in builds
+   // that hook the allocator
+   RealtimeAllocationTrap::Scope trap;
+
    // Avoiding std::vector
-   const auto pointers = stackAllocate(float*, mNumPlaybackChannels);
+   RealtimeArena::Mark mark{ mTransformArena };
+   const auto pointers = mTransformArena.Allocate<float*>(mNumPlaybackChannels);
 
    const auto numPlaybackSequences = mPlaybackSequences.size();
    // mPlaybackBuffers correspond many-to-one with mPlaybackSequences
@@ -2106,7 +2166,7 @@ void AudioIO::TransformPlayBuffers(
                mScratchPointers.data(),
                // The single dummy output buffer:
                mScratchPointers[mNumPlaybackChannels],
-               mNumPlaybackChannels, len);
+               mNumPlaybackChannels, len, mTransformArena);
             iChannel = 0;
             for (; iChannel < nChannels; ++iChannel) {
                auto &ringBuffer = *mPlaybackBuffers[iBuffer + iChannel];
@@ -2119,11 +2179,8 @@ void AudioIO::TransformPlayBuffers(
    }
 }
 
-void AudioIO::DrainRecordBuffers()
+void AudioIO::GuardRecording(const std::function<void()> &action)
 {
-   if (mRecordingException || mCaptureSequences.empty())
-      return;
-
    auto delayedHandler = [this] ( AudacityException * pException ) {
       // In the main thread, stop recording
       // This is one place where the application handles disk
@@ -2143,14 +2200,51 @@ void AudioIO::DrainRecordBuffers()
       DefaultDelayedHandlerAction( pException );
    };
 
-   GuardedCall( [&] {
+   GuardedCall( action,
+   // handler
+   [this] ( AudacityException *pException ) {
+      if ( pException ) {
+         // So that we don't attempt to fill the recording buffer again
+         // before the main thread stops recording
+         SetRecordingException();
+         return ;
+      }
+      else
+         // Don't want to intercept other exceptions (?)
+         throw;
+   },
+   delayedHandler );
+}
+
+void AudioIO::DrainRecordBuffers()
+{
+   TRACE_SCOPE("audio", "DrainRecordBuffers");
+   if (mRecordingException || mCaptureSequences.empty())
+      return;
+
+   // While the writer is behind by as much as the ring buffers hold, leave
+   // the samples in them, so that memory does not grow without limit.  If the
+   // ring buffers fill too, the callback reports the lost samples as dropouts.
+   if (mCaptureWriter && !mCaptureWriter->HasRoom()) {
+      if (IsStreamActive())
+         return;
+      // This is the last drain before the stream stops; lose nothing
+      mCaptureWriter->WaitForRoom();
+   }
+
+   GuardRecording( [&] {
       // start record buffering
       const auto avail = GetCommonlyAvailCapture(); // samples
       const auto remainingTime =
          std::max(0.0, mRecordingSchedule.ToConsume());
       // This may be a very big double number:
       const auto remainingSamples = remainingTime * mRate;
-      bool latencyCorrected = true;
+      std::atomic<bool> latencyCorrected{ true };
+
+      // Remember how near the callback came to losing samples
+      const auto waiting = MaxValue(mCaptureBuffers, &RingBuffer::AvailForGet);
+      if (waiting > mCaptureHighWater.load(std::memory_order_relaxed))
+         mCaptureHighWater.store(waiting, std::memory_order_relaxed);
 
       double deltat = avail / mRate;
 
@@ -2158,22 +2252,25 @@ void AudioIO::DrainRecordBuffers()
           .load(std::memory_order_relaxed) ||
           deltat >= mMinCaptureSecsToCopy)
       {
-         bool newBlocks = false;
-
-         // Append captured samples to the end of the RecordableSequences.
-         // (WaveTracks have their own buffering for efficiency.)
-         auto iter = mCaptureSequences.begin();
-         auto width = (*iter)->NChannels();
-         size_t iChannel = 0;
-         for (size_t i = 0; i < mNumCaptureChannels; ++i) {
-            Finally Do {[&]{
-               if (++iChannel == width) {
-                  ++iter;
-                  iChannel = 0;
-                  if (iter != mCaptureSequences.end())
-                     width = (*iter)->NChannels();
-               }
-            }};
+         // Find the sequence and channel of each capture channel
+         std::vector<std::pair<RecordableSequence *, size_t>> targets;
+         targets.reserve(mNumCaptureChannels);
+         for (auto &pSequence : mCaptureSequences)
+            for (size_t iChannel = 0, width = pSequence->NChannels();
+                 iChannel < width; ++iChannel)
+               targets.emplace_back(pSequence.get(), iChannel);
+         wxASSERT(targets.size() >= mNumCaptureChannels);
+
+         const bool streamActive = IsStreamActive();
+
+         // Take captured samples from the ring buffers, independently for
+         // each channel.  The CaptureWriter appends them to the
+         // RecordableSequences.  (WaveTracks have their own buffering for
+         // efficiency.)
+         std::vector<CaptureWriter::Batch> batches(mNumCaptureChannels);
+         const auto drain = [&](size_t i){
+            auto &batch = batches[i];
+            const auto [pSequence, iChannel] = targets[i];
             size_t discarded = 0;
 
             if (!mRecordingSchedule.mLatencyCorrected) {
@@ -2185,9 +2282,8 @@ void AudioIO::DrainRecordBuffers()
                   size_t size = floor( correction * mRate * mFactor);
                   SampleBuffer temp(size, mCaptureFormat);
                   ClearSamples(temp.ptr(), mCaptureFormat, 0, size);
-                  (*iter)->Append(temp.ptr(), mCaptureFormat, size, 1,
-                     // Do not dither recordings
-                     narrowestSampleFormat, iChannel);
+                  batch.push_back({ pSequence, iChannel,
+                     std::move(temp), mCaptureFormat, size });
                }
                else {
                   // Leftward shift
@@ -2202,7 +2298,7 @@ void AudioIO::DrainRecordBuffers()
                   if (discarded < size)
                      // We need to visit this again to complete the
                      // discarding.
-                     latencyCorrected = false;
+                     latencyCorrected.store(false, std::memory_order_relaxed);
                }
             }
 
@@ -2266,7 +2362,7 @@ void AudioIO::DrainRecordBuffers()
                      toGet = floor(remainingSamples);
                   const auto results =
                   mResample[i]->Process(mFactor, (float *)temp1.ptr(), toGet,
-                                        !IsStreamActive(), (float *)temp.ptr(), size);
+                                        !streamActive, (float *)temp.ptr(), size);
                   size = results.second;
                }
             }
@@ -2288,39 +2384,67 @@ void AudioIO::DrainRecordBuffers()
                }
             }
 
-            // Now append
-            // see comment in second handler about guarantee
-            newBlocks = (*iter)->Append(
-               temp.ptr(), format, size, 1,
-               // Do not dither recordings
-               narrowestSampleFormat, iChannel
-            ) || newBlocks;
-         } // end loop over capture channels
+            batch.push_back(
+               { pSequence, iChannel, std::move(temp), format, size });
+         }; // end of work on one capture channel
+         if (mCaptureWorkers)
+            mCaptureWorkers->ForEach(mNumCaptureChannels, drain);
+         else
+            for (size_t i = 0; i < mNumCaptureChannels; ++i)
+               drain(i);
 
          // Now update the recording schedule position
          mRecordingSchedule.mPosition += avail / mRate;
-         mRecordingSchedule.mLatencyCorrected = latencyCorrected;
-
-         auto pListener = GetListener();
-         if (pListener && newBlocks)
-            pListener->OnAudioIONewBlocks();
-
+         mRecordingSchedule.mLatencyCorrected =
+            latencyCorrected.load(std::memory_order_relaxed);
+
+         // Now append, on the writer thread
+         CaptureWriter::Batch all;
+         for (auto &batch : batches)
+            std::move(batch.begin(), batch.end(), std::back_inserter(all));
+         if (mCaptureWriter)
+            mCaptureWriter->Push(std::move(all));
       }
       // end of record buffering
-   },
-   // handler
-   [this] ( AudacityException *pException ) {
-      if ( pException ) {
-         // So that we don't attempt to fill the recording buffer again
-         // before the main thread stops recording
-         SetRecordingException();
-         return ;
+   } );
+}
+
+void AudioIO::AppendCaptured(CaptureWriter::Batch &&batch)
+{
+   if (mRecordingException)
+      return;
+
+   GuardRecording( [&] {
+      // One transaction for the blocks of all channels that fill, rather than
+      // one for each.  The scope excludes transactions of other threads, so
+      // it covers only what one drain of the capture buffers produced.
+      std::optional<TransactionScope> pScope;
+      if (auto pOwningProject = mOwningProject.lock())
+         pScope.emplace(*pOwningProject, "Recording");
+
+      bool newBlocks = false;
+      try {
+         for (auto &chunk : batch)
+            // see comment in the delayed handler about guarantee
+            newBlocks = chunk.pSequence->Append(
+               chunk.buffer.ptr(), chunk.format, chunk.size, 1,
+               // Do not dither recordings
+               narrowestSampleFormat, chunk.iChannel
+            ) || newBlocks;
       }
-      else
-         // Don't want to intercept other exceptions (?)
+      catch (...) {
+         // Keep the blocks already appended, which the sequences now use
+         if (pScope)
+            pScope->Commit();
          throw;
-   },
-   delayedHandler );
+      }
+      if (pScope)
+         pScope->Commit();
+
+      auto pListener = GetListener();
+      if (pListener && newBlocks)
+         pListener->OnAudioIONewBlocks();
+   } );
 }
 
 void AudioIoCallback::SetListener(
@@ -2655,12 +2779,14 @@ bool AudioIoCallback::FillOutputBuffers(
    }
 
    // ------ MEMORY ALLOCATION ----------------------
+   // From the arena reserved in AllocateBuffers, not the heap
+   RealtimeArena::Mark mark{ mCallbackArena };
    // These are small structures.
-   const auto tempBufs = stackAllocate(float *, numPlaybackChannels);
+   const auto tempBufs = mCallbackArena.Allocate<float *>(numPlaybackChannels);
 
    // And these are larger structures....
    for (unsigned int c = 0; c < numPlaybackChannels; c++)
-      tempBufs[c] = stackAllocate(float, framesPerBuffer);
+      tempBufs[c] = mCallbackArena.Allocate<float>(framesPerBuffer);
    // ------ End of MEMORY ALLOCATION ---------------
 
    // Choose a common size to take from all ring buffers
@@ -3106,6 +3232,10 @@ int AudioIoCallback::AudioCallback(
    const PaStreamCallbackTimeInfo *timeInfo,
    const PaStreamCallbackFlags statusFlags, void * WXUNUSED(userData) )
 {
+   // This thread must not allocate; this detects any allocation, in builds
+   // that hook the allocator
+   RealtimeAllocationTrap::Scope trap;
+
    // Poll sequences for change of state.
    // (User might click mute and solo buttons.)
    mbHasSoloSequences = CountSoloingSequences() > 0 ;
@@ -3133,7 +3263,8 @@ int AudioIoCallback::AudioCallback(
    // audio data.  One temporary use is for the InputMeter data.
    const auto numPlaybackChannels = mNumPlaybackChannels;
    const auto numCaptureChannels = mNumCaptureChannels;
-   const auto tempFloats = stackAllocate(float,
+   RealtimeArena::Mark mark{ mCallbackArena };
+   const auto tempFloats = mCallbackArena.Allocate<float>(
       framesPerBuffer * std::max(numCaptureChannels, numPlaybackChannels));
 
    bool bVolEmulationActive =
@@ -3142,7 +3273,7 @@ int AudioIoCallback::AudioCallback(
    // we can often reuse the existing outputBuffer and save on allocating
    // something new.
    const auto outputMeterFloats = bVolEmulationActive
-      ? stackAllocate(float, framesPerBuffer * numPlaybackChannels)
+      ? mCallbackArena.Allocate<float>(framesPerBuffer * numPlaybackChannels)
       : outputBuffer;
    // ----- END of MEMORY ALLOCATIONS ------------------------------------------
 
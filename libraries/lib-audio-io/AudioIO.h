@@ -15,6 +15,8 @@
 
 #include "AudioIOBase.h" // to inherit
 #include "AudioIOSequences.h"
+#include "CaptureWriter.h" // member variable
+#include "ChannelWorkers.h" // member variable
 #include "PlaybackSchedule.h" // member variable
 
 #include <functional>
@@ -26,6 +28,7 @@
 
 #include "PluginProvider.h" // for PluginID
 #include "Observer.h"
+#include "RealtimeArena.h" // member variable
 #include "SampleCount.h"
 #include "SampleFormat.h"
 
@@ -270,7 +273,15 @@ public:
 
    using RingBuffers = std::vector<std::unique_ptr<RingBuffer>>;
    RingBuffers mCaptureBuffers;
+   //! Capacity of each of mCaptureBuffers
+   size_t mCaptureBufferSize{ 0 };
+   //! Greatest number of samples found waiting in any of mCaptureBuffers
+   std::atomic<size_t> mCaptureHighWater{ 0 };
    RecordableSequences mCaptureSequences;
+   //! Appends to mCaptureSequences, while they are not empty
+   std::unique_ptr<CaptureWriter> mCaptureWriter;
+   //! Share the draining of mCaptureBuffers, when there are many
+   std::unique_ptr<ChannelWorkers> mCaptureWorkers;
    /*! Read by worker threads but unchanging during playback */
    RingBuffers mPlaybackBuffers;
    ConstPlayableSequences      mPlaybackSequences;
@@ -281,6 +292,12 @@ public:
    std::vector<SampleBuffer> mScratchBuffers;
    std::vector<float *> mScratchPointers; //!< pointing into mScratchBuffers
 
+   //! Scratch memory for the PortAudio callback, reserved in AllocateBuffers
+   RealtimeArena mCallbackArena;
+   //! Scratch memory for realtime effects on the thread filling playback
+   //! buffers, reserved in AllocateBuffers
+   RealtimeArena mTransformArena;
+
    std::vector<std::unique_ptr<Mixer>> mPlaybackMixers;
 
    std::atomic<float>  mMixerOutputVol{ 1.0 };
@@ -344,6 +361,8 @@ public:
 protected:
    static size_t MinValue(
       const RingBuffers &buffers, size_t (RingBuffer::*pmf)() const);
+   static size_t MaxValue(
+      const RingBuffers &buffers, size_t (RingBuffer::*pmf)() const);
 
    float GetMixerOutputVol() {
       return mMixerOutputVol.load(std::memory_order_relaxed); }
@@ -392,6 +411,13 @@ public:
    const std::vector< std::pair<double, double> > &LostCaptureIntervals()
    { return mLostCaptureIntervals; }
 
+   //! Greatest fraction of the capture buffers that was filled during the
+   //! last recording; samples are lost when it reaches 1
+   double CaptureHighWater() const
+   { return mCaptureBufferSize == 0 ? 0.0
+      : double(mCaptureHighWater.load(std::memory_order_relaxed))
+         / mCaptureBufferSize; }
+
    // Used only for testing purposes in alpha builds
    bool mSimulateRecordingErrors{ false };
 
@@ -629,6 +655,10 @@ private:
 
    //! Second part of SequenceBufferExchange
    void DrainRecordBuffers();
+   //! Called on the thread of mCaptureWriter
+   void AppendCaptured(CaptureWriter::Batch &&batch);
+   //! Stop recording in the main thread, if action throws
+   void GuardRecording(const std::function<void()> &action);
 
    /** \brief Get the number of audio samples free in all of the playback
    * buffers.
@@ -0,0 +1,95 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  CaptureWriter.cpp
+
+**********************************************************************/
+
+#include "CaptureWriter.h"
+
+#include "MemoryX.h"
+
+CaptureWriter::CaptureWriter(Consumer consumer, size_t limit)
+   : mConsumer{ std::move(consumer) }
+   , mLimit{ limit }
+   , mThread{ [this]{ Run(); } }
+{
+}
+
+CaptureWriter::~CaptureWriter()
+{
+   Finish();
+}
+
+void CaptureWriter::Push(Batch &&batch)
+{
+   if (batch.empty())
+      return;
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      for (auto &chunk : batch)
+         mPending += chunk.size;
+      mQueue.push_back(std::move(batch));
+   }
+   mCondition.notify_one();
+}
+
+void CaptureWriter::Finish()
+{
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      mFinishing = true;
+   }
+   mCondition.notify_one();
+   if (mThread.joinable())
+      mThread.join();
+}
+
+bool CaptureWriter::HasRoom() const
+{
+   std::lock_guard<std::mutex> lock{ mMutex };
+   return mPending < mLimit;
+}
+
+void CaptureWriter::WaitForRoom()
+{
+   std::unique_lock<std::mutex> lock{ mMutex };
+   mRoomCondition.wait(lock, [this]{ return mStopped || mPending < mLimit; });
+}
+
+void CaptureWriter::Run()
+{
+   Finally Do{ [this]{
+      {
+         std::lock_guard<std::mutex> lock{ mMutex };
+         mStopped = true;
+      }
+      mRoomCondition.notify_all();
+   } };
+
+   while (true) {
+      Batch batch;
+      size_t size = 0;
+      {
+         std::unique_lock<std::mutex> lock{ mMutex };
+         mCondition.wait(lock, [this]{ return mFinishing || !mQueue.empty(); });
+         if (mQueue.empty())
+            // Finishing, and nothing remains
+            return;
+         batch = std::move(mQueue.front());
+         mQueue.pop_front();
+         for (auto &chunk : batch)
+            size += chunk.size;
+      }
+
+      // The consumer is responsible for its exceptions
+      mConsumer(std::move(batch));
+
+      {
+         std::lock_guard<std::mutex> lock{ mMutex };
+         mPending -= size;
+      }
+      mRoomCondition.notify_all();
+   }
+}
@@ -0,0 +1,91 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  CaptureWriter.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_CAPTURE_WRITER__
+#define __AUDACITY_CAPTURE_WRITER__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SampleFormat.h"
+
+class RecordableSequence;
+
+/*! @class CaptureWriter
+ @brief Appends captured samples to the recorded sequences on a thread of
+ its own
+
+ Appending may fill blocks, which are then committed to storage, and that
+ can be slow.  Handing the samples to this thread lets the thread that
+ drains the capture ring buffers keep up with the device.
+
+ Each pushed batch is given to the consumer separately, so that one
+ transaction for a batch keeps other threads waiting no longer than it takes
+ to append one batch.
+
+ The backlog is bounded only by the pusher, which should stop pushing while
+ HasRoom() is false.
+ */
+class CaptureWriter final
+{
+public:
+   //! Samples for one channel of one sequence
+   struct Chunk {
+      RecordableSequence *pSequence;
+      size_t iChannel;
+      SampleBuffer buffer;
+      sampleFormat format;
+      size_t size;
+   };
+   //! Chunks in the order they must be appended
+   using Batch = std::vector<Chunk>;
+
+   //! Called on the writer thread
+   using Consumer = std::function<void(Batch &&)>;
+
+   //! Starts the thread
+   /*!
+    @param limit total size, in samples, of pending chunks at which
+    HasRoom() becomes false
+    */
+   CaptureWriter(Consumer consumer, size_t limit);
+   //! Calls Finish()
+   ~CaptureWriter();
+
+   void Push(Batch &&batch);
+
+   //! Wait until all pushed chunks are consumed, then stop the thread
+   void Finish();
+
+   //! Whether the total size of chunks not yet consumed is below the limit
+   bool HasRoom() const;
+   //! Block until HasRoom() or the thread has stopped
+   void WaitForRoom();
+
+private:
+   void Run();
+
+   const Consumer mConsumer;
+   const size_t mLimit;
+
+   mutable std::mutex mMutex;
+   std::condition_variable mCondition;
+   std::condition_variable mRoomCondition;
+   std::deque<Batch> mQueue;
+   size_t mPending{ 0 };
+   bool mStopped{ false };
+   bool mFinishing{ false };
+
+   std::thread mThread;
+};
+
+#endif
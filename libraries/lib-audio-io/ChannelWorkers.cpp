@@ -0,0 +1,91 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ChannelWorkers.cpp
+
+**********************************************************************/
+
+#include "ChannelWorkers.h"
+
+ChannelWorkers::ChannelWorkers(size_t nThreads)
+{
+   mThreads.reserve(nThreads > 0 ? nThreads - 1 : 0);
+   try {
+      for (size_t iThread = 1; iThread < nThreads; ++iThread)
+         mThreads.emplace_back([this, iThread]{ Run(iThread); });
+   }
+   catch (...) {
+      // Could not start another thread; make do with fewer
+   }
+   mErrors.resize(mThreads.size() + 1);
+}
+
+ChannelWorkers::~ChannelWorkers()
+{
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      mStopping = true;
+   }
+   mStart.notify_all();
+   for (auto &thread : mThreads)
+      thread.join();
+}
+
+void ChannelWorkers::DoForEach(size_t n, Function function, const void *pF)
+{
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      mFunction = function;
+      mpF = pF;
+      mN = n;
+      mRunning = mThreads.size();
+      ++mGeneration;
+      for (auto &error : mErrors)
+         error = nullptr;
+   }
+   mStart.notify_all();
+
+   Work(0);
+
+   {
+      std::unique_lock<std::mutex> lock{ mMutex };
+      mDone.wait(lock, [this]{ return mRunning == 0; });
+   }
+
+   for (auto &error : mErrors)
+      if (error)
+         std::rethrow_exception(error);
+}
+
+void ChannelWorkers::Work(size_t iThread) noexcept
+{
+   const auto nThreads = mThreads.size() + 1;
+   try {
+      for (size_t i = iThread; i < mN; i += nThreads)
+         mFunction(mpF, i);
+   }
+   catch (...) {
+      mErrors[iThread] = std::current_exception();
+   }
+}
+
+void ChannelWorkers::Run(size_t iThread)
+{
+   uint64_t generation = 0;
+   std::unique_lock<std::mutex> lock{ mMutex };
+   while (true) {
+      mStart.wait(lock,
+         [&]{ return mStopping || mGeneration != generation; });
+      if (mStopping)
+         return;
+      generation = mGeneration;
+
+      lock.unlock();
+      Work(iThread);
+      lock.lock();
+
+      if (--mRunning == 0)
+         mDone.notify_one();
+   }
+}
@@ -0,0 +1,63 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ChannelWorkers.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_CHANNEL_WORKERS__
+#define __AUDACITY_CHANNEL_WORKERS__
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*! @class ChannelWorkers
+ @brief Threads, kept for the length of a stream, that share the work on
+ many channels with the thread that asks for it
+
+ Starting threads each time the capture buffers are drained would cost more
+ than the work on a few channels.
+ */
+class ChannelWorkers final
+{
+public:
+   //! Starts up to nThreads - 1 threads; the calling thread makes the last
+   explicit ChannelWorkers(size_t nThreads);
+   //! Stops the threads
+   ~ChannelWorkers();
+
+   //! Call f(i) for each i less than n, on all of the threads, and wait
+   /*! The first exception thrown is rethrown, after all threads finish */
+   template<typename F> void ForEach(size_t n, const F &f)
+   {
+      DoForEach(n,
+         [](const void *pF, size_t i){ (*static_cast<const F*>(pF))(i); }, &f);
+   }
+
+private:
+   using Function = void (*)(const void *pF, size_t i);
+   void DoForEach(size_t n, Function function, const void *pF);
+   //! Call the function for the indices that belong to thread iThread
+   void Work(size_t iThread) noexcept;
+   void Run(size_t iThread);
+
+   std::mutex mMutex;
+   std::condition_variable mStart;
+   std::condition_variable mDone;
+   Function mFunction{};
+   const void *mpF{};
+   size_t mN{ 0 };
+   uint64_t mGeneration{ 0 };
+   size_t mRunning{ 0 };
+   bool mStopping{ false };
+
+   std::vector<std::exception_ptr> mErrors;
+   std::vector<std::thread> mThreads;
+};
+
+#endif
@@ -324,6 +324,11 @@ FilePath FileNames::ConfigDir() { return GetUserTargetDir(DirTarget::Config, tru
 FilePath FileNames::DataDir() { return GetUserTargetDir(DirTarget::Data, true); }
 FilePath FileNames::StateDir() { return GetUserTargetDir(DirTarget::State, false); }
 
+void FileNames::SetConfigDirOverride(const FilePath &dir)
+{
+   gTargetDirs[size_t(DirTarget::Config)] = FileNames::MkDir(dir);
+}
+
 FilePath FileNames::ResourcesDir(){
 #if __WXMSW__
    static auto resourcesDir = wxFileName(wxStandardPaths::Get().GetExecutablePath()).GetPath();
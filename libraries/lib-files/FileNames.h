@@ -127,6 +127,9 @@ namespace FileNames
     * Where audacity keeps its user state squirreled away, by default ~/.local/state/audacity/
     * on Unix, Application Data/Audacity on windows system */
    FILES_API FilePath StateDir();
+   //! Use the given directory for configuration files in this session
+   /*! Not persistent; must be called before any of them is read */
+   FILES_API void SetConfigDirOverride(const FilePath &dir);
 
    FILES_API FilePath ResourcesDir();
    FILES_API FilePath HtmlHelpDir();
@@ -43,12 +43,21 @@ static wxString &TempDirPath()
    return path;
 }
 
+static FilePath &TempDirOverridePath()
+{
+   static FilePath path;
+   return path;
+}
+
 /// Returns the directory used for temp files.
 /// \todo put a counter in here to see if it gets used a lot.
 /// if it does, then maybe we should cache the path name
 /// each time.
 wxString TempDirectory::TempDir()
 {
+   if (const auto &overridePath = TempDirOverridePath(); !overridePath.empty())
+      return FileNames::MkDir(overridePath);
+
    auto &path = TempDirPath();
    if (gPrefs && path.empty())
       path =
@@ -76,6 +85,11 @@ void TempDirectory::ResetTempDir()
    TempDirPath().clear();
 }
 
+void TempDirectory::SetTempDirOverride( const FilePath &tempDir )
+{
+   TempDirOverridePath() = tempDir;
+}
+
 /** \brief Default temp directory */
 static FilePath sDefaultTempDir;
 
@@ -25,6 +25,10 @@ namespace TempDirectory
    FILES_API wxString TempDir();
    FILES_API void ResetTempDir();
 
+   //! Use the given directory for this session instead of the preference
+   /*! Not persistent; an empty path restores the usual behavior */
+   FILES_API void SetTempDirOverride( const FilePath &tempDir );
+
    FILES_API const FilePath &DefaultTempDir();
    FILES_API void SetDefaultTempDir( const FilePath &tempDir );
    FILES_API bool IsTempDirectoryNameOK( const FilePath & Name );
@@ -21,6 +21,7 @@
 #include "ExportPluginRegistry.h"
 #include "Mix.h"
 #include "Project.h"
+#include "SharedExportMix.h"
 #include "WaveTrack.h"
 #include "wxFileNameWrapper.h"
 #include "StretchingSequence.h"
@@ -69,6 +70,12 @@ ExportTaskBuilder& ExportTaskBuilder::SetMixerSpec(MixerOptions::Downmix *mixerS
    return *this;
 }
 
+ExportTaskBuilder& ExportTaskBuilder::SetSharedMix(std::shared_ptr<SharedExportMix> sharedMix) noexcept
+{
+   mSharedMix = std::move(sharedMix);
+   return *this;
+}
+
 ExportTaskBuilder& ExportTaskBuilder::SetSampleRate(double sampleRate) noexcept
 {
    mSampleRate = sampleRate;
@@ -96,6 +103,8 @@ ExportTask ExportTaskBuilder::Build(AudacityProject& project)
    }
 
    auto processor = mPlugin->CreateProcessor(mFormat);
+   //The processor makes its mixer during initialization
+   SharedExportMix::Scope scope { mSharedMix.get() };
    if(!processor->Initialize(project,
       mParameters,
       mFileName.GetFullPath(),
@@ -12,6 +12,7 @@
 #define __AUDACITY_EXPORT__
 
 #include <functional>
+#include <memory>
 #include <vector>
 #include <wx/filename.h> // member variable
 #include "Identifier.h"
@@ -23,6 +24,7 @@
 class AudacityProject;
 class WaveTrack;
 class ExportProcessorDelegate;
+class SharedExportMix;
 namespace MixerOptions{ class Downmix; }
 using MixerSpec = MixerOptions::Downmix;
 using WaveTrackConstArray = std::vector < std::shared_ptr < const WaveTrack > >;
@@ -44,6 +46,9 @@ public:
    ExportTaskBuilder& SetTags(const Tags* tags) noexcept;
    ExportTaskBuilder& SetSampleRate(double sampleRate) noexcept;
    ExportTaskBuilder& SetMixerSpec(MixerOptions::Downmix* mixerSpec) noexcept;
+   //! Let the processor read a mix rendered once for several tasks
+   /*! All tasks built with the same mix must run at the same time */
+   ExportTaskBuilder& SetSharedMix(std::shared_ptr<SharedExportMix> sharedMix) noexcept;
    
    ExportTask Build(AudacityProject& project);
    
@@ -59,6 +64,7 @@ private:
    int mFormat{};
    MixerOptions::Downmix* mMixerSpec{};//Should be const
    const Tags* mTags{};
+   std::shared_ptr<SharedExportMix> mSharedMix;
 };
 
 void IMPORT_EXPORT_API ShowExportErrorDialog(const TranslatableString& message,
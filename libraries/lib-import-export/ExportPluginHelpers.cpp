@@ -18,6 +18,7 @@
 #include "ExportUtils.h"
 #include "ExportPlugin.h"
 #include "StretchingSequence.h"
+#include "SharedExportMix.h"
 
 //Create a mixer by computing the time warp factor
 std::unique_ptr<Mixer> ExportPluginHelpers::CreateMixer(const TrackList &tracks,
@@ -27,6 +28,12 @@ std::unique_ptr<Mixer> ExportPluginHelpers::CreateMixer(const TrackList &tracks,
          double outRate, sampleFormat outFormat,
          MixerOptions::Downmix *mixerSpec)
 {
+   if (const auto pShared = SharedExportMix::Current())
+      if (auto mixer = pShared->CreateMixer(tracks, selectionOnly,
+            startTime, stopTime, numOutChannels, outBufferSize, outInterleaved,
+            outRate, outFormat, mixerSpec))
+         return mixer;
+
    Mixer::Inputs inputs;
 
    for (auto pTrack: ExportUtils::FindExportWaveTracks(tracks, selectionOnly))
@@ -0,0 +1,316 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  SharedExportMix.cpp
+
+**********************************************************************/
+
+#include "SharedExportMix.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "ExportPluginHelpers.h"
+#include "Mix.h"
+#include "MixerOptions.h"
+#include "Track.h"
+#include "WideSampleSequence.h"
+
+namespace
+{
+SharedExportMix *sCurrent{};
+
+//! Position of a reader that was removed; passes all blocks
+const sampleCount NoReader = sampleCount::max();
+}
+
+//! Presents the shared render as a sequence for the Mixer of one processor
+class SharedExportMix::Reader final : public WideSampleSequence
+{
+public:
+   explicit Reader(std::shared_ptr<SharedExportMix> pMix)
+      : mpMix{ move(pMix) }
+      , mIndex{ mpMix->AddReader() }
+   {
+   }
+
+   ~Reader() override
+   {
+      mpMix->RemoveReader(mIndex);
+   }
+
+   AudioGraph::ChannelType GetChannelType() const override
+   {
+      return mpMix->mNumChannels == 1
+         ? AudioGraph::MonoChannel
+         : AudioGraph::LeftChannel;
+   }
+
+   size_t NChannels() const override
+   {
+      return mpMix->mNumChannels;
+   }
+
+   float GetChannelGain(int) const override
+   {
+      // Gains were applied in the render
+      return 1.0f;
+   }
+
+   bool DoGet(size_t iChannel, size_t nBuffers, const samplePtr buffers[],
+      sampleFormat format, sampleCount start, size_t len, bool backward,
+      fillFormat, bool, sampleCount* pNumWithinClips) const override
+   {
+      // Mixers for export read forward only
+      assert(!backward);
+      mpMix->Fetch(mIndex, iChannel, nBuffers, buffers, format, start, len);
+      if (pNumWithinClips)
+         *pNumWithinClips = len;
+      return true;
+   }
+
+   double GetStartTime() const override { return mpMix->mT0; }
+   double GetEndTime() const override { return mpMix->mT1; }
+   double GetRate() const override { return mpMix->mRate; }
+
+   sampleFormat WidestEffectiveFormat() const override
+   {
+      // So that the Mixer of the processor dithers only if the render
+      // really is wider than its output
+      return mpMix->mEffectiveFormat;
+   }
+
+   bool HasTrivialEnvelope() const override { return true; }
+
+   void GetEnvelopeValues(double* buffer, size_t bufferLen, double, bool)
+      const override
+   {
+      std::fill(buffer, buffer + bufferLen, 1.0);
+   }
+
+private:
+   const std::shared_ptr<SharedExportMix> mpMix;
+   const size_t mIndex;
+};
+
+SharedExportMix::Scope::Scope(SharedExportMix *pMix)
+   : mPrevious{ sCurrent }
+{
+   sCurrent = pMix;
+}
+
+SharedExportMix::Scope::~Scope()
+{
+   sCurrent = mPrevious;
+}
+
+std::shared_ptr<SharedExportMix> SharedExportMix::Create(double rate)
+{
+   return std::make_shared<SharedExportMix>(PrivateToken{}, rate);
+}
+
+SharedExportMix::SharedExportMix(PrivateToken, double rate)
+   : mRate{ rate }
+{
+}
+
+SharedExportMix::~SharedExportMix()
+{
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      mStopping = true;
+   }
+   mCondition.notify_all();
+   if (mThread.joinable())
+      mThread.join();
+}
+
+SharedExportMix *SharedExportMix::Current()
+{
+   return sCurrent;
+}
+
+std::unique_ptr<Mixer> SharedExportMix::CreateMixer(const TrackList &tracks,
+   bool selectionOnly,
+   double startTime, double stopTime,
+   unsigned numOutChannels, size_t outBufferSize, bool outInterleaved,
+   double outRate, sampleFormat outFormat,
+   MixerOptions::Downmix *mixerSpec)
+{
+   // The Mixer of each processor takes at most two channels from each of its
+   // inputs (see Mixer::Process), so it could not pass a render of more
+   // channels through.  Such exports mix for themselves.
+   if (numOutChannels > MaxChannels || stopTime <= startTime)
+      return {};
+
+   // With a time warp, the length of the render isn't known in advance
+   if (Mixer::WarpOptions{ tracks.GetOwner() }.envelope)
+      return {};
+
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      if (mThread.joinable())
+         // The render began; a new reader can't have it from the start
+         return {};
+      if (!mMaster) {
+         // Make the mixer of the render as if for a single export
+         Scope scope{ nullptr };
+         mMaster = ExportPluginHelpers::CreateMixer(tracks, selectionOnly,
+            startTime, stopTime, numOutChannels, BlockSize, false,
+            mRate, floatSample, mixerSpec);
+         mpTracks = &tracks;
+         mSelectionOnly = selectionOnly;
+         mT0 = startTime;
+         mT1 = stopTime;
+         mNumChannels = numOutChannels;
+         mpMixerSpec = mixerSpec;
+         mEffectiveFormat = mMaster->EffectiveFormat();
+         mStart = sampleCount(floor(startTime * mRate + 0.5));
+         mProduced = mStart;
+      }
+      else if (mpTracks != &tracks || mSelectionOnly != selectionOnly ||
+         mT0 != startTime || mT1 != stopTime ||
+         mNumChannels != numOutChannels || mpMixerSpec != mixerSpec)
+         return {};
+   }
+
+   Mixer::Inputs inputs;
+   inputs.emplace_back(std::make_shared<Reader>(shared_from_this()));
+   return std::make_unique<Mixer>(move(inputs),
+      // Throw, to stop exporting, if the render fails:
+      true,
+      // Any warp was applied in the render
+      Mixer::WarpOptions{ 1.0, 1.0 },
+      startTime, stopTime,
+      numOutChannels, outBufferSize, outInterleaved,
+      outRate, outFormat,
+      true, nullptr);
+}
+
+size_t SharedExportMix::AddReader()
+{
+   std::lock_guard<std::mutex> lock{ mMutex };
+   mPositions.push_back(mStart);
+   ++mLiveReaders;
+   return mPositions.size() - 1;
+}
+
+void SharedExportMix::RemoveReader(size_t iReader)
+{
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      mPositions[iReader] = NoReader;
+      --mLiveReaders;
+   }
+   mCondition.notify_all();
+}
+
+void SharedExportMix::Fetch(size_t iReader, size_t iChannel, size_t nBuffers,
+   const samplePtr buffers[], sampleFormat format,
+   sampleCount start, size_t len)
+{
+   const auto end = start + len;
+   const auto sampleSize = SAMPLE_SIZE(format);
+
+   std::unique_lock<std::mutex> lock{ mMutex };
+   if (!mThread.joinable())
+      mThread = std::thread{ [this]{ Run(); } };
+
+   // Let the render go on past what this reader no longer needs
+   mPositions[iReader] = start;
+   mCondition.notify_all();
+
+   mCondition.wait(lock, [&]{
+      return mError || mFinished || mProduced >= end; });
+   if (mError)
+      std::rethrow_exception(mError);
+
+   for (size_t ii = 0; ii < nBuffers; ++ii)
+      ClearSamples(buffers[ii], format, 0, len);
+   for (const auto &block : mBlocks) {
+      const auto blockEnd = block.start + block.length;
+      if (blockEnd <= start)
+         continue;
+      if (block.start >= end)
+         break;
+      const auto from = std::max(start, block.start);
+      const auto to = std::min(end, blockEnd);
+      const auto count = (to - from).as_size_t();
+      const auto srcOffset = (from - block.start).as_size_t();
+      const auto dstOffset = (from - start).as_size_t();
+      for (size_t ii = 0; ii < nBuffers; ++ii)
+         CopySamples(
+            reinterpret_cast<constSamplePtr>(
+               block.channels[iChannel + ii].data() + srcOffset),
+            floatSample,
+            buffers[ii] + dstOffset * sampleSize, format,
+            count, DitherType::none);
+   }
+
+   mPositions[iReader] = end;
+   lock.unlock();
+   mCondition.notify_all();
+}
+
+void SharedExportMix::DiscardRead()
+{
+   if (mPositions.empty())
+      return;
+   const auto slowest =
+      *std::min_element(mPositions.begin(), mPositions.end());
+   while (!mBlocks.empty() &&
+      mBlocks.front().start + mBlocks.front().length <= slowest)
+      mBlocks.pop_front();
+}
+
+void SharedExportMix::Run()
+{
+   while (true) {
+      {
+         std::unique_lock<std::mutex> lock{ mMutex };
+         mCondition.wait(lock, [this]{
+            DiscardRead();
+            return mStopping || mLiveReaders == 0 ||
+               mBlocks.size() < MaxBlocks;
+         });
+         if (mStopping || mLiveReaders == 0)
+            return;
+      }
+
+      Block block;
+      size_t length = 0;
+      try {
+         length = block.length = mMaster->Process();
+         block.channels.resize(mNumChannels);
+         for (unsigned c = 0; c < mNumChannels; ++c) {
+            const auto src =
+               reinterpret_cast<const float*>(mMaster->GetBuffer(c));
+            block.channels[c].assign(src, src + block.length);
+         }
+      }
+      catch (...) {
+         {
+            std::lock_guard<std::mutex> lock{ mMutex };
+            mError = std::current_exception();
+         }
+         mCondition.notify_all();
+         return;
+      }
+
+      {
+         std::lock_guard<std::mutex> lock{ mMutex };
+         if (length == 0)
+            mFinished = true;
+         else {
+            block.start = mProduced;
+            mProduced += block.length;
+            mBlocks.push_back(std::move(block));
+         }
+      }
+      mCondition.notify_all();
+      if (length == 0)
+         return;
+   }
+}
@@ -0,0 +1,145 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  SharedExportMix.h
+
+**********************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SampleCount.h"
+#include "SampleFormat.h"
+
+class TrackList;
+class Mixer;
+
+namespace MixerOptions
+{
+class Downmix;
+}
+
+/*! @class SharedExportMix
+ @brief Renders one mix of the tracks for several exports that run at once
+
+ While a Scope is active, ExportPluginHelpers::CreateMixer gives each
+ processor a Mixer that reads this render, instead of one that mixes the
+ tracks and applies their effects again.  Only the format conversion and any
+ resampling to the rate of the processor remain to be done by each.
+
+ The first request fixes the tracks, time range, channels and downmix of the
+ render; requests that differ, and requests for mixes that cannot be shared,
+ get a Mixer of their own as usual.  Those include requests for more than
+ MaxChannels channels, and mixes with a time warp.
+
+ The render runs on a thread of its own, which is at most a bounded number of
+ buffers ahead of the slowest reader.  So all processors sharing the mix must
+ be created before any of them starts, and all must run concurrently.
+ */
+class IMPORT_EXPORT_API SharedExportMix final
+   : public std::enable_shared_from_this<SharedExportMix>
+{
+   struct PrivateToken{};
+public:
+   //! Makes CreateMixer consult a SharedExportMix while this object exists
+   /*! For use on the main thread, around ExportProcessor::Initialize() */
+   class IMPORT_EXPORT_API Scope final
+   {
+   public:
+      explicit Scope(SharedExportMix *pMix);
+      ~Scope();
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+   private:
+      SharedExportMix *const mPrevious;
+   };
+
+   //! Most channels of a render that can be shared
+   static constexpr unsigned MaxChannels = 2;
+
+   //! @param rate sample rate of the render
+   static std::shared_ptr<SharedExportMix> Create(double rate);
+
+   SharedExportMix(PrivateToken, double rate);
+   ~SharedExportMix();
+
+   //! @return the mix of the innermost Scope, if any
+   static SharedExportMix *Current();
+
+   //! Arguments are as for ExportPluginHelpers::CreateMixer
+   /*!
+    @return a Mixer reading the shared render, or null if it can't serve this
+    request
+    */
+   std::unique_ptr<Mixer> CreateMixer(const TrackList &tracks,
+      bool selectionOnly,
+      double startTime, double stopTime,
+      unsigned numOutChannels, size_t outBufferSize, bool outInterleaved,
+      double outRate, sampleFormat outFormat,
+      MixerOptions::Downmix *mixerSpec);
+
+private:
+   class Reader;
+
+   //! Samples rendered at once
+   static constexpr size_t BlockSize = 65536;
+   //! Limit of rendered blocks not yet read by all readers
+   static constexpr size_t MaxBlocks = 16;
+
+   struct Block {
+      sampleCount start;
+      size_t length;
+      std::vector<std::vector<float>> channels;
+   };
+
+   size_t AddReader();
+   void RemoveReader(size_t iReader);
+
+   //! Blocks until the render reaches `start + len` or ends
+   /*!
+    Positions outside of the render are filled with zeros
+    */
+   void Fetch(size_t iReader, size_t iChannel, size_t nBuffers,
+      const samplePtr buffers[], sampleFormat format,
+      sampleCount start, size_t len);
+
+   //! Discard blocks that all readers have passed
+   /*! @pre mMutex is locked */
+   void DiscardRead();
+
+   void Run();
+
+   const double mRate;
+
+   // Fixed by the first request
+   const TrackList *mpTracks{};
+   bool mSelectionOnly{};
+   double mT0{};
+   double mT1{};
+   unsigned mNumChannels{};
+   MixerOptions::Downmix *mpMixerSpec{};
+   std::unique_ptr<Mixer> mMaster;
+   sampleFormat mEffectiveFormat{ floatSample };
+   sampleCount mStart{ 0 };
+
+   std::mutex mMutex;
+   std::condition_variable mCondition;
+   std::deque<Block> mBlocks;
+   //! Next position to be read by each reader, or none if removed
+   std::vector<sampleCount> mPositions;
+   size_t mLiveReaders{ 0 };
+   sampleCount mProduced{ 0 };
+   bool mFinished{ false };
+   bool mStopping{ false };
+   std::exception_ptr mError;
+
+   std::thread mThread;
+};
@@ -0,0 +1,145 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  GainKernels.cpp
+
+**********************************************************************/
+
+#include "GainKernels.h"
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GAIN_KERNELS_SSE 1
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define GAIN_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace GainKernels
+{
+#if GAIN_KERNELS_SSE
+
+void Scale(float *buffer, size_t len, float gain)
+{
+   const auto g = _mm_set1_ps(gain);
+   size_t i = 0;
+   for (; i + 4 <= len; i += 4)
+      _mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), g));
+   for (; i < len; ++i)
+      buffer[i] *= gain;
+}
+
+void ScaleByRamp(float *buffer, size_t len, float start, float step)
+{
+   const auto s = _mm_set1_ps(start);
+   const auto d = _mm_set1_ps(step);
+   const auto lanes = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+   size_t i = 0;
+   for (; i + 4 <= len; i += 4) {
+      const auto index =
+         _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lanes);
+      const auto g = _mm_add_ps(s, _mm_mul_ps(index, d));
+      _mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), g));
+   }
+   for (; i < len; ++i)
+      buffer[i] *= start + static_cast<float>(i) * step;
+}
+
+void Multiply(float *buffer, const float *gains, size_t len)
+{
+   size_t i = 0;
+   for (; i + 4 <= len; i += 4)
+      _mm_storeu_ps(buffer + i,
+         _mm_mul_ps(_mm_loadu_ps(buffer + i), _mm_loadu_ps(gains + i)));
+   for (; i < len; ++i)
+      buffer[i] *= gains[i];
+}
+
+void MultiplyAdd(float *dst, const float *src, size_t len, float gain)
+{
+   const auto g = _mm_set1_ps(gain);
+   size_t i = 0;
+   for (; i + 4 <= len; i += 4)
+      _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i),
+         _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+   for (; i < len; ++i)
+      dst[i] += src[i] * gain;
+}
+
+#elif GAIN_KERNELS_NEON
+
+void Scale(float *buffer, size_t len, float gain)
+{
+   size_t i = 0;
+   for (; i + 4 <= len; i += 4)
+      vst1q_f32(buffer + i, vmulq_n_f32(vld1q_f32(buffer + i), gain));
+   for (; i < len; ++i)
+      buffer[i] *= gain;
+}
+
+void ScaleByRamp(float *buffer, size_t len, float start, float step)
+{
+   const float lanesInit[4]{ 0.0f, 1.0f, 2.0f, 3.0f };
+   const auto lanes = vld1q_f32(lanesInit);
+   const auto s = vdupq_n_f32(start);
+   size_t i = 0;
+   for (; i + 4 <= len; i += 4) {
+      const auto index =
+         vaddq_f32(vdupq_n_f32(static_cast<float>(i)), lanes);
+      const auto g = vmlaq_n_f32(s, index, step);
+      vst1q_f32(buffer + i, vmulq_f32(vld1q_f32(buffer + i), g));
+   }
+   for (; i < len; ++i)
+      buffer[i] *= start + static_cast<float>(i) * step;
+}
+
+void Multiply(float *buffer, const float *gains, size_t len)
+{
+   size_t i = 0;
+   for (; i + 4 <= len; i += 4)
+      vst1q_f32(buffer + i,
+         vmulq_f32(vld1q_f32(buffer + i), vld1q_f32(gains + i)));
+   for (; i < len; ++i)
+      buffer[i] *= gains[i];
+}
+
+void MultiplyAdd(float *dst, const float *src, size_t len, float gain)
+{
+   size_t i = 0;
+   for (; i + 4 <= len; i += 4)
+      vst1q_f32(dst + i,
+         vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), gain));
+   for (; i < len; ++i)
+      dst[i] += src[i] * gain;
+}
+
+#else
+
+void Scale(float *buffer, size_t len, float gain)
+{
+   for (size_t i = 0; i < len; ++i)
+      buffer[i] *= gain;
+}
+
+void ScaleByRamp(float *buffer, size_t len, float start, float step)
+{
+   for (size_t i = 0; i < len; ++i)
+      buffer[i] *= start + static_cast<float>(i) * step;
+}
+
+void Multiply(float *buffer, const float *gains, size_t len)
+{
+   for (size_t i = 0; i < len; ++i)
+      buffer[i] *= gains[i];
+}
+
+void MultiplyAdd(float *dst, const float *src, size_t len, float gain)
+{
+   for (size_t i = 0; i < len; ++i)
+      dst[i] += src[i] * gain;
+}
+
+#endif
+}
@@ -0,0 +1,35 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  GainKernels.h
+
+**********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+//! Loops applying gains to float samples, vectorized where the target allows
+/*!
+ SSE is used on x86 and NEON on ARM; elsewhere the loops are plain, for the
+ compiler to do what it can.
+ */
+namespace GainKernels
+{
+//! buffer[i] *= gain
+MATH_API void Scale(float *buffer, size_t len, float gain);
+
+//! buffer[i] *= start + i * step
+/*!
+ Each gain is computed from its index, not accumulated, so that long ramps
+ don't drift
+ */
+MATH_API void ScaleByRamp(float *buffer, size_t len, float start, float step);
+
+//! buffer[i] *= gains[i]
+MATH_API void Multiply(float *buffer, const float *gains, size_t len);
+
+//! dst[i] += src[i] * gain
+MATH_API void MultiplyAdd(float *dst, const float *src, size_t len, float gain);
+}
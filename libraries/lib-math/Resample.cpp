@@ -16,9 +16,10 @@
 
       libsoxr, written by Rob Sykes. LGPL.
 
-   Since Audacity always does resampling on mono streams that are
-   contiguous in memory, this class doesn't support multiple channels
-   or some of the other optional features of some of these resamplers.
+   Channels are in separate buffers, contiguous in memory; several channels
+   may be resampled together, which lets libsoxr work on them in parallel.
+   This class doesn't support interleaved buffers or some of the other
+   optional features of some of these resamplers.
 
 *//*******************************************************************/
 
@@ -27,9 +28,14 @@
 #include "Internat.h"
 #include "ComponentInterface.h"
 
+#include <algorithm>
+#include <cassert>
+
 #include <soxr.h>
 
-Resample::Resample(const bool useBestMethod, const double dMinFactor, const double dMaxFactor)
+Resample::Resample(const bool useBestMethod, const double dMinFactor, const double dMaxFactor,
+   unsigned numChannels, bool multithreaded)
+   : mNumChannels{ std::max(1u, numChannels) }
 {
    this->SetMethod(useBestMethod);
    soxr_quality_spec_t q_spec;
@@ -43,7 +49,12 @@ Resample::Resample(const bool useBestMethod, const double dMinFactor, const doub
       mbWantConstRateResampling = false; // variable rate resampling
       q_spec = soxr_quality_spec(SOXR_HQ, SOXR_VR);
    }
-   mHandle.reset(soxr_create(1, dMinFactor, 1, 0, 0, &q_spec, 0));
+   // Buffers of channels are Separate, not interleaved
+   const auto io_spec = soxr_io_spec(SOXR_FLOAT32_S, SOXR_FLOAT32_S);
+   // Zero lets the library choose the number of threads
+   const auto runtime_spec = soxr_runtime_spec(multithreaded ? 0 : 1);
+   mHandle.reset(soxr_create(1, dMinFactor, mNumChannels, 0,
+      &io_spec, &q_spec, &runtime_spec));
 }
 
 Resample::~Resample()
@@ -92,6 +103,22 @@ std::pair<size_t, size_t>
                         float  *outBuffer,
                         size_t  outBufferLen)
 {
+   assert(mNumChannels == 1);
+   return Process(factor, &inBuffer, inBufferLen, lastFlag,
+      &outBuffer, outBufferLen);
+}
+
+std::pair<size_t, size_t>
+      Resample::Process(double  factor,
+                        const float *const inBuffers[],
+                        size_t  inBufferLen,
+                        bool    lastFlag,
+                        float  *const outBuffers[],
+                        size_t  outBufferLen)
+{
+   // With split buffers, soxr takes arrays of pointers
+   const auto inBuffer = static_cast<soxr_in_t>(inBuffers);
+   const auto outBuffer = static_cast<soxr_out_t>(const_cast<float**>(outBuffers));
    size_t idone, odone;
    if (mbWantConstRateResampling)
    {
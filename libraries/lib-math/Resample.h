@@ -36,7 +36,11 @@ class MATH_API Resample final
    /// the fast method.
    // dMinFactor and dMaxFactor specify the range of factors for variable-rate resampling.
    // For constant-rate, pass the same value for both.
-   Resample(const bool useBestMethod, const double dMinFactor, const double dMaxFactor);
+   // numChannels streams are resampled together, each in a buffer of its own.
+   // multithreaded lets the library divide the work among threads, which
+   // pays for offline processing of several channels, but not for real time.
+   Resample(const bool useBestMethod, const double dMinFactor, const double dMaxFactor,
+      unsigned numChannels = 1, bool multithreaded = false);
    ~Resample();
 
    static EnumSetting< int > FastMethodSetting;
@@ -72,6 +76,24 @@ class MATH_API Resample final
                         float  *outBuffer,
                         size_t  outBufferLen);
 
+   /** @brief Resample all channels in one call
+    *
+    * As for the other overload, but with one input and one output buffer per
+    * channel.  The same numbers of samples are consumed and produced in every
+    * channel.
+    @param inBuffers GetNumChannels() buffers of inBufferLen samples
+    @param outBuffers GetNumChannels() buffers of outBufferLen samples
+   */
+   std::pair<size_t, size_t>
+                Process(double  factor,
+                        const float *const inBuffers[],
+                        size_t  inBufferLen,
+                        bool    lastFlag,
+                        float  *const outBuffers[],
+                        size_t  outBufferLen);
+
+   unsigned GetNumChannels() const { return mNumChannels; }
+
  protected:
    void SetMethod(const bool useBestMethod);
 
@@ -79,6 +101,7 @@ class MATH_API Resample final
    int   mMethod; // resampler-specific enum for resampling method
    soxrHandle mHandle; // constant-rate or variable-rate resampler (XOR per instance)
    bool mbWantConstRateResampling;
+   unsigned mNumChannels;
 };
 
 #endif // __AUDACITY_RESAMPLE_H__
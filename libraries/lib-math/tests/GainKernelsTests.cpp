@@ -0,0 +1,79 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  GainKernelsTests.cpp
+
+**********************************************************************/
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include "GainKernels.h"
+
+namespace
+{
+// Not a multiple of the vector width, to exercise the remainders
+constexpr size_t Length = 1027;
+
+std::vector<float> MakeSamples(size_t length, float frequency)
+{
+   std::vector<float> samples(length);
+   for (size_t i = 0; i < length; ++i)
+      samples[i] = std::sin(frequency * i);
+   return samples;
+}
+}
+
+TEST_CASE("GainKernels agree with plain loops", "[GainKernels]")
+{
+   const auto input = MakeSamples(Length, 0.01f);
+
+   SECTION("Scale")
+   {
+      auto actual = input;
+      GainKernels::Scale(actual.data(), actual.size(), 0.25f);
+      for (size_t i = 0; i < Length; ++i)
+         REQUIRE(actual[i] == input[i] * 0.25f);
+   }
+
+   SECTION("ScaleByRamp")
+   {
+      const auto start = 0.9f;
+      const auto step = -0.0007f;
+      auto actual = input;
+      GainKernels::ScaleByRamp(actual.data(), actual.size(), start, step);
+      for (size_t i = 0; i < Length; ++i)
+         REQUIRE(actual[i] ==
+            Approx(input[i] * (start + i * step)).margin(1e-6));
+   }
+
+   SECTION("Multiply")
+   {
+      const auto gains = MakeSamples(Length, 0.003f);
+      auto actual = input;
+      GainKernels::Multiply(actual.data(), gains.data(), actual.size());
+      for (size_t i = 0; i < Length; ++i)
+         REQUIRE(actual[i] == input[i] * gains[i]);
+   }
+
+   SECTION("MultiplyAdd")
+   {
+      const auto src = MakeSamples(Length, 0.02f);
+      auto actual = input;
+      GainKernels::MultiplyAdd(actual.data(), src.data(), actual.size(), 0.5f);
+      for (size_t i = 0; i < Length; ++i)
+         REQUIRE(actual[i] == Approx(input[i] + src[i] * 0.5f).margin(1e-6));
+   }
+
+   SECTION("Empty buffers are left alone")
+   {
+      GainKernels::Scale(nullptr, 0, 2.0f);
+      GainKernels::ScaleByRamp(nullptr, 0, 1.0f, 0.5f);
+      GainKernels::Multiply(nullptr, nullptr, 0);
+      GainKernels::MultiplyAdd(nullptr, nullptr, 0, 2.0f);
+   }
+}
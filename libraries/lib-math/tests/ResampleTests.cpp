@@ -0,0 +1,145 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ResampleTests.cpp
+
+**********************************************************************/
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "Resample.h"
+
+#include "MockedPrefs.h"
+
+namespace
+{
+constexpr auto NumChannels = 4u;
+constexpr size_t InputLength = 44100 * 2;
+//! As when MixerSource drives variable rate resampling
+constexpr size_t BlockLength = 1024;
+
+using Channels = std::vector<std::vector<float>>;
+
+Channels MakeInput(size_t length)
+{
+   Channels input(NumChannels, std::vector<float>(length));
+   for (size_t c = 0; c < NumChannels; ++c)
+      for (size_t i = 0; i < length; ++i)
+         input[c][i] = std::sin(0.01 * (c + 1) * i);
+   return input;
+}
+
+//! Varies the factor from block to block, as a time track would
+double FactorAt(double minFactor, double maxFactor, size_t block)
+{
+   const auto phase = 0.5 + 0.5 * std::sin(0.1 * block);
+   return minFactor + (maxFactor - minFactor) * phase;
+}
+
+//! Resample the channels with one resampler for each, or one for all
+Channels ResampleChannels(const Channels& input, double minFactor, double maxFactor,
+   bool together)
+{
+   const auto nChannels = input.size();
+   const auto length = input[0].size();
+   const auto outLength =
+      static_cast<size_t>(length * maxFactor) + BlockLength;
+   Channels output(nChannels, std::vector<float>(outLength));
+
+   std::vector<std::unique_ptr<Resample>> resamplers;
+   if (together)
+      resamplers.push_back(std::make_unique<Resample>(
+         true, minFactor, maxFactor, nChannels, true));
+   else
+      for (size_t c = 0; c < nChannels; ++c)
+         resamplers.push_back(
+            std::make_unique<Resample>(true, minFactor, maxFactor));
+
+   std::vector<const float*> in(nChannels);
+   std::vector<float*> out(nChannels);
+   size_t consumed = 0;
+   size_t produced = 0;
+   for (size_t block = 0; consumed < length; ++block) {
+      const auto factor = FactorAt(minFactor, maxFactor, block);
+      const auto len = std::min(BlockLength, length - consumed);
+      const auto last = consumed + len == length;
+      for (size_t c = 0; c < nChannels; ++c) {
+         in[c] = input[c].data() + consumed;
+         out[c] = output[c].data() + produced;
+      }
+      std::pair<size_t, size_t> results;
+      if (together)
+         results = resamplers[0]->Process(factor, in.data(), len, last,
+            out.data(), outLength - produced);
+      else
+         for (size_t c = 0; c < nChannels; ++c)
+            results = resamplers[c]->Process(factor, &in[c], len, last,
+               &out[c], outLength - produced);
+      consumed += results.first;
+      produced += results.second;
+      if (last && results.first == 0 && results.second == 0)
+         break;
+   }
+   for (auto& channel : output)
+      channel.resize(produced);
+   return output;
+}
+}
+
+TEST_CASE("Resample processes channels together as it does each alone",
+   "[Resample]")
+{
+   MockedPrefs prefs;
+   const auto input = MakeInput(InputLength);
+
+   SECTION("Constant rate")
+   {
+      const auto factor = 48000.0 / 44100.0;
+      const auto separate = ResampleChannels(input, factor, factor, false);
+      const auto together = ResampleChannels(input, factor, factor, true);
+      REQUIRE(separate[0].size() > 0);
+      for (size_t c = 0; c < NumChannels; ++c)
+         REQUIRE(separate[c] == together[c]);
+   }
+
+   SECTION("Variable rate")
+   {
+      const auto separate = ResampleChannels(input, 0.5, 2.0, false);
+      const auto together = ResampleChannels(input, 0.5, 2.0, true);
+      REQUIRE(separate[0].size() > 0);
+      for (size_t c = 0; c < NumChannels; ++c)
+         REQUIRE(separate[c] == together[c]);
+   }
+}
+
+// Hidden; run with the tag [benchmark]
+TEST_CASE("Resample benchmark", "[.][benchmark]")
+{
+   MockedPrefs prefs;
+   const auto input = MakeInput(InputLength * 5);
+
+   const auto factor = 48000.0 / 44100.0;
+   BENCHMARK("Constant rate, one resampler per channel")
+   {
+      return ResampleChannels(input, factor, factor, false).size();
+   };
+   BENCHMARK("Constant rate, all channels together")
+   {
+      return ResampleChannels(input, factor, factor, true).size();
+   };
+   BENCHMARK("Variable rate, one resampler per channel")
+   {
+      return ResampleChannels(input, 0.5, 2.0, false).size();
+   };
+   BENCHMARK("Variable rate, all channels together")
+   {
+      return ResampleChannels(input, 0.5, 2.0, true).size();
+   };
+}
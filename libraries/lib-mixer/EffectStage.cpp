@@ -14,6 +14,7 @@
 #include "EffectStage.h"
 #include "AudacityException.h"
 #include "AudioGraphBuffers.h"
+#include "Tracing.h"
 #include "WideSampleSequence.h"
 #include <cassert>
 
@@ -298,6 +299,7 @@ bool EffectStage::Process(EffectInstance &instance,
    size_t channel, const Buffers &data, size_t curBlockSize,
    size_t outBufferOffset) const
 {
+   TRACE_SCOPE("effects", "EffectStage::Process");
    size_t processed{};
    try {
       const auto positions = mInBuffers.Positions();
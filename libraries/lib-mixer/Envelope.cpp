@@ -39,6 +39,8 @@ a draggable point type.
 #include <wx/log.h>
 #include <wx/utils.h>
 
+#include "XMLNames.h"
+
 static const double VALUE_TOLERANCE = 0.001;
 
 Envelope::Envelope(bool exponential, double minValue, double maxValue, double defaultValue)
@@ -306,10 +308,38 @@ static double Limit( double Lo, double Value, double Hi )
 }
 #endif
 
+namespace {
+// Names that envelopes compare as integers when deserializing
+const auto EnvelopeTag = XMLNames::Intern("envelope");
+const auto NumPointsAttr = XMLNames::Intern("numpoints");
+const auto ControlPointTag = XMLNames::Intern("controlpoint");
+const auto TAttr = XMLNames::Intern("t");
+const auto ValAttr = XMLNames::Intern("val");
+}
+
+bool EnvPoint::HandleXMLTag(
+   const std::string_view& tag, const AttributesList& attrs)
+{
+   if (XMLNames::Find(tag) == ControlPointTag) {
+      for(auto pair : attrs) {
+         auto attr = XMLNames::Find(pair.first);
+         auto value = pair.second;
+
+         if (attr == TAttr)
+            SetT(value.Get(GetT()));
+         else if (attr == ValAttr)
+            SetVal(nullptr, value.Get(GetVal()));
+      }
+      return true;
+   }
+   else
+      return false;
+}
+
 bool Envelope::HandleXMLTag(const std::string_view& tag, const AttributesList& attrs)
 {
    // Return unless it's the envelope tag.
-   if (tag != "envelope")
+   if (XMLNames::Find(tag) != EnvelopeTag)
       return false;
 
    int numPoints = -1;
@@ -319,7 +349,7 @@ bool Envelope::HandleXMLTag(const std::string_view& tag, const AttributesList& a
       auto attr = pair.first;
       auto value = pair.second;
 
-      if (attr == "numpoints")
+      if (XMLNames::Find(attr) == NumPointsAttr)
          value.TryGet(numPoints);
    }
 
@@ -333,7 +363,7 @@ bool Envelope::HandleXMLTag(const std::string_view& tag, const AttributesList& a
 
 XMLTagHandler *Envelope::HandleXMLChild(const std::string_view& tag)
 {
-   if (tag != "controlpoint")
+   if (XMLNames::Find(tag) != ControlPointTag)
       return NULL;
 
    mEnv.push_back( EnvPoint{} );
@@ -934,6 +964,25 @@ double Envelope::GetInterpolationStartValueAtPoint( int iPoint ) const
       return log10(v);
 }
 
+namespace {
+void FillSegment(const Envelope::Segment &segment, double *buffer)
+{
+   if (segment.IsFlat())
+      std::fill(buffer, buffer + segment.length, segment.value);
+   else if (segment.exponential) {
+      auto value = segment.value;
+      for (size_t i = 0; i < segment.length; ++i, value *= segment.step)
+         buffer[i] = value;
+   }
+   else {
+      // Accumulate, as GetValues() always did
+      auto value = segment.value;
+      for (size_t i = 0; i < segment.length; ++i, value += segment.step)
+         buffer[i] = value;
+   }
+}
+}
+
 void Envelope::GetValues( double *buffer, int bufferLen,
                           double t0, double tstep ) const
 {
@@ -948,113 +997,174 @@ void Envelope::GetValuesRelative
 {
    // JC: If bufferLen ==0 we have probably just allocated a zero sized buffer.
    // wxASSERT( bufferLen > 0 );
+   if (bufferLen <= 0)
+      return;
 
-   const auto epsilon = tstep / 2;
-   int len = mEnv.size();
+   VisitSegmentsRelative(bufferLen, t0, tstep, leftLimit,
+      [&buffer](const Segment &segment){
+         FillSegment(segment, buffer);
+         buffer += segment.length;
+      });
+}
 
-   double t = t0;
-   double increment = 0;
-   if ( len > 1 && t <= mEnv[0].GetT() && mEnv[0].GetT() == mEnv[1].GetT() )
-      increment = leftLimit ? -epsilon : epsilon;
+void Envelope::GetSegments(
+   Segments &segments, size_t len, double t0, double tstep) const
+{
+   segments.clear();
+   AppendSegments(segments, len, t0, tstep);
+}
 
-   double tprev, vprev, tnext = 0, vnext, vstep = 0;
+void Envelope::AppendSegments(
+   Segments &segments, size_t len, double t0, double tstep) const
+{
+   // Convert t0 from absolute to clip-relative time
+   VisitSegmentsRelative(len, t0 - mOffset, tstep, false,
+      [&segments](const Segment &segment){ segments.push_back(segment); });
+}
 
-   for (int b = 0; b < bufferLen; b++) {
+void Envelope::FillValues(const Segments &segments, double *buffer)
+{
+   for (const auto &segment : segments) {
+      FillSegment(segment, buffer);
+      buffer += segment.length;
+   }
+}
 
-      // Get easiest cases out the way first...
-      // IF empty envelope THEN default value
-      if (len <= 0) {
-         buffer[b] = mDefaultValue;
-         t += tstep;
-         continue;
-      }
+double Envelope::Segment::LastValue() const
+{
+   if (length <= 1 || IsFlat())
+      return value;
+   return exponential
+      ? value * pow(step, length - 1)
+      : value + (length - 1) * step;
+}
 
-      auto tplus = t + increment;
+auto Envelope::Segment::Reversed() const -> Segment
+{
+   return { length, LastValue(),
+      exponential ? 1.0 / step : -step, exponential };
+}
+
+void Envelope::VisitSegmentsRelative(size_t bufferLen,
+   double t0, double tstep, bool leftLimit,
+   const std::function<void(const Segment &)> &visit) const
+{
+   const int len = mEnv.size();
+
+   // IF empty envelope THEN default value
+   if (len <= 0) {
+      if (bufferLen > 0)
+         visit({ bufferLen, mDefaultValue, 0.0, false });
+      return;
+   }
+
+   const auto epsilon = tstep / 2;
+   double increment = 0;
+   if ( len > 1 && t0 <= mEnv[0].GetT() && mEnv[0].GetT() == mEnv[1].GetT() )
+      increment = leftLimit ? -epsilon : epsilon;
+
+   // How many samples, from b on, have times before limit, or at it if
+   // inclusive
+   const auto countBefore = [&](size_t b, double limit, bool inclusive) {
+      const auto rest = bufferLen - b;
+      const auto isBefore = [&](size_t n) {
+         const auto tplus = t0 + (b + n) * tstep + increment;
+         return inclusive ? tplus <= limit : tplus < limit;
+      };
+      if (tstep <= 0)
+         return isBefore(0) ? rest : 0;
+      // Estimate, then correct for roundoff
+      const auto estimate =
+         ceil((limit - (t0 + b * tstep + increment)) / tstep);
+      size_t n = estimate <= 0 ? 0
+         : estimate >= rest ? rest
+         : static_cast<size_t>(estimate);
+      while (n > 0 && !isBefore(n - 1))
+         --n;
+      while (n < rest && isBefore(n))
+         ++n;
+      return n;
+   };
+
+   for (size_t b = 0; b < bufferLen;) {
+      const double t = t0 + b * tstep;
+      const auto tplus = t + increment;
 
       // IF before envelope THEN first value
       if ( leftLimit ? tplus <= mEnv[0].GetT() : tplus < mEnv[0].GetT() ) {
-         buffer[b] = mEnv[0].GetVal();
-         t += tstep;
+         const auto n = countBefore(b, mEnv[0].GetT(), leftLimit);
+         visit({ n, mEnv[0].GetVal(), 0.0, false });
+         b += n;
          continue;
       }
-      // IF after envelope THEN last value
+      // IF after envelope THEN last value, for all later samples too
       if ( leftLimit
             ? tplus > mEnv[len - 1].GetT() : tplus >= mEnv[len - 1].GetT() ) {
-         buffer[b] = mEnv[len - 1].GetVal();
-         t += tstep;
-         continue;
+         visit({ bufferLen - b, mEnv[len - 1].GetVal(), 0.0, false });
+         return;
       }
 
-      // be careful to get the correct limit even in case epsilon == 0
-      if ( b == 0 ||
-           ( leftLimit ? tplus > tnext : tplus >= tnext ) ) {
-
-         // We're beyond our tnext, so find the next one.
-         // Don't just increment lo or hi because we might
-         // be zoomed far out and that could be a large number of
-         // points to move over.  That's why we binary search.
+      // Find the interval containing the sample.
+      // Don't just increment lo or hi because we might
+      // be zoomed far out and that could be a large number of
+      // points to move over.  That's why we binary search.
 
-         int lo,hi;
-         if ( leftLimit )
-            BinarySearchForTime_LeftLimit( lo, hi, tplus );
-         else
-            BinarySearchForTime( lo, hi, tplus );
-
-         // mEnv[0] is before tplus because of eliminations above, therefore lo >= 0
-         // mEnv[len - 1] is after tplus, therefore hi <= len - 1
-         wxASSERT( lo >= 0 && hi <= len - 1 );
-
-         tprev = mEnv[lo].GetT();
-         tnext = mEnv[hi].GetT();
-
-         if ( hi + 1 < len && tnext == mEnv[ hi + 1 ].GetT() )
-            // There is a discontinuity after this point-to-point interval.
-            // Usually will stop evaluating in this interval when time is slightly
-            // before tNext, then use the right limit.
-            // This is the right intent
-            // in case small roundoff errors cause a sample time to be a little
-            // before the envelope point time.
-            // Less commonly we want a left limit, so we continue evaluating in
-            // this interval until shortly after the discontinuity.
-            increment = leftLimit ? -epsilon : epsilon;
-         else
-            increment = 0;
+      int lo,hi;
+      if ( leftLimit )
+         BinarySearchForTime_LeftLimit( lo, hi, tplus );
+      else
+         BinarySearchForTime( lo, hi, tplus );
+
+      // mEnv[0] is before tplus because of eliminations above, therefore lo >= 0
+      // mEnv[len - 1] is after tplus, therefore hi <= len - 1
+      wxASSERT( lo >= 0 && hi <= len - 1 );
+
+      const double tprev = mEnv[lo].GetT();
+      const double tnext = mEnv[hi].GetT();
+
+      if ( hi + 1 < len && tnext == mEnv[ hi + 1 ].GetT() )
+         // There is a discontinuity after this point-to-point interval.
+         // Usually will stop evaluating in this interval when time is slightly
+         // before tNext, then use the right limit.
+         // This is the right intent
+         // in case small roundoff errors cause a sample time to be a little
+         // before the envelope point time.
+         // Less commonly we want a left limit, so we continue evaluating in
+         // this interval until shortly after the discontinuity.
+         increment = leftLimit ? -epsilon : epsilon;
+      else
+         increment = 0;
 
-         vprev = GetInterpolationStartValueAtPoint( lo );
-         vnext = GetInterpolationStartValueAtPoint( hi );
+      const double vprev = GetInterpolationStartValueAtPoint( lo );
+      const double vnext = GetInterpolationStartValueAtPoint( hi );
 
-         // Interpolate, either linear or log depending on mDB.
-         double dt = (tnext - tprev);
-         double to = t - tprev;
-         double v;
-         if (dt > 0.0)
-         {
-            v = (vprev * (dt - to) + vnext * to) / dt;
-            vstep = (vnext - vprev) * tstep / dt;
-         }
-         else
-         {
-            v = vnext;
-            vstep = 0.0;
-         }
-
-         // An adjustment if logarithmic scale.
-         if( mDB )
-         {
-            v = pow(10.0, v);
-            vstep = pow( 10.0, vstep );
-         }
+      // Interpolate, either linear or log depending on mDB.
+      double dt = (tnext - tprev);
+      double to = t - tprev;
+      double v, vstep;
+      if (dt > 0.0)
+      {
+         v = (vprev * (dt - to) + vnext * to) / dt;
+         vstep = (vnext - vprev) * tstep / dt;
+      }
+      else
+      {
+         v = vnext;
+         vstep = 0.0;
+      }
 
-         buffer[b] = v;
-      } else {
-         if (mDB){
-            buffer[b] = buffer[b - 1] * vstep;
-         }else{
-            buffer[b] = buffer[b - 1] + vstep;
-         }
+      // An adjustment if logarithmic scale.
+      if( mDB )
+      {
+         v = pow(10.0, v);
+         vstep = pow( 10.0, vstep );
       }
 
-      t += tstep;
+      // The segment lasts until a sample is beyond tnext; be careful to get
+      // the correct limit even in case epsilon == 0
+      const auto n = std::max<size_t>(1, countBefore(b, tnext, leftLimit));
+      visit({ n, v, vstep, mDB });
+      b += n;
    }
 }
 
@@ -13,6 +13,7 @@
 
 #include <stdlib.h>
 #include <algorithm>
+#include <functional>
 #include <vector>
 
 #include "XMLTagHandler.h"
@@ -26,7 +27,7 @@ class EnvPoint;
 
 class ZoomInfo;
 
-class EnvPoint final : public XMLTagHandler {
+class MIXER_API EnvPoint final : public XMLTagHandler {
 
 public:
    EnvPoint() {}
@@ -37,23 +38,7 @@ public:
    double GetVal() const { return mVal; }
    inline void SetVal( Envelope *pEnvelope, double val );
 
-   bool HandleXMLTag(const std::string_view& tag, const AttributesList& attrs) override
-   {
-      if (tag == "controlpoint") {
-         for(auto pair : attrs) {
-            auto attr = pair.first;
-            auto value = pair.second;
-
-            if (attr == "t")
-               SetT(value.Get(GetT()));
-            else if (attr == "val")
-               SetVal(nullptr, value.Get(GetVal()));
-         }
-         return true;
-      }
-      else
-         return false;
-   }
+   bool HandleXMLTag(const std::string_view& tag, const AttributesList& attrs) override;
 
    XMLTagHandler *HandleXMLChild(const std::string_view&  WXUNUSED(tag)) override
    {
@@ -139,6 +124,40 @@ public:
     * more than one value in a row. */
    void GetValues(double *buffer, int len, double t0, double tstep) const;
 
+   //! A run of samples over which the envelope is constant, or changes
+   //! linearly, or (if exponential) geometrically
+   struct Segment {
+      //! Number of samples
+      size_t length;
+      //! Value at the first sample
+      double value;
+      //! Added to the value from each sample to the next, or multiplies it
+      //! if `exponential`
+      double step;
+      bool exponential;
+
+      bool IsFlat() const { return step == (exponential ? 1.0 : 0.0); }
+      //! Value at the last sample
+      double LastValue() const;
+      //! The same values in reverse order
+      Segment Reversed() const;
+   };
+   using Segments = std::vector<Segment>;
+
+   /** \brief Get the values that GetValues() would, as segments whose lengths
+    * sum to len, without computing each value
+    *
+    * Replaces the contents of segments */
+   void GetSegments(Segments &segments, size_t len, double t0, double tstep)
+      const;
+   //! Like GetSegments(), but add to the end of segments
+   void AppendSegments(Segments &segments, size_t len, double t0, double tstep)
+      const;
+
+   //! Compute the values of segments into buffer, which must have room for
+   //! their total length
+   static void FillValues(const Segments &segments, double *buffer);
+
    // Guarantee an envelope point at the end of the domain.
    void Cap( double sampleDur );
 
@@ -150,6 +169,10 @@ private:
       ( size_t startAt, bool rightward, bool testNeighbors = true );
 
    double GetValueRelative(double t, bool leftLimit = false) const;
+   //! Calls visit for each segment, in order
+   void VisitSegmentsRelative(size_t len, double t0, double tstep,
+      bool leftLimit, const std::function<void(const Segment &)> &visit)
+      const;
    void GetValuesRelative
       (double *buffer, int len, double t0, double tstep, bool leftLimit = false)
       const;
@@ -20,7 +20,9 @@
 #include <cmath>
 #include "EffectStage.h"
 #include "Dither.h"
+#include "GainKernels.h"
 #include "Resample.h"
+#include "Tracing.h"
 #include "WideSampleSequence.h"
 #include "float_cast.h"
 #include <numeric>
@@ -259,10 +261,8 @@ static void MixBuffers(unsigned numChannels,
    for (unsigned int c = 0; c < numChannels; c++) {
       if (!channelFlags[c])
          continue;
-      float *dest = dests[c].data();
-      float gain = gains[c];
-      for (int j = 0; j < len; ++j)
-         *dest++ += pSrc[j] * gain;   // the actual mixing process
+      // the actual mixing process
+      GainKernels::MultiplyAdd(dests[c].data(), pSrc, len, gains[c]);
    }
 }
 
@@ -270,6 +270,7 @@ static void MixBuffers(unsigned numChannels,
 
 size_t Mixer::Process(const size_t maxToProcess)
 {
+   TRACE_SCOPE("mixer", "Mixer::Process");
    assert(maxToProcess <= BufferSize());
 
    // MB: this is wrong! mT represented warped time, and mTime is too inaccurate to use
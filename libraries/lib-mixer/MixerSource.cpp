@@ -15,6 +15,7 @@
 
 #include "AudioGraphBuffers.h"
 #include "Envelope.h"
+#include "GainKernels.h"
 #include "Resample.h"
 #include "WideSampleSequence.h"
 #include "float_cast.h"
@@ -39,10 +40,12 @@ initVector(size_t dim1, size_t dim2)
 
 void MixerSource::MakeResamplers()
 {
-   for (size_t j = 0; j < mnChannels; ++j)
-      mResample[j] = std::make_unique<Resample>(
-         mResampleParameters.mHighQuality,
-         mResampleParameters.mMinFactor, mResampleParameters.mMaxFactor);
+   // High quality resampling is for offline mixing, which may use more
+   // threads
+   mResample = std::make_unique<Resample>(
+      mResampleParameters.mHighQuality,
+      mResampleParameters.mMinFactor, mResampleParameters.mMaxFactor,
+      mnChannels, mResampleParameters.mHighQuality);
 }
 
 namespace {
@@ -135,14 +138,10 @@ size_t MixerSource::MixVariableRates(
                // for (size_t iChannel = 0; iChannel < nChannels; ++iChannel)
                   // memset(dst[i], 0, sizeof(float) * getLen);
             }
-            mpLeader->GetEnvelopeValues(
-               mEnvValues.data(), getLen, (pos).as_double() / sequenceRate,
+            mpLeader->GetEnvelopeSegments(
+               mEnvSegments, getLen, (pos).as_double() / sequenceRate,
                backwards);
-            for (size_t iChannel = 0; iChannel < nChannels; ++iChannel) {
-               const auto queue = mSampleQueue[iChannel].data();
-               for (decltype(getLen) i = 0; i < getLen; i++)
-                  queue[(queueLen) + i] *= mEnvValues[i];
-            }
+            ApplyEnvelope(nChannels, dst.data());
 
             if (backwards)
                pos -= getLen;
@@ -174,28 +173,31 @@ size_t MixerSource::MixVariableRates(
                t, t + (double)thisProcessLen / sequenceRate);
       }
 
-      std::pair<size_t, size_t> results;
-      for (size_t iChannel = 0; iChannel < nChannels; ++iChannel) {
-         const auto queue = mSampleQueue[iChannel].data();
-         const auto pResample = mResample[iChannel].get();
-         const auto pFloat = floatBuffers[iChannel];
-         // Assuming that progress of the Resampler depends only
-         // on the size of its inputs, this assignment has the same effect on
-         // each pass.
-         results = pResample->Process(factor,
-            &queue[queueStart],
-            thisProcessLen,
-            last,
-            // PRL:  Bug2536: crash in soxr happened on Mac, sometimes, when
-            // maxOut - out == 1 and &pFloat[out + 1] was an unmapped
-            // address, because soxr, strangely, fetched an 8-byte (misaligned!)
-            // value from &pFloat[out], but did nothing with it anyway,
-            // in soxr_output_no_callback.
-            // Now we make the bug go away by allocating a little more space in
-            // the buffer than we need.
-            &pFloat[out],
-            maxOut - out);
+      // All channels of the sequence go through the resampler together,
+      // though the caller may want fewer of them
+      for (size_t iChannel = 0; iChannel < mnChannels; ++iChannel) {
+         mResampleIn[iChannel] = &mSampleQueue[iChannel][queueStart];
+         // PRL:  Bug2536: crash in soxr happened on Mac, sometimes, when
+         // maxOut - out == 1 and &pFloat[out + 1] was an unmapped
+         // address, because soxr, strangely, fetched an 8-byte (misaligned!)
+         // value from &pFloat[out], but did nothing with it anyway,
+         // in soxr_output_no_callback.
+         // Now we make the bug go away by allocating a little more space in
+         // the buffer than we need.
+         if (iChannel < nChannels)
+            mResampleOut[iChannel] = &floatBuffers[iChannel][out];
+         else {
+            auto &discard = mDiscarded[iChannel - nChannels];
+            discard.resize(std::max(discard.size(), maxOut - out + 1));
+            mResampleOut[iChannel] = discard.data();
+         }
       }
+      const auto results = mResample->Process(factor,
+         mResampleIn.data(),
+         thisProcessLen,
+         last,
+         mResampleOut.data(),
+         maxOut - out);
 
       const auto input_used = results.first;
       queueStart += input_used;
@@ -260,13 +262,8 @@ size_t MixerSource::MixSameRate(unsigned nChannels, const size_t maxOut,
       
    }
 
-   mpLeader->GetEnvelopeValues(mEnvValues.data(), slen, t, backwards);
-
-   for (size_t iChannel = 0; iChannel < nChannels; ++iChannel) {
-      const auto pFloat = floatBuffers[iChannel];
-      for (size_t i = 0; i < slen; i++)
-         pFloat[i] *= mEnvValues[i]; // Track gain control will go here?
-   }
+   mpLeader->GetEnvelopeSegments(mEnvSegments, slen, t, backwards);
+   ApplyEnvelope(nChannels, floatBuffers);
 
    if (backwards)
       pos -= slen;
@@ -278,6 +275,36 @@ size_t MixerSource::MixSameRate(unsigned nChannels, const size_t maxOut,
    return slen;
 }
 
+void MixerSource::ApplyEnvelope(
+   unsigned nChannels, float *const floatBuffers[])
+{
+   size_t offset = 0;
+   for (const auto &segment : mEnvSegments) {
+      const auto len = segment.length;
+      if (segment.IsFlat()) {
+         // Skip the usual unit gain entirely
+         if (segment.value != 1.0)
+            for (size_t iChannel = 0; iChannel < nChannels; ++iChannel)
+               GainKernels::Scale(floatBuffers[iChannel] + offset, len,
+                  segment.value);
+      }
+      else if (segment.exponential) {
+         assert(len <= mEnvValues.size());
+         auto value = segment.value;
+         for (size_t i = 0; i < len; ++i, value *= segment.step)
+            mEnvValues[i] = value;
+         for (size_t iChannel = 0; iChannel < nChannels; ++iChannel)
+            GainKernels::Multiply(floatBuffers[iChannel] + offset,
+               mEnvValues.data(), len);
+      }
+      else
+         for (size_t iChannel = 0; iChannel < nChannels; ++iChannel)
+            GainKernels::ScaleByRamp(floatBuffers[iChannel] + offset, len,
+               segment.value, segment.step);
+      offset += len;
+   }
+}
+
 void MixerSource::ZeroFill(
    size_t produced, size_t max, float &floatBuffer)
 {
@@ -301,7 +328,9 @@ MixerSource::MixerSource(
    , mQueueStart{ 0 }
    , mQueueLen{ 0 }
    , mResampleParameters{ highQuality, mpLeader->GetRate(), rate, options }
-   , mResample( mnChannels )
+   , mResampleIn( mnChannels )
+   , mResampleOut( mnChannels )
+   , mDiscarded( mnChannels )
    , mEnvValues( std::max(sQueueMaxLen, bufferSize) )
    , mpMap{ pMap }
 {
@@ -15,6 +15,7 @@
 #define __AUDACITY_MIXER_SOURCE__
 
 #include "AudioGraphSource.h"
+#include "Envelope.h"
 #include "MixerOptions.h"
 #include "SampleCount.h"
 #include <memory>
@@ -97,6 +98,9 @@ private:
     */
    void ZeroFill(size_t produced, size_t max, float &floatBuffer);
 
+   //! Multiply the buffers by the values described in mEnvSegments
+   void ApplyEnvelope(unsigned nChannels, float *const floatBuffers[]);
+
    const std::shared_ptr<const WideSampleSequence> mpLeader;
    size_t i;
 
@@ -125,10 +129,18 @@ private:
    int mQueueLen;
 
    const ResampleParameters mResampleParameters;
-   std::vector<std::unique_ptr<Resample>> mResample;
+   //! Resamples all channels at once
+   std::unique_ptr<Resample> mResample;
+   //! Pointers to the channels passed to mResample
+   std::vector<const float *> mResampleIn;
+   std::vector<float *> mResampleOut;
+   //! Output of channels that Acquire() was not asked for
+   std::vector<std::vector<float>> mDiscarded;
 
    //! Gain envelopes are applied to input before other transformations
-   std::vector<double> mEnvValues;
+   Envelope::Segments mEnvSegments;
+   //! Values of exponential segments of the envelope
+   std::vector<float> mEnvValues;
 
    //! many-to-one mixing of channels
    //! Pointer into array of arrays
@@ -8,7 +8,9 @@ Paul Licameli split from SampleFrame.cpp
 
 **********************************************************************/
 #include "WideSampleSequence.h"
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 WideSampleSequence::~WideSampleSequence() = default;
 
@@ -27,6 +29,69 @@ double WideSampleSequence::SnapToSample(double t) const
    return LongSamplesToTime(TimeToLongSamples(t));
 }
 
+namespace {
+//! How many of the values, from the first, the segment reproduces
+size_t Extent(
+   const double *values, size_t len, const Envelope::Segment &segment)
+{
+   // Tolerate the roundoff of values that were computed by accumulation
+   constexpr double Tolerance = 1e-9;
+   auto predicted = segment.value;
+   size_t n = 0;
+   for (; n < len; ++n) {
+      const auto value = values[n];
+      if (std::abs(value - predicted) >
+         Tolerance * std::max(1.0, std::abs(value)))
+         break;
+      if (segment.exponential)
+         predicted *= segment.step;
+      else
+         predicted += segment.step;
+   }
+   return n;
+}
+}
+
+void WideSampleSequence::GetEnvelopeSegments(Envelope::Segments &segments,
+   size_t bufferLen, double t0, bool backwards) const
+{
+   segments.clear();
+   if (bufferLen == 0)
+      return;
+   if (HasTrivialEnvelope()) {
+      segments.push_back({ bufferLen, 1.0, 0.0, false });
+      return;
+   }
+   // Reused by each thread, because a sequence may be mixed by several at once
+   static thread_local std::vector<double> values;
+   if (values.size() < bufferLen)
+      values.resize(bufferLen);
+   GetEnvelopeValues(values.data(), bufferLen, t0, backwards);
+   for (size_t i = 0; i < bufferLen;) {
+      const auto pValues = values.data() + i;
+      const auto rest = bufferLen - i;
+      const auto value = pValues[0];
+      Envelope::Segment segment{ 1, value, 0.0, false };
+      if (rest > 1) {
+         // Take the longest of a flat run, a linear ramp, or a geometric
+         // ramp starting at this sample
+         const auto next = pValues[1];
+         const auto ratio = value != 0 ? next / value : 1.0;
+         for (auto candidate : {
+            Envelope::Segment{ 0, value, 0.0, false },
+            Envelope::Segment{ 0, value, next - value, false },
+            Envelope::Segment{ 0, value, ratio, true }
+         }) {
+            candidate.length = Extent(pValues, rest, candidate);
+            if (candidate.length > segment.length)
+               segment = candidate;
+         }
+      }
+      segments.push_back(segment);
+      i += segment.length;
+   }
+}
+
 bool WideSampleSequence::GetFloats(size_t iChannel, size_t nBuffers,
    float *const buffers[], sampleCount start, size_t len,
    bool backwards, fillFormat fill,
@@ -11,6 +11,7 @@ Paul Licameli split from SampleFrame.h
 #define __AUDACITY_WIDE_SAMPLE_SEQUENCE_
 
 #include "AudioGraphChannel.h"
+#include "Envelope.h"
 #include "SampleCount.h"
 #include "SampleFormat.h"
 
@@ -127,6 +128,16 @@ public:
     */
    virtual void GetEnvelopeValues(
       double* buffer, size_t bufferLen, double t0, bool backwards) const = 0;
+
+   //! Describe the values GetEnvelopeValues() would give as segments, whose
+   //! lengths sum to `bufferLen`; replaces the contents of `segments`
+   /*!
+    The default gives one unit segment if HasTrivialEnvelope(), else
+    evaluates GetEnvelopeValues() and finds the flat runs and the linear or
+    geometric ramps in the values
+    */
+   virtual void GetEnvelopeSegments(Envelope::Segments &segments,
+      size_t bufferLen, double t0, bool backwards) const;
 };
 
 #endif
@@ -0,0 +1,168 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  EnvelopeTests.cpp
+
+**********************************************************************/
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include "Envelope.h"
+#include "WideSampleSequence.h"
+
+namespace
+{
+constexpr double Rate = 1000.0;
+constexpr size_t Length = 3000;
+
+//! Evaluate one sample at a time, as for the display
+std::vector<double> SampleBySample(const Envelope& envelope, double t0)
+{
+   std::vector<double> values(Length);
+   for (size_t i = 0; i < Length; ++i)
+      envelope.GetValues(&values[i], 1, t0 + i / Rate, 1 / Rate);
+   return values;
+}
+
+std::vector<double> FromSegments(const Envelope& envelope, double t0)
+{
+   Envelope::Segments segments;
+   envelope.GetSegments(segments, Length, t0, 1 / Rate);
+   size_t total = 0;
+   for (const auto& segment : segments)
+      total += segment.length;
+   REQUIRE(total == Length);
+   std::vector<double> values(Length);
+   Envelope::FillValues(segments, values.data());
+   return values;
+}
+
+//! Has only GetEnvelopeValues(), so that the default GetEnvelopeSegments()
+//! is used
+class EnvelopeSequence final : public WideSampleSequence
+{
+public:
+   explicit EnvelopeSequence(const Envelope& envelope)
+       : mEnvelope{ envelope }
+   {
+   }
+
+   size_t NChannels() const override { return 1; }
+   float GetChannelGain(int) const override { return 1.f; }
+   bool DoGet(size_t, size_t, const samplePtr[], sampleFormat, sampleCount,
+      size_t, bool, fillFormat, bool, sampleCount*) const override
+   {
+      return false;
+   }
+   double GetStartTime() const override { return 0; }
+   double GetEndTime() const override { return Length / Rate; }
+   double GetRate() const override { return Rate; }
+   sampleFormat WidestEffectiveFormat() const override { return floatSample; }
+   bool HasTrivialEnvelope() const override { return false; }
+   void GetEnvelopeValues(double* buffer, size_t bufferLen, double t0,
+      bool backwards) const override
+   {
+      if (backwards)
+         t0 -= bufferLen / Rate;
+      mEnvelope.GetValues(buffer, bufferLen, t0, 1 / Rate);
+      if (backwards)
+         std::reverse(buffer, buffer + bufferLen);
+   }
+   AudioGraph::ChannelType GetChannelType() const override
+   {
+      return AudioGraph::MonoChannel;
+   }
+
+private:
+   const Envelope& mEnvelope;
+};
+}
+
+TEST_CASE("Envelope segments", "[Envelope]")
+{
+   for (const auto exponential : { false, true }) {
+      Envelope envelope{ exponential, 1e-7, 2.0, 1.0 };
+      envelope.InsertOrReplace(0.5, 0.25);
+      envelope.InsertOrReplace(1.0, 1.5);
+      envelope.InsertOrReplace(2.0, 1.5);
+      envelope.InsertOrReplace(2.2, 0.5);
+
+      SECTION(exponential ? "Exponential: values" : "Linear: values")
+      {
+         const auto expected = SampleBySample(envelope, 0.0);
+         const auto actual = FromSegments(envelope, 0.0);
+         for (size_t i = 0; i < Length; ++i)
+            REQUIRE(actual[i] == Approx(expected[i]).epsilon(1e-9));
+      }
+
+      SECTION(exponential ? "Exponential: one segment per piece" :
+         "Linear: one segment per piece")
+      {
+         Envelope::Segments segments;
+         envelope.GetSegments(segments, Length, 0.0, 1 / Rate);
+         // Before the first point, three ramps, after the last point
+         REQUIRE(segments.size() == 5);
+         REQUIRE(segments.front().IsFlat());
+         REQUIRE(segments[2].IsFlat());
+         REQUIRE(segments.back().IsFlat());
+         REQUIRE(segments.back().value == 0.5);
+      }
+   }
+
+   SECTION("Reversed segments give the values backwards")
+   {
+      Envelope envelope{ false, 0.0, 2.0, 1.0 };
+      envelope.InsertOrReplace(0.0, 0.0);
+      envelope.InsertOrReplace(1.0, 1.0);
+      Envelope::Segments segments;
+      envelope.GetSegments(segments, 11, 0.0, 0.1);
+      REQUIRE(segments.size() == 2);
+      const auto reversed = segments[0].Reversed();
+      REQUIRE(reversed.length == segments[0].length);
+      REQUIRE(reversed.value == Approx(segments[0].LastValue()));
+      REQUIRE(reversed.LastValue() == Approx(segments[0].value));
+   }
+
+   SECTION("Empty envelope gives one flat segment")
+   {
+      Envelope envelope{ false, 0.0, 2.0, 1.0 };
+      Envelope::Segments segments;
+      envelope.GetSegments(segments, Length, 0.0, 1 / Rate);
+      REQUIRE(segments.size() == 1);
+      REQUIRE(segments[0].IsFlat());
+      REQUIRE(segments[0].value == 1.0);
+   }
+}
+
+TEST_CASE("Default envelope segments of a sequence", "[Envelope]")
+{
+   for (const auto exponential : { false, true }) {
+      Envelope envelope{ exponential, 1e-7, 2.0, 1.0 };
+      envelope.InsertOrReplace(0.5, 0.25);
+      envelope.InsertOrReplace(1.0, 1.5);
+      envelope.InsertOrReplace(2.0, 1.5);
+      envelope.InsertOrReplace(2.2, 0.5);
+      const EnvelopeSequence sequence{ envelope };
+
+      for (const auto backwards : { false, true }) {
+         const double t0 = backwards ? Length / Rate : 0.0;
+         std::vector<double> expected(Length);
+         sequence.GetEnvelopeValues(expected.data(), Length, t0, backwards);
+
+         Envelope::Segments segments;
+         sequence.GetEnvelopeSegments(segments, Length, t0, backwards);
+         // Ramps are found in the values, not one segment for each sample;
+         // a ramp may break where a value falls on an envelope point
+         REQUIRE(segments.size() <= 8);
+         std::vector<double> actual(Length);
+         Envelope::FillValues(segments, actual.data());
+         for (size_t i = 0; i < Length; ++i)
+            REQUIRE(actual[i] == Approx(expected[i]).epsilon(1e-9));
+      }
+   }
+}
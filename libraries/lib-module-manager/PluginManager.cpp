@@ -25,6 +25,7 @@ for shared and private configs - which need to move out.
 
 #include <algorithm>
 
+#include <wx/filename.h>
 #include <wx/log.h>
 #include <wx/tokenzr.h>
 
@@ -48,6 +49,8 @@ for shared and private configs - which need to move out.
 // Registry has the list of plug ins
 #define REGVERKEY wxString(wxT("/pluginregistryversion"))
 #define REGROOT wxString(wxT("/pluginregistry/"))
+// Sizes and modification times of modules, to detect changed plug ins
+#define STAMPROOT wxString(wxT("/pluginmodulestamps/"))
 
 // Settings has the values of the plug in settings.
 #define SETVERKEY wxString(wxT("/pluginsettingsversion"))
@@ -56,6 +59,8 @@ for shared and private configs - which need to move out.
 
 #define KEY_ID                         wxT("ID")
 #define KEY_PATH                       wxT("Path")
+#define KEY_SIZE                       wxT("Size")
+#define KEY_MODIFIED                   wxT("Modified")
 #define KEY_SYMBOL                     wxT("Symbol")
 #define KEY_NAME                       wxT("Name")
 #define KEY_VENDOR                     wxT("Vendor")
@@ -153,6 +158,11 @@ bool PluginManager::IsPluginLoaded(const wxString& ID) const
 
 void PluginManager::RegisterPlugin(PluginDescriptor&& desc)
 {
+   // Descriptors come here from validation; remember which version of the
+   // module was validated
+   const auto modulePath = desc.GetPath().BeforeFirst(wxT(';'));
+   if (auto stamp = GetModuleStamp(modulePath))
+      mModuleStamps[modulePath] = *stamp;
    mRegisteredPlugins[desc.GetID()] = std::move(desc);
 }
 
@@ -612,6 +622,8 @@ void PluginManager::Load()
    LoadGroup(&registry, PluginTypeImporter);
 
    LoadGroup(&registry, PluginTypeStub);
+
+   LoadModuleStamps(registry);
    return;
 }
 
@@ -888,6 +900,8 @@ void PluginManager::Save()
    // And now the providers
    SaveGroup(&registry, PluginTypeModule);
 
+   SaveModuleStamps(registry);
+
    // Write the version string
    registry.Write(REGVERKEY, REGVERCUR);
 
@@ -1207,6 +1221,7 @@ std::map<wxString, std::vector<wxString>> PluginManager::CheckPluginUpdates()
       {
          const auto modulePath = path.BeforeFirst(';');
          if (!make_iterator_range(pathIndex).contains(modulePath) ||
+            IsModuleChanged(modulePath) ||
             make_iterator_range(mEffectPluginsCleared).any_of([&modulePath](const PluginDescriptor& plug) {
                return plug.GetPath().BeforeFirst(wxT(';')) == modulePath;
             })
@@ -1506,6 +1521,75 @@ wxString PluginManager::ConvertID(const PluginID & ID)
    return wxT("base64:") + Base64::Encode(buf, strlen(buf));
 }
 
+auto PluginManager::GetModuleStamp(const PluginPath &modulePath)
+   -> std::optional<ModuleStamp>
+{
+   // Some providers report paths that are not files, such as URIs
+   const wxFileName fn{ modulePath };
+   ModuleStamp stamp;
+   if (wxFileName::FileExists(modulePath))
+      stamp.size = fn.GetSize().GetValue();
+   else if (!wxFileName::DirExists(modulePath))
+      // Bundles are directories, with only the time stamp
+      return {};
+   const auto modified = fn.GetModificationTime();
+   if (!modified.IsValid())
+      return {};
+   stamp.modified = modified.GetValue().GetValue();
+   return stamp;
+}
+
+bool PluginManager::IsModuleChanged(const PluginPath &modulePath)
+{
+   const auto stamp = GetModuleStamp(modulePath);
+   if (!stamp)
+      return false;
+   const auto iter = mModuleStamps.find(modulePath);
+   if (iter == mModuleStamps.end()) {
+      // Registered before stamps were recorded; trust the registry and start
+      // tracking from now
+      mModuleStamps.emplace(modulePath, *stamp);
+      return false;
+   }
+   return !(iter->second == *stamp);
+}
+
+void PluginManager::LoadModuleStamps(audacity::BasicSettings &registry)
+{
+   mModuleStamps.clear();
+   const auto stampsGroup = registry.BeginGroup(STAMPROOT);
+   for (const auto &groupName : registry.GetChildGroups()) {
+      const auto moduleGroup = registry.BeginGroup(groupName);
+      wxString path;
+      ModuleStamp stamp;
+      if (registry.Read(KEY_PATH, &path) &&
+          registry.Read(KEY_SIZE, &stamp.size) &&
+          registry.Read(KEY_MODIFIED, &stamp.modified))
+         mModuleStamps[path] = stamp;
+   }
+}
+
+void PluginManager::SaveModuleStamps(audacity::BasicSettings &registry)
+{
+   // Forget modules that no registered plugin comes from any more
+   std::map<PluginPath, ModuleStamp> stamps;
+   for (auto &pair : mRegisteredPlugins) {
+      const auto modulePath = pair.second.GetPath().BeforeFirst(wxT(';'));
+      if (auto iter = mModuleStamps.find(modulePath);
+          iter != mModuleStamps.end())
+         stamps.insert(*iter);
+   }
+   mModuleStamps.swap(stamps);
+
+   for (auto &[path, stamp] : mModuleStamps) {
+      const auto moduleGroup =
+         registry.BeginGroup(STAMPROOT + ConvertID(path));
+      registry.Write(KEY_PATH, path);
+      registry.Write(KEY_SIZE, stamp.size);
+      registry.Write(KEY_MODIFIED, stamp.modified);
+   }
+}
+
 // This is defined out-of-line here, to keep ComponentInterface free of other
 // #include directives.
 TranslatableString ComponentInterface::GetName() const
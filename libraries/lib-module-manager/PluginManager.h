@@ -17,6 +17,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "EffectInterface.h"
@@ -170,6 +171,9 @@ public:
    /**
     * \brief Ensures that all currently registered plugins still exist
     * and scans for new ones.
+    *
+    * Modules already registered are scanned again only if their size or
+    * modification time differs from that recorded when they were validated.
     * \return Map, where each module path(key) is associated with at least one provider id
     */
    std::map<wxString, std::vector<wxString>> CheckPluginUpdates();
@@ -223,6 +227,20 @@ private:
    // case, we use base64 encoding.
    wxString ConvertID(const PluginID & ID);
 
+   //! Identifies one version of a plugin module file
+   struct ModuleStamp {
+      long long size{};
+      long long modified{};
+      bool operator ==(const ModuleStamp &other) const
+      { return size == other.size && modified == other.modified; }
+   };
+   //! @return nullopt if the path does not name a file or directory
+   static std::optional<ModuleStamp> GetModuleStamp(const PluginPath &modulePath);
+   //! Whether the module was replaced since it was last validated
+   bool IsModuleChanged(const PluginPath &modulePath);
+   void LoadModuleStamps(audacity::BasicSettings &registry);
+   void SaveModuleStamps(audacity::BasicSettings &registry);
+
 private:
    friend std::default_delete<PluginManager>;
    static std::unique_ptr<PluginManager> mInstance;
@@ -237,6 +255,8 @@ private:
    PluginMap mRegisteredPlugins;
    std::map<PluginID, std::unique_ptr<ComponentInterface>> mLoadedInterfaces;
    std::vector<PluginDescriptor> mEffectPluginsCleared;
+   //! Keyed by module path, the part of a plugin path before any ';'
+   std::map<PluginPath, ModuleStamp> mModuleStamps;
 
    PluginRegistryVersion mRegver;
 };
@@ -19,10 +19,15 @@ Paul Licameli -- split from ProjectFileIO.cpp
 #include "BasicUI.h"
 #include "FileNames.h"
 #include "Internat.h"
+#include "MemoryX.h"
 #include "Project.h"
 #include "FileException.h"
 #include "wxFileNameWrapper.h"
 #include "SentryHelper.h"
+#include "Tracing.h"
+
+#include <algorithm>
+#include <string>
 
 #define AUDACITY_PROJECT_PAGE_SIZE 65536
 
@@ -48,11 +53,103 @@ static const char *FastConfig =
    "PRAGMA <schema>.synchronous = OFF;"
    "PRAGMA <schema>.journal_mode = OFF;";
 
+// Configuration for read-only connections, which may share the file with other
+// processes.  The journal mode is left as the file has it: changing it needs a
+// write.  Without a checkpoint connection, nothing ever checkpoints.
+static const char *ReadOnlyConfig =
+   "PRAGMA <schema>.busy_timeout = 5000;"
+   "PRAGMA query_only = 1;";
+
+// Milliseconds that a checkpoint other than Passive may wait for readers of
+// the project, such as the waveform worker or the summary prefetch.  Writers
+// wait meanwhile, so this is much shorter than the other connections' timeout.
+static const int CheckpointBusyTimeout = 100;
+
+//! Prepared statements of one connection, for each thread that uses them
+/*! See bug 2673: we must not use the same prepared statement from two
+ different threads.
+ */
+struct DBStatementCache
+{
+   using Index = std::pair<enum DBConnection::StatementID, std::thread::id>;
+
+   //! Finalize the statements of one thread
+   void Release(std::thread::id id);
+   //! Finalize all statements
+   void Clear(sqlite3 *db);
+
+   std::mutex mutex;
+   std::map<Index, sqlite3_stmt *> statements;
+};
+
+void DBStatementCache::Release(std::thread::id id)
+{
+   std::lock_guard<std::mutex> guard(mutex);
+   for (auto iter = statements.begin(); iter != statements.end();)
+      if (iter->first.second == id) {
+         sqlite3_finalize(iter->second);
+         iter = statements.erase(iter);
+      }
+      else
+         ++iter;
+}
+
+void DBStatementCache::Clear(sqlite3 *db)
+{
+   std::lock_guard<std::mutex> guard(mutex);
+   for (auto stmt : statements)
+   {
+      // No need to process return code, but log it for diagnosis
+      auto rc = sqlite3_finalize(stmt.second);
+      if (rc != SQLITE_OK)
+      {
+         wxLogMessage("Failed to finalize statement on %s\n"
+                      "\tErrMsg: %s\n"
+                      "\tSQL: %s",
+                      sqlite3_db_filename(db, nullptr),
+                      sqlite3_errmsg(db),
+                      stmt.second);
+      }
+   }
+   statements.clear();
+}
+
+namespace {
+//! When its thread ends, finalizes the statements that the thread prepared
+//! on connections still open
+/*! Worker threads, such as those of recording, come and go, and the cache
+ would otherwise keep their statements until the project closes */
+struct ThreadStatements
+{
+   ~ThreadStatements()
+   {
+      const auto id = std::this_thread::get_id();
+      for (auto &wCache : caches)
+         if (auto pCache = wCache.lock())
+            pCache->Release(id);
+   }
+
+   void Add(const std::shared_ptr<DBStatementCache> &pCache)
+   {
+      // Forget connections already closed
+      caches.erase(std::remove_if(caches.begin(), caches.end(),
+         [](auto &wCache){ return wCache.expired(); }), caches.end());
+      if (std::none_of(caches.begin(), caches.end(),
+         [&](auto &wCache){ return wCache.lock() == pCache; }))
+         caches.push_back(pCache);
+   }
+
+   std::vector<std::weak_ptr<DBStatementCache>> caches;
+};
+thread_local ThreadStatements threadStatements;
+}
+
 DBConnection::DBConnection(
    const std::weak_ptr<AudacityProject> &pProject,
    const std::shared_ptr<DBConnectionErrors> &pErrors,
    CheckpointFailureCallback callback)
 : mpProject{ pProject }
+, mpStatements{ std::make_shared<DBStatementCache>() }
 , mpErrors{ pErrors }
 , mCallback{ std::move(callback) }
 {
@@ -63,6 +160,7 @@ DBConnection::DBConnection(
 
 DBConnection::~DBConnection()
 {
+   StopPrefetch();
    wxASSERT(mDB == nullptr);
    if (mDB)
    {
@@ -166,6 +264,126 @@ int DBConnection::Open(const FilePath fileName)
    return rc;
 }
 
+namespace {
+// Make a URI for sqlite3_open_v2(), so that query parameters can be given
+std::string MakeReadOnlyURI(const FilePath &fileName, bool immutable)
+{
+   std::string path = fileName.ToUTF8().data();
+   std::string uri = "file:";
+#ifdef __WXMSW__
+   std::replace(path.begin(), path.end(), '\\', '/');
+   // A drive letter follows an empty authority
+   if (path.size() > 1 && path[1] == ':')
+      uri += '/';
+#endif
+   // Escape what would end the path or start an escape
+   for (const auto c : path) {
+      if (c == '%' || c == '?' || c == '#') {
+         static const char hex[] = "0123456789ABCDEF";
+         uri += '%';
+         uri += hex[static_cast<unsigned char>(c) >> 4];
+         uri += hex[static_cast<unsigned char>(c) & 0xF];
+      }
+      else
+         uri += c;
+   }
+   uri += "?mode=ro";
+   if (immutable)
+      uri += "&immutable=1";
+   return uri;
+}
+}
+
+int DBConnection::OpenReadOnly(const FilePath fileName, bool immutable)
+{
+   wxASSERT(mDB == nullptr);
+
+   mReadOnly = true;
+   const auto uri = MakeReadOnlyURI(fileName, immutable);
+   int rc = sqlite3_open_v2(uri.c_str(), &mDB,
+      SQLITE_OPEN_READONLY | SQLITE_OPEN_URI, nullptr);
+   if (rc == SQLITE_OK)
+   {
+      rc = ModeConfig(mDB, "main", ReadOnlyConfig);
+      if (rc != SQLITE_OK)
+         SetDBError(XO("Failed to configure read-only connection to %s")
+            .Format(fileName));
+      else
+         ApplyTuning();
+   }
+   else
+   {
+      ADD_EXCEPTION_CONTEXT("sqlite3.rc", std::to_string(rc));
+      ADD_EXCEPTION_CONTEXT("sqlite3.context", "DBConnection::OpenReadOnly");
+
+      wxLogMessage("Failed to open read-only connection to %s: %d, %s\n",
+         fileName,
+         rc,
+         sqlite3_errstr(rc));
+   }
+
+   if (rc != SQLITE_OK)
+   {
+      // sqlite3_open_v2() makes a handle even when it fails
+      sqlite3_close(mDB);
+      mDB = nullptr;
+   }
+   return rc;
+}
+
+bool DBConnection::IsReadOnly() const
+{
+   return mReadOnly;
+}
+
+void DBConnection::SetTuning(const DBTuning &tuning)
+{
+   mTuning = tuning;
+   mCheckpointFrames = std::max(0, tuning.checkpointFrames);
+   mCheckpointMode = static_cast<int>(tuning.checkpointMode);
+   if (mDB)
+      ApplyTuning();
+}
+
+const DBTuning &DBConnection::GetTuning() const
+{
+   return mTuning;
+}
+
+DBStats DBConnection::GetStats(bool reset)
+{
+   DBStats stats;
+   if (!mDB)
+      return stats;
+
+   const auto status = [&](int op, bool resettable) {
+      int current = 0, highwater = 0;
+      sqlite3_db_status(mDB, op, &current, &highwater, reset && resettable);
+      return current;
+   };
+   stats.cacheHits = status(SQLITE_DBSTATUS_CACHE_HIT, true);
+   stats.cacheMisses = status(SQLITE_DBSTATUS_CACHE_MISS, true);
+   stats.cacheWrites = status(SQLITE_DBSTATUS_CACHE_WRITE, true);
+   stats.cacheBytes = status(SQLITE_DBSTATUS_CACHE_USED, false);
+
+   stats.walFrames = mWalFrames;
+   stats.checkpoints = mCheckpoints;
+
+   const auto name = sqlite3_db_filename(mDB, "main");
+   if (name && *name)
+   {
+      const auto walName = wxString::FromUTF8(sqlite3_filename_wal(name));
+      if (wxFileExists(walName))
+      {
+         const auto size = wxFileName::GetSize(walName);
+         if (size != wxInvalidSize)
+            stats.walBytes = size.GetValue();
+      }
+   }
+
+   return stats;
+}
+
 int DBConnection::OpenStepByStep(const FilePath fileName)
 {
    const char *name = fileName.ToUTF8();
@@ -202,6 +420,9 @@ int DBConnection::OpenStepByStep(const FilePath fileName)
       return rc;
    }
 
+   // Failure is only logged; the connection works without tuning
+   ApplyTuning();
+
    rc = sqlite3_open(name, &mCheckpointDB);
    if (rc != SQLITE_OK)
    {
@@ -220,6 +441,7 @@ int DBConnection::OpenStepByStep(const FilePath fileName)
       SetDBError(XO("Failed to set safe mode on checkpoint connection to %s").Format(fileName));
       return rc;
    }
+   sqlite3_busy_timeout(mCheckpointDB, CheckpointBusyTimeout);
 
    auto db = mCheckpointDB;
    mCheckpointThread = std::thread(
@@ -241,6 +463,10 @@ bool DBConnection::Close()
       return true;
    }
 
+   // The prefetch reads with this connection
+   StopPrefetch();
+   DiscardBlockMetadata();
+
    // Uninstall our checkpoint hook so that no additional checkpoints
    // are sent our way.  (Though this shouldn't really happen.)
    sqlite3_wal_hook(mDB, nullptr, nullptr);
@@ -286,24 +512,7 @@ bool DBConnection::Close()
    }
 
    // We're done with the prepared statements
-   {
-      std::lock_guard<std::mutex> guard(mStatementMutex);
-      for (auto stmt : mStatements)
-      {
-         // No need to process return code, but log it for diagnosis
-         rc = sqlite3_finalize(stmt.second);
-         if (rc != SQLITE_OK)
-         {
-            wxLogMessage("Failed to finalize statement on %s\n"
-                         "\tErrMsg: %s\n"
-                         "\tSQL: %s",
-                         sqlite3_db_filename(mDB, nullptr), 
-                         sqlite3_errmsg(mDB),
-                         stmt.second);
-         }
-      }
-      mStatements.clear();
-   }
+   mpStatements->Clear(mDB);
 
    // Not much we can do if the closes fail, so just report the error
 
@@ -379,6 +588,21 @@ int DBConnection::SetPageSize(const char* schema)
    return ModeConfig(mDB, schema, PageSizeConfig);
 }
 
+int DBConnection::ApplyTuning()
+{
+   // A negative cache_size is in KiB, whatever the page size
+   std::string config =
+      "PRAGMA <schema>.cache_size = " +
+         std::to_string(-std::max(1, mTuning.cacheSizeKB)) + ";"
+      "PRAGMA <schema>.mmap_size = " +
+         std::to_string(std::max<int64_t>(0, mTuning.mmapSize)) + ";";
+   // A read-only connection never checkpoints, so never truncates
+   if (!mReadOnly)
+      config += "PRAGMA <schema>.journal_size_limit = " +
+         std::to_string(std::max<int64_t>(-1, mTuning.walSizeLimit)) + ";";
+   return ModeConfig(mDB, "main", config.c_str());
+}
+
 int DBConnection::ModeConfig(sqlite3 *db, const char *schema, const char *config)
 {
    // Ensure attached DB connection gets configured
@@ -427,17 +651,18 @@ const wxString DBConnection::GetLastMessage() const
 
 sqlite3_stmt *DBConnection::Prepare(enum StatementID id, const char *sql)
 {
-   std::lock_guard<std::mutex> guard(mStatementMutex);
+   auto &cache = *mpStatements;
+   std::lock_guard<std::mutex> guard(cache.mutex);
 
    int rc;
    // See bug 2673
    // We must not use the same prepared statement from two different threads.
    // Therefore, in the cache, use the thread id too.
-   StatementIndex ndx(id, std::this_thread::get_id());
+   DBStatementCache::Index ndx(id, std::this_thread::get_id());
 
    // Return an existing statement if it's already been prepared
-   auto iter = mStatements.find(ndx);
-   if (iter != mStatements.end())
+   auto iter = cache.statements.find(ndx);
+   if (iter != cache.statements.end())
    {
       return iter->second;
    }
@@ -462,23 +687,175 @@ sqlite3_stmt *DBConnection::Prepare(enum StatementID id, const char *sql)
       THROW_INCONSISTENCY_EXCEPTION;
    }
 
-   // There are a small number (10 or so) of different id's corresponding 
-   // to different SQL statements, see enum StatementID
-   // We have relatively few threads running at any one time,
-   // e.g. main gui thread, a playback thread, a thread for compacting.
-   // However the cache might keep growing, as we start/stop audio,
-   // perhaps, if we chose to use a new thread each time.
-   // For 3.0.0 I think that's OK.  If it's a data leak it's a slow 
-   // enough one.  wxLogDebugs seem to show that the audio play thread
-   // is being reused, not recreated with a new ID, i.e. no leak at all.
-   // ANSWER-ME Just how serious is the data leak?  How best to fix?
-
-   // Remember the cached statement.
-   mStatements.insert({ndx, stmt});
+   // Remember the cached statement, until this thread ends or the connection
+   // closes
+   cache.statements.insert({ndx, stmt});
+   threadStatements.Add(mpStatements);
 
    return stmt;
 }
 
+namespace {
+int ReadBlockMetadata(
+   sqlite3 *db, std::vector<DBConnection::BlockMetadata> &metadata)
+{
+   // length() of a blob needs only the record header, not the overflow pages
+   // that hold the samples; and blockid is the rowid, so the order is free
+   sqlite3_stmt *stmt = nullptr;
+   auto rc = sqlite3_prepare_v2(db,
+      "SELECT blockid, sampleformat, summin, summax, sumrms,"
+      "       length(samples)"
+      "  FROM sampleblocks ORDER BY blockid;",
+      -1, &stmt, nullptr);
+   if (rc != SQLITE_OK)
+      return rc;
+   auto cleanup = finally([&]{ sqlite3_finalize(stmt); });
+
+   while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+      metadata.push_back({
+         sqlite3_column_int64(stmt, 0),
+         sqlite3_column_double(stmt, 2),
+         sqlite3_column_double(stmt, 3),
+         sqlite3_column_double(stmt, 4),
+         static_cast<uint32_t>(sqlite3_column_int(stmt, 5)),
+         sqlite3_column_int(stmt, 1)
+      });
+   if (rc != SQLITE_DONE)
+      return rc;
+
+   metadata.shrink_to_fit();
+   return SQLITE_OK;
+}
+}
+
+bool DBConnection::PreloadBlockMetadata()
+{
+   TRACE_SCOPE("sqlite", "DBConnection::PreloadBlockMetadata");
+   DiscardBlockMetadata();
+
+   std::vector<BlockMetadata> metadata;
+   if (ReadBlockMetadata(mDB, metadata) != SQLITE_OK) {
+      SetDBError(XO("Unable to read sample block metadata"));
+      return false;
+   }
+
+   mBlockMetadata.swap(metadata);
+   return true;
+}
+
+void DBConnection::StartBlockMetadataPreload()
+{
+   DiscardBlockMetadata();
+
+   // A temporary or in-memory database has no name to open again; and a
+   // read-only one may be immutable, which another connection can't know
+   const auto fileName = sqlite3_db_filename(mDB, "main");
+   if (mReadOnly || !fileName || !*fileName) {
+      PreloadBlockMetadata();
+      return;
+   }
+
+   mPendingBlockMetadata = std::async(std::launch::async,
+      [fileName = std::string{ fileName }]
+         -> std::optional<std::vector<BlockMetadata>> {
+         TRACE_SCOPE("sqlite", "DBConnection::StartBlockMetadataPreload");
+         std::vector<BlockMetadata> metadata;
+         sqlite3 *db = nullptr;
+         auto cleanup = finally([&]{ sqlite3_close(db); });
+         // On failure, FindBlockMetadata() reads with this connection instead
+         if (sqlite3_open_v2(fileName.c_str(), &db,
+               SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK ||
+             ReadBlockMetadata(db, metadata) != SQLITE_OK)
+            return {};
+         return metadata;
+      });
+}
+
+void DBConnection::DiscardBlockMetadata()
+{
+   if (mPendingBlockMetadata.valid())
+      mPendingBlockMetadata.wait();
+   mPendingBlockMetadata = {};
+   std::vector<BlockMetadata>{}.swap(mBlockMetadata);
+}
+
+auto DBConnection::FindBlockMetadata(int64_t blockID)
+   -> const BlockMetadata *
+{
+   if (mPendingBlockMetadata.valid()) {
+      TRACE_SCOPE("sqlite", "DBConnection::FindBlockMetadata wait");
+      if (auto metadata = mPendingBlockMetadata.get())
+         mBlockMetadata.swap(*metadata);
+      else
+         PreloadBlockMetadata();
+   }
+
+   const auto end = mBlockMetadata.end();
+   const auto iter = std::lower_bound(mBlockMetadata.begin(), end, blockID,
+      [](const BlockMetadata &metadata, int64_t id){
+         return metadata.blockID < id; });
+   if (iter == end || iter->blockID != blockID)
+      return nullptr;
+   return &*iter;
+}
+
+void DBConnection::PrefetchSummaries(
+   std::vector<int64_t> summary256IDs, std::vector<int64_t> summary64kIDs)
+{
+   StopPrefetch();
+   mPrefetchStop = false;
+
+   // As for StartBlockMetadataPreload(), there may be no file to open again;
+   // then there is nothing to gain either
+   const auto fileName = sqlite3_db_filename(mDB, "main");
+   if (mReadOnly || !fileName || !*fileName)
+      return;
+
+   // Use a read-only connection of its own, so that this one's mutex and
+   // error state are left alone.  Its page cache is not this one's, but the
+   // reads still warm the operating system's cache of the file.
+   mPrefetchThread = std::thread([
+      this, fileName = std::string{ fileName },
+      summary256IDs = std::move(summary256IDs),
+      summary64kIDs = std::move(summary64kIDs)
+   ]{
+      TRACE_SCOPE("sqlite", "DBConnection::PrefetchSummaries");
+      sqlite3 *db = nullptr;
+      auto closeDB = finally([&]{ sqlite3_close(db); });
+      if (sqlite3_open_v2(fileName.c_str(), &db,
+            SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK)
+         return;
+      const auto prefetch = [&](const char *sql, const std::vector<int64_t> &ids){
+         sqlite3_stmt *stmt = nullptr;
+         if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+            return;
+         auto cleanup = finally([&]{ sqlite3_finalize(stmt); });
+         for (const auto id : ids) {
+            if (mPrefetchStop)
+               return;
+            if (id <= 0)
+               continue;
+            sqlite3_bind_int64(stmt, 1, id);
+            // Stepping reads the blob's pages; the values are not needed
+            if (sqlite3_step(stmt) == SQLITE_ROW)
+               sqlite3_column_blob(stmt, 0);
+            sqlite3_reset(stmt);
+         }
+      };
+      prefetch("SELECT summary64k FROM sampleblocks WHERE blockid = ?1;",
+         summary64kIDs);
+      prefetch("SELECT summary256 FROM sampleblocks WHERE blockid = ?1;",
+         summary256IDs);
+   });
+}
+
+void DBConnection::StopPrefetch()
+{
+   mPrefetchStop = true;
+   if (mPrefetchThread.joinable())
+      mPrefetchThread.join();
+}
+
 void DBConnection::CheckpointThread(sqlite3 *db, const FilePath &fileName)
 {
    int rc = SQLITE_OK;
@@ -506,18 +883,46 @@ void DBConnection::CheckpointThread(sqlite3 *db, const FilePath &fileName)
          mCheckpointPending = false;
       }
 
+      int mode = SQLITE_CHECKPOINT_PASSIVE;
+      switch (static_cast<DBTuning::CheckpointMode>(mCheckpointMode.load()))
+      {
+      case DBTuning::CheckpointMode::Passive:
+         break;
+      case DBTuning::CheckpointMode::Full:
+         mode = SQLITE_CHECKPOINT_FULL;
+         break;
+      case DBTuning::CheckpointMode::Restart:
+         mode = SQLITE_CHECKPOINT_RESTART;
+         break;
+      case DBTuning::CheckpointMode::Truncate:
+         mode = SQLITE_CHECKPOINT_TRUNCATE;
+         break;
+      }
+
       // And kick off the checkpoint. This may not checkpoint ALL frames
       // in the WAL.  They'll be gotten the next time around.
       using namespace std::chrono;
+      int logFrames = 0, checkpointedFrames = 0;
       do {
          rc = giveUp ? SQLITE_OK :
             sqlite3_wal_checkpoint_v2(
-               db, nullptr, SQLITE_CHECKPOINT_PASSIVE, nullptr, nullptr);
+               db, nullptr, mode, &logFrames, &checkpointedFrames);
       }
       // Contentions for an exclusive lock on the database are possible,
       // even while the main thread is merely drawing the tracks, which
       // may perform reads
-      while (rc == SQLITE_BUSY && (std::this_thread::sleep_for(1ms), true));
+      while (rc == SQLITE_BUSY && mode == SQLITE_CHECKPOINT_PASSIVE &&
+         (std::this_thread::sleep_for(1ms), true));
+
+      // The other modes waited already, as long as CheckpointBusyTimeout;
+      // what they left will be gotten the next time around too
+      if (rc == SQLITE_BUSY)
+         rc = SQLITE_OK;
+      else if (rc == SQLITE_OK && !giveUp)
+      {
+         ++mCheckpoints;
+         mWalFrames = std::max(0, logFrames - checkpointedFrames);
+      }
 
       // Reset
       mCheckpointActive = false;
@@ -578,6 +983,11 @@ int DBConnection::CheckpointHook(void *data, sqlite3 *db, const char *schema, in
    // Get access to our object
    DBConnection *that = static_cast<DBConnection *>(data);
 
+   // Let the WAL grow to the threshold first
+   that->mWalFrames = pages;
+   if (pages < that->mCheckpointFrames)
+      return SQLITE_OK;
+
    // Queue the database pointer for our checkpoint thread to process
    std::lock_guard<std::mutex> guard(that->mCheckpointMutex);
    that->mCheckpointPending = true;
@@ -591,12 +1001,16 @@ int DBConnection::CheckpointHook(void *data, sqlite3 *db, const char *schema, in
 
 struct DBConnectionTransactionScopeImpl final : TransactionScopeImpl {
    explicit DBConnectionTransactionScopeImpl(DBConnection &connection)
-      : mConnection{ connection } {}
+      : mLock{ connection.GetTransactionMutex() }
+      , mConnection{ connection } {}
    ~DBConnectionTransactionScopeImpl() override;
    bool TransactionStart(const wxString &name) override;
    bool TransactionCommit(const wxString &name) override;
    bool TransactionRollback(const wxString &name) override;
 
+   // The recording writer thread may open a transaction concurrently
+   // with the main thread
+   std::unique_lock<std::recursive_mutex> mLock;
    DBConnection &mConnection;
 };
 
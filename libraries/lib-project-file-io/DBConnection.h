@@ -14,19 +14,25 @@ Paul Licameli -- split from ProjectFileIO.h
 
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
+#include <vector>
 
 #include "ClientData.h"
+#include "DBTuning.h"
 #include "Identifier.h"
 
 struct sqlite3;
 struct sqlite3_stmt;
 class wxString;
 class AudacityProject;
+struct DBStatementCache;
 
 struct DBConnectionErrors
 {
@@ -36,7 +42,7 @@ struct DBConnectionErrors
    wxString mLog;
 };
 
-class DBConnection
+class PROJECT_FILE_IO_API DBConnection
 {
 public:
    using CheckpointFailureCallback = std::function<void()>;
@@ -52,6 +58,14 @@ public:
    ~DBConnection();
 
    int Open(const FilePath fileName);
+   //! Open for reading only, with no checkpoints and no write locks, so that
+   //! other processes may read the same file at once
+   /*!
+    @param immutable promise that nothing writes the file while it is open,
+    so that no locks are taken at all, even on read-only media
+    */
+   int OpenReadOnly(const FilePath fileName, bool immutable);
+   bool IsReadOnly() const;
    bool Close();
 
    //! throw and show appropriate message box
@@ -59,6 +73,13 @@ public:
       bool write //!< If true, a database update failed; if false, only a SELECT failed
    ) const;
 
+   //! Takes effect now if open, and at later opens
+   void SetTuning(const DBTuning &tuning);
+   const DBTuning &GetTuning() const;
+   //! @param reset whether to restart the counts of cache hits, misses and
+   //! writes from zero
+   DBStats GetStats(bool reset = false);
+
    int SafeMode(const char *schema = "main");
    int FastMode(const char* schema = "main");
    int SetPageSize(const char* schema = "main");
@@ -80,13 +101,61 @@ public:
       InsertSampleBlock,
       DeleteSampleBlock,
       GetSampleBlockSize,
-      GetAllSampleBlocksSize
+      GetAllSampleBlocksSize,
+      GetSampleBlockContents
    };
    sqlite3_stmt *Prepare(enum StatementID id, const char *sql);
 
+   //! What SqliteSampleBlock loads for a row of sampleblocks, without samples
+   struct BlockMetadata
+   {
+      int64_t blockID;
+      double sumMin;
+      double sumMax;
+      double sumRms;
+      uint32_t sampleBytes;
+      int sampleFormat;
+   };
+
+   //! Read the metadata of all sample blocks with one query
+   /*!
+    Until DiscardBlockMetadata(), FindBlockMetadata() answers from memory.
+    Scanning the table costs much less than one query per block when opening
+    a project that mentions most of them.
+    @return success; if false, FindBlockMetadata() finds nothing
+    */
+   bool PreloadBlockMetadata();
+   //! Like PreloadBlockMetadata(), but on a worker thread with its own
+   //! read-only connection
+   /*!
+    The first FindBlockMetadata() waits for the result.  If the worker could
+    not read it, that call falls back to PreloadBlockMetadata().  Only what
+    this connection does before that call overlaps the preload.
+    */
+   void StartBlockMetadataPreload();
+   void DiscardBlockMetadata();
+   //! @return null if not preloaded or there is no such row
+   const BlockMetadata *FindBlockMetadata(int64_t blockID);
+
+   //! Read the summaries of blocks on a worker thread, with its own
+   //! read-only connection, so that drawing them soon after finds the file's
+   //! pages in the operating system's cache
+   /*!
+    Stops any prefetch still in progress.  Close() stops this one.
+    Nonpositive ids, which are of silent blocks, are skipped.  Does nothing
+    for a database without a file name, or one opened read-only.
+    */
+   void PrefetchSummaries(
+      std::vector<int64_t> summary256IDs, std::vector<int64_t> summary64kIDs);
+   void StopPrefetch();
+
    void SetBypass( bool bypass );
    bool ShouldBypass();
 
+   //! Held by each TransactionScope for its lifetime, so that savepoints
+   //! opened by different threads on this connection do not interleave
+   std::recursive_mutex &GetTransactionMutex() { return mTransactionMutex; }
+
    //! Just set stored errors
    void SetError(
       const TranslatableString &msg,
@@ -102,6 +171,7 @@ public:
 private:
    int OpenStepByStep(const FilePath fileName);
    int ModeConfig(sqlite3 *db, const char *schema, const char *config);
+   int ApplyTuning();
 
    void CheckpointThread(sqlite3 *db, const FilePath &fileName);
    static int CheckpointHook(void *data, sqlite3 *db, const char *schema, int pages);
@@ -118,15 +188,34 @@ private:
    std::atomic_bool mCheckpointPending{ false };
    std::atomic_bool mCheckpointActive{ false };
 
-   std::mutex mStatementMutex;
-   using StatementIndex = std::pair<enum StatementID, std::thread::id>;
-   std::map<StatementIndex, sqlite3_stmt *> mStatements;
+   DBTuning mTuning;
+   // Copies of tuning that the WAL hook and checkpoint thread read
+   std::atomic<int> mCheckpointFrames{ 0 };
+   std::atomic<int> mCheckpointMode{ 0 };
+   std::atomic<int64_t> mWalFrames{ 0 };
+   std::atomic<int64_t> mCheckpoints{ 0 };
+
+   //! Shared with the threads that prepared statements, so that each can
+   //! finalize its own when it ends
+   std::shared_ptr<DBStatementCache> mpStatements;
+
+   //! Sorted by blockID
+   std::vector<BlockMetadata> mBlockMetadata;
+   //! Empty if the worker failed
+   std::future<std::optional<std::vector<BlockMetadata>>>
+      mPendingBlockMetadata;
+
+   std::thread mPrefetchThread;
+   std::atomic<bool> mPrefetchStop{ false };
+
+   std::recursive_mutex mTransactionMutex;
 
    std::shared_ptr<DBConnectionErrors> mpErrors;
    CheckpointFailureCallback mCallback;
 
    // Bypass transactions if database will be deleted after close
    bool mBypass;
+   bool mReadOnly{ false };
 };
 
 using Connection = std::unique_ptr<DBConnection>;
@@ -0,0 +1,67 @@
+/*!********************************************************************
+
+Audacity: A Digital Audio Editor
+
+@file DBTuning.h
+@brief Declare DBTuning and DBStats, settings and statistics of a DBConnection
+
+**********************************************************************/
+
+#ifndef __AUDACITY_DB_TUNING__
+#define __AUDACITY_DB_TUNING__
+
+#include <cstdint>
+
+//! Settings of a project's database connection, trading memory for speed
+struct DBTuning
+{
+   //! How hard the checkpoint thread tries, as for sqlite3_wal_checkpoint_v2()
+   /*!
+    Modes other than Passive hold off writers of the project while they wait
+    for its readers: the waveform worker, the summary prefetch, and the
+    preload of block metadata.  So the checkpoint connection waits at most
+    a tenth of a second for them, not the five seconds of the others, and
+    leaves the rest of the WAL for the next checkpoint.
+    */
+   enum class CheckpointMode
+   {
+      Passive, //!< Never waits for other connections
+      Full, //!< Waits for writers, then copies every frame
+      Restart, //!< As Full, then waits for readers so the WAL restarts
+      Truncate, //!< As Restart, then truncates the WAL file to nothing
+   };
+
+   //! Limit of the page cache, in KiB
+   int cacheSizeKB{ 2000 };
+   //! Bytes of the file that reads may map into memory; 0 maps none
+   int64_t mmapSize{ 0 };
+   //! Frames that the WAL must hold before a checkpoint starts; 0 starts one
+   //! after each commit
+   int checkpointFrames{ 0 };
+   //! Bytes that the WAL file is truncated to after a checkpoint;
+   //! negative leaves it at its largest size
+   int64_t walSizeLimit{ -1 };
+   CheckpointMode checkpointMode{ CheckpointMode::Passive };
+};
+
+//! Statistics of a project's database connection
+struct DBStats
+{
+   //! Page cache lookups satisfied from memory
+   int64_t cacheHits{ 0 };
+   //! Page cache lookups that read the file
+   int64_t cacheMisses{ 0 };
+   //! Pages written from the cache
+   int64_t cacheWrites{ 0 };
+   //! Memory used by the page cache
+   int64_t cacheBytes{ 0 };
+   //! Frames in the WAL not yet checkpointed, as of the last commit or
+   //! checkpoint
+   int64_t walFrames{ 0 };
+   //! Size of the WAL file, or 0 if it does not exist
+   int64_t walBytes{ 0 };
+   //! Checkpoints completed since opening
+   int64_t checkpoints{ 0 };
+};
+
+#endif
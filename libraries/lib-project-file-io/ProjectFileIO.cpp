@@ -10,10 +10,12 @@ Paul Licameli split from AudacityProject.cpp
 
 #include "ProjectFileIO.h"
 
+#include <algorithm>
 #include <atomic>
 #include <sqlite3.h>
 #include <optional>
 #include <cstring>
+#include <vector>
 
 #include <wx/crt.h>
 #include <wx/log.h>
@@ -31,6 +33,8 @@ Paul Licameli split from AudacityProject.cpp
 #include "SampleBlock.h"
 #include "TempDirectory.h"
 #include "TransactionScope.h"
+#include "Sequence.h"
+#include "WaveClip.h"
 #include "WaveTrack.h"
 #include "BasicUI.h"
 #include "wxFileNameWrapper.h"
@@ -423,6 +427,44 @@ bool ProjectFileIO::InitializeSQL()
    return sqliteIniter.mRc == SQLITE_OK;
 }
 
+IntSetting SQLiteSettings::CacheSizeKB{ L"/SQLite/CacheSizeKB", 2000 };
+IntSetting SQLiteSettings::MmapSizeMB{ L"/SQLite/MmapSizeMB", 0 };
+IntSetting SQLiteSettings::CheckpointFrames{ L"/SQLite/CheckpointFrames", 0 };
+IntSetting SQLiteSettings::WalSizeLimitMB{ L"/SQLite/WalSizeLimitMB", -1 };
+
+EnumSetting<DBTuning::CheckpointMode> SQLiteSettings::CheckpointMode{
+   L"/SQLite/CheckpointMode",
+   {
+      { L"Passive", XO("Passive") },
+      { L"Full", XO("Full") },
+      { L"Restart", XO("Restart") },
+      { L"Truncate", XO("Truncate") },
+   },
+   0, // Passive
+   {
+      DBTuning::CheckpointMode::Passive,
+      DBTuning::CheckpointMode::Full,
+      DBTuning::CheckpointMode::Restart,
+      DBTuning::CheckpointMode::Truncate,
+   }
+};
+
+BoolSetting SQLiteSettings::DeduplicateBlocks{
+   L"/SQLite/DeduplicateBlocks", false };
+
+DBTuning SQLiteSettings::DefaultTuning()
+{
+   constexpr int64_t MB = 1024 * 1024;
+   DBTuning tuning;
+   tuning.cacheSizeKB = CacheSizeKB.Read();
+   tuning.mmapSize = MmapSizeMB.Read() * MB;
+   tuning.checkpointFrames = CheckpointFrames.Read();
+   const auto walSizeLimitMB = WalSizeLimitMB.Read();
+   tuning.walSizeLimit = walSizeLimitMB < 0 ? -1 : walSizeLimitMB * MB;
+   tuning.checkpointMode = CheckpointMode.ReadEnum();
+   return tuning;
+}
+
 static const AudacityProject::AttachedObjects::RegisteredFactory sFileIOKey{
    []( AudacityProject &parent ){
       auto result = std::make_shared< ProjectFileIO >( parent );
@@ -444,6 +486,7 @@ const ProjectFileIO &ProjectFileIO::Get( const AudacityProject &project )
 ProjectFileIO::ProjectFileIO(AudacityProject &project)
    : mProject{ project }
    , mpErrors{ std::make_shared<DBConnectionErrors>() }
+   , mTuning{ SQLiteSettings::DefaultTuning() }
 {
    mPrevConn = nullptr;
 
@@ -552,6 +595,7 @@ bool ProjectFileIO::OpenConnection(FilePath fileName /* = {}  */)
    // Pass weak_ptr to project into DBConnection constructor
    curConn = std::make_unique<DBConnection>(
       mProject.shared_from_this(), mpErrors, [this]{ OnCheckpointFailure(); } );
+   curConn->SetTuning(mTuning);
    auto rc = curConn->Open(fileName);
    if (rc != SQLITE_OK)
    {
@@ -592,6 +636,7 @@ bool ProjectFileIO::CloseConnection()
    curConn.reset();
 
    SetFileName({});
+   mReadOnly = false;
 
    return true;
 }
@@ -1624,14 +1669,14 @@ void ProjectFileIO::SetFileName(const FilePath &fileName)
 {
    auto &project = mProject;
 
-   if (!mFileName.empty())
+   if (!mFileName.empty() && !mReadOnly)
    {
       ActiveProjects::Remove(mFileName);
    }
 
    mFileName = fileName;
 
-   if (!mFileName.empty())
+   if (!mFileName.empty() && !mReadOnly)
    {
       ActiveProjects::Add(mFileName);
    }
@@ -2039,6 +2084,28 @@ void ProjectFileIO::TentativeConnection::Commit()
    }
 }
 
+bool ProjectFileIO::DecodeDocument(const char *table, int64_t rowId)
+{
+   // Sample blocks mentioned by the document find their metadata in
+   // memory, instead of making one query each.  Another connection reads
+   // them, but decoding waits for them at the first sample block, so only
+   // the start of the document is read meanwhile.
+   auto &conn = CurrConn();
+   conn->StartBlockMetadataPreload();
+   Finally Do{[&]{ conn->DiscardBlockMetadata(); }};
+
+   BufferedProjectBlobStream stream(DB(), "main", table, rowId);
+   if (!ProjectSerializer::Decode(stream, this))
+   {
+      SetError(
+         XO("Unable to parse project information.")
+      );
+      return false;
+   }
+
+   return true;
+}
+
 auto ProjectFileIO::LoadProject(const FilePath &fileName, bool ignoreAutosave)
    -> std::optional<TentativeConnection>
 {
@@ -2078,18 +2145,9 @@ auto ProjectFileIO::LoadProject(const FilePath &fileName, bool ignoreAutosave)
    else
    {
       // Load 'er up
-      BufferedProjectBlobStream stream(
-         DB(), "main", useAutosave ? "autosave" : "project", rowId);
-
-      success = ProjectSerializer::Decode(stream, this);
-
+      success = DecodeDocument(useAutosave ? "autosave" : "project", rowId);
       if (!success)
-      {
-         SetError(
-            XO("Unable to parse project information.")
-         );
          return {};
-      }
 
       // Check for orphans blocks...sets mRecovered if any were deleted
       
@@ -2137,6 +2195,109 @@ auto ProjectFileIO::LoadProject(const FilePath &fileName, bool ignoreAutosave)
    return result;
 }
 
+bool ProjectFileIO::LoadProjectReadOnly(
+   const FilePath &fileName, bool immutable)
+{
+   auto &curConn = CurrConn();
+   wxASSERT(!curConn);
+   if (curConn)
+      return false;
+
+   curConn = std::make_unique<DBConnection>(
+      mProject.shared_from_this(), mpErrors, [this]{ OnCheckpointFailure(); } );
+   curConn->SetTuning(mTuning);
+   auto rc = curConn->OpenReadOnly(fileName, immutable);
+   if (rc != SQLITE_OK)
+   {
+      SetError(
+         XO("Failed to open database file:\n\n%s").Format(fileName),
+         {},
+         rc
+      );
+      curConn.reset();
+      return false;
+   }
+
+   // Before SetFileName(), so that the file is not listed among active
+   // projects, as if this process owned it
+   mReadOnly = true;
+   mTemporary = false;
+   SetFileName(fileName);
+
+   // Sample blocks must not delete their rows when released
+   curConn->SetBypass(true);
+
+   // Orphan blocks stay, and an autosave document is ignored, because either
+   // would need a write
+   int64_t rowId = -1;
+   if (!CheckVersion() ||
+       !GetValue("SELECT ROWID FROM main.project WHERE id = 1;", rowId, false) ||
+       !DecodeDocument("project", rowId))
+   {
+      // Release any blocks decoded so far while the connection is open
+      TrackList::Get(mProject).Clear();
+      CloseConnection();
+      return false;
+   }
+
+   return true;
+}
+
+bool ProjectFileIO::IsReadOnly() const
+{
+   return mReadOnly;
+}
+
+void ProjectFileIO::PrefetchSummaries(double t0, double t1, double zoom)
+{
+   auto &curConn = CurrConn();
+   if (!curConn || !(zoom > 0) || t0 >= t1)
+      return;
+
+   std::vector<int64_t> summary256IDs, summary64kIDs;
+   for (const auto pTrack : TrackList::Get(mProject).Any<const WaveTrack>())
+      for (const auto &pClip : pTrack->GetClipsIntersecting(t0, t1)) {
+         // Choose the summary as GetWaveDisplay does; at greater zoom it
+         // reads samples, which are not worth reading ahead
+         const auto samplesPerPixel =
+            pClip->GetRate() / (zoom * pClip->GetStretchRatio());
+         if (samplesPerPixel < 256)
+            continue;
+         auto &ids = samplesPerPixel >= 65536 ? summary64kIDs : summary256IDs;
+
+         const auto s0 = pClip->TimeToSequenceSamples(
+            std::max(t0, pClip->GetPlayStartTime()));
+         const auto s1 = pClip->TimeToSequenceSamples(
+            std::min(t1, pClip->GetPlayEndTime()));
+         for (size_t ii = 0, width = pClip->GetWidth(); ii < width; ++ii)
+            for (const auto &block : *pClip->GetSequenceBlockArray(ii))
+               if (block.start < s1 &&
+                   block.start + block.sb->GetSampleCount() > s0)
+                  ids.push_back(block.sb->GetBlockID());
+      }
+
+   curConn->PrefetchSummaries(
+      std::move(summary256IDs), std::move(summary64kIDs));
+}
+
+const DBTuning &ProjectFileIO::GetTuning() const
+{
+   return mTuning;
+}
+
+void ProjectFileIO::SetTuning(const DBTuning &tuning)
+{
+   mTuning = tuning;
+   if (auto &curConn = CurrConn())
+      curConn->SetTuning(tuning);
+}
+
+DBStats ProjectFileIO::GetDBStats(bool reset)
+{
+   auto &curConn = CurrConn();
+   return curConn ? curConn->GetStats(reset) : DBStats{};
+}
+
 bool ProjectFileIO::UpdateSaved(const TrackList *tracks)
 {
    ProjectSerializer doc;
@@ -2232,6 +2393,7 @@ bool ProjectFileIO::SaveProject(
       Connection newConn = std::make_unique<DBConnection>(
          mProject.shared_from_this(), mpErrors,
          [this]{ OnCheckpointFailure(); });
+      newConn->SetTuning(mTuning);
 
       // NOTE: There is a noticeable delay here when dealing with large multi-hour
       //       projects that we just created. The delay occurs in Open() when it
@@ -2689,3 +2851,36 @@ static ProjectHistory::AutoSave::Scope scope {
          "Error:_Disk_full_or_not_writable"
       };
 } };
+
+ReadOnlyProject::ReadOnlyProject(std::shared_ptr<AudacityProject> pProject)
+   : mpProject{ move(pProject) }
+{
+}
+
+std::unique_ptr<ReadOnlyProject> ReadOnlyProject::Open(
+   const FilePath &fileName, bool immutable, TranslatableString *pError)
+{
+   auto pProject = AudacityProject::Create();
+   auto &projectFileIO = ProjectFileIO::Get(*pProject);
+   if (!projectFileIO.LoadProjectReadOnly(fileName, immutable))
+   {
+      if (pError)
+         *pError = projectFileIO.GetLastError();
+      return nullptr;
+   }
+   return std::unique_ptr<ReadOnlyProject>{
+      safenew ReadOnlyProject{ move(pProject) } };
+}
+
+ReadOnlyProject::~ReadOnlyProject()
+{
+   // Release the sample blocks before closing the database; they delete
+   // nothing, because the connection is bypassed
+   TrackList::Get(Project()).Clear();
+   ProjectFileIO::Get(Project()).CloseProject();
+}
+
+const TrackList &ReadOnlyProject::GetTracks() const
+{
+   return TrackList::Get(*mpProject);
+}
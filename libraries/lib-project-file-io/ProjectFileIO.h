@@ -18,6 +18,7 @@ Paul Licameli split from AudacityProject.h
 #include <wx/event.h>
 
 #include "ClientData.h" // to inherit
+#include "DBTuning.h"
 #include "Observer.h"
 #include "Prefs.h" // to inherit
 #include "XMLTagHandler.h" // to inherit
@@ -54,6 +55,31 @@ enum class ProjectFileIOMessage : int {
    ProjectTitleChange,  //!< A normal occurrence
 };
 
+//! Preferences giving the defaults of ProjectFileIO::GetTuning()
+namespace SQLiteSettings {
+extern PROJECT_FILE_IO_API IntSetting CacheSizeKB;
+extern PROJECT_FILE_IO_API IntSetting MmapSizeMB;
+extern PROJECT_FILE_IO_API IntSetting CheckpointFrames;
+//! Negative leaves the WAL file at its largest size
+extern PROJECT_FILE_IO_API IntSetting WalSizeLimitMB;
+extern PROJECT_FILE_IO_API EnumSetting<DBTuning::CheckpointMode>
+   CheckpointMode;
+//! Whether a new sample block with the contents of one still in use shares
+//! its row, and a new block of zeros is silent, taking no row; a project's
+//! sample block factory reads it once, when made
+/*!
+ Blocks loaded from the project file, or pasted from another project, are
+ read and hashed only when new contents have the same length, format, least
+ and greatest sample.  Limits remain:  only whole blocks are compared, so
+ the same audio at another offset within blocks is not shared; only blocks
+ still held by a track, the clipboard or an undo state are found; and a block
+ is never shared with contents in another sample format.
+ */
+extern PROJECT_FILE_IO_API BoolSetting DeduplicateBlocks;
+
+PROJECT_FILE_IO_API DBTuning DefaultTuning();
+}
+
 ///\brief Object associated with a project that manages reading and writing
 /// of Audacity project file formats, and autosave
 class PROJECT_FILE_IO_API ProjectFileIO final
@@ -119,6 +145,33 @@ public:
    std::optional<TentativeConnection>
       LoadProject(const FilePath &fileName, bool ignoreAutosave);
 
+   //! Open a saved project for reading only, without taking it over
+   /*!
+    Any number of processes may read the same file at once this way.  Nothing
+    is written: the autosave document is ignored, orphan blocks are kept, no
+    checkpoints are made, and the file is not listed among active projects.
+    The project must not have had a connection before.
+    @param immutable promise that nothing writes the file while it is open,
+    so that SQLite takes no locks, as for files on read-only media
+    @return success; if false, see GetLastError()
+    */
+   bool LoadProjectReadOnly(const FilePath &fileName, bool immutable = false);
+   bool IsReadOnly() const;
+
+   //! Read ahead, on a worker thread, the summaries of sample blocks that
+   //! drawing the tracks between t0 and t1 at zoom pixels per second needs
+   /*! Call after LoadProject(); closing the connection stops the reading */
+   void PrefetchSummaries(double t0, double t1, double zoom);
+
+   //! Settings of this project's database connections, at first
+   //! SQLiteSettings::DefaultTuning()
+   const DBTuning &GetTuning() const;
+   //! Takes effect at once for the current connection, and for those opened
+   //! later
+   void SetTuning(const DBTuning &tuning);
+   //! Statistics of the current connection, or zeroes if there is none
+   DBStats GetDBStats(bool reset = false);
+
    bool UpdateSaved(const TrackList *tracks = nullptr);
    bool SaveProject(const FilePath &fileName, const TrackList *lastSaved);
    bool SaveCopy(const FilePath& fileName);
@@ -269,6 +322,9 @@ private:
    bool CheckVersion();
    bool InstallSchema(sqlite3 *db, const char *schema = "main");
 
+   //! Decode the document in a row of the project or autosave table
+   bool DecodeDocument(const char *table, int64_t rowId);
+
    // Write project or autosave XML (binary) documents
    bool WriteDoc(const char *table, const ProjectSerializer &autosave, const char *schema = "main");
 
@@ -325,6 +381,11 @@ private:
    // Is this project still a temporary/unsaved project
    bool mTemporary;
 
+   // Was this project opened by LoadProjectReadOnly()
+   bool mReadOnly{ false };
+
+   DBTuning mTuning;
+
    // Project was compacted last time Compact() ran
    bool mWasCompacted;
 
@@ -350,4 +411,31 @@ private:
    std::shared_ptr<AudacityProject> mpProject;
 };
 
+//! A saved project opened for reading only, with no window
+/*!
+ For tools that read the tracks of saved projects, perhaps many processes
+ reading one file at once.  Read samples through the WaveTracks of
+ GetTracks() as usual: their sample blocks use the read-only connection.
+ @see ProjectFileIO::LoadProjectReadOnly
+ */
+class PROJECT_FILE_IO_API ReadOnlyProject
+{
+public:
+   //! @return null on failure, described in *pError if not null
+   static std::unique_ptr<ReadOnlyProject> Open(const FilePath &fileName,
+      bool immutable = false, TranslatableString *pError = nullptr);
+   ~ReadOnlyProject();
+
+   AudacityProject &Project()
+   {
+      return *mpProject;
+   }
+   const TrackList &GetTracks() const;
+
+private:
+   explicit ReadOnlyProject(std::shared_ptr<AudacityProject> pProject);
+
+   std::shared_ptr<AudacityProject> mpProject;
+};
+
 #endif
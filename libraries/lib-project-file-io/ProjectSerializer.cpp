@@ -26,6 +26,7 @@
 #include <wx/log.h>
 
 #include "BufferedStreamReader.h"
+#include "XMLNames.h"
 
 ///
 /// ProjectSerializer class
@@ -227,16 +228,6 @@ public:
       mHandlers.pop_back();
    }
 
-   void WriteAttr(const std::string_view& name, std::string value)
-   {
-      assert(mInTag);
-
-      if (!mInTag)
-         return;
-
-      mAttributes.emplace_back(name, CacheString(std::move(value)));
-   }
-
    template <typename T> void WriteAttr(const std::string_view& name, T value)
    {
       assert(mInTag);
@@ -247,16 +238,16 @@ public:
       mAttributes.emplace_back(name, XMLAttributeValueView(value));
    }
 
-   void WriteData(std::string value)
+   void WriteData(const std::string_view& value)
    {
       if (mInTag)
          EmitStartTag();
 
       if (XMLTagHandler* const handler = mHandlers.back())
-         handler->HandleXMLContent(CacheString(std::move(value)));
+         handler->HandleXMLContent(value);
    }
 
-   void WriteRaw(std::string)
+   void WriteRaw(const std::string_view&)
    {
       // This method is intentionally left empty.
       // The only data that is serialized by FT_Raw
@@ -264,6 +255,15 @@ public:
       // which are ignored
    }
 
+   //! Returns a buffer for a string value, valid until the tag is emitted
+   /*! Buffers are reused for later tags, keeping their capacity */
+   std::string& NextString()
+   {
+      if (mUsedStrings == mStrings.size())
+         mStrings.emplace_back();
+      return mStrings[mUsedStrings++];
+   }
+
    bool Finalize()
    {
       if (mInTag)
@@ -301,24 +301,20 @@ private:
          }
       }
 
-      mStringsCache.clear();
+      mUsedStrings = 0;
       mAttributes.clear();
       mInTag = false;
    }
 
-   std::string_view CacheString(std::string string)
-   {
-      mStringsCache.emplace_back(std::move(string));
-      return mStringsCache.back();
-   }
-
    XMLTagHandler* mBaseHandler;
 
    std::vector<XMLTagHandler*> mHandlers;
 
    std::string_view mCurrentTagName;
 
-   std::deque<std::string> mStringsCache;
+   // A deque, so that growing it does not move the strings in use
+   std::deque<std::string> mStrings;
+   size_t mUsedStrings { 0 };
    AttributesList mAttributes;
 
    bool mInTag { false };
@@ -331,7 +327,7 @@ private:
 // }
 
 template<typename BaseCharType>
-std::string FastStringConvert(const void* bytes, int bytesCount)
+void FastStringConvert(const void* bytes, int bytesCount, std::string& result)
 {
    constexpr int charSize = sizeof(BaseCharType);
 
@@ -346,10 +342,10 @@ std::string FastStringConvert(const void* bytes, int bytesCount)
       { return static_cast<std::make_unsigned_t<BaseCharType>>(c) < 0x7f; });
 
    if (isAscii)
-      return std::string(begin, end);
-   
-   return std::wstring_convert<std::codecvt_utf8<BaseCharType>, BaseCharType>()
-      .to_bytes(begin, end);
+      result.assign(begin, end);
+   else
+      result = std::wstring_convert<std::codecvt_utf8<BaseCharType>, BaseCharType>()
+         .to_bytes(begin, end);
 }
 } // namespace
 
@@ -534,55 +530,75 @@ bool ProjectSerializer::Decode(BufferedStreamReader& in, XMLTagHandler* handler)
    XMLTagHandlerAdapter adapter(handler);
 
    std::vector<char> bytes;
-   IdMap mIds;
-   std::vector<IdMap> mIdStack;
+   // Names indexed by their ids in the document; a view with null data is
+   // not defined
+   std::vector<std::string_view> mIds;
+   std::vector<std::vector<std::string_view>> mIdStack;
+   // Copies of the names that no handler interned
+   std::deque<std::string> mNames;
    char mCharSize = 0;
 
-   mIds.clear();
-
    struct Error{}; // exception type for short-range try/catch
    auto Lookup = [&mIds]( UShort id ) -> std::string_view
    {
-      auto iter = mIds.find( id );
-      if (iter == mIds.end())
+      if (id >= mIds.size() || mIds[id].data() == nullptr)
       {
          throw Error{};
       }
 
-      return iter->second;
+      return mIds[id];
    };
 
    int64_t stringsCount = 0;
    int64_t stringsLength = 0;
 
-   auto ReadString = [&mCharSize, &in, &bytes, &stringsCount, &stringsLength](int len) -> std::string
+   // Read into result, reusing its capacity
+   auto ReadString = [&mCharSize, &in, &bytes, &stringsCount, &stringsLength](
+      int len, std::string &result) -> std::string_view
    {
-      bytes.reserve( len );
-      auto data = bytes.data();
-      in.Read( data, len );
-
       stringsCount++;
       stringsLength += len;
-      
+
       switch (mCharSize)
       {
          case 1:
-            return std::string(bytes.data(), len);
+            result.resize( len );
+            in.Read( result.data(), len );
+            break;
 
          case 2:
-            return FastStringConvert<char16_t>(bytes.data(), len);
+            bytes.resize( len );
+            in.Read( bytes.data(), len );
+            FastStringConvert<char16_t>(bytes.data(), len, result);
+            break;
 
          case 4:
-            return FastStringConvert<char32_t>(bytes.data(), len);
+            bytes.resize( len );
+            in.Read( bytes.data(), len );
+            FastStringConvert<char32_t>(bytes.data(), len, result);
+            break;
 
          default:
             wxASSERT_MSG(false, wxT("Characters size not 1, 2, or 4"));
+            result.clear();
          break;
       }
 
-      return {};
+      return result;
+   };
+
+   // Names are looked up in the global table once, not for each use
+   std::string name;
+   auto ReadName = [&](int len) -> std::string_view
+   {
+      ReadString(len, name);
+      if (const auto stored = XMLNames::Stored(name); !stored.empty())
+         return stored;
+      return mNames.emplace_back(name);
    };
 
+   std::string scratch;
+
    try
    {
       while (!in.Eof())
@@ -593,14 +609,14 @@ bool ProjectSerializer::Decode(BufferedStreamReader& in, XMLTagHandler* handler)
          {
             case FT_Push:
             {
-               mIdStack.push_back(mIds);
+               mIdStack.push_back(std::move(mIds));
                mIds.clear();
             }
             break;
 
             case FT_Pop:
             {
-               mIds = mIdStack.back();
+               mIds = std::move(mIdStack.back());
                mIdStack.pop_back();
             }
             break;
@@ -609,7 +625,9 @@ bool ProjectSerializer::Decode(BufferedStreamReader& in, XMLTagHandler* handler)
             {
                id = ReadUShort( in );
                auto len = ReadUShort( in );
-               mIds[id] = ReadString(len);
+               if (id >= mIds.size())
+                  mIds.resize(id + 1);
+               mIds[id] = ReadName(len);
             }
             break;
 
@@ -634,7 +652,7 @@ bool ProjectSerializer::Decode(BufferedStreamReader& in, XMLTagHandler* handler)
                id = ReadUShort( in );
                int len = ReadLength( in );
                
-               adapter.WriteAttr(Lookup(id), ReadString(len));
+               adapter.WriteAttr(Lookup(id), ReadString(len, adapter.NextString()));
             }
             break;
 
@@ -711,14 +729,14 @@ bool ProjectSerializer::Decode(BufferedStreamReader& in, XMLTagHandler* handler)
             case FT_Data:
             {
                int len = ReadLength( in );
-               adapter.WriteData(ReadString(len));
+               adapter.WriteData(ReadString(len, adapter.NextString()));
             }
             break;
 
             case FT_Raw:
             {
                int len = ReadLength( in );
-               adapter.WriteRaw(ReadString(len));
+               adapter.WriteRaw(ReadString(len, scratch));
             }
             break;
 
@@ -30,7 +30,6 @@ class BufferedStreamReader;
 ///
 
 using NameMap = std::unordered_map<wxString, unsigned short>;
-using IdMap = std::unordered_map<unsigned short, std::string>;
 
 // This class's overrides do NOT throw AudacityException.
 class PROJECT_FILE_IO_API ProjectSerializer final : public XMLWriter
@@ -19,13 +19,21 @@ Paul Licameli -- split from SampleBlock.cpp and SampleBlock.h
 #include "XMLTagHandler.h"
 
 #include "SampleBlock.h" // to inherit
+#include "Tracing.h"
 #include "UndoManager.h"
 #include "WaveTrack.h"
 
 #include "SentryHelper.h"
 #include <wx/log.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <mutex>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
 
 class SqliteSampleBlockFactory;
 
@@ -53,6 +61,9 @@ public:
    using Sizes = std::pair< size_t, size_t >;
    void Commit(Sizes sizes);
 
+   //! Insert a copy of the row of a block in another database, as stored
+   void CopyFrom(SqliteSampleBlock &source);
+
    void Delete();
 
    SampleBlockID GetBlockID() const override;
@@ -93,6 +104,10 @@ private:
                   sampleFormat srcformat,
                   size_t srcoffset,
                   size_t srcbytes);
+   //! Read stored bytes of samples straight from the database into dest,
+   //! with no intermediate copy, if the block is large enough to gain by it
+   /*! @return false if not tried, or the row could not be read so */
+   bool ReadStoredSamples(void *dest, size_t srcoffset, size_t srcbytes);
 
    enum {
       fields = 3, /* min, max, rms */
@@ -100,6 +115,10 @@ private:
    };
    Sizes SetSizes( size_t numsamples, sampleFormat srcformat );
    void CalcSummary(Sizes sizes);
+   //! Insert a row with the given contents and the other fields of this
+   /*! @post mBlockID is the new row's */
+   void Insert(const void *summary256, size_t summary256Bytes,
+      const void *summary64k, size_t summary64kBytes, const void *samples);
 
 private:
    //! This must never be called for silent blocks
@@ -134,6 +153,10 @@ private:
 #endif
 };
 
+// Samples of at least this many bytes, a page of the project file, are read
+// through an incremental blob handle
+static const size_t MinBlobHandleBytes = 65536;
+
 // Silent blocks use nonpositive id values to encode a length
 // and don't occupy any rows in the database; share blocks for repeatedly
 // used length values
@@ -164,7 +187,23 @@ public:
       sampleFormat srcformat,
       const AttributesList &attrs) override;
 
+   SampleBlockPtr DoCreateCopy(
+      const SampleBlockPtr &source,
+      sampleFormat format) override;
+
 private:
+   //! @return a block in use with the same contents, if any
+   SampleBlockPtr FindDuplicate(uint64_t hash,
+      constSamplePtr src, size_t numsamples, sampleFormat srcformat);
+
+   //! Remember a block that was not made from samples in memory, to hash it
+   //! only if new contents could equal it
+   void AddUnhashed(const std::shared_ptr<SqliteSampleBlock> &sb);
+   //! Hash the unhashed blocks that could have these contents, for
+   //! FindDuplicate()
+   void HashCandidates(
+      constSamplePtr src, size_t numsamples, sampleFormat srcformat);
+
    void OnBeginPurge(size_t begin, size_t end);
    void OnEndPurge();
 
@@ -174,6 +213,8 @@ private:
    Observer::Subscription mUndoSubscription;
    std::optional<SampleBlock::DeletionCallback::Scope> mScope;
    const std::shared_ptr<ConnectionPtr> mppConnection;
+   // SQLiteSettings::DeduplicateBlocks, as when the factory was made
+   const bool mDeduplicate;
 
    // Track all blocks that this factory has created, but don't control
    // their lifetimes (so use weak_ptr)
@@ -182,11 +223,88 @@ private:
    using AllBlocksMap =
       std::map< SampleBlockID, std::weak_ptr< SqliteSampleBlock > >;
    AllBlocksMap mAllBlocks;
+
+   // Copies made by DoCreateCopy(), so that pasting the same blocks again
+   // shares them; the key is valid only while the source is the same object
+   struct Copy {
+      std::weak_ptr< SampleBlock > source;
+      std::weak_ptr< SqliteSampleBlock > copy;
+   };
+   std::unordered_map< const SampleBlock*, Copy > mCopies;
+   size_t mCopiesLimit{ 1024 };
+
+   // Blocks made by DoCreate() while deduplicating, by hash of contents.
+   // Sharing a block object shares its row, which is deleted only when the
+   // last user releases it, as GetActiveBlockIDs() expects
+   std::unordered_multimap< uint64_t, std::weak_ptr< SqliteSampleBlock > >
+      mBlocksByHash;
+   size_t mBlocksByHashLimit{ 1024 };
+
+   // Blocks loaded from the project or copied from another, while
+   // deduplicating, and not yet in mBlocksByHash.  Their levels are known
+   // without reading the samples; only those with the same length, format,
+   // least and greatest sample as new contents are read and hashed.
+   using LevelsKey = std::tuple< size_t, sampleFormat, float, float >;
+   std::multimap< LevelsKey, std::weak_ptr< SqliteSampleBlock > > mUnhashed;
+   size_t mUnhashedLimit{ 1024 };
 };
 
+namespace {
+//! Hash of sample bytes, for finding candidate duplicates, which are then
+//! compared in full; also tells whether all bytes are zero
+uint64_t HashSamples(
+   constSamplePtr src, size_t size, sampleFormat format, bool &zero)
+{
+   constexpr uint64_t prime1 = 0x9E3779B185EBCA87ull;
+   constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+   const auto mix = [&](uint64_t hash, uint64_t word) {
+      hash ^= word * prime2;
+      return ((hash << 31) | (hash >> 33)) * prime1;
+   };
+
+   uint64_t hash = mix(size, static_cast<uint64_t>(format));
+   uint64_t bits = 0;
+   for (; size >= sizeof(uint64_t); src += sizeof(uint64_t),
+        size -= sizeof(uint64_t)) {
+      uint64_t word;
+      std::memcpy(&word, src, sizeof(word));
+      bits |= word;
+      hash = mix(hash, word);
+   }
+   if (size > 0) {
+      uint64_t word = 0;
+      std::memcpy(&word, src, size);
+      bits |= word;
+      hash = mix(hash, word);
+   }
+   zero = (bits == 0);
+
+   hash ^= hash >> 33;
+   hash *= prime2;
+   hash ^= hash >> 29;
+   return hash;
+}
+
+//! The least and greatest samples, as the summaries of a block find them
+std::pair<float, float> SampleRange(
+   constSamplePtr src, size_t numsamples, sampleFormat format)
+{
+   Floats buffer;
+   auto samples = reinterpret_cast<const float*>(src);
+   if (format != floatSample) {
+      buffer.reinit(numsamples);
+      SamplesToFloats(src, format, buffer.get(), numsamples);
+      samples = buffer.get();
+   }
+   const auto [pMin, pMax] = std::minmax_element(samples, samples + numsamples);
+   return { *pMin, *pMax };
+}
+}
+
 SqliteSampleBlockFactory::SqliteSampleBlockFactory( AudacityProject &project )
    : mProject{ project }
    , mppConnection{ ConnectionPtr::Get(project).shared_from_this() }
+   , mDeduplicate{ SQLiteSettings::DeduplicateBlocks.Read() }
 {
    mUndoSubscription = UndoManager::Get(project)
       .Subscribe([this](UndoRedoMessage message){
@@ -206,13 +324,115 @@ SqliteSampleBlockFactory::~SqliteSampleBlockFactory() = default;
 SampleBlockPtr SqliteSampleBlockFactory::DoCreate(
    constSamplePtr src, size_t numsamples, sampleFormat srcformat )
 {
+   std::optional<uint64_t> hash;
+   if (numsamples > 0 && mDeduplicate) {
+      bool zero = false;
+      hash = HashSamples(
+         src, numsamples * SAMPLE_SIZE(srcformat), srcformat, zero);
+      if (zero)
+         return DoCreateSilent(numsamples, srcformat);
+      HashCandidates(src, numsamples, srcformat);
+      if (auto sb = FindDuplicate(*hash, src, numsamples, srcformat))
+         return sb;
+   }
+
    auto sb = std::make_shared<SqliteSampleBlock>(shared_from_this());
    sb->SetSamples(src, numsamples, srcformat);
    // block id has now been assigned
    mAllBlocks[ sb->GetBlockID() ] = sb;
+
+   if (hash) {
+      mBlocksByHash.emplace(*hash, sb);
+      if (mBlocksByHash.size() >= mBlocksByHashLimit) {
+         // Tighten up the map
+         for (auto it = mBlocksByHash.begin(); it != mBlocksByHash.end();)
+            if (it->second.expired())
+               it = mBlocksByHash.erase(it);
+            else
+               ++it;
+         mBlocksByHashLimit =
+            std::max<size_t>(1024, 2 * mBlocksByHash.size());
+      }
+   }
+
    return sb;
 }
 
+SampleBlockPtr SqliteSampleBlockFactory::FindDuplicate(uint64_t hash,
+   constSamplePtr src, size_t numsamples, sampleFormat srcformat)
+{
+   const auto bytes = numsamples * SAMPLE_SIZE(srcformat);
+   std::optional<SampleBuffer> buffer;
+   const auto range = mBlocksByHash.equal_range(hash);
+   for (auto it = range.first; it != range.second; ++it) {
+      const auto pBlock = it->second.lock();
+      if (!pBlock || pBlock->GetSampleFormat() != srcformat ||
+          pBlock->GetSampleCount() != numsamples)
+         continue;
+      // Equal hashes are not proof; compare the stored samples
+      if (!buffer)
+         buffer.emplace(numsamples, srcformat);
+      if (pBlock->GetSamples(
+             buffer->ptr(), srcformat, 0, numsamples, false) == numsamples &&
+          std::memcmp(buffer->ptr(), src, bytes) == 0)
+         return pBlock;
+   }
+   return {};
+}
+
+void SqliteSampleBlockFactory::AddUnhashed(
+   const std::shared_ptr<SqliteSampleBlock> &sb)
+{
+   const auto min = static_cast<float>(sb->mSumMin);
+   const auto max = static_cast<float>(sb->mSumMax);
+   // NaN would break the ordering of keys
+   if (!mDeduplicate || !sb->mValid || std::isnan(min) || std::isnan(max))
+      return;
+   mUnhashed.emplace(
+      LevelsKey{ sb->GetSampleCount(), sb->GetSampleFormat(), min, max }, sb);
+   if (mUnhashed.size() >= mUnhashedLimit) {
+      // Tighten up the map
+      for (auto it = mUnhashed.begin(); it != mUnhashed.end();)
+         if (it->second.expired())
+            it = mUnhashed.erase(it);
+         else
+            ++it;
+      mUnhashedLimit = std::max<size_t>(1024, 2 * mUnhashed.size());
+   }
+}
+
+void SqliteSampleBlockFactory::HashCandidates(
+   constSamplePtr src, size_t numsamples, sampleFormat srcformat)
+{
+   // Find the levels of the contents only if some length and format match
+   constexpr auto lowest = -std::numeric_limits<float>::infinity();
+   const auto first =
+      mUnhashed.lower_bound({ numsamples, srcformat, lowest, lowest });
+   if (first == mUnhashed.end() ||
+       std::get<0>(first->first) != numsamples ||
+       std::get<1>(first->first) != srcformat)
+      return;
+   const auto [min, max] = SampleRange(src, numsamples, srcformat);
+   if (std::isnan(min) || std::isnan(max))
+      return;
+
+   const auto range = mUnhashed.equal_range({ numsamples, srcformat, min, max });
+   std::optional<SampleBuffer> buffer;
+   for (auto it = range.first; it != range.second;) {
+      if (const auto pBlock = it->second.lock()) {
+         if (!buffer)
+            buffer.emplace(numsamples, srcformat);
+         if (pBlock->GetSamples(
+               buffer->ptr(), srcformat, 0, numsamples, false) == numsamples) {
+            bool zero = false;
+            mBlocksByHash.emplace(HashSamples(buffer->ptr(),
+               numsamples * SAMPLE_SIZE(srcformat), srcformat, zero), pBlock);
+         }
+      }
+      it = mUnhashed.erase(it);
+   }
+}
+
 auto SqliteSampleBlockFactory::GetActiveBlockIDs() -> SampleBlockIDs
 {
    SampleBlockIDs result;
@@ -246,6 +466,40 @@ SampleBlockPtr SqliteSampleBlockFactory::DoCreateSilent(
 }
 
 
+SampleBlockPtr SqliteSampleBlockFactory::DoCreateCopy(
+   const SampleBlockPtr &source, sampleFormat format )
+{
+   const auto pSource = std::dynamic_pointer_cast<SqliteSampleBlock>(source);
+   if (pSource && pSource->IsSilent())
+      return DoCreateSilent(pSource->GetSampleCount(), format);
+   // Conversion of the format needs the samples
+   if (!pSource || pSource->GetSampleFormat() != format)
+      return SampleBlockFactory::DoCreateCopy(source, format);
+
+   auto &entry = mCopies[ pSource.get() ];
+   if (entry.source.lock() == pSource)
+      if (auto pCopy = entry.copy.lock())
+         return pCopy;
+
+   auto sb = std::make_shared<SqliteSampleBlock>(shared_from_this());
+   sb->CopyFrom(*pSource);
+   mAllBlocks[ sb->GetBlockID() ] = sb;
+   entry = { pSource, sb };
+   AddUnhashed(sb);
+
+   if (mCopies.size() >= mCopiesLimit) {
+      // Tighten up the map
+      for (auto it = mCopies.begin(); it != mCopies.end();)
+         if (it->second.source.expired() || it->second.copy.expired())
+            it = mCopies.erase(it);
+         else
+            ++it;
+      mCopiesLimit = std::max<size_t>(1024, 2 * mCopies.size());
+   }
+
+   return sb;
+}
+
 SampleBlockPtr SqliteSampleBlockFactory::DoCreateFromXML(
    sampleFormat srcformat, const AttributesList &attrs )
 {
@@ -283,6 +537,7 @@ SampleBlockPtr SqliteSampleBlockFactory::DoCreateFromXML(
                // This may throw database errors
                // It initializes the rest of the fields
                ssb->Load((SampleBlockID) nValue);
+               AddUnhashed(ssb);
             }
          }
          found++;
@@ -421,6 +676,11 @@ size_t SqliteSampleBlock::DoGetSamples(samplePtr dest,
       return numsamples;
    }
 
+   const auto size = SAMPLE_SIZE(mSampleFormat);
+   if (destformat == mSampleFormat &&
+       ReadStoredSamples(dest, sampleoffset * size, numsamples * size))
+      return numsamples;
+
    // Prepare and cache statement...automatically finalized at DB close
    sqlite3_stmt *stmt = Conn()->Prepare(DBConnection::GetSamples,
       "SELECT samples FROM sampleblocks WHERE blockid = ?1;");
@@ -573,6 +833,47 @@ size_t SqliteSampleBlock::GetSpaceUsage() const
       return ProjectFileIO::GetDiskUsage(*Conn(), mBlockID);
 }
 
+bool SqliteSampleBlock::ReadStoredSamples(
+   void *dest, size_t srcoffset, size_t srcbytes)
+{
+   TRACE_SCOPE("sqlite", "SqliteSampleBlock::ReadStoredSamples");
+
+   wxASSERT(!IsSilent());
+
+   if (!mValid)
+   {
+      Load(mBlockID);
+   }
+
+   // Opening a blob handle compiles a statement each time, where GetBlob()
+   // reuses a prepared one; that costs more than the copy it saves until
+   // the samples fill a page of the database
+   if (mSampleBytes < MinBlobHandleBytes)
+      return false;
+   // GetBlob() pads a read past the end with zeroes
+   if (srcoffset > mSampleBytes || srcbytes > mSampleBytes - srcoffset)
+      return false;
+
+   // An incremental blob handle copies only the range from the database
+   // pages into dest, where sqlite3_column_blob() would first gather all
+   // pages of the row into a buffer of its own
+   sqlite3_blob *blob = nullptr;
+   auto rc = sqlite3_blob_open(
+      DB(), "main", "sampleblocks", "samples", mBlockID, 0, &blob);
+   if (rc == SQLITE_OK)
+   {
+      if (static_cast<size_t>(sqlite3_blob_bytes(blob)) != mSampleBytes)
+         rc = SQLITE_CORRUPT;
+      else
+         rc = sqlite3_blob_read(blob, dest, static_cast<int>(srcbytes),
+            static_cast<int>(srcoffset));
+   }
+   // Harmless if the handle failed to open
+   sqlite3_blob_close(blob);
+
+   return rc == SQLITE_OK;
+}
+
 size_t SqliteSampleBlock::GetBlob(void *dest,
                                   sampleFormat destformat,
                                   sqlite3_stmt *stmt,
@@ -580,6 +881,7 @@ size_t SqliteSampleBlock::GetBlob(void *dest,
                                   size_t srcoffset,
                                   size_t srcbytes)
 {
+   TRACE_SCOPE("sqlite", "SqliteSampleBlock::GetBlob");
    auto db = DB();
 
    wxASSERT(!IsSilent());
@@ -699,11 +1001,25 @@ size_t SqliteSampleBlock::GetBlob(void *dest,
 
 void SqliteSampleBlock::Load(SampleBlockID sbid)
 {
+   wxASSERT(sbid > 0);
+
+   // While a project opens, the metadata of all blocks are in memory
+   if (const auto pMetadata = Conn()->FindBlockMetadata(sbid)) {
+      mBlockID = sbid;
+      mSampleFormat = static_cast<sampleFormat>(pMetadata->sampleFormat);
+      mSumMin = pMetadata->sumMin;
+      mSumMax = pMetadata->sumMax;
+      mSumRms = pMetadata->sumRms;
+      mSampleBytes = pMetadata->sampleBytes;
+      mSampleCount = mSampleBytes / SAMPLE_SIZE(mSampleFormat);
+      mValid = true;
+      return;
+   }
+
+   TRACE_SCOPE("sqlite", "SqliteSampleBlock::Load");
    auto db = DB();
    int rc;
 
-   wxASSERT(sbid > 0);
-
    mValid = false;
    mSampleCount = 0;
    mSampleBytes = 0;
@@ -767,9 +1083,93 @@ void SqliteSampleBlock::Load(SampleBlockID sbid)
 
 void SqliteSampleBlock::Commit(Sizes sizes)
 {
-   const auto mSummary256Bytes = sizes.first;
-   const auto mSummary64kBytes = sizes.second;
+   TRACE_SCOPE("sqlite", "SqliteSampleBlock::Commit");
+   Insert(mSummary256.get(), sizes.first,
+      mSummary64k.get(), sizes.second, mSamples.get());
+
+   // Reset local arrays
+   mSamples.reset();
+   mSummary256.reset();
+   mSummary64k.reset();
+   {
+      std::lock_guard<std::mutex> lock(mCacheMutex);
+      mCache.reset();
+   }
+
+   mValid = true;
+}
+
+void SqliteSampleBlock::CopyFrom(SqliteSampleBlock &source)
+{
+   TRACE_SCOPE("sqlite", "SqliteSampleBlock::CopyFrom");
+   auto sourceConn = source.Conn();
+   int rc;
+
+   // The stored row needs no conversion of samples and no new summaries.
+   // Read it with the source's own connection, which sees any transaction
+   // that it has open.
+   // Prepare and cache statement...automatically finalized at DB close
+   sqlite3_stmt *stmt = sourceConn->Prepare(
+      DBConnection::GetSampleBlockContents,
+      "SELECT summary256, summary64k, samples"
+      "  FROM sampleblocks WHERE blockid = ?1;");
 
+   // Bind statement parameters
+   // Might return SQLITE_MISUSE which means it's our mistake that we violated
+   // preconditions; should return SQL_OK which is 0
+   if (sqlite3_bind_int64(stmt, 1, source.mBlockID))
+   {
+      ADD_EXCEPTION_CONTEXT(
+         "sqlite3.rc", std::to_string(sqlite3_errcode(sourceConn->DB())));
+      ADD_EXCEPTION_CONTEXT("sqlite3.context", "SqliteSampleBlock::CopyFrom::bind");
+
+      wxASSERT_MSG(false, wxT("Binding failed...bug!!!"));
+   }
+
+   // Clear statement bindings and rewind statement, after the insertion
+   // has used the blobs that the statement owns
+   auto cleanup = finally([stmt]{
+      sqlite3_clear_bindings(stmt);
+      sqlite3_reset(stmt);
+   });
+
+   // Execute the statement
+   rc = sqlite3_step(stmt);
+   if (rc != SQLITE_ROW)
+   {
+      ADD_EXCEPTION_CONTEXT("sqlite3.rc", std::to_string(rc));
+      ADD_EXCEPTION_CONTEXT("sqlite3.context", "SqliteSampleBlock::CopyFrom::step");
+
+      wxLogDebug(wxT("SqliteSampleBlock::CopyFrom - SQLITE error %s"),
+         sqlite3_errmsg(sourceConn->DB()));
+
+      // Just showing the user a simple message, not the library error too
+      // which isn't internationalized
+      sourceConn->ThrowException( false );
+   }
+
+   mSampleFormat = source.mSampleFormat;
+   mSumMin = source.mSumMin;
+   mSumMax = source.mSumMax;
+   mSumRms = source.mSumRms;
+   mSampleCount = source.mSampleCount;
+
+   // Call sqlite3_column_blob() before sqlite3_column_bytes()
+   const auto summary256 = sqlite3_column_blob(stmt, 0);
+   const size_t summary256Bytes = sqlite3_column_bytes(stmt, 0);
+   const auto summary64k = sqlite3_column_blob(stmt, 1);
+   const size_t summary64kBytes = sqlite3_column_bytes(stmt, 1);
+   const auto samples = sqlite3_column_blob(stmt, 2);
+   mSampleBytes = sqlite3_column_bytes(stmt, 2);
+
+   Insert(summary256, summary256Bytes, summary64k, summary64kBytes, samples);
+
+   mValid = true;
+}
+
+void SqliteSampleBlock::Insert(const void *summary256, size_t summary256Bytes,
+   const void *summary64k, size_t summary64kBytes, const void *samples)
+{
    auto db = DB();
    int rc;
 
@@ -786,14 +1186,14 @@ void SqliteSampleBlock::Commit(Sizes sizes)
        sqlite3_bind_double(stmt, 2, mSumMin) ||
        sqlite3_bind_double(stmt, 3, mSumMax) ||
        sqlite3_bind_double(stmt, 4, mSumRms) ||
-       sqlite3_bind_blob(stmt, 5, mSummary256.get(), mSummary256Bytes, SQLITE_STATIC) ||
-       sqlite3_bind_blob(stmt, 6, mSummary64k.get(), mSummary64kBytes, SQLITE_STATIC) ||
-       sqlite3_bind_blob(stmt, 7, mSamples.get(), mSampleBytes, SQLITE_STATIC))
+       sqlite3_bind_blob(stmt, 5, summary256, summary256Bytes, SQLITE_STATIC) ||
+       sqlite3_bind_blob(stmt, 6, summary64k, summary64kBytes, SQLITE_STATIC) ||
+       sqlite3_bind_blob(stmt, 7, samples, mSampleBytes, SQLITE_STATIC))
    {
 
       ADD_EXCEPTION_CONTEXT(
          "sqlite3.rc", std::to_string(sqlite3_errcode(Conn()->DB())));
-      ADD_EXCEPTION_CONTEXT("sqlite3.context", "SqliteSampleBlock::Commit::bind");
+      ADD_EXCEPTION_CONTEXT("sqlite3.context", "SqliteSampleBlock::Insert::bind");
 
 
       wxASSERT_MSG(false, wxT("Binding failed...bug!!!"));
@@ -804,9 +1204,9 @@ void SqliteSampleBlock::Commit(Sizes sizes)
    if (rc != SQLITE_DONE)
    {
       ADD_EXCEPTION_CONTEXT("sqlite3.rc", std::to_string(rc));
-      ADD_EXCEPTION_CONTEXT("sqlite3.context", "SqliteSampleBlock::Commit::step");
+      ADD_EXCEPTION_CONTEXT("sqlite3.context", "SqliteSampleBlock::Insert::step");
 
-      wxLogDebug(wxT("SqliteSampleBlock::Commit - SQLITE error %s"), sqlite3_errmsg(db));
+      wxLogDebug(wxT("SqliteSampleBlock::Insert - SQLITE error %s"), sqlite3_errmsg(db));
 
       // Clear statement bindings and rewind statement
       sqlite3_clear_bindings(stmt);
@@ -820,24 +1220,14 @@ void SqliteSampleBlock::Commit(Sizes sizes)
    // Retrieve returned data
    mBlockID = sqlite3_last_insert_rowid(db);
 
-   // Reset local arrays
-   mSamples.reset();
-   mSummary256.reset();
-   mSummary64k.reset();
-   {
-      std::lock_guard<std::mutex> lock(mCacheMutex);
-      mCache.reset();
-   }
-
    // Clear statement bindings and rewind statement
    sqlite3_clear_bindings(stmt);
    sqlite3_reset(stmt);
-
-   mValid = true;
 }
 
 void SqliteSampleBlock::Delete()
 {
+   TRACE_SCOPE("sqlite", "SqliteSampleBlock::Delete");
    auto db = DB();
    int rc;
 
@@ -9,6 +9,7 @@
  **********************************************************************/
 #include "RealtimeEffectManager.h"
 #include "RealtimeEffectState.h"
+#include "RealtimeArena.h"
 #include "Channel.h"
 
 #include <memory>
@@ -56,6 +57,10 @@ void RealtimeEffectManager::Initialize(
    // (Re)Set processor parameters
    mRates.clear();
    mGroups.clear();
+   mChainTimings.Reset();
+   mLoad.store(0, std::memory_order_relaxed);
+   mLoadWindowStart = std::chrono::steady_clock::now();
+   mBusy = {};
 
    // RealtimeAdd/RemoveEffect() needs to know when we're active so it can
    // initialize newly added effects
@@ -91,7 +96,7 @@ void RealtimeEffectManager::Finalize() noexcept
    SetSuspended(true);
 
    // Assume it is now safe to clean up
-   mLatency = std::chrono::microseconds(0);
+   mLoad.store(0, std::memory_order_relaxed);
 
    VisitAll([](RealtimeEffectState &state, bool){ state.Finalize(); });
 
@@ -122,22 +127,20 @@ void RealtimeEffectManager::ProcessStart(bool suspended)
 size_t RealtimeEffectManager::Process(bool suspended,
    const ChannelGroup &group,
    float *const *buffers, float *const *scratch, float *const dummy,
-   unsigned nBuffers, size_t numSamples)
+   unsigned nBuffers, size_t numSamples, RealtimeArena &arena)
 {
    // Can be suspended because of the audio stream being paused or because
    // effects have been suspended, so allow the samples to pass as-is.
    if (suspended)
       return 0;
 
-   // Remember when we started so we can calculate the amount of latency we
-   // are introducing
+   // Remember when we started so we can measure the time taken
    auto start = std::chrono::steady_clock::now();
 
    // Allocate the in and out buffer arrays
-   const auto ibuf =
-      static_cast<float **>(alloca(nBuffers * sizeof(float *)));
-   const auto obuf =
-      static_cast<float **>(alloca(nBuffers * sizeof(float *)));
+   RealtimeArena::Mark mark{ arena };
+   const auto ibuf = arena.Allocate<float *>(nBuffers);
+   const auto obuf = arena.Allocate<float *>(nBuffers);
 
    // And populate the input with the buffers we've been given while allocating
    // NEW output buffers
@@ -155,7 +158,8 @@ size_t RealtimeEffectManager::Process(bool suspended,
       [&](RealtimeEffectState &state, bool)
       {
          discardable +=
-            state.Process(group, nBuffers, ibuf, obuf, dummy, numSamples);
+            state.Process(group, nBuffers, ibuf, obuf, dummy, numSamples,
+               arena);
          for (auto i = 0; i < nBuffers; ++i)
             std::swap(ibuf[i], obuf[i]);
          called++;
@@ -170,9 +174,17 @@ size_t RealtimeEffectManager::Process(bool suspended,
       for (unsigned int i = 0; i < nBuffers; i++)
          memcpy(buffers[i], ibuf[i], numSamples * sizeof(float));
 
-   // Remember the latency
+   // Remember the time taken, compared with the duration of the audio
    auto end = std::chrono::steady_clock::now();
-   mLatency = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+   if (called) {
+      const auto iter = mRates.find(&group);
+      const auto rate = (iter == mRates.end()) ? 0 : iter->second;
+      mChainTimings.Record(end - start, rate > 0
+         ? std::chrono::duration_cast<RealtimeEffectTimings::Duration>(
+            std::chrono::duration<double>{ numSamples / rate })
+         : RealtimeEffectTimings::Duration::max());
+   }
+   mBusy += end - start;
 
    //
    // This is wrong...needs to handle tails
@@ -190,6 +202,17 @@ void RealtimeEffectManager::ProcessEnd(bool suspended) noexcept
    VisitAll([suspended](RealtimeEffectState &state, bool){
       state.ProcessEnd();
    });
+
+   // Update the load a few times a second
+   using namespace std::chrono;
+   const auto now = steady_clock::now();
+   const auto window = now - mLoadWindowStart;
+   if (window >= 250ms) {
+      mLoad.store(duration<float>(mBusy) / duration<float>(window),
+         std::memory_order_relaxed);
+      mLoadWindowStart = now;
+      mBusy = {};
+   }
 }
 
 RealtimeEffectManager::
@@ -341,10 +364,3 @@ std::optional<size_t> RealtimeEffectManager::FindState(
    return states.FindState(pState);
 }
 
-// Where is this used?
-#if 0
-auto RealtimeEffectManager::GetLatency() const -> Latency
-{
-   return mLatency; // should this be atomic?
-}
-#endif
@@ -23,6 +23,9 @@
 #include "Observer.h"
 #include "PluginProvider.h" // for PluginID
 #include "RealtimeEffectList.h"
+#include "RealtimeEffectTimings.h"
+
+class RealtimeArena;
 
 class ChannelGroup;
 class EffectInstance;
@@ -50,8 +53,6 @@ class REALTIME_EFFECTS_API RealtimeEffectManager final :
    public Observer::Publisher<RealtimeEffectManagerMessage>
 {
 public:
-   using Latency = std::chrono::microseconds;
-
    RealtimeEffectManager(AudacityProject &project);
    ~RealtimeEffectManager();
 
@@ -62,7 +63,16 @@ public:
 
    //! To be called only from main thread
    bool IsActive() const noexcept;
-//   Latency GetLatency() const;
+
+   //! Times of whole chains of effects, in all groups, since playback began
+   /*! May be called from any thread.  See also RealtimeEffectState::GetTimings */
+   RealtimeEffectTimings::Summary GetChainTimings() const noexcept
+      { return mChainTimings.Summarize(); }
+   //! Fraction of the time that the worker thread spent processing effects,
+   //! over the last quarter second or so of playback
+   /*! May be called from any thread */
+   float GetLoad() const noexcept
+      { return mLoad.load(std::memory_order_relaxed); }
 
    //! Main thread appends a global or per-group effect
    /*!
@@ -162,7 +172,7 @@ private:
    size_t Process(bool suspended,
       const ChannelGroup &group,
       float *const *buffers, float *const *scratch, float *dummy,
-      unsigned nBuffers, size_t numSamples);
+      unsigned nBuffers, size_t numSamples, RealtimeArena &arena);
    void ProcessEnd(bool suspended) noexcept;
 
    RealtimeEffectManager(const RealtimeEffectManager&) = delete;
@@ -209,7 +219,12 @@ private:
    }
 
    AudacityProject &mProject;
-   Latency mLatency{ 0 };
+   //! Written in the worker thread by Process()
+   RealtimeEffectTimings mChainTimings;
+   std::atomic<float> mLoad{ 0 };
+   // These are used only by the worker thread, while processing
+   std::chrono::steady_clock::time_point mLoadWindowStart{};
+   std::chrono::steady_clock::duration mBusy{};
 
    std::atomic<bool> mSuspended{ true };
 
@@ -297,13 +312,16 @@ public:
       float *const *scratch,
       float *dummy,
       unsigned nBuffers, //!< how many buffers; equal number of scratches
-      size_t numSamples //!< length of each buffer
+      size_t numSamples, //!< length of each buffer
+      //! Scratch memory of the calling thread, reserved before processing;
+      //! the pointer arrays of the effect chain come from here
+      RealtimeArena &arena
    )
    {
       if (auto pProject = mwProject.lock())
          return RealtimeEffectManager::Get(*pProject)
             .Process(mSuspended, group, buffers, scratch, dummy,
-               nBuffers, numSamples);
+               nBuffers, numSamples, arena);
       else
          return 0; // consider them trivially processed
    }
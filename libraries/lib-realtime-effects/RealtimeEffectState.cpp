@@ -14,6 +14,7 @@
 #include "EffectInterface.h"
 #include "MessageBuffer.h"
 #include "PluginManager.h"
+#include "RealtimeArena.h"
 #include "SampleCount.h"
 
 #include <chrono>
@@ -423,6 +424,7 @@ RealtimeEffectState::Initialize(double sampleRate)
    mCurrentProcessor = 0;
    mGroups.clear();
    mLatency = {};
+   mTimings.Reset();
    return EnsureInstance(sampleRate);
 }
 
@@ -529,28 +531,30 @@ bool RealtimeEffectState::ProcessStart(bool running)
       return result;
 }
 
-#define stackAllocate(T, count) static_cast<T*>(alloca(count * sizeof(T)))
-
 //! Visit the effect processors that were added in AddGroup
 /*! The iteration over channels in AddGroup and Process must be the same */
 size_t RealtimeEffectState::Process(
    const ChannelGroup &group, unsigned chans,
    const float *const *inbuf, float *const *outbuf, float *const dummybuf,
-   size_t numSamples)
+   size_t numSamples, RealtimeArena &arena)
 {
    auto pInstance = mwInstance.lock();
-   if (!mPlugin || !pInstance || !mLastActive) {
+   // Don't insert into mGroups, which would allocate on this thread
+   const auto iter = mGroups.find(&group);
+   if (!mPlugin || !pInstance || !mLastActive || iter == mGroups.end()) {
       // Process trivially
       for (size_t ii = 0; ii < chans; ++ii)
          memcpy(outbuf[ii], inbuf[ii], numSamples * sizeof(float));
       return 0;
    }
+   const auto start = std::chrono::steady_clock::now();
    const auto numAudioIn = pInstance->GetAudioInCount();
    const auto numAudioOut = pInstance->GetAudioOutCount();
-   const auto clientIn = stackAllocate(const float *, numAudioIn);
-   const auto clientOut = stackAllocate(float *, numAudioOut);
+   RealtimeArena::Mark mark{ arena };
+   const auto clientIn = arena.Allocate<const float *>(numAudioIn);
+   const auto clientOut = arena.Allocate<float *>(numAudioOut);
    size_t len = 0;
-   const auto &pair = mGroups[&group];
+   const auto &pair = iter->second;
    auto processor = pair.first;
    // Outer loop over processors
    AllocateChannelsToProcessors(chans, numAudioIn, numAudioOut,
@@ -603,6 +607,12 @@ size_t RealtimeEffectState::Process(
       ++processor;
       return true;
    });
+   // Compare the time taken with the duration of the audio
+   mTimings.Record(std::chrono::steady_clock::now() - start, pair.second > 0
+      ? std::chrono::duration_cast<RealtimeEffectTimings::Duration>(
+         std::chrono::duration<double>{ numSamples / pair.second })
+      : RealtimeEffectTimings::Duration::max());
+
    // Report the number discardable during the processing scope
    // We are assuming len as calculated above is the same in case of multiple
    // processors
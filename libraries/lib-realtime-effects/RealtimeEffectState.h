@@ -22,8 +22,11 @@
 #include "MemoryX.h"
 #include "Observer.h"
 #include "PluginProvider.h" // for PluginID
+#include "RealtimeEffectTimings.h"
 #include "XMLTagHandler.h"
 
+class RealtimeArena;
+
 class ChannelGroup;
 class EffectSettingsAccess;
 
@@ -66,6 +69,9 @@ public:
    //! Get locations that a GUI can connect meters to
    const EffectOutputs *GetOutputs() const { return mMovedOutputs.get(); }
 
+   //! Times of Process() since the last Initialize(), for any thread to read
+   const RealtimeEffectTimings &GetTimings() const { return mTimings; }
+
    //! Main thread sets up for playback
    std::shared_ptr<EffectInstance> Initialize(double rate);
    //! Main thread sets up this state before adding it to lists
@@ -87,7 +93,9 @@ public:
       const float *const *inbuf, //!< chans input buffers
       float *const *outbuf, //!< chans output buffers
       float *dummybuf, //!<  one dummy output buffer
-      size_t numSamples);
+      size_t numSamples,
+      RealtimeArena &arena //!< scratch memory of the worker thread
+   );
    //! Worker thread finishes a batch of samples
    bool ProcessEnd();
 
@@ -181,6 +189,8 @@ private:
    std::optional<EffectInstance::SampleCount> mLatency;
    //! Assigned in the worker thread at the start of each processing scope
    bool mLastActive{};
+   //! Written in the worker thread by Process()
+   RealtimeEffectTimings mTimings;
 
    //! @}
 
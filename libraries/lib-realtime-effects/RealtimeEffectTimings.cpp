@@ -0,0 +1,88 @@
+/**********************************************************************
+
+ Audacity: A Digital Audio Editor
+
+ @file RealtimeEffectTimings.cpp
+
+ **********************************************************************/
+#include "RealtimeEffectTimings.h"
+
+#include <algorithm>
+
+namespace {
+// Single writer, so read-modify-write need not be atomic
+template<typename T> void Increment(std::atomic<T> &counter) noexcept
+{
+   counter.store(
+      counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+}
+
+size_t RealtimeEffectTimings::BinIndex(uint64_t nanoseconds) noexcept
+{
+   // Small values have bins of their own
+   if (nanoseconds < 4)
+      return nanoseconds;
+   // Find the octave, then the quarter within it
+   unsigned octave = 2;
+   while (octave < 63 && (nanoseconds >> (octave + 1)) != 0)
+      ++octave;
+   const auto quarter = (nanoseconds >> (octave - 2)) & 3;
+   return std::min<size_t>(NBins - 1, 4 * (octave - 1) + quarter);
+}
+
+uint64_t RealtimeEffectTimings::BinLimit(size_t index) noexcept
+{
+   if (index < 4)
+      return index;
+   const auto octave = index / 4 + 1;
+   const auto quarter = index % 4;
+   return ((4 + quarter + 1) << (octave - 2)) - 1;
+}
+
+void RealtimeEffectTimings::Record(Duration elapsed, Duration budget) noexcept
+{
+   const auto ns = static_cast<uint64_t>(std::max<Duration::rep>(0, elapsed.count()));
+   Increment(mBins[BinIndex(ns)]);
+   if (elapsed > budget)
+      Increment(mOverruns);
+   if (ns > mMax.load(std::memory_order_relaxed))
+      mMax.store(ns, std::memory_order_relaxed);
+}
+
+auto RealtimeEffectTimings::Summarize() const noexcept -> Summary
+{
+   Summary result;
+   std::array<uint64_t, NBins> bins;
+   uint64_t total = 0;
+   for (size_t ii = 0; ii < NBins; ++ii)
+      total += (bins[ii] = mBins[ii].load(std::memory_order_relaxed));
+
+   result.count = total;
+   result.overruns = mOverruns.load(std::memory_order_relaxed);
+   result.max = Duration{ mMax.load(std::memory_order_relaxed) };
+   if (total == 0)
+      return result;
+
+   const auto percentile = [&](uint64_t rank) {
+      uint64_t sum = 0;
+      // The last bin has no upper limit
+      for (size_t ii = 0; ii + 1 < NBins; ++ii)
+         if ((sum += bins[ii]) >= rank)
+            // Not beyond the true maximum
+            return std::min(Duration(BinLimit(ii)), result.max);
+      return result.max;
+   };
+   // Nearest-rank percentiles
+   result.p50 = percentile((total * 50 + 99) / 100);
+   result.p99 = percentile((total * 99 + 99) / 100);
+   return result;
+}
+
+void RealtimeEffectTimings::Reset() noexcept
+{
+   for (auto &bin : mBins)
+      bin.store(0, std::memory_order_relaxed);
+   mOverruns.store(0, std::memory_order_relaxed);
+   mMax.store(0, std::memory_order_relaxed);
+}
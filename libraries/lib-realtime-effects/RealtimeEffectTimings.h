@@ -0,0 +1,60 @@
+/**********************************************************************
+
+ Audacity: A Digital Audio Editor
+
+ @file RealtimeEffectTimings.h
+
+ **********************************************************************/
+
+#ifndef __AUDACITY_REALTIMEEFFECTTIMINGS_H__
+#define __AUDACITY_REALTIMEEFFECTTIMINGS_H__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+//! Histogram of processing times, written by the worker thread without locks
+/*!
+ Bins are spaced by quarter octaves of nanoseconds, so that percentiles are
+ reported within about 20%.  Readers in other threads see a consistent enough
+ picture for display, though not a snapshot.
+ */
+class REALTIME_EFFECTS_API RealtimeEffectTimings final
+{
+public:
+   using Duration = std::chrono::nanoseconds;
+
+   struct Summary {
+      uint64_t count{};
+      //! How many times processing took longer than the audio it processed
+      uint64_t overruns{};
+      Duration p50{};
+      Duration p99{};
+      Duration max{};
+   };
+
+   //! To be called only by the worker thread
+   /*!
+    @param budget the duration of the processed audio
+    */
+   void Record(Duration elapsed, Duration budget) noexcept;
+
+   //! May be called from any thread
+   Summary Summarize() const noexcept;
+
+   //! To be called only while there is no processing
+   void Reset() noexcept;
+
+private:
+   static constexpr size_t NBins = 128;
+   static size_t BinIndex(uint64_t nanoseconds) noexcept;
+   //! Largest value that falls in the bin
+   static uint64_t BinLimit(size_t index) noexcept;
+
+   std::array<std::atomic<uint32_t>, NBins> mBins{};
+   std::atomic<uint64_t> mOverruns{ 0 };
+   std::atomic<uint64_t> mMax{ 0 };
+};
+
+#endif
@@ -0,0 +1,121 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  RealtimeEffectTimingsTests.cpp
+
+**********************************************************************/
+
+#include <catch2/catch.hpp>
+
+#include "RealtimeEffectTimings.h"
+
+namespace
+{
+using Duration = RealtimeEffectTimings::Duration;
+constexpr auto NoBudget = Duration::max();
+}
+
+TEST_CASE("RealtimeEffectTimings", "[RealtimeEffectTimings]")
+{
+   RealtimeEffectTimings timings;
+
+   SECTION("Nothing recorded")
+   {
+      const auto summary = timings.Summarize();
+      REQUIRE(summary.count == 0);
+      REQUIRE(summary.overruns == 0);
+      REQUIRE(summary.p50 == Duration{});
+      REQUIRE(summary.p99 == Duration{});
+      REQUIRE(summary.max == Duration{});
+   }
+
+   SECTION("Small times are exact")
+   {
+      for (long long ns = 0; ns < 8; ++ns)
+         timings.Record(Duration{ ns }, NoBudget);
+      const auto summary = timings.Summarize();
+      REQUIRE(summary.count == 8);
+      // Nearest rank 4 of 8
+      REQUIRE(summary.p50 == Duration{ 3 });
+      REQUIRE(summary.p99 == Duration{ 7 });
+      REQUIRE(summary.max == Duration{ 7 });
+   }
+
+   SECTION("Percentiles are within a quarter octave above the true value")
+   {
+      // Cross the boundaries of bins and of octaves, up to seconds
+      for (long long ns = 4; ns < 2'000'000'000LL; ns = ns * 9 / 7 + 1) {
+         RealtimeEffectTimings two;
+         two.Record(Duration{ ns }, NoBudget);
+         // A larger time, so that the maximum does not limit the result
+         two.Record(Duration{ 4 * ns }, NoBudget);
+         const auto p50 = two.Summarize().p50.count();
+         INFO("ns = " << ns << ", p50 = " << p50);
+         REQUIRE(p50 >= ns);
+         REQUIRE(p50 <= ns + ns / 4);
+      }
+   }
+
+   SECTION("p99 finds the slowest one percent")
+   {
+      const Duration fast{ 1000 }, slow{ 1'000'000 };
+      for (int ii = 0; ii < 990; ++ii)
+         timings.Record(fast, NoBudget);
+      for (int ii = 0; ii < 10; ++ii)
+         timings.Record(slow, NoBudget);
+      auto summary = timings.Summarize();
+      REQUIRE(summary.count == 1000);
+      REQUIRE(summary.p50 >= fast);
+      REQUIRE(summary.p50 < fast + fast / 4);
+      // Rank 990 is still fast
+      REQUIRE(summary.p99 < fast + fast / 4);
+
+      timings.Record(slow, NoBudget);
+      summary = timings.Summarize();
+      // Not beyond the true maximum
+      REQUIRE(summary.p99 == slow);
+      REQUIRE(summary.max == slow);
+   }
+
+   SECTION("Overruns")
+   {
+      const Duration budget{ 5000 };
+      timings.Record(Duration{ 4000 }, budget);
+      timings.Record(budget, budget);
+      timings.Record(Duration{ 6000 }, budget);
+      // An unknown budget, as for a zero rate, is never overrun
+      timings.Record(Duration{ 6000 }, NoBudget);
+      REQUIRE(timings.Summarize().overruns == 1);
+   }
+
+   SECTION("Extreme times")
+   {
+      timings.Record(Duration{ -5 }, NoBudget);
+      timings.Record(Duration::max(), NoBudget);
+      auto summary = timings.Summarize();
+      REQUIRE(summary.count == 2);
+      REQUIRE(summary.p50 == Duration{});
+      REQUIRE(summary.p99 == Duration::max());
+
+      // Times beyond the bins are not understated
+      RealtimeEffectTimings slow;
+      const Duration long1{ 20'000'000'000LL }, long2{ 30'000'000'000LL };
+      slow.Record(long1, NoBudget);
+      slow.Record(long2, NoBudget);
+      summary = slow.Summarize();
+      REQUIRE(summary.p50 >= long1);
+      REQUIRE(summary.p99 == long2);
+   }
+
+   SECTION("Reset")
+   {
+      timings.Record(Duration{ 6000 }, Duration{ 1000 });
+      timings.Reset();
+      const auto summary = timings.Summarize();
+      REQUIRE(summary.count == 0);
+      REQUIRE(summary.overruns == 0);
+      REQUIRE(summary.max == Duration{});
+   }
+}
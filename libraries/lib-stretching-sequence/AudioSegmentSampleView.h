@@ -15,6 +15,7 @@ ranges.
 
 #include "SampleCount.h"
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <memory>
@@ -55,6 +56,33 @@ public:
     */
    size_t GetSampleCount() const;
 
+   /**
+    * @brief Calls `visitor(data, length)` for each run of contiguous samples
+    * in this view, in order, with `data` pointing into the blocks' own memory
+    * rather than into a copy. `data` is null for a run of silence.
+    * @details The pointers are valid as long as this view exists.
+    */
+   template <typename Visitor> void ForEachSpan(Visitor&& visitor) const
+   {
+      if (mIsSilent)
+      {
+         if (mLength > 0)
+            visitor(static_cast<const float*>(nullptr), mLength);
+         return;
+      }
+      size_t toVisit = mLength;
+      size_t offset = mStart;
+      for (const auto& block : mBlockViews)
+      {
+         if (toVisit == 0)
+            break;
+         const auto length = std::min(block->size() - offset, toVisit);
+         visitor(static_cast<const float*>(block->data() + offset), length);
+         toVisit -= length;
+         offset = 0;
+      }
+   }
+
 private:
    void DoCopy(float* buffer, size_t bufferSize) const;
 
@@ -149,6 +149,12 @@ void StretchingSequence::GetEnvelopeValues(
    mSequence.GetEnvelopeValues(buffer, bufferLen, t0, backwards);
 }
 
+void StretchingSequence::GetEnvelopeSegments(Envelope::Segments& segments,
+   size_t bufferLen, double t0, bool backwards) const
+{
+   mSequence.GetEnvelopeSegments(segments, bufferLen, t0, backwards);
+}
+
 AudioGraph::ChannelType StretchingSequence::GetChannelType() const
 {
    return mSequence.GetChannelType();
@@ -48,6 +48,8 @@ public:
    void GetEnvelopeValues(
       double* buffer, size_t bufferLen, double t0,
       bool backwards) const override;
+   void GetEnvelopeSegments(Envelope::Segments& segments,
+      size_t bufferLen, double t0, bool backwards) const override;
    bool DoGet(
       size_t iChannel, size_t nBuffers, const samplePtr buffers[],
       sampleFormat format, sampleCount start, size_t len, bool backwards,
@@ -56,3 +56,42 @@ TEST_CASE("AudioSegmentSampleView", "Copy returns expected values when")
       }
    }
 }
+
+TEST_CASE("AudioSegmentSampleView::ForEachSpan", "visits without copying when")
+{
+   using Spans = std::vector<std::pair<const float*, size_t>>;
+   const auto visit = [](const AudioSegmentSampleView& sut) {
+      Spans spans;
+      sut.ForEachSpan([&](const float* data, size_t length) {
+         spans.emplace_back(data, length);
+      });
+      return spans;
+   };
+
+   SECTION("AudioSegmentSampleView is silent")
+   {
+      REQUIRE(visit(AudioSegmentSampleView { 3 }) == Spans { { nullptr, 3u } });
+      REQUIRE(visit(AudioSegmentSampleView { 0 }).empty());
+   }
+
+   SECTION("AudioSegmentSampleView is NOT silent")
+   {
+      const auto segment1 = std::make_shared<std::vector<float>>(
+         std::vector<float> { 1.f, 2.f, 3.f });
+      const auto segment2 = std::make_shared<std::vector<float>>(
+         std::vector<float> { 4.f, 5.f, 6.f });
+
+      SECTION("and spans blocks.")
+      {
+         AudioSegmentSampleView sut { { segment1, segment2 }, 2u, 3u };
+         REQUIRE(
+            visit(sut) == Spans { { segment1->data() + 2, 1u },
+                                  { segment2->data(), 2u } });
+      }
+      SECTION("and lies within one block.")
+      {
+         AudioSegmentSampleView sut { { segment1 }, 1u, 2u };
+         REQUIRE(visit(sut) == Spans { { segment1->data() + 1, 2u } });
+      }
+   }
+}
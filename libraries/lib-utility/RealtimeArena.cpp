@@ -0,0 +1,99 @@
+/*!********************************************************************
+
+ Audacity: A Digital Audio Editor
+
+ @file RealtimeArena.cpp
+
+ **********************************************************************/
+#include "RealtimeArena.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+
+namespace {
+std::uintptr_t AlignUp(std::uintptr_t address, size_t alignment)
+{
+   assert((alignment & (alignment - 1)) == 0);
+   return (address + alignment - 1) & ~std::uintptr_t(alignment - 1);
+}
+}
+
+RealtimeArena::RealtimeArena() = default;
+RealtimeArena::~RealtimeArena() = default;
+
+void RealtimeArena::Reserve(size_t bytes)
+{
+   mOverflowBlocks.clear();
+   mOverflows = 0;
+   mTop = 0;
+   if (bytes > mCapacity) {
+      mStorage.reset();
+      mStorage = std::make_unique<std::byte[]>(bytes);
+      mCapacity = bytes;
+   }
+}
+
+void *RealtimeArena::AllocateBytes(size_t bytes, size_t alignment)
+{
+   const auto base = reinterpret_cast<std::uintptr_t>(mStorage.get());
+   const auto start = AlignUp(base + mTop, alignment);
+   if (mStorage && start + bytes <= base + mCapacity) {
+      mTop = start + bytes - base;
+      return reinterpret_cast<void*>(start);
+   }
+
+   // Correct, but not realtime-safe
+   ++mOverflows;
+   const auto &block = mOverflowBlocks.emplace_back(
+      std::make_unique<std::byte[]>(bytes + alignment));
+   return reinterpret_cast<void*>(
+      AlignUp(reinterpret_cast<std::uintptr_t>(block.get()), alignment));
+}
+
+RealtimeArena::Mark::~Mark()
+{
+   mArena.mTop = mTop;
+   mArena.mOverflowBlocks.resize(mNOverflowBlocks);
+}
+
+namespace {
+thread_local bool sArmed = false;
+std::atomic<size_t> sReportedCount{ 0 };
+}
+
+RealtimeAllocationTrap::Scope::Scope() noexcept
+   : mWasArmed{ sArmed }
+{
+   sArmed = true;
+}
+
+RealtimeAllocationTrap::Scope::~Scope()
+{
+   sArmed = mWasArmed;
+}
+
+bool RealtimeAllocationTrap::IsArmed() noexcept
+{
+   return sArmed;
+}
+
+void RealtimeAllocationTrap::Report(size_t bytes) noexcept
+{
+   ++sReportedCount;
+#ifndef NDEBUG
+   // Disarm, in case reporting allocates
+   const auto wasArmed = std::exchange(sArmed, false);
+   std::fprintf(stderr,
+      "Heap allocation of %zu bytes on a realtime thread\n", bytes);
+   sArmed = wasArmed;
+   assert(false);
+#endif
+}
+
+size_t RealtimeAllocationTrap::ReportedCount() noexcept
+{
+   return sReportedCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,123 @@
+/*!********************************************************************
+
+ Audacity: A Digital Audio Editor
+
+ @file RealtimeArena.h
+
+ @brief Scratch memory for threads that must not allocate
+
+ **********************************************************************/
+
+#ifndef __AUDACITY_REALTIME_ARENA__
+#define __AUDACITY_REALTIME_ARENA__
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+//! Preallocated scratch memory for one realtime thread
+/*!
+ Reserve() is called before processing starts, outside of the realtime
+ thread.  That thread then allocates in stack order:  a Mark remembers the
+ top of the arena and restores it when destroyed, so the same memory serves
+ each buffer of the stream, as alloca() would, but without risk of
+ overflowing the stack.
+
+ Requests that do not fit the reserve are satisfied from the heap, so that a
+ low estimate costs only time; they are counted by Overflows(), and are
+ reported as any other allocation when RealtimeAllocationTrap is armed.
+ */
+class UTILITY_API RealtimeArena final
+{
+public:
+   RealtimeArena();
+   ~RealtimeArena();
+   RealtimeArena(const RealtimeArena&) = delete;
+   RealtimeArena &operator=(const RealtimeArena&) = delete;
+
+   //! Discard all allocations and make room for at least the given size
+   /*! Not realtime-safe */
+   void Reserve(size_t bytes);
+   size_t Capacity() const noexcept { return mCapacity; }
+   //! How many allocations did not fit the reserve, since the last Reserve()
+   size_t Overflows() const noexcept { return mOverflows; }
+
+   //! Uninitialized storage for count objects, valid until the enclosing Mark
+   //! is destroyed
+   template<typename T> T *Allocate(size_t count)
+   {
+      static_assert(std::is_trivially_destructible_v<T>);
+      return static_cast<T*>(AllocateBytes(count * sizeof(T),
+         std::max(alignof(T), alignof(std::max_align_t))));
+   }
+
+   //! @pre alignment is a power of two
+   void *AllocateBytes(size_t bytes, size_t alignment);
+
+   //! Bytes needed to satisfy Allocate<T>(count) from the reserve
+   template<typename T> static constexpr size_t Needed(size_t count)
+   {
+      return count * sizeof(T) +
+         std::max(alignof(T), alignof(std::max_align_t));
+   }
+
+   //! RAII object that frees everything allocated during its lifetime
+   class Mark final
+   {
+   public:
+      explicit Mark(RealtimeArena &arena) noexcept
+         : mArena{ arena }
+         , mTop{ arena.mTop }
+         , mNOverflowBlocks{ arena.mOverflowBlocks.size() }
+      {}
+      ~Mark();
+      Mark(const Mark&) = delete;
+      Mark &operator=(const Mark&) = delete;
+   private:
+      RealtimeArena &mArena;
+      const size_t mTop;
+      const size_t mNOverflowBlocks;
+   };
+
+private:
+   std::unique_ptr<std::byte[]> mStorage;
+   size_t mCapacity{};
+   size_t mTop{};
+   std::vector<std::unique_ptr<std::byte[]>> mOverflowBlocks;
+   size_t mOverflows{};
+};
+
+//! Detection of heap allocation on threads that must not allocate
+/*!
+ The application may replace the global operator new, so that it calls
+ Report() when IsArmed() is true.  Audacity does so when built with
+ EXPERIMENTAL_REALTIME_ALLOCATION_TRAP.  Otherwise, arming has no effect.
+ */
+namespace RealtimeAllocationTrap {
+   //! While an object of this class exists, allocations on the constructing
+   //! thread are reported
+   class UTILITY_API Scope final
+   {
+   public:
+      Scope() noexcept;
+      ~Scope();
+      Scope(const Scope&) = delete;
+      Scope &operator=(const Scope&) = delete;
+   private:
+      const bool mWasArmed;
+   };
+
+   //! Whether the current thread is within a Scope
+   UTILITY_API bool IsArmed() noexcept;
+
+   //! Count an allocation; in debug builds, also write to standard error
+   //! and fail an assertion
+   UTILITY_API void Report(size_t bytes) noexcept;
+
+   //! How many allocations have been reported, on all threads
+   UTILITY_API size_t ReportedCount() noexcept;
+}
+
+#endif
@@ -0,0 +1,222 @@
+/*!********************************************************************
+
+ Audacity: A Digital Audio Editor
+
+ @file Tracing.cpp
+
+ **********************************************************************/
+
+#include "Tracing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct Event {
+   const char *category;
+   const char *name;
+   int64_t start;
+   int64_t end;
+};
+
+//! Ring buffer written only by its own thread
+struct ThreadBuffer {
+   static constexpr size_t Capacity = 1 << 15;
+
+   explicit ThreadBuffer(unsigned id) : id{ id }, events(Capacity) {}
+
+   const unsigned id;
+   std::atomic<const char *> name{ nullptr };
+   std::vector<Event> events;
+   //! Count of events ever written; the writer publishes each with a release
+   std::atomic<uint64_t> head{ 0 };
+   //! Events before this one precede the last Start(); used under the mutex
+   uint64_t tail{ 0 };
+};
+
+struct Registry {
+   std::mutex mutex;
+   std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+   unsigned nextId{ 1 };
+   int64_t origin{ 0 };
+};
+
+Registry &GetRegistry()
+{
+   static Registry registry;
+   return registry;
+}
+
+std::atomic<bool> sStarted{ false };
+
+struct ThreadState {
+   const char *name{ nullptr };
+   std::shared_ptr<ThreadBuffer> pBuffer;
+};
+thread_local ThreadState sThreadState;
+
+ThreadBuffer &GetThreadBuffer()
+{
+   auto &state = sThreadState;
+   if (!state.pBuffer) {
+      auto &registry = GetRegistry();
+      std::lock_guard<std::mutex> lock{ registry.mutex };
+      state.pBuffer = std::make_shared<ThreadBuffer>(registry.nextId++);
+      state.pBuffer->name = state.name;
+      registry.buffers.push_back(state.pBuffer);
+   }
+   return *state.pBuffer;
+}
+
+//! Write s as a JSON string
+void PutString(FILE *file, const char *s)
+{
+   fputc('"', file);
+   for (; s && *s; ++s) {
+      if (*s == '"' || *s == '\\')
+         fputc('\\', file);
+      if (static_cast<unsigned char>(*s) >= 0x20)
+         fputc(*s, file);
+   }
+   fputc('"', file);
+}
+
+}
+
+bool Tracing::IsStarted() noexcept
+{
+   return sStarted.load(std::memory_order_relaxed);
+}
+
+int64_t Tracing::Now() noexcept
+{
+   using namespace std::chrono;
+   return duration_cast<nanoseconds>(
+      steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracing::Start()
+{
+   auto &registry = GetRegistry();
+   std::lock_guard<std::mutex> lock{ registry.mutex };
+   // Forget threads that have finished
+   auto &buffers = registry.buffers;
+   buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+      [](const auto &pBuffer){ return pBuffer.use_count() == 1; }),
+      buffers.end());
+   for (auto &pBuffer : buffers)
+      pBuffer->tail = pBuffer->head.load(std::memory_order_acquire);
+   registry.origin = Now();
+   sStarted.store(true, std::memory_order_relaxed);
+}
+
+bool Tracing::Stop(const std::string &path)
+{
+   const auto file = fopen(path.c_str(), "w");
+   const bool ok = Stop(file);
+   return file && (fclose(file) == 0) && ok;
+}
+
+bool Tracing::Stop(std::FILE *file)
+{
+   sStarted.store(false, std::memory_order_relaxed);
+
+   auto &registry = GetRegistry();
+   std::lock_guard<std::mutex> lock{ registry.mutex };
+
+   struct Collected {
+      unsigned id;
+      const char *name;
+      std::vector<Event> events;
+   };
+   std::vector<Collected> threads;
+   for (auto &pBuffer : registry.buffers) {
+      auto &buffer = *pBuffer;
+      const auto head = buffer.head.load(std::memory_order_acquire);
+      auto first = std::max(buffer.tail,
+         head > ThreadBuffer::Capacity ? head - ThreadBuffer::Capacity : 0);
+      std::vector<Event> events;
+      events.reserve(head - first);
+      for (auto index = first; index < head; ++index)
+         events.push_back(buffer.events[index % ThreadBuffer::Capacity]);
+
+      // Scopes that began before Stop() may still be writing, overwriting
+      // the oldest events; drop what they might have reached, and the slot
+      // of one more event in progress
+      const auto after = buffer.head.load(std::memory_order_acquire);
+      const auto safe = after + 1 > ThreadBuffer::Capacity
+         ? after + 1 - ThreadBuffer::Capacity : 0;
+      if (safe > first) {
+         const auto drop = std::min<uint64_t>(safe - first, events.size());
+         events.erase(events.begin(), events.begin() + drop);
+      }
+      buffer.tail = head;
+
+      if (!events.empty())
+         threads.push_back({ buffer.id, buffer.name.load(), std::move(events) });
+   }
+
+   if (!file)
+      return false;
+
+   const auto origin = registry.origin;
+   fputs("{\"traceEvents\":[", file);
+   bool first = true;
+   auto separate = [&]{
+      fputs(first ? "\n" : ",\n", file);
+      first = false;
+   };
+   for (const auto &thread : threads) {
+      if (thread.name) {
+         separate();
+         fprintf(file,
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+            "\"args\":{\"name\":", thread.id);
+         PutString(file, thread.name);
+         fputs("}}", file);
+      }
+      for (const auto &event : thread.events) {
+         separate();
+         fputs("{\"name\":", file);
+         PutString(file, event.name);
+         fputs(",\"cat\":", file);
+         PutString(file, event.category);
+         fprintf(file,
+            ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            thread.id,
+            (event.start - origin) / 1000.0,
+            (event.end - event.start) / 1000.0);
+      }
+   }
+   fputs("\n],\"displayTimeUnit\":\"ms\"}\n", file);
+   return fflush(file) == 0 && !ferror(file);
+}
+
+void Tracing::SetThreadName(const char *name)
+{
+   auto &state = sThreadState;
+   state.name = name;
+   if (state.pBuffer)
+      state.pBuffer->name = name;
+}
+
+void Tracing::Scope::Record(const char *category, const char *name,
+   int64_t start, int64_t end) noexcept
+{
+   try {
+      auto &buffer = GetThreadBuffer();
+      const auto index = buffer.head.load(std::memory_order_relaxed);
+      buffer.events[index % ThreadBuffer::Capacity] =
+         { category, name, start, end };
+      buffer.head.store(index + 1, std::memory_order_release);
+   }
+   catch (...) {
+      // Lose the event rather than disturb the traced code
+   }
+}
@@ -0,0 +1,100 @@
+/*!********************************************************************
+
+ Audacity: A Digital Audio Editor
+
+ @file Tracing.h
+
+ @brief Timed scopes of several threads, written as a Chrome trace
+
+ **********************************************************************/
+
+#ifndef __AUDACITY_TRACING__
+#define __AUDACITY_TRACING__
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+//! Records when hot paths of each thread begin and end
+/*!
+ While tracing is started, each Scope appends one event to a ring buffer of
+ its own thread.  Writing an event takes no lock; only the first event of each
+ thread allocates its buffer.  When a buffer is full, the oldest events are
+ overwritten.
+
+ Stop() collects the buffers into a file in the Chrome trace event format,
+ which chrome://tracing, Perfetto and speedscope can show as a flame graph.
+
+ Build with the has_tracing option turned off and TRACE_SCOPE compiles to
+ nothing.
+ */
+namespace Tracing {
+
+//! Whether events are being recorded
+UTILITY_API bool IsStarted() noexcept;
+
+//! Discard any earlier events and begin recording
+UTILITY_API void Start();
+
+//! Stop recording and write the events as a Chrome trace
+/*! @return whether the file was written */
+UTILITY_API bool Stop(const std::string &path);
+
+//! Stop recording and write the events to a file that the caller opened
+/*!
+ For paths that fopen can't take, as those of non-ASCII characters on Windows
+
+ @param file may be null, as when it could not be opened; recording stops
+ anyway
+ @return whether the events were written; the caller must still check the
+ closing of the file
+ */
+UTILITY_API bool Stop(std::FILE *file);
+
+//! Label the calling thread in the trace
+/*! @param name must have static storage duration */
+UTILITY_API void SetThreadName(const char *name);
+
+//! Nanoseconds of a monotonic clock
+UTILITY_API int64_t Now() noexcept;
+
+//! Records the time between its construction and destruction
+class UTILITY_API Scope final
+{
+public:
+   //! @param category, name must have static storage duration
+   explicit Scope(const char *category, const char *name) noexcept
+      : mCategory{ category }, mName{ name }
+      , mStart{ IsStarted() ? Now() : -1 }
+   {}
+   ~Scope() noexcept
+   {
+      if (mStart >= 0)
+         Record(mCategory, mName, mStart, Now());
+   }
+   Scope(const Scope&) = delete;
+   Scope &operator=(const Scope&) = delete;
+
+private:
+   static void Record(const char *category, const char *name,
+      int64_t start, int64_t end) noexcept;
+
+   const char *const mCategory;
+   const char *const mName;
+   const int64_t mStart;
+};
+
+}
+
+#define TRACE_CONCAT_IMPL(a, b) a ## b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#ifdef HAS_TRACING
+//! Trace the rest of the enclosing block; arguments are string literals
+#define TRACE_SCOPE(category, name) \
+   const Tracing::Scope TRACE_CONCAT(traceScope, __LINE__){ category, name }
+#else
+#define TRACE_SCOPE(category, name) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,67 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  RealtimeArenaTest.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include "RealtimeArena.h"
+#include <cstdint>
+
+TEST_CASE("RealtimeArena")
+{
+   RealtimeArena arena;
+   arena.Reserve(RealtimeArena::Needed<float>(100) +
+      RealtimeArena::Needed<double>(10));
+   REQUIRE(arena.Overflows() == 0);
+
+   float *first{};
+   {
+      RealtimeArena::Mark mark{ arena };
+      first = arena.Allocate<float>(100);
+      const auto second = arena.Allocate<double>(10);
+      REQUIRE(reinterpret_cast<std::uintptr_t>(second) % alignof(double) == 0);
+      REQUIRE(second != reinterpret_cast<double*>(first));
+      REQUIRE(arena.Overflows() == 0);
+   }
+
+   SECTION("Memory is reused after the mark")
+   {
+      RealtimeArena::Mark mark{ arena };
+      REQUIRE(arena.Allocate<float>(100) == first);
+   }
+
+   SECTION("Excess falls back to the heap")
+   {
+      RealtimeArena::Mark mark{ arena };
+      const auto big = arena.Allocate<float>(1000);
+      REQUIRE(big != nullptr);
+      big[999] = 1.0f;
+      REQUIRE(arena.Overflows() == 1);
+   }
+
+   SECTION("Reserve discards everything")
+   {
+      arena.Allocate<char>(1);
+      arena.Reserve(0);
+      RealtimeArena::Mark mark{ arena };
+      REQUIRE(arena.Allocate<float>(100) == first);
+   }
+}
+
+TEST_CASE("RealtimeAllocationTrap")
+{
+   REQUIRE(!RealtimeAllocationTrap::IsArmed());
+   {
+      RealtimeAllocationTrap::Scope scope;
+      REQUIRE(RealtimeAllocationTrap::IsArmed());
+      {
+         RealtimeAllocationTrap::Scope inner;
+      }
+      REQUIRE(RealtimeAllocationTrap::IsArmed());
+   }
+   REQUIRE(!RealtimeAllocationTrap::IsArmed());
+}
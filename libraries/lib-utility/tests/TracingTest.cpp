@@ -0,0 +1,117 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  TracingTest.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include "Tracing.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace {
+std::string ReadFile(const std::string &path)
+{
+   std::ifstream stream{ path };
+   std::stringstream contents;
+   contents << stream.rdbuf();
+   return contents.str();
+}
+
+size_t Count(const std::string &text, const std::string &pattern)
+{
+   size_t result = 0;
+   for (auto pos = text.find(pattern); pos != std::string::npos;
+      pos = text.find(pattern, pos + 1))
+      ++result;
+   return result;
+}
+}
+
+TEST_CASE("Tracing")
+{
+   const std::string path = "TracingTest.json";
+
+   SECTION("Scopes outside of Start() and Stop() are not recorded")
+   {
+      REQUIRE(!Tracing::IsStarted());
+      {
+         Tracing::Scope scope{ "test", "ignored" };
+      }
+      Tracing::Start();
+      REQUIRE(Tracing::IsStarted());
+      {
+         Tracing::Scope scope{ "test", "outer" };
+         Tracing::Scope inner{ "test", "inner\"quoted\"" };
+      }
+      REQUIRE(Tracing::Stop(path));
+      REQUIRE(!Tracing::IsStarted());
+
+      const auto text = ReadFile(path);
+      REQUIRE(text.find("{\"traceEvents\":[") == 0);
+      REQUIRE(Count(text, "\"ph\":\"X\"") == 2);
+      REQUIRE(Count(text, "\"name\":\"outer\"") == 1);
+      REQUIRE(Count(text, "\"name\":\"inner\\\"quoted\\\"\"") == 1);
+      REQUIRE(Count(text, "ignored") == 0);
+   }
+
+   SECTION("Each thread is named and keeps its own events")
+   {
+      Tracing::Start();
+      std::thread thread{ []{
+         Tracing::SetThreadName("Worker");
+         for (int ii = 0; ii < 10; ++ii)
+            Tracing::Scope scope{ "test", "work" };
+      } };
+      thread.join();
+      {
+         Tracing::Scope scope{ "test", "main" };
+      }
+      REQUIRE(Tracing::Stop(path));
+
+      const auto text = ReadFile(path);
+      REQUIRE(Count(text, "\"name\":\"work\"") == 10);
+      REQUIRE(Count(text, "\"name\":\"main\"") == 1);
+      REQUIRE(Count(text, "\"args\":{\"name\":\"Worker\"}") == 1);
+   }
+
+   SECTION("Start() discards earlier events")
+   {
+      Tracing::Start();
+      {
+         Tracing::Scope scope{ "test", "first" };
+      }
+      Tracing::Start();
+      {
+         Tracing::Scope scope{ "test", "second" };
+      }
+      REQUIRE(Tracing::Stop(path));
+
+      const auto text = ReadFile(path);
+      REQUIRE(Count(text, "\"name\":\"first\"") == 0);
+      REQUIRE(Count(text, "\"name\":\"second\"") == 1);
+   }
+
+   SECTION("A full buffer keeps the newest events")
+   {
+      Tracing::Start();
+      for (int ii = 0; ii < 100000; ++ii)
+         Tracing::Scope scope{ "test", "many" };
+      {
+         Tracing::Scope scope{ "test", "last" };
+      }
+      REQUIRE(Tracing::Stop(path));
+
+      const auto text = ReadFile(path);
+      REQUIRE(Count(text, "\"name\":\"last\"") == 1);
+      REQUIRE(Count(text, "\"ph\":\"X\"") < 100000);
+   }
+
+   std::remove(path.c_str());
+}
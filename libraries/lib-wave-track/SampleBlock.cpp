@@ -56,6 +56,27 @@ SampleBlockPtr SampleBlockFactory::CreateFromXML(
    return result;
 }
 
+SampleBlockPtr SampleBlockFactory::CreateCopy(
+   const SampleBlockPtr &source,
+   sampleFormat format)
+{
+   auto result = DoCreateCopy(source, format);
+   if (!result)
+      THROW_INCONSISTENCY_EXCEPTION;
+   Publisher<SampleBlockCreateMessage>::Publish({});
+   return result;
+}
+
+SampleBlockPtr SampleBlockFactory::DoCreateCopy(
+   const SampleBlockPtr &source,
+   sampleFormat format)
+{
+   auto sampleCount = source->GetSampleCount();
+   SampleBuffer buffer{ sampleCount, format };
+   source->GetSamples( buffer.ptr(), format, 0, sampleCount );
+   return DoCreate( buffer.ptr(), sampleCount, format );
+}
+
 SampleBlock::~SampleBlock() = default;
 
 size_t SampleBlock::GetSamples(samplePtr dest,
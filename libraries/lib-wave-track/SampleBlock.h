@@ -141,6 +141,13 @@ public:
       sampleFormat srcformat,
       const AttributesList &attrs);
 
+   //! Make a block of this factory with the contents of a block of another
+   //! factory, as when pasting between projects
+   /*! Returns a non-null pointer or else throws an exception */
+   SampleBlockPtr CreateCopy(
+      const SampleBlockPtr &source,
+      sampleFormat format);
+
    using SampleBlockIDs = std::unordered_set<SampleBlockID>;
    /*! @return ids of all sample blocks created by this factory and still extant */
    virtual SampleBlockIDs GetActiveBlockIDs() = 0;
@@ -163,6 +170,13 @@ protected:
    virtual SampleBlockPtr DoCreateFromXML(
       sampleFormat srcformat,
       const AttributesList &attrs) = 0;
+
+   //! Default implementation reads all samples of source, converted to
+   //! format, and passes them to DoCreate(); an override may copy the stored
+   //! contents directly, when it knows how they are stored
+   virtual SampleBlockPtr DoCreateCopy(
+      const SampleBlockPtr &source,
+      sampleFormat format);
 };
 
 #endif
@@ -44,6 +44,34 @@
 #include "Dither.h"
 #include "SampleBlock.h"
 #include "InconsistencyException.h"
+#include "XMLNames.h"
+
+namespace {
+// Names that Sequence::HandleXMLTag compares as integers
+const auto WaveBlockTag = XMLNames::Intern("waveblock");
+const auto SequenceTag = XMLNames::Intern("sequence");
+const auto StartAttr = XMLNames::Intern("start");
+const auto MaxSamplesAttr = XMLNames::Intern("maxsamples");
+const auto SampleFormatAttr = XMLNames::Intern("sampleformat");
+const auto EffectiveSampleFormatAttr =
+   XMLNames::Intern("effectivesampleformat");
+const auto NumSamplesAttr = XMLNames::Intern("numsamples");
+}
+
+auto BlockArray::Blocks() const -> const Vector &
+{
+   static const Vector empty;
+   return mpBlocks ? *mpBlocks : empty;
+}
+
+auto BlockArray::Unshared() -> Vector &
+{
+   if (!mpBlocks)
+      mpBlocks = std::make_shared<Vector>();
+   else if (mpBlocks.use_count() > 1)
+      mpBlocks = std::make_shared<Vector>(*mpBlocks);
+   return *mpBlocks;
+}
 
 size_t Sequence::sMaxDiskBlockSize = 1048576;
 
@@ -184,7 +212,7 @@ bool Sequence::ConvertToSampleFormat(sampleFormat format,
 
       for (size_t i = 0, nn = mBlock.size(); i < nn; i++)
       {
-         SeqBlock &oldSeqBlock = mBlock[i];
+         const SeqBlock &oldSeqBlock = mBlock[i];
          const auto &oldBlockFile = oldSeqBlock.sb;
          const auto len = oldBlockFile->GetSampleCount();
          ensureSampleBufferSize(bufferOld, oldFormats.Stored(), oldSize, len);
@@ -399,6 +427,14 @@ std::unique_ptr<Sequence> Sequence::Copy( const SampleBlockFactoryPtr &pFactory,
    // contents are used -- must copy if factories are different:
    auto pUseFactory = (pFactory == mpFactory) ? nullptr : pFactory.get();
 
+   if (!pUseFactory && s0 == 0 && s1 >= mNumSamples) {
+      // Share the array of blocks
+      dest->mBlock = mBlock;
+      dest->mNumSamples = mNumSamples;
+      dest->ConsistencyCheck(wxT("Sequence::Copy()"));
+      return dest;
+   }
+
    int numBlocks = mBlock.size();
 
    int b0 = FindBlock(s0);
@@ -478,13 +514,9 @@ namespace {
    SampleBlockPtr ShareOrCopySampleBlock(
       SampleBlockFactory *pFactory, sampleFormat format, SampleBlockPtr sb )
    {
-      if ( pFactory ) {
+      if ( pFactory )
          // must copy contents to a fresh SampleBlock object in another database
-         auto sampleCount = sb->GetSampleCount();
-         SampleBuffer buffer{ sampleCount, format };
-         sb->GetSamples( buffer.ptr(), format, 0, sampleCount );
-         sb = pFactory->Create( buffer.ptr(), sampleCount, format );
-      }
+         sb = pFactory->CreateCopy( sb, format );
       else
          // Can just share
          ;
@@ -541,6 +573,17 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
    auto pUseFactory =
       (src->mpFactory == mpFactory) ? nullptr : mpFactory.get();
 
+   if (numBlocks == 0 && !pUseFactory) {
+      // Special case, as when copying a whole sequence for undo:  share the
+      // array itself, which also starts at 0, but check it as the other
+      // branches do
+      BlockArray newBlock{ srcBlock };
+      CommitChangesIfConsistent
+         (newBlock, addedLen, wxT("Paste branch zero"));
+      mSampleFormats.UpdateEffective(src->mSampleFormats.Effective());
+      return;
+   }
+
    if (numBlocks == 0 ||
        (s == mNumSamples && mBlock.back().sb->GetSampleCount() >= mMinSamples)) {
       // Special case: this track is currently empty, or it's safe to append
@@ -564,7 +607,7 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
 
    const int b = (s == mNumSamples) ? mBlock.size() - 1 : FindBlock(s);
    wxASSERT((b >= 0) && (b < (int)numBlocks));
-   SeqBlock *const pBlock = &mBlock[b];
+   const SeqBlock *const pBlock = &mBlock[b];
    const auto length = pBlock->sb->GetSampleCount();
    const auto largerBlockLen = addedLen + length;
    // PRL: when insertion point is the first sample of a block,
@@ -574,7 +617,7 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
       // Special case: we can fit all of the NEW samples inside of
       // one block!
 
-      SeqBlock &block = *pBlock;
+      const SeqBlock &block = *pBlock;
       // largerBlockLen is not more than mMaxSamples...
       SampleBuffer buffer(largerBlockLen.as_size_t(), format);
 
@@ -590,17 +633,18 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
            splitPoint, length - splitPoint, true);
 
       // largerBlockLen is not more than mMaxSamples...
-      block.sb = mpFactory->Create(
+      auto sb = mpFactory->Create(
          buffer.ptr(),
          largerBlockLen.as_size_t(),
          format);
 
-      // Don't make a duplicate array.  We can still give Strong-guarantee
-      // if we modify only one block in place.
+      // Don't make a duplicate array, unless it is shared.  We can still give
+      // Strong-guarantee if we modify only one block in place.
+      mBlock.Mutable(b).sb = std::move(sb);
 
       // use No-fail-guarantee in remaining steps
       for (unsigned int i = b + 1; i < numBlocks; i++)
-         mBlock[i].start += addedLen;
+         mBlock.Mutable(i).start += addedLen;
 
       mNumSamples += addedLen;
 
@@ -619,7 +663,7 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
    newBlock.reserve(numBlocks + srcNumBlocks + 2);
    newBlock.insert(newBlock.end(), mBlock.begin(), mBlock.begin() + b);
 
-   SeqBlock &splitBlock = mBlock[b];
+   const SeqBlock &splitBlock = mBlock[b];
    auto splitLen = splitBlock.sb->GetSampleCount();
    // s lies within splitBlock
    auto splitPoint = ( s - splitBlock.start ).as_size_t();
@@ -813,9 +857,10 @@ size_t Sequence::GetBestBlockSize(sampleCount start) const
 bool Sequence::HandleXMLTag(const std::string_view& tag, const AttributesList &attrs)
 {
    auto &factory = *mpFactory;
+   const auto tagId = XMLNames::Find(tag);
 
    /* handle waveblock tag and its attributes */
-   if (tag == "waveblock")
+   if (tagId == WaveBlockTag)
    {
       SeqBlock wb;
 
@@ -830,10 +875,10 @@ bool Sequence::HandleXMLTag(const std::string_view& tag, const AttributesList &a
       // loop through attrs, which is a null-terminated list of attribute-value pairs
       for (auto pair : attrs)
       {
-         auto attr = pair.first;
+         auto attr = XMLNames::Find(pair.first);
          auto value = pair.second;
 
-         if (attr == "start")
+         if (attr == StartAttr)
          {
             // This attribute is a sample offset, so can be 64bit
             sampleCount::type start;
@@ -854,18 +899,18 @@ bool Sequence::HandleXMLTag(const std::string_view& tag, const AttributesList &a
    }
 
    /* handle sequence tag and its attributes */
-   if (tag == "sequence")
+   if (tagId == SequenceTag)
    {
       std::optional<sampleFormat> effective;
       sampleFormat stored = floatSample;
       for (auto pair : attrs)
       {
-         auto attr = pair.first;
+         auto attr = XMLNames::Find(pair.first);
          auto value = pair.second;
 
          long long nValue = 0;
 
-         if (attr == "maxsamples")
+         if (attr == MaxSamplesAttr)
          {
             // This attribute is a sample count, so can be 64bit
             if (!value.TryGet(nValue))
@@ -886,7 +931,7 @@ bool Sequence::HandleXMLTag(const std::string_view& tag, const AttributesList &a
             // nValue is now safe for size_t
             mMaxSamples = nValue;
          }
-         else if (attr == "sampleformat")
+         else if (attr == SampleFormatAttr)
          {
             // This attribute is a sample format, normal int
             long fValue;
@@ -898,7 +943,7 @@ bool Sequence::HandleXMLTag(const std::string_view& tag, const AttributesList &a
             }
             stored = static_cast<sampleFormat>( fValue );
          }
-         else if (attr == "effectivesampleformat")
+         else if (attr == EffectiveSampleFormatAttr)
          {
             // This attribute is a sample format, normal int
             long fValue;
@@ -910,7 +955,7 @@ bool Sequence::HandleXMLTag(const std::string_view& tag, const AttributesList &a
             }
             effective.emplace(static_cast<sampleFormat>(fValue));
          }
-         else if (attr == "numsamples")
+         else if (attr == NumSamplesAttr)
          {
             // This attribute is a sample count, so can be 64bit
             if (!value.TryGet(nValue) || (nValue < 0))
@@ -952,7 +997,7 @@ void Sequence::HandleXMLEndTag(const std::string_view& tag)
    sampleCount numSamples = 0;
    for (unsigned b = 0, nn = mBlock.size(); b < nn;  b++)
    {
-      SeqBlock &block = mBlock[b];
+      const SeqBlock &block = mBlock[b];
       if (block.start != numSamples)
       {
          wxLogWarning(
@@ -963,10 +1008,10 @@ void Sequence::HandleXMLEndTag(const std::string_view& tag)
             Internat::ToString(block.start.as_double(), 0),
             block.sb->GetBlockID(),
             Internat::ToString(numSamples.as_double(), 0));
-         block.start = numSamples;
+         mBlock.Mutable(b).start = numSamples;
          mErrorOpening = true;
       }
-      numSamples += block.sb->GetSampleCount();
+      numSamples += mBlock[b].sb->GetSampleCount();
    }
 
    if (mNumSamples != numSamples)
@@ -983,7 +1028,7 @@ void Sequence::HandleXMLEndTag(const std::string_view& tag)
 
 XMLTagHandler *Sequence::HandleXMLChild(const std::string_view& tag)
 {
-   if (tag == "waveblock")
+   if (XMLNames::Find(tag) == WaveBlockTag)
    {
       return this;
    }
@@ -1209,7 +1254,7 @@ void Sequence::SetSamples(constSamplePtr buffer, sampleFormat format,
       && b < (int)size
    ) {
       newBlock.push_back( mBlock[b] );
-      SeqBlock &block = newBlock.back();
+      SeqBlock &block = newBlock.Mutable(newBlock.size() - 1);
       // start is within block
       const auto bstart = ( start - block.start ).as_size_t();
       const auto fileLength = block.sb->GetSampleCount();
@@ -1417,7 +1462,7 @@ SeqBlock::SampleBlockPtr Sequence::DoAppend(
 
    // If the last block is not full, we need to add samples to it
    int numBlocks = mBlock.size();
-   SeqBlock *pLastBlock;
+   const SeqBlock *pLastBlock;
    decltype(pLastBlock->sb->GetSampleCount()) length;
    size_t bufferSize = mMaxSamples;
    const auto dstFormat = mSampleFormats.Stored();
@@ -1564,7 +1609,7 @@ void Sequence::Delete(sampleCount start, sampleCount len)
    const auto format = mSampleFormats.Stored();
    auto sampleSize = SAMPLE_SIZE(format);
 
-   SeqBlock *pBlock;
+   const SeqBlock *pBlock;
    decltype(pBlock->sb->GetSampleCount()) length;
 
    // One buffer for reuse in various branches here
@@ -1577,7 +1622,7 @@ void Sequence::Delete(sampleCount start, sampleCount len)
    // deletion within this block:
    if (b0 == b1 &&
        (length = (pBlock = &mBlock[b0])->sb->GetSampleCount()) - len >= mMinSamples) {
-      SeqBlock &b = *pBlock;
+      const SeqBlock &b = *pBlock;
       // start is within block
       auto pos = ( start - b.start ).as_size_t();
 
@@ -1598,15 +1643,16 @@ void Sequence::Delete(sampleCount start, sampleCount len)
            // is not more than the length of the block
            ( pos + len ).as_size_t(), newLen - pos, true);
 
-      b.sb = factory.Create(scratch.ptr(), newLen, format);
+      auto sb = factory.Create(scratch.ptr(), newLen, format);
 
-      // Don't make a duplicate array.  We can still give Strong-guarantee
-      // if we modify only one block in place.
+      // Don't make a duplicate array, unless it is shared.  We can still give
+      // Strong-guarantee if we modify only one block in place.
+      mBlock.Mutable(b0).sb = std::move(sb);
 
       // use No-fail-guarantee in remaining steps
 
       for (unsigned int j = b0 + 1; j < numBlocks; j++)
-         mBlock[j].start -= len;
+         mBlock.Mutable(j).start -= len;
 
       mNumSamples -= len;
 
@@ -1690,7 +1736,7 @@ void Sequence::Delete(sampleCount start, sampleCount len)
 
          newBlock.push_back(SeqBlock(file, start));
       } else {
-         SeqBlock &postpostBlock = mBlock[b1 + 1];
+         const SeqBlock &postpostBlock = mBlock[b1 + 1];
          const auto postpostLen = postpostBlock.sb->GetSampleCount();
          const auto sum = postpostLen + postBufferLen;
 
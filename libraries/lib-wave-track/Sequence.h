@@ -14,6 +14,7 @@
 
 #include <vector>
 #include <functional>
+#include <memory>
 
 #include "SampleFormat.h"
 #include "XMLTagHandler.h"
@@ -47,7 +48,74 @@ class SeqBlock {
       return SeqBlock(sb, start + delta);
    }
 };
-class BlockArray : public std::vector<SeqBlock> {};
+
+//! The blocks of a Sequence in order; copies share them until one is changed
+/*!
+ Elements are read only through const references.  Changes go through the
+ other members, which first copy the elements if they are shared.  So a copy of
+ a whole sequence, as for an undo state, costs one pointer, and its blocks are
+ copied only if the original is then edited.
+
+ A reference returned by Mutable() must not be used after the next copy of
+ this array, or the change would show in the copy too.
+
+ Only copies are cheap.  An edit still copies the whole vector if it is
+ shared, and shifts the starts of all later blocks, so it costs linear time,
+ as the consistency check after each edit does.  Starts relative to a node of
+ a persistent tree would make edits logarithmic, but every reader of
+ SeqBlock::start expects an absolute position.
+ */
+class WAVE_TRACK_API BlockArray {
+   using Vector = std::vector<SeqBlock>;
+public:
+   using value_type = SeqBlock;
+   using size_type = Vector::size_type;
+   using const_iterator = Vector::const_iterator;
+   using iterator = const_iterator;
+
+   bool empty() const { return size() == 0; }
+   size_type size() const { return mpBlocks ? mpBlocks->size() : 0; }
+
+   const_iterator begin() const { return Blocks().begin(); }
+   const_iterator end() const { return Blocks().end(); }
+   const SeqBlock &operator[](size_type ii) const { return (*mpBlocks)[ii]; }
+   const SeqBlock &back() const { return mpBlocks->back(); }
+
+   //! Element that may be changed, after the blocks are copied if shared
+   SeqBlock &Mutable(size_type ii) { return Unshared()[ii]; }
+
+   void reserve(size_type n) { Unshared().reserve(n); }
+   void resize(size_type n) { Unshared().resize(n); }
+   void clear() noexcept { mpBlocks.reset(); }
+   void push_back(const SeqBlock &block) { Unshared().push_back(block); }
+   void push_back(SeqBlock &&block) { Unshared().push_back(std::move(block)); }
+   template<typename... Args> void emplace_back(Args &&...args)
+   {
+      Unshared().emplace_back(std::forward<Args>(args)...);
+   }
+   void pop_back() { Unshared().pop_back(); }
+   //! @pre first and last are not iterators of this
+   template<typename Iterator>
+   void insert(const_iterator pos, Iterator first, Iterator last)
+   {
+      const auto offset = pos - begin();
+      auto &blocks = Unshared();
+      blocks.insert(blocks.begin() + offset, first, last);
+   }
+   //! @pre first and last are not iterators of this
+   template<typename Iterator> void assign(Iterator first, Iterator last)
+   {
+      Unshared().assign(first, last);
+   }
+   void swap(BlockArray &other) noexcept { mpBlocks.swap(other.mpBlocks); }
+
+private:
+   const Vector &Blocks() const;
+   //! @post the vector is owned by this only
+   Vector &Unshared();
+
+   std::shared_ptr<Vector> mpBlocks;
+};
 using BlockPtrArray = std::vector<SeqBlock*>; // non-owning pointers
 
 class WAVE_TRACK_API Sequence final : public XMLTagHandler{
@@ -28,11 +28,27 @@
 #include "Sequence.h"
 #include "TimeAndPitchInterface.h"
 #include "UserException.h"
+#include "WaveClipLevels.h"
+#include "XMLNames.h"
 
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+namespace {
+// Names that WaveClip compares as integers when deserializing
+const auto WaveClipTag = XMLNames::Intern("waveclip");
+const auto SequenceTag = XMLNames::Intern("sequence");
+const auto EnvelopeTag = XMLNames::Intern("envelope");
+const auto OffsetAttr = XMLNames::Intern("offset");
+const auto TrimLeftAttr = XMLNames::Intern("trimLeft");
+const auto TrimRightAttr = XMLNames::Intern("trimRight");
+const auto RawAudioTempoAttr = XMLNames::Intern("rawAudioTempo");
+const auto ClipStretchRatioAttr = XMLNames::Intern("clipStretchRatio");
+const auto NameAttr = XMLNames::Intern("name");
+const auto ColorIndexAttr = XMLNames::Intern("colorindex");
+}
+
 WaveClipListener::~WaveClipListener()
 {
 }
@@ -423,7 +439,8 @@ std::pair<float, float> WaveClip::GetMinMax(size_t ii,
    auto s0 = TimeToSequenceSamples(t0);
    auto s1 = TimeToSequenceSamples(t1);
 
-   return mSequences[ii]->GetMinMax(s0, s1 - s0, mayThrow);
+   return WaveClipLevels::Get(*this)
+      .GetMinMax(*mSequences[ii], ii, s0, s1 - s0, mayThrow);
 }
 
 float WaveClip::GetRMS(size_t ii, double t0, double t1, bool mayThrow) const
@@ -441,7 +458,8 @@ float WaveClip::GetRMS(size_t ii, double t0, double t1, bool mayThrow) const
    auto s0 = TimeToSequenceSamples(t0);
    auto s1 = TimeToSequenceSamples(t1);
 
-   return mSequences[ii]->GetRMS(s0, s1-s0, mayThrow);
+   return WaveClipLevels::Get(*this)
+      .GetRMS(*mSequences[ii], ii, s0, s1 - s0, mayThrow);
 }
 
 void WaveClip::ConvertToSampleFormat(sampleFormat format,
@@ -542,34 +560,34 @@ void WaveClip::Flush()
 
 bool WaveClip::HandleXMLTag(const std::string_view& tag, const AttributesList &attrs)
 {
-   if (tag == "waveclip")
+   if (XMLNames::Find(tag) == WaveClipTag)
    {
       double dblValue;
       long longValue;
       for (auto pair : attrs)
       {
-         auto attr = pair.first;
+         auto attr = XMLNames::Find(pair.first);
          auto value = pair.second;
 
-         if (attr == "offset")
+         if (attr == OffsetAttr)
          {
             if (!value.TryGet(dblValue))
                return false;
             SetSequenceStartTime(dblValue);
          }
-         else if (attr == "trimLeft")
+         else if (attr == TrimLeftAttr)
          {
             if (!value.TryGet(dblValue))
                return false;
             SetTrimLeft(dblValue);
          }
-         else if (attr == "trimRight")
+         else if (attr == TrimRightAttr)
          {
             if (!value.TryGet(dblValue))
                return false;
             SetTrimRight(dblValue);
          }
-         else if (attr == "rawAudioTempo")
+         else if (attr == RawAudioTempoAttr)
          {
             if (!value.TryGet(dblValue))
                return false;
@@ -578,18 +596,18 @@ bool WaveClip::HandleXMLTag(const std::string_view& tag, const AttributesList &a
             else
                mRawAudioTempo = dblValue;
          }
-         else if (attr == "clipStretchRatio")
+         else if (attr == ClipStretchRatioAttr)
          {
             if (!value.TryGet(dblValue))
                return false;
             mClipStretchRatio = dblValue;
          }
-         else if (attr == "name")
+         else if (attr == NameAttr)
          {
             if(value.IsStringView())
                SetName(value.ToWString());
          }
-         else if (attr == "colorindex")
+         else if (attr == ColorIndexAttr)
          {
             if (!value.TryGet(longValue))
                return false;
@@ -608,7 +626,7 @@ void WaveClip::HandleXMLEndTag(const std::string_view& tag)
    // by the constructor which remains empty.
    mSequences.erase(mSequences.begin());
    mSequences.shrink_to_fit();
-   if (tag == "waveclip")
+   if (XMLNames::Find(tag) == WaveClipTag)
       UpdateEnvelopeTrackLen();
    // A proof of this assertion assumes that nothing has happened since
    // construction of this, besides calls to the other deserialization
@@ -619,14 +637,15 @@ void WaveClip::HandleXMLEndTag(const std::string_view& tag)
 XMLTagHandler *WaveClip::HandleXMLChild(const std::string_view& tag)
 {
    auto &pFirst = mSequences[0];
-   if (tag == "sequence") {
+   const auto tagId = XMLNames::Find(tag);
+   if (tagId == SequenceTag) {
       mSequences.push_back(std::make_unique<Sequence>(
          pFirst->GetFactory(), pFirst->GetSampleFormats()));
       return mSequences.back().get();
    }
-   else if (tag == "envelope")
+   else if (tagId == EnvelopeTag)
       return mEnvelope.get();
-   else if (tag == "waveclip")
+   else if (tagId == WaveClipTag)
    {
       // Nested wave clips are cut lines
       auto format = pFirst->GetSampleFormats().Stored();
@@ -0,0 +1,258 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  WaveClipLevels.cpp
+
+**********************************************************************/
+#include "WaveClipLevels.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+#include "SampleBlock.h"
+#include "Sequence.h"
+
+namespace {
+//! Frames of the 256 summary, as SampleBlock::GetSummary256() gives them
+constexpr size_t FrameSize = 256;
+
+//! Min/max tree of n leaves, stored from index n; index 1 is the root
+struct MinMaxTree
+{
+   void Build(std::vector<float> mins, std::vector<float> maxes)
+   {
+      const auto n = mins.size();
+      min.resize(2 * n);
+      max.resize(2 * n);
+      std::copy(mins.begin(), mins.end(), min.begin() + n);
+      std::copy(maxes.begin(), maxes.end(), max.begin() + n);
+      for (auto ii = n; ii-- > 1;) {
+         min[ii] = std::min(min[2 * ii], min[2 * ii + 1]);
+         max[ii] = std::max(max[2 * ii], max[2 * ii + 1]);
+      }
+   }
+
+   //! Combine leaves [first, last) into result
+   void Query(size_t first, size_t last, float &resultMin, float &resultMax)
+      const
+   {
+      const auto n = min.size() / 2;
+      for (first += n, last += n; first < last; first /= 2, last /= 2) {
+         if (first & 1) {
+            resultMin = std::min(resultMin, min[first]);
+            resultMax = std::max(resultMax, max[first++]);
+         }
+         if (last & 1) {
+            resultMin = std::min(resultMin, min[--last]);
+            resultMax = std::max(resultMax, max[last]);
+         }
+      }
+   }
+
+   std::vector<float> min, max;
+};
+}
+
+//! Prefix sums of squares and min/max tree of consecutive intervals
+struct WaveClipLevels::Intervals
+{
+   template<typename Fn> void Build(size_t n, const Fn &get)
+   {
+      std::vector<float> mins(n), maxes(n);
+      sumSquares.assign(n + 1, 0.0);
+      for (size_t ii = 0; ii < n; ++ii) {
+         const auto [levels, length] = get(ii);
+         mins[ii] = levels.min;
+         maxes[ii] = levels.max;
+         const double rms = levels.RMS;
+         sumSquares[ii + 1] = sumSquares[ii] + rms * rms * length;
+      }
+      tree.Build(std::move(mins), std::move(maxes));
+   }
+
+   std::vector<double> sumSquares;
+   MinMaxTree tree;
+};
+
+struct WaveClipLevels::Levels
+{
+   void Add(const MinMaxRMS &levels, size_t length)
+   {
+      min = std::min(min, levels.min);
+      max = std::max(max, levels.max);
+      const double rms = levels.RMS;
+      sumSquares += rms * rms * length;
+      count += length;
+   }
+
+   float min = FLT_MAX;
+   float max = -FLT_MAX;
+   double sumSquares = 0;
+   sampleCount count = 0;
+};
+
+struct WaveClipLevels::Channel
+{
+   sampleCount numSamples;
+   Intervals blocks;
+   //! Frames of each block, made on demand
+   std::vector<std::unique_ptr<Intervals>> frames;
+};
+
+static WaveClip::Caches::RegisteredFactory sKeyL{ [](WaveClip &) {
+   return std::make_unique<WaveClipLevels>();
+} };
+
+WaveClipLevels &WaveClipLevels::Get(const WaveClip &clip)
+{
+   return const_cast< WaveClip& >( clip ) // Consider it mutable data
+      .Caches::Get< WaveClipLevels >( sKeyL );
+}
+
+WaveClipLevels::WaveClipLevels() = default;
+
+WaveClipLevels::~WaveClipLevels() = default;
+
+void WaveClipLevels::MarkChanged()
+{
+   std::lock_guard<std::mutex> lock{ mMutex };
+   mChannels.clear();
+}
+
+void WaveClipLevels::Invalidate()
+{
+   MarkChanged();
+}
+
+std::pair<float, float> WaveClipLevels::GetMinMax(const Sequence &sequence,
+   size_t ii, sampleCount start, sampleCount len, bool mayThrow)
+{
+   if (len == 0 || sequence.GetBlockArray().size() == 0)
+      return { 0.f, 0.f };
+   const auto levels = Query(sequence, ii, start, len, false, mayThrow);
+   return { levels.min, levels.max };
+}
+
+float WaveClipLevels::GetRMS(const Sequence &sequence,
+   size_t ii, sampleCount start, sampleCount len, bool mayThrow)
+{
+   if (len == 0 || sequence.GetBlockArray().size() == 0)
+      return 0.f;
+   const auto levels = Query(sequence, ii, start, len, true, mayThrow);
+   // PRL: catch bugs like 1320:
+   assert(levels.count == len);
+   return sqrt(levels.sumSquares / levels.count.as_double());
+}
+
+auto WaveClipLevels::GetChannel(const Sequence &sequence, size_t ii,
+   bool mayThrow) -> Channel &
+{
+   if (mChannels.size() <= ii)
+      mChannels.resize(ii + 1);
+   auto &pChannel = mChannels[ii];
+   const auto &blocks = sequence.GetBlockArray();
+   // Rebuild also if an edit somehow did not mark the clip changed
+   if (!pChannel || pChannel->numSamples != sequence.GetNumSamples() ||
+       pChannel->frames.size() != blocks.size()) {
+      // Build it aside, so that an exception leaves nothing half made
+      auto pNewChannel = std::make_unique<Channel>();
+      pNewChannel->numSamples = sequence.GetNumSamples();
+      pNewChannel->frames.resize(blocks.size());
+      pNewChannel->blocks.Build(blocks.size(), [&](size_t b){
+         const auto &sb = *blocks[b].sb;
+         return std::pair{ sb.GetMinMaxRMS(mayThrow), sb.GetSampleCount() };
+      });
+      pChannel = std::move(pNewChannel);
+   }
+   return *pChannel;
+}
+
+auto WaveClipLevels::Query(const Sequence &sequence, size_t ii,
+   sampleCount start, sampleCount len, bool needRMS, bool mayThrow) -> Levels
+{
+   std::lock_guard<std::mutex> lock{ mMutex };
+   auto &channel = GetChannel(sequence, ii, mayThrow);
+   const auto &blocks = sequence.GetBlockArray();
+   Levels result;
+
+   // Samples [from, to) of block b
+   const auto addPart = [&](size_t b, size_t from, size_t to) {
+      auto &sb = *blocks[b].sb;
+      const auto length = sb.GetSampleCount();
+      if (from == 0 && to == length) {
+         result.Add(sb.GetMinMaxRMS(mayThrow), length);
+         return;
+      }
+      if (!needRMS) {
+         // If the block's extremes are no more extreme, ignore them
+         const auto levels = sb.GetMinMaxRMS(mayThrow);
+         if (!(levels.min < result.min || levels.max > result.max))
+            return;
+      }
+
+      const auto read = [&](size_t first, size_t last) {
+         if (first < last)
+            result.Add(sb.GetMinMaxRMS(first, last - first, mayThrow),
+               last - first);
+      };
+
+      auto &pFrames = channel.frames[b];
+      const auto nFrames = (length + FrameSize - 1) / FrameSize;
+      if (!pFrames) {
+         std::vector<float> summary(3 * nFrames);
+         if (!sb.GetSummary256(summary.data(), 0, nFrames))
+            // Not cached, so that the next query tries again
+            return read(from, to);
+         pFrames = std::make_unique<Intervals>();
+         pFrames->Build(nFrames, [&](size_t f){
+            const auto pSummary = summary.data() + 3 * f;
+            return std::pair{
+               MinMaxRMS{ pSummary[0], pSummary[1], pSummary[2] },
+               std::min(FrameSize, length - f * FrameSize)
+            };
+         });
+      }
+
+      // Whole frames between from and to; the last frame may be short
+      const auto f0 = (from + FrameSize - 1) / FrameSize;
+      const auto f1 = (to == length) ? nFrames : to / FrameSize;
+      if (f0 >= f1)
+         return read(from, to);
+      read(from, f0 * FrameSize);
+      const auto &frames = *pFrames;
+      frames.tree.Query(f0, f1, result.min, result.max);
+      result.sumSquares += frames.sumSquares[f1] - frames.sumSquares[f0];
+      const auto framesEnd = std::min(f1 * FrameSize, length);
+      result.count += framesEnd - f0 * FrameSize;
+      read(framesEnd, to);
+   };
+
+   const auto end = start + len;
+   const size_t b0 = sequence.FindBlock(start);
+   const size_t b1 = sequence.FindBlock(end - 1);
+   const auto &block0 = blocks[b0];
+   const auto &block1 = blocks[b1];
+
+   // Whole blocks in the middle
+   if (b1 > b0 + 1) {
+      channel.blocks.tree.Query(b0 + 1, b1, result.min, result.max);
+      const auto &sumSquares = channel.blocks.sumSquares;
+      result.sumSquares += sumSquares[b1] - sumSquares[b0 + 1];
+      result.count += block1.start - blocks[b0 + 1].start;
+   }
+
+   if (b0 == b1)
+      addPart(b0, (start - block0.start).as_size_t(),
+         (end - block0.start).as_size_t());
+   else {
+      addPart(b0, (start - block0.start).as_size_t(),
+         block0.sb->GetSampleCount());
+      addPart(b1, 0, (end - block1.start).as_size_t());
+   }
+
+   return result;
+}
@@ -0,0 +1,62 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  WaveClipLevels.h
+
+**********************************************************************/
+#pragma once
+
+#include "WaveClip.h" // to inherit WaveClipListener
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class Sequence;
+
+//! Cache of the levels of a clip's sequences, answering peak and RMS
+//! queries about many regions without reading most of their samples
+/*!
+ Keeps prefix sums of squares and a min/max tree over whole blocks, built from
+ the statistics that blocks hold in memory, and the same over the 256-sample
+ frames of a block's summary, read when a query first ends inside that block.
+ A query then costs O(log n), plus reads of fewer than 256 samples at either
+ end.
+
+ Forgotten at WaveClip::MarkChanged().
+ */
+class WaveClipLevels final : public WaveClipListener
+{
+public:
+   static WaveClipLevels &Get(const WaveClip &clip);
+
+   WaveClipLevels();
+   ~WaveClipLevels() override;
+
+   void MarkChanged() override;
+   void Invalidate() override;
+
+   //! Same as sequence.GetMinMax(start, len, mayThrow)
+   /*! @param ii which sequence of the clip it is */
+   std::pair<float, float> GetMinMax(const Sequence &sequence, size_t ii,
+      sampleCount start, sampleCount len, bool mayThrow);
+   //! Same as sequence.GetRMS(start, len, mayThrow), up to rounding
+   /*! @param ii which sequence of the clip it is */
+   float GetRMS(const Sequence &sequence, size_t ii,
+      sampleCount start, sampleCount len, bool mayThrow);
+
+   struct Levels;
+   struct Intervals;
+   struct Channel;
+
+private:
+   Levels Query(const Sequence &sequence, size_t ii,
+      sampleCount start, sampleCount len, bool needRMS, bool mayThrow);
+   Channel &GetChannel(const Sequence &sequence, size_t ii, bool mayThrow);
+
+   std::mutex mMutex;
+   std::vector<std::unique_ptr<Channel>> mChannels;
+};
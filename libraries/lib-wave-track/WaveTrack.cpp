@@ -37,6 +37,7 @@ from the project that will own the track.
 
 #include <algorithm>
 #include <float.h>
+#include <functional>
 #include <math.h>
 #include <numeric>
 #include <optional>
@@ -3602,6 +3603,18 @@ bool WaveTrack::HasTrivialEnvelope() const
 void WaveTrack::GetEnvelopeValues(
    double* buffer, size_t bufferLen, double t0, bool backwards) const
 {
+   // Reused by each thread; the display and playback may evaluate the same
+   // track at once
+   static thread_local Envelope::Segments segments;
+   GetEnvelopeSegments(segments, bufferLen, t0, backwards);
+   Envelope::FillValues(segments, buffer);
+}
+
+void WaveTrack::GetEnvelopeSegments(Envelope::Segments &segments,
+   size_t bufferLen, double t0, bool backwards) const
+{
+   segments.clear();
+
    auto pTrack = this;
    if (GetOwner())
       // Substitute the leader track
@@ -3609,70 +3622,112 @@ void WaveTrack::GetEnvelopeValues(
 
    if (backwards)
       t0 -= bufferLen / GetRate();
-   // The output buffer corresponds to an unbroken span of time which the callers expect
-   // to be fully valid.  As clips are processed below, the output buffer is updated with
-   // envelope values from any portion of a clip, start, end, middle, or none at all.
-   // Since this does not guarantee that the entire buffer is filled with values we need
-   // to initialize the entire buffer to a default value.
-   //
-   // This does mean that, in the cases where a usable clip is located, the buffer value will
-   // be set twice.  Unfortunately, there is no easy way around this since the clips are not
-   // stored in increasing time order.  If they were, we could just track the time as the
-   // buffer is filled.
-   for (decltype(bufferLen) i = 0; i < bufferLen; i++)
-   {
-      buffer[i] = 1.0;
-   }
 
+   // The segments correspond to an unbroken span of time which the callers
+   // expect to be fully described.  Clips may cover any portion of it, start,
+   // end, middle, or none at all; elsewhere the envelope is unit.
    double startTime = t0;
    const auto rate = GetRate();
    auto tstep = 1.0 / rate;
    double endTime = t0 + tstep * bufferLen;
-   for (const auto &clip: pTrack->mClips)
-   {
-      // IF clip intersects startTime..endTime THEN...
-      auto dClipStartTime = clip->GetPlayStartTime();
-      auto dClipEndTime = clip->GetPlayEndTime();
-      if ((dClipStartTime < endTime) && (dClipEndTime > startTime))
+
+   // Clips are not stored in increasing time order.  Few of them intersect
+   // one buffer, so rather than sort them into other storage, find each next
+   // one by a search; this is called for each buffer that is mixed.
+   const auto before = [](const WaveClip *a, const WaveClip *b){
+      const auto ta = a->GetPlayStartTime(), tb = b->GetPlayStartTime();
+      return ta < tb || (ta == tb && std::less<>{}(a, b));
+   };
+   const WaveClip *pPrevious = nullptr;
+   size_t pos = 0;
+   while (true) {
+      const WaveClip *pClip = nullptr;
+      for (const auto &clip: pTrack->mClips) {
+         // IF clip intersects startTime..endTime THEN...
+         if (clip->GetPlayStartTime() < endTime &&
+            clip->GetPlayEndTime() > startTime &&
+            (!pPrevious || before(pPrevious, clip.get())) &&
+            (!pClip || before(clip.get(), pClip)))
+            pClip = clip.get();
+      }
+      if (!pClip)
+         break;
+      pPrevious = pClip;
+
+      auto dClipStartTime = pClip->GetPlayStartTime();
+      auto dClipEndTime = pClip->GetPlayEndTime();
+      size_t rstart = 0;
+      auto rlen = bufferLen;
+      auto rt0 = t0;
+
+      if (rt0 < dClipStartTime)
       {
-         auto rbuf = buffer;
-         auto rlen = bufferLen;
-         auto rt0 = t0;
+         // This is not more than the number of samples in
+         // (endTime - startTime) which is bufferLen:
+         auto nDiff = (sampleCount)floor((dClipStartTime - rt0) * rate + 0.5);
+         auto snDiff = nDiff.as_size_t();
+         rstart = snDiff;
+         wxASSERT(snDiff <= rlen);
+         rlen -= snDiff;
+         rt0 = dClipStartTime;
+      }
 
-         if (rt0 < dClipStartTime)
-         {
-            // This is not more than the number of samples in
-            // (endTime - startTime) which is bufferLen:
-            auto nDiff = (sampleCount)floor((dClipStartTime - rt0) * rate + 0.5);
-            auto snDiff = nDiff.as_size_t();
-            rbuf += snDiff;
-            wxASSERT(snDiff <= rlen);
-            rlen -= snDiff;
-            rt0 = dClipStartTime;
-         }
+      if (rt0 + rlen*tstep > dClipEndTime)
+      {
+         auto nClipLen =
+            pClip->GetPlayEndSample() - pClip->GetPlayStartSample();
 
-         if (rt0 + rlen*tstep > dClipEndTime)
-         {
-            auto nClipLen = clip->GetPlayEndSample() - clip->GetPlayStartSample();
-
-            if (nClipLen <= 0) // Testing for bug 641, this problem is consistently '== 0', but doesn't hurt to check <.
-               return;
-
-            // This check prevents problem cited in http://bugzilla.audacityteam.org/show_bug.cgi?id=528#c11,
-            // Gale's cross_fade_out project, which was already corrupted by bug 528.
-            // This conditional prevents the previous write past the buffer end, in clip->GetEnvelope() call.
-            // Never increase rlen here.
-            // PRL bug 827:  rewrote it again
-            rlen = limitSampleBufferSize( rlen, nClipLen );
-            rlen = std::min(rlen, size_t(floor(0.5 + (dClipEndTime - rt0) / tstep)));
+         if (nClipLen <= 0) // Testing for bug 641, this problem is consistently '== 0', but doesn't hurt to check <.
+            break;
+
+         // This check prevents problem cited in http://bugzilla.audacityteam.org/show_bug.cgi?id=528#c11,
+         // Gale's cross_fade_out project, which was already corrupted by bug 528.
+         // This conditional prevents the previous write past the buffer end, in clip->GetEnvelope() call.
+         // Never increase rlen here.
+         // PRL bug 827:  rewrote it again
+         rlen = limitSampleBufferSize( rlen, nClipLen );
+         rlen = std::min(rlen, size_t(floor(0.5 + (dClipEndTime - rt0) / tstep)));
+      }
+      if (rlen == 0)
+         continue;
+
+      if (rstart > pos) {
+         segments.push_back({ rstart - pos, 1.0, 0.0, false });
+         pos = rstart;
+      }
+      // Samples are obtained for the purpose of rendering a wave track,
+      // so quantize time
+      const auto first = segments.size();
+      pClip->GetEnvelope()->AppendSegments(segments, rlen, rt0, tstep);
+
+      // Clips don't overlap, but in case rounding of their times did, drop
+      // what was already described
+      auto skip = pos - rstart;
+      auto iter = segments.begin() + first;
+      while (skip > 0 && iter != segments.end()) {
+         auto &segment = *iter;
+         if (segment.length <= skip) {
+            skip -= segment.length;
+            ++iter;
+            continue;
          }
-         // Samples are obtained for the purpose of rendering a wave track,
-         // so quantize time
-         clip->GetEnvelope()->GetValues(rbuf, rlen, rt0, tstep);
+         segment.value = segment.exponential
+            ? segment.value * pow(segment.step, skip)
+            : segment.value + skip * segment.step;
+         segment.length -= skip;
+         skip = 0;
       }
+      segments.erase(segments.begin() + first, iter);
+      pos = std::max(pos, rstart + rlen);
+   }
+   if (pos < bufferLen)
+      segments.push_back({ bufferLen - pos, 1.0, 0.0, false });
+
+   if (backwards) {
+      std::reverse(segments.begin(), segments.end());
+      for (auto &segment : segments)
+         segment = segment.Reversed();
    }
-   if (backwards)
-      std::reverse(buffer, buffer + bufferLen);
 }
 
 const WaveClip* WaveTrack::GetAdjacentClip(
@@ -622,6 +622,9 @@ public:
       double* buffer, size_t bufferLen, double t0,
       bool backwards) const override;
 
+   void GetEnvelopeSegments(Envelope::Segments &segments,
+      size_t bufferLen, double t0, bool backwards) const override;
+
    //
    // MM: We now have more than one sequence and envelope per track, so
    // instead of GetEnvelope() we have the following function which gives the
@@ -0,0 +1,164 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  MemorySampleBlock.cpp
+
+**********************************************************************/
+#include "MemorySampleBlock.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+//! Levels of samples as SqliteSampleBlock computes them
+MinMaxRMS Levels(const float* samples, size_t len)
+{
+   float min = FLT_MAX;
+   float max = -FLT_MAX;
+   float sumsq = 0;
+   for (size_t i = 0; i < len; ++i) {
+      const auto sample = samples[i];
+      min = std::min(min, sample);
+      max = std::max(max, sample);
+      sumsq += sample * sample;
+   }
+   return { min, max, len ? static_cast<float>(sqrt(sumsq / len)) : 0.0f };
+}
+}
+
+MemorySampleBlock::MemorySampleBlock(
+   SampleBlockID id, std::vector<float> samples)
+    : mId{ id }
+    , mSamples{ std::move(samples) }
+{
+}
+
+void MemorySampleBlock::CloseLock() noexcept
+{
+}
+
+SampleBlockID MemorySampleBlock::GetBlockID() const
+{
+   return mId;
+}
+
+size_t MemorySampleBlock::GetSampleCount() const
+{
+   return mSamples.size();
+}
+
+bool MemorySampleBlock::GetSummary256(
+   float* dest, size_t frameoffset, size_t numframes)
+{
+   GetSummary(dest, frameoffset, numframes, 256);
+   return true;
+}
+
+bool MemorySampleBlock::GetSummary64k(
+   float* dest, size_t frameoffset, size_t numframes)
+{
+   GetSummary(dest, frameoffset, numframes, 65536);
+   return true;
+}
+
+void MemorySampleBlock::GetSummary(
+   float* dest, size_t frameoffset, size_t numframes, size_t frameSize) const
+{
+   for (size_t ii = 0; ii < numframes; ++ii, dest += 3) {
+      const auto start = (frameoffset + ii) * frameSize;
+      if (mId < 0)
+         dest[0] = dest[1] = dest[2] = 0;
+      else if (start >= mSamples.size()) {
+         // Frames after the samples don't contribute, as in the database
+         dest[0] = FLT_MAX;
+         dest[1] = -FLT_MAX;
+         dest[2] = 0;
+      }
+      else {
+         const auto levels = Levels(mSamples.data() + start,
+            std::min(frameSize, mSamples.size() - start));
+         dest[0] = levels.min;
+         dest[1] = levels.max;
+         dest[2] = levels.RMS;
+      }
+   }
+}
+
+size_t MemorySampleBlock::GetSpaceUsage() const
+{
+   return mId < 0 ? 0 : mSamples.size() * sizeof(float);
+}
+
+void MemorySampleBlock::SaveXML(XMLWriter&)
+{
+}
+
+BlockSampleView MemorySampleBlock::GetFloatSampleView(bool)
+{
+   return std::make_shared<std::vector<float>>(mSamples);
+}
+
+size_t MemorySampleBlock::DoGetSamples(
+   samplePtr dest, sampleFormat destformat, size_t sampleoffset,
+   size_t numsamples)
+{
+   numsamples = std::min(numsamples, mSamples.size() - sampleoffset);
+   CopySamples(
+      reinterpret_cast<constSamplePtr>(mSamples.data() + sampleoffset),
+      floatSample, dest, destformat, numsamples);
+   return numsamples;
+}
+
+MinMaxRMS MemorySampleBlock::DoGetMinMaxRMS(size_t start, size_t len)
+{
+   if (mId < 0)
+      return {};
+   len = std::min(len, mSamples.size() - start);
+   return Levels(mSamples.data() + start, len);
+}
+
+MinMaxRMS MemorySampleBlock::DoGetMinMaxRMS() const
+{
+   if (mId < 0)
+      return {};
+   return Levels(mSamples.data(), mSamples.size());
+}
+
+auto MemorySampleBlockFactory::GetActiveBlockIDs() -> SampleBlockIDs
+{
+   SampleBlockIDs result;
+   for (const auto& wBlock : mBlocks)
+      if (const auto pBlock = wBlock.lock(); pBlock && pBlock->GetBlockID() > 0)
+         result.insert(pBlock->GetBlockID());
+   return result;
+}
+
+SampleBlockPtr MemorySampleBlockFactory::DoCreate(
+   constSamplePtr src, size_t numsamples, sampleFormat srcformat)
+{
+   std::vector<float> samples(numsamples);
+   SamplesToFloats(src, srcformat, samples.data(), numsamples);
+   auto result =
+      std::make_shared<MemorySampleBlock>(mNextId++, std::move(samples));
+   mBlocks.push_back(result);
+   return result;
+}
+
+SampleBlockPtr MemorySampleBlockFactory::DoCreateSilent(
+   size_t numsamples, sampleFormat)
+{
+   // Negative ids, as for silent blocks in the database
+   return std::make_shared<MemorySampleBlock>(
+      -static_cast<SampleBlockID>(numsamples),
+      std::vector<float>(numsamples));
+}
+
+SampleBlockPtr MemorySampleBlockFactory::DoCreateFromXML(
+   sampleFormat, const AttributesList&)
+{
+   return nullptr;
+}
@@ -0,0 +1,65 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  MemorySampleBlock.h
+
+**********************************************************************/
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "SampleBlock.h"
+
+//! Holds its samples as floats in memory, and computes its summaries and
+//! levels from them as SqliteSampleBlock does
+class MemorySampleBlock final : public SampleBlock
+{
+public:
+   //! A negative id makes a silent block
+   MemorySampleBlock(SampleBlockID id, std::vector<float> samples);
+
+   void CloseLock() noexcept override;
+   SampleBlockID GetBlockID() const override;
+   size_t GetSampleCount() const override;
+   bool
+   GetSummary256(float* dest, size_t frameoffset, size_t numframes) override;
+   bool
+   GetSummary64k(float* dest, size_t frameoffset, size_t numframes) override;
+   size_t GetSpaceUsage() const override;
+   void SaveXML(XMLWriter&) override;
+   BlockSampleView GetFloatSampleView(bool mayThrow) override;
+
+private:
+   size_t DoGetSamples(
+      samplePtr dest, sampleFormat destformat, size_t sampleoffset,
+      size_t numsamples) override;
+   MinMaxRMS DoGetMinMaxRMS(size_t start, size_t len) override;
+   MinMaxRMS DoGetMinMaxRMS() const override;
+
+   void GetSummary(
+      float* dest, size_t frameoffset, size_t numframes, size_t frameSize)
+      const;
+
+   const SampleBlockID mId;
+   const std::vector<float> mSamples;
+};
+
+class MemorySampleBlockFactory final : public SampleBlockFactory
+{
+public:
+   SampleBlockIDs GetActiveBlockIDs() override;
+
+private:
+   SampleBlockPtr DoCreate(
+      constSamplePtr src, size_t numsamples, sampleFormat srcformat) override;
+   SampleBlockPtr
+   DoCreateSilent(size_t numsamples, sampleFormat srcformat) override;
+   SampleBlockPtr DoCreateFromXML(
+      sampleFormat srcformat, const AttributesList& attrs) override;
+
+   std::vector<std::weak_ptr<SampleBlock>> mBlocks;
+   SampleBlockID mNextId = 1;
+};
@@ -0,0 +1,139 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  SequenceTests.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "MemoryX.h"
+#include "Sequence.h"
+
+#include "MemorySampleBlock.h"
+
+namespace
+{
+// Small blocks, so that a few thousand samples make several
+constexpr size_t MaxDiskBlockSize = 1024 * sizeof(float);
+constexpr size_t Length = 10000;
+
+std::vector<float> MakeSamples(size_t length, float scale)
+{
+   std::vector<float> samples(length);
+   for (size_t i = 0; i < length; ++i)
+      samples[i] = scale * ((i % 100) / 50.0f - 1.0f);
+   return samples;
+}
+
+std::vector<float> GetAll(const Sequence& sequence)
+{
+   std::vector<float> samples(sequence.GetNumSamples().as_size_t());
+   REQUIRE(sequence.Get(reinterpret_cast<samplePtr>(samples.data()),
+      floatSample, 0, samples.size(), true));
+   return samples;
+}
+
+//! What must not change in a sequence when a copy of it is edited
+struct Snapshot {
+   explicit Snapshot(const Sequence& sequence)
+       : numSamples{ sequence.GetNumSamples() }
+       , samples{ GetAll(sequence) }
+   {
+      for (const auto& block : sequence.GetBlockArray())
+         blocks.emplace_back(block.sb.get(), block.start);
+   }
+
+   bool operator==(const Snapshot& other) const
+   {
+      return numSamples == other.numSamples && blocks == other.blocks &&
+             samples == other.samples;
+   }
+
+   sampleCount numSamples;
+   std::vector<std::pair<const SampleBlock*, sampleCount>> blocks;
+   std::vector<float> samples;
+};
+}
+
+TEST_CASE("Copies of a Sequence share blocks until edited", "[Sequence]")
+{
+   Sequence::SetMaxDiskBlockSize(MaxDiskBlockSize);
+   auto cleanup = finally([]{ Sequence::SetMaxDiskBlockSize(1048576); });
+
+   const auto pFactory = std::make_shared<MemorySampleBlockFactory>();
+   Sequence original{ pFactory, SampleFormats{ floatSample, floatSample } };
+   const auto samples = MakeSamples(Length, 0.5f);
+   original.Append(reinterpret_cast<constSamplePtr>(samples.data()),
+      floatSample, samples.size(), 1, floatSample);
+   original.Flush();
+   REQUIRE(original.GetBlockArray().size() > 4);
+   const Snapshot before{ original };
+
+   const auto other = MakeSamples(300, 0.25f);
+   const auto pOther = reinterpret_cast<constSamplePtr>(other.data());
+   const auto middle = sampleCount{ Length / 2 };
+
+   using Edit = std::function<void(Sequence&)>;
+   const std::vector<std::pair<const char*, Edit>> edits{
+      { "Delete", [&](Sequence& copy){ copy.Delete(middle, 2000); } },
+      { "SetSamples", [&](Sequence& copy){
+         copy.SetSamples(pOther, floatSample, middle, other.size(),
+            floatSample);
+      } },
+      { "Append", [&](Sequence& copy){
+         copy.Append(pOther, floatSample, other.size(), 1, floatSample);
+         copy.Flush();
+      } },
+      { "InsertSilence", [&](Sequence& copy){
+         copy.InsertSilence(middle, 3000);
+      } },
+      { "Paste", [&](Sequence& copy){
+         const auto clipboard = copy.Copy(pFactory, 100, 2100);
+         copy.Paste(middle, clipboard.get());
+      } },
+      { "Mutable", [&](Sequence& copy){
+         // Replace the contents of one block, as an edit in place would
+         auto& blocks = copy.GetBlockArray();
+         const auto length = blocks[1].sb->GetSampleCount();
+         const auto replacement = MakeSamples(length, 0.75f);
+         blocks.Mutable(1).sb = pFactory->Create(
+            reinterpret_cast<constSamplePtr>(replacement.data()),
+            length, floatSample);
+      } },
+   };
+
+   for (const auto& [name, edit] : edits) {
+      DYNAMIC_SECTION(name << " of a copy")
+      {
+         SECTION("made by the copy constructor")
+         {
+            Sequence copy{ original, pFactory };
+            // The copy shares the array
+            REQUIRE(&copy.GetBlockArray()[0] == &original.GetBlockArray()[0]);
+            edit(copy);
+            REQUIRE(Snapshot{ original } == before);
+            REQUIRE(&copy.GetBlockArray()[0] != &original.GetBlockArray()[0]);
+         }
+         SECTION("made by Copy()")
+         {
+            const auto copy = original.Copy(pFactory, 0, Length);
+            edit(*copy);
+            REQUIRE(Snapshot{ original } == before);
+         }
+         SECTION("of the original")
+         {
+            // The other direction: edits of the original don't show in a copy
+            Sequence copy{ original, pFactory };
+            const Snapshot copyBefore{ copy };
+            edit(original);
+            REQUIRE(Snapshot{ copy } == copyBefore);
+         }
+      }
+   }
+}
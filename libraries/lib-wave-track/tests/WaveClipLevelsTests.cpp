@@ -0,0 +1,139 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  WaveClipLevelsTests.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "MemoryX.h"
+#include "Sequence.h"
+#include "WaveClip.h"
+
+#include "MemorySampleBlock.h"
+
+namespace
+{
+// Small blocks, so that a few thousand samples make several, each with a few
+// frames of the 256-sample summary
+constexpr size_t MaxDiskBlockSize = 1024 * sizeof(float);
+constexpr size_t Length = 20000;
+constexpr size_t SilenceLength = 2500;
+// A power of two, so that sample times are exact
+constexpr int Rate = 1024;
+
+//! A sine whose amplitude changes every few hundred samples
+std::vector<float> MakeSamples(size_t length, float scale)
+{
+   std::vector<float> samples(length);
+   for (size_t i = 0; i < length; ++i)
+      samples[i] = scale * std::sin(0.01 * i) * (0.2 + 0.2 * ((i / 777) % 5));
+   return samples;
+}
+
+void Append(WaveClip& clip, const std::vector<float>& samples)
+{
+   constSamplePtr buffers[]{
+      reinterpret_cast<constSamplePtr>(samples.data()) };
+   clip.Append(buffers, floatSample, samples.size(), 1, floatSample);
+   clip.Flush();
+}
+
+//! Regions starting and ending around block and frame boundaries, and some
+//! others at random
+std::vector<std::pair<sampleCount, sampleCount>> Regions(const WaveClip& clip)
+{
+   const auto& sequence = *clip.GetSequence(0);
+   const auto numSamples = sequence.GetNumSamples();
+   std::vector<std::pair<sampleCount, sampleCount>> regions;
+   const auto add = [&](sampleCount s0, sampleCount s1) {
+      s0 = std::max<sampleCount>(s0, 0);
+      s1 = std::min(s1, numSamples);
+      if (s0 < s1)
+         regions.emplace_back(s0, s1);
+   };
+
+   std::vector<sampleCount> boundaries;
+   for (const auto& block : sequence.GetBlockArray()) {
+      boundaries.push_back(block.start);
+      boundaries.push_back(block.start + 256);
+      boundaries.push_back(block.start + 512);
+   }
+   boundaries.push_back(numSamples);
+   for (const auto boundary : boundaries) {
+      add(boundary - 1, boundary + 1);
+      add(boundary, boundary + 255);
+      add(boundary + 1, boundary + 257);
+      add(boundary - 257, boundary + 513);
+      add(boundary - 700, boundary + 1500);
+   }
+   add(0, numSamples);
+
+   std::mt19937 engine{ 4242 };
+   for (size_t ii = 0; ii < 200; ++ii) {
+      const auto s0 = std::uniform_int_distribution<long long>{
+         0, numSamples.as_long_long() - 1 }(engine);
+      const auto s1 = std::uniform_int_distribution<long long>{
+         s0 + 1, numSamples.as_long_long() }(engine);
+      add(s0, s1);
+   }
+   return regions;
+}
+
+//! The clip's cache answers as the sequence does, reading samples
+void RequireSameLevels(const WaveClip& clip)
+{
+   const auto& sequence = *clip.GetSequence(0);
+   for (const auto& [s0, s1] : Regions(clip)) {
+      INFO("Samples " << s0.as_long_long() << " to " << s1.as_long_long());
+      const auto t0 = s0.as_double() / Rate;
+      const auto t1 = s1.as_double() / Rate;
+      const auto len = s1 - s0;
+      for (const auto mayThrow : { true, false }) {
+         REQUIRE(clip.GetMinMax(0, t0, t1, mayThrow) ==
+            sequence.GetMinMax(s0, len, mayThrow));
+         REQUIRE(clip.GetRMS(0, t0, t1, mayThrow) ==
+            Approx(sequence.GetRMS(s0, len, mayThrow))
+               .epsilon(1e-5).margin(1e-7));
+      }
+   }
+}
+}
+
+TEST_CASE("WaveClip levels agree with the Sequence", "[WaveClipLevels]")
+{
+   Sequence::SetMaxDiskBlockSize(MaxDiskBlockSize);
+   auto cleanup = finally([]{ Sequence::SetMaxDiskBlockSize(1048576); });
+
+   const auto pFactory = std::make_shared<MemorySampleBlockFactory>();
+   WaveClip clip{ 1, pFactory, floatSample, Rate, 0 };
+   Append(clip, MakeSamples(Length, 1.0f));
+   clip.InsertSilence(static_cast<double>(Length / 2) / Rate,
+      static_cast<double>(SilenceLength) / Rate);
+   REQUIRE(clip.GetSequence(0)->GetBlockArray().size() > 10);
+   RequireSameLevels(clip);
+
+   // Each edit must forget what the first queries cached
+   SECTION("After SetSamples")
+   {
+      // More extreme than anything before
+      const auto replacement = MakeSamples(3000, 3.0f);
+      clip.SetSamples(0, reinterpret_cast<constSamplePtr>(replacement.data()),
+         floatSample, Length / 4, replacement.size(), floatSample);
+      RequireSameLevels(clip);
+   }
+
+   SECTION("After Append")
+   {
+      Append(clip, MakeSamples(5000, 3.0f));
+      RequireSameLevels(clip);
+   }
+}
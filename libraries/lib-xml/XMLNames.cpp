@@ -0,0 +1,188 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  XMLNames.cpp
+
+**********************************************************************/
+
+#include "XMLNames.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+// Each name in the arena is preceded by its header
+struct Header
+{
+   XMLNames::Id id;
+   std::uint16_t length;
+};
+
+constexpr size_t ArenaSize = 16 * 1024;
+constexpr size_t MaxArenaNames = ArenaSize / (sizeof(Header) + 1);
+
+struct Entry
+{
+   std::string_view name;
+   XMLNames::Id id;
+};
+
+// Open addressing, kept at most half full, so that probes are short
+constexpr size_t TableSize = 4096;
+constexpr size_t MaxTableNames = TableSize / 2;
+
+struct Registry
+{
+   // Serializes Intern(); Find() and Stored() lock it only for names beyond
+   // the table, which ordinary use does not reach
+   std::mutex mutex;
+   // Neither deque relocates its elements
+   std::deque<Entry> entries;
+   // Names that did not fit in the arena
+   std::deque<std::string> overflow;
+   XMLNames::Id nextId{ XMLNames::Unknown + 1 };
+
+   // Slots are written once, under the mutex, and never cleared, so that
+   // lookups can probe them without locking
+   std::atomic<const Entry*> table[TableSize]{};
+   std::atomic<bool> crowded{ false };
+   std::unordered_map<std::string_view, XMLNames::Id> crowdedIds;
+
+   // Written under the mutex before used is released, and never again, so
+   // that Find() can read the arena without locking
+   char arena[ArenaSize];
+   std::atomic<const char*> starts[MaxArenaNames]{};
+   std::atomic<size_t> used{ 0 };
+
+   size_t Slot(std::string_view name) const
+   {
+      return std::hash<std::string_view>{}(name) & (TableSize - 1);
+   }
+
+   //! Lock-free
+   const Entry* Lookup(std::string_view name) const
+   {
+      for (auto slot = Slot(name);; slot = (slot + 1) & (TableSize - 1)) {
+         const auto pEntry = table[slot].load(std::memory_order_acquire);
+         if (!pEntry || pEntry->name == name)
+            return pEntry;
+      }
+   }
+
+   //! Only for names not found by Lookup()
+   std::optional<Entry> LookupCrowded(std::string_view name)
+   {
+      if (!crowded.load(std::memory_order_acquire))
+         return {};
+      std::lock_guard<std::mutex> lock{ mutex };
+      const auto iter = crowdedIds.find(name);
+      if (iter == crowdedIds.end())
+         return {};
+      return Entry{ iter->first, iter->second };
+   }
+
+   //! Call under the mutex
+   void Insert(const Entry& entry)
+   {
+      if (entries.size() >= MaxTableNames) {
+         crowdedIds.emplace(entry.name, entry.id);
+         crowded.store(true, std::memory_order_release);
+         return;
+      }
+      const auto pEntry = &entries.emplace_back(entry);
+      auto slot = Slot(entry.name);
+      while (table[slot].load(std::memory_order_relaxed))
+         slot = (slot + 1) & (TableSize - 1);
+      table[slot].store(pEntry, std::memory_order_release);
+   }
+};
+
+Registry& GetRegistry()
+{
+   static Registry registry;
+   return registry;
+}
+}
+
+XMLNames::Id XMLNames::Intern(std::string_view name)
+{
+   auto& registry = GetRegistry();
+   std::lock_guard<std::mutex> lock{ registry.mutex };
+
+   if (const auto pEntry = registry.Lookup(name))
+      return pEntry->id;
+   if (const auto iter = registry.crowdedIds.find(name);
+       iter != registry.crowdedIds.end())
+      return iter->second;
+
+   assert(registry.nextId != std::numeric_limits<Id>::max());
+   const auto id = registry.nextId++;
+
+   std::string_view stored;
+   const auto used = registry.used.load(std::memory_order_relaxed);
+   if (id < MaxArenaNames &&
+       name.size() <= std::numeric_limits<std::uint16_t>::max() &&
+       used + sizeof(Header) + name.size() <= ArenaSize)
+   {
+      const Header header{ id, static_cast<std::uint16_t>(name.size()) };
+      const auto pHeader = registry.arena + used;
+      const auto pName = pHeader + sizeof(Header);
+      std::memcpy(pHeader, &header, sizeof(Header));
+      std::memcpy(pName, name.data(), name.size());
+      registry.starts[id].store(pName, std::memory_order_relaxed);
+      registry.used.store(
+         used + sizeof(Header) + name.size(), std::memory_order_release);
+      stored = { pName, name.size() };
+   }
+   else
+      stored = registry.overflow.emplace_back(name);
+
+   registry.Insert({ stored, id });
+   return id;
+}
+
+XMLNames::Id XMLNames::Find(std::string_view name)
+{
+   auto& registry = GetRegistry();
+
+   // Names from Stored() are recognized by address
+   const auto pName = name.data();
+   const auto begin = registry.arena + sizeof(Header);
+   const auto end =
+      registry.arena + registry.used.load(std::memory_order_acquire);
+   const std::less<const char*> less;
+   if (!less(pName, begin) && less(pName, end))
+   {
+      Header header;
+      std::memcpy(&header, pName - sizeof(Header), sizeof(Header));
+      if (header.id < MaxArenaNames && header.length == name.size() &&
+          registry.starts[header.id].load(std::memory_order_relaxed) == pName)
+         return header.id;
+   }
+
+   if (const auto pEntry = registry.Lookup(name))
+      return pEntry->id;
+   if (const auto entry = registry.LookupCrowded(name))
+      return entry->id;
+   return Unknown;
+}
+
+std::string_view XMLNames::Stored(std::string_view name)
+{
+   auto& registry = GetRegistry();
+   if (const auto pEntry = registry.Lookup(name))
+      return pEntry->name;
+   if (const auto entry = registry.LookupCrowded(name))
+      return entry->name;
+   return {};
+}
@@ -0,0 +1,44 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  XMLNames.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_XML_NAMES__
+#define __AUDACITY_XML_NAMES__
+
+#include <cstdint>
+#include <string_view>
+
+//! Interned tag and attribute names, so that handlers can compare integers
+/*!
+ A handler interns the names it understands, once, in static initializers,
+ and compares the result of Find() for the names it is given.
+
+ A decoder that replaces each name of its document with the result of
+ Stored(), looked up once per name, makes Find() a constant time check of
+ the address.  For other names, as from XMLFileReader, Find() is a hash
+ lookup.  Neither takes a lock, unless thousands of names were interned.
+ */
+class XML_API XMLNames final
+{
+public:
+   using Id = std::uint16_t;
+
+   //! Find() returns this for names that were never interned
+   static constexpr Id Unknown = 0;
+
+   //! Equal names give equal ids, which are never Unknown
+   static Id Intern(std::string_view name);
+
+   //! Returns the id of a name, or Unknown
+   static Id Find(std::string_view name);
+
+   //! Returns the stored copy of an interned name, or an empty view
+   /*! The copy lives until the end of the program */
+   static std::string_view Stored(std::string_view name);
+};
+
+#endif
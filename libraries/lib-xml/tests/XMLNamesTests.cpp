@@ -0,0 +1,110 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  XMLNamesTests.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "XMLNames.h"
+
+namespace
+{
+std::string MakeName(const char* prefix, size_t ii)
+{
+   return prefix + std::to_string(ii);
+}
+}
+
+TEST_CASE("XMLNames", "[XMLNames]")
+{
+   const auto id = XMLNames::Intern("xmlnames-test");
+
+   SECTION("Equal names give equal ids")
+   {
+      REQUIRE(id != XMLNames::Unknown);
+      REQUIRE(XMLNames::Intern(std::string{ "xmlnames-test" }) == id);
+      REQUIRE(XMLNames::Intern("xmlnames-other") != id);
+   }
+
+   SECTION("Find looks up names by content")
+   {
+      const std::string copy{ "xmlnames-test" };
+      REQUIRE(XMLNames::Find(copy) == id);
+      REQUIRE(XMLNames::Find("xmlnames-never-interned") == XMLNames::Unknown);
+      // A prefix or extension of a name is another name
+      REQUIRE(XMLNames::Find("xmlnames-tes") == XMLNames::Unknown);
+      REQUIRE(XMLNames::Find("xmlnames-test2") == XMLNames::Unknown);
+      REQUIRE(XMLNames::Find("") == XMLNames::Unknown);
+   }
+
+   SECTION("Stored gives a lasting copy, which Find recognizes")
+   {
+      std::string name{ "xmlnames-test" };
+      const auto stored = XMLNames::Stored(name);
+      REQUIRE(stored == "xmlnames-test");
+      REQUIRE(stored.data() != name.data());
+      name.assign("overwritten");
+      REQUIRE(XMLNames::Stored("xmlnames-test").data() == stored.data());
+      REQUIRE(XMLNames::Find(stored) == id);
+      // A part of a stored name is not the name
+      REQUIRE(XMLNames::Find(stored.substr(1)) == XMLNames::Unknown);
+      REQUIRE(XMLNames::Find(stored.substr(0, 3)) == XMLNames::Unknown);
+      REQUIRE(XMLNames::Stored("xmlnames-never-interned").empty());
+   }
+
+   SECTION("Many names, beyond the arena and the table")
+   {
+      constexpr size_t Count = 5000;
+      std::vector<XMLNames::Id> ids;
+      for (size_t ii = 0; ii < Count; ++ii)
+         ids.push_back(XMLNames::Intern(MakeName("xmlnames-many-", ii)));
+      for (size_t ii = 0; ii < Count; ++ii) {
+         const auto name = MakeName("xmlnames-many-", ii);
+         REQUIRE(XMLNames::Intern(name) == ids[ii]);
+         REQUIRE(XMLNames::Find(name) == ids[ii]);
+         const auto stored = XMLNames::Stored(name);
+         REQUIRE(stored == name);
+         REQUIRE(XMLNames::Find(stored) == ids[ii]);
+      }
+      REQUIRE(XMLNames::Find("xmlnames-many-") == XMLNames::Unknown);
+   }
+}
+
+TEST_CASE("XMLNames lookups concurrent with interning", "[XMLNames]")
+{
+   constexpr size_t Count = 3000;
+   const auto id = XMLNames::Intern("xmlnames-concurrent");
+   std::atomic<bool> done{ false };
+   std::atomic<size_t> mismatches{ 0 };
+
+   std::vector<std::thread> readers;
+   for (size_t ii = 0; ii < 4; ++ii)
+      readers.emplace_back([&]{
+         const std::string name{ "xmlnames-concurrent" };
+         do {
+            if (XMLNames::Find(name) != id ||
+                XMLNames::Find(XMLNames::Stored(name)) != id)
+               ++mismatches;
+         } while (!done.load());
+      });
+
+   std::vector<XMLNames::Id> ids;
+   for (size_t ii = 0; ii < Count; ++ii)
+      ids.push_back(XMLNames::Intern(MakeName("xmlnames-concurrent-", ii)));
+   done.store(true);
+   for (auto& reader : readers)
+      reader.join();
+
+   REQUIRE(mismatches == 0);
+   for (size_t ii = 0; ii < Count; ++ii)
+      REQUIRE(
+         XMLNames::Find(MakeName("xmlnames-concurrent-", ii)) == ids[ii]);
+}
@@ -23,6 +23,13 @@ Licensed under the GNU General Public License v2 or later
 #include "FFmpeg.h"
 #include "FFmpegFunctions.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 #include <wx/log.h>
 #include <wx/window.h>
 
@@ -187,6 +194,107 @@ struct StreamContext final
    bool Use { true };
 };
 
+//! Samples decoded from one packet, with the progress after reading it
+struct DecodedPacket final
+{
+   StreamContext* Context { nullptr };
+
+   //! Taken from the codec context by the decoding thread, after decoding,
+   //! so that the importing thread need not read the codec context
+   int Channels { 0 };
+   sampleFormat Format { floatSample };
+
+   //! Only one of these is filled, depending on Format
+   std::vector<int16_t> Int16Data;
+   std::vector<float> FloatData;
+
+   wxInt64 ProgressPos { 0 };
+   wxInt64 ProgressLen { 1 };
+};
+
+//! Hands decoded packets from the decoding thread to the importing thread
+/*!
+ At most a bounded number of packets wait, so that the decoder can run ahead
+ of appending to the tracks, without holding the whole file in memory.
+ */
+class DecodedPacketQueue final
+{
+public:
+   explicit DecodedPacketQueue(size_t capacity)
+      : mCapacity{ capacity }
+   {
+   }
+
+   //! Called by the decoder; blocks while the queue is full
+   //! @return false if the consumer abandoned the queue
+   bool Push(DecodedPacket&& packet)
+   {
+      std::unique_lock<std::mutex> lock{ mMutex };
+      mCondition.wait(lock,
+         [this]{ return mAborted || mPackets.size() < mCapacity; });
+      if (mAborted)
+         return false;
+      mPackets.push_back(std::move(packet));
+      lock.unlock();
+      mCondition.notify_all();
+      return true;
+   }
+
+   //! Called by the decoder when no more packets will come
+   void Finish(std::exception_ptr error = {})
+   {
+      {
+         std::lock_guard<std::mutex> lock{ mMutex };
+         mFinished = true;
+         mError = error;
+      }
+      mCondition.notify_all();
+   }
+
+   //! Called by the consumer; blocks while the queue is empty
+   /*!
+    @return false when all packets were consumed
+    @throws whatever stopped the decoder
+    */
+   bool Pop(DecodedPacket& packet)
+   {
+      std::unique_lock<std::mutex> lock{ mMutex };
+      mCondition.wait(lock,
+         [this]{ return mFinished || !mPackets.empty(); });
+      if (mPackets.empty()) {
+         if (mError)
+            std::rethrow_exception(mError);
+         return false;
+      }
+      packet = std::move(mPackets.front());
+      mPackets.pop_front();
+      lock.unlock();
+      mCondition.notify_all();
+      return true;
+   }
+
+   //! Called by the consumer to make Push() fail from now on
+   void Abort()
+   {
+      {
+         std::lock_guard<std::mutex> lock{ mMutex };
+         mAborted = true;
+         mPackets.clear();
+      }
+      mCondition.notify_all();
+   }
+
+private:
+   const size_t mCapacity;
+
+   std::mutex mMutex;
+   std::condition_variable mCondition;
+   std::deque<DecodedPacket> mPackets;
+   std::exception_ptr mError;
+   bool mFinished { false };
+   bool mAborted { false };
+};
+
 ///! Does actual import, returned by FFmpegImportPlugin::Open
 class FFmpegImportFileHandle final : public ImportFileHandle
 {
@@ -217,9 +325,16 @@ public:
    
    void Stop() override;
    
-   ///! Writes decoded data into WaveTracks.
+   ///! Decodes a packet and updates the progress; called on the decoding thread
    ///\param sc - stream context
-   void WriteData(StreamContext* sc, const AVPacketWrapper* packet);
+   DecodedPacket DecodePacket(StreamContext* sc, const AVPacketWrapper* packet);
+
+   ///! Reads and decodes all packets, then flushes the decoders
+   ///\param queue - receives the decoded packets
+   void DecodeAll(DecodedPacketQueue& queue);
+
+   ///! Writes decoded data into WaveTracks.
+   void WriteData(const DecodedPacket& decoded);
 
    ///! Writes extracted metadata to tags object
    ///\param avf - file context
@@ -272,6 +387,10 @@ private:
 
    bool                  mCancelled = false;     //!< True if importing was canceled by user
    bool                  mStopped = false;       //!< True if importing was stopped by user
+   //! Tells the decoding thread to read no more packets; set on cancel or stop
+   std::atomic<bool>     mStopReading { false };
+   //! Tells the decoding thread not to flush the decoders
+   std::atomic<bool>     mSkipFlush { false };
    const FilePath        mName;
    std::vector<TrackListHolder> mStreams;
 };
@@ -383,6 +502,22 @@ bool FFmpegImportFileHandle::InitCodecs()
 
          auto codecContextPtr = stream->GetAVCodecContext();
 
+         // Let the decoder use all cores, for codecs that can.  Frame
+         // threading only delays output by some frames, which flushing at the
+         // end of the import recovers
+         const int threadCaps = codec->GetCapabilities() &
+            (AUDACITY_AV_CODEC_CAP_FRAME_THREADS |
+             AUDACITY_AV_CODEC_CAP_SLICE_THREADS);
+         if (threadCaps != 0)
+         {
+            codecContextPtr->SetThreadCount(0);
+            codecContextPtr->SetThreadType(
+               ((threadCaps & AUDACITY_AV_CODEC_CAP_FRAME_THREADS)
+                   ? AUDACITY_FF_THREAD_FRAME : 0) |
+               ((threadCaps & AUDACITY_AV_CODEC_CAP_SLICE_THREADS)
+                   ? AUDACITY_FF_THREAD_SLICE : 0));
+         }
+
          if ( codecContextPtr->Open( codecContextPtr->GetCodec() ) < 0 )
          {
             wxLogError(wxT("FFmpeg : Open() failed. Index[%02d], Codec[%02x - %s]"),i,id,name);
@@ -500,35 +635,48 @@ void FFmpegImportFileHandle::Import(ImportProgressListener& progressListener,
    }
 
    // This is the heart of the importing process
-   
-   // Read frames.
-   for (std::unique_ptr<AVPacketWrapper> packet;
-        (packet = mAVFormatContext->ReadNextPacket()) != nullptr &&
-        !mCancelled && !mStopped;)
-   {
-      // Find a matching StreamContext
-      auto streamContextIt = std::find_if(
-         mStreamContexts.begin(), mStreamContexts.end(),
-         [index = packet->GetStreamIndex()](const StreamContext& ctx)
-         { return ctx.StreamIndex == index;
-      });
-
-      if (streamContextIt == mStreamContexts.end())
-         continue;
 
-      WriteData(&(*streamContextIt), packet.get());
-      if(mProgressLen > 0)
-         progressListener.OnImportProgress(static_cast<double>(mProgressPos) /
-                                           static_cast<double>(mProgressLen));
-   }
-
-   // Flush the decoders.
-   if (!mStreamContexts.empty() && !mCancelled)
+   // Decoding and sample conversion run on another thread, while this one
+   // appends to the tracks, which may commit blocks to storage
+   mStopReading = false;
+   mSkipFlush = false;
+   DecodedPacketQueue queue{ 64 };
+   std::thread decoder{ [this, &queue]{
+      try {
+         DecodeAll(queue);
+         queue.Finish();
+      }
+      catch (...) {
+         queue.Finish(std::current_exception());
+      }
+   } };
+   auto cleanup = finally([&]{
+      // Also when appending throws
+      mStopReading = true;
+      mSkipFlush = true;
+      queue.Abort();
+      decoder.join();
+   });
+
+   for (DecodedPacket decoded; queue.Pop(decoded);)
    {
-      auto emptyPacket = mFFmpeg->CreateAVPacketWrapper();
+      WriteData(decoded);
+      if(decoded.ProgressLen > 0)
+         progressListener.OnImportProgress(
+            static_cast<double>(decoded.ProgressPos) /
+            static_cast<double>(decoded.ProgressLen));
 
-      for (StreamContext& sc : mStreamContexts)
-         WriteData(&sc, emptyPacket.get());
+      if (mCancelled)
+      {
+         // Discard what was decoded but not yet written
+         mSkipFlush = true;
+         mStopReading = true;
+         queue.Abort();
+         break;
+      }
+      else if (mStopped)
+         // Write what was decoded, and what flushing the decoders yields
+         mStopReading = true;
    }
 
    if(mCancelled)
@@ -564,8 +712,94 @@ void FFmpegImportFileHandle::Stop()
       mStopped = true;
 }
 
-void FFmpegImportFileHandle::WriteData(StreamContext *sc, const AVPacketWrapper* packet)
+void FFmpegImportFileHandle::DecodeAll(DecodedPacketQueue& queue)
+{
+   // Read frames.
+   for (std::unique_ptr<AVPacketWrapper> packet;
+        !mStopReading &&
+        (packet = mAVFormatContext->ReadNextPacket()) != nullptr;)
+   {
+      // Find a matching StreamContext
+      auto streamContextIt = std::find_if(
+         mStreamContexts.begin(), mStreamContexts.end(),
+         [index = packet->GetStreamIndex()](const StreamContext& ctx)
+         { return ctx.StreamIndex == index;
+      });
+
+      if (streamContextIt == mStreamContexts.end())
+         continue;
+
+      if (!queue.Push(DecodePacket(&(*streamContextIt), packet.get())))
+         return;
+   }
+
+   // Flush the decoders.
+   if (!mStreamContexts.empty() && !mSkipFlush)
+   {
+      auto emptyPacket = mFFmpeg->CreateAVPacketWrapper();
+
+      for (StreamContext& sc : mStreamContexts)
+         if (!queue.Push(DecodePacket(&sc, emptyPacket.get())))
+            return;
+   }
+}
+
+DecodedPacket FFmpegImportFileHandle::DecodePacket(
+   StreamContext *sc, const AVPacketWrapper* packet)
+{
+   DecodedPacket decoded;
+   decoded.Context = sc;
+   decoded.Format = sc->SampleFormat;
+
+   if (decoded.Format == int16Sample)
+      decoded.Int16Data = sc->CodecContext->DecodeAudioPacketInt16(packet);
+   else if (decoded.Format == floatSample)
+      decoded.FloatData = sc->CodecContext->DecodeAudioPacketFloat(packet);
+   decoded.Channels = sc->CodecContext->GetChannels();
+
+   const AVStreamWrapper* avStream = mAVFormatContext->GetStream(sc->StreamIndex);
+
+   int64_t filesize = mFFmpeg->avio_size(mAVFormatContext->GetAVIOContext()->GetWrappedValue());
+   // PTS (presentation time) is the proper way of getting current position
+   if (
+      packet->GetPresentationTimestamp() != AUDACITY_AV_NOPTS_VALUE &&
+      mAVFormatContext->GetDuration() != AUDACITY_AV_NOPTS_VALUE)
+   {
+      auto timeBase = avStream->GetTimeBase();
+
+      mProgressPos =
+         packet->GetPresentationTimestamp() * timeBase.num / timeBase.den;
+
+      mProgressLen =
+         (mAVFormatContext->GetDuration() > 0 ?
+             mAVFormatContext->GetDuration() / AUDACITY_AV_TIME_BASE :
+             1);
+   }
+   // When PTS is not set, use number of frames and number of current frame
+   else if (
+      avStream->GetFramesCount() > 0 && sc->CodecContext->GetFrameNumber() > 0 &&
+      sc->CodecContext->GetFrameNumber() <= avStream->GetFramesCount())
+   {
+      mProgressPos = sc->CodecContext->GetFrameNumber();
+      mProgressLen = avStream->GetFramesCount();
+   }
+   // When number of frames is unknown, use position in file
+   else if (
+      filesize > 0 && packet->GetPos() > 0 && packet->GetPos() <= filesize)
+   {
+      mProgressPos = packet->GetPos();
+      mProgressLen = filesize;
+   }
+
+   decoded.ProgressPos = mProgressPos;
+   decoded.ProgressLen = mProgressLen;
+   return decoded;
+}
+
+void FFmpegImportFileHandle::WriteData(const DecodedPacket& decoded)
 {
+   StreamContext* sc = decoded.Context;
+
    // Find the stream in mStreamContexts array
    auto streamIt = std::find_if(
       mStreamContexts.begin(),
@@ -581,13 +815,17 @@ void FFmpegImportFileHandle::WriteData(StreamContext *sc, const AVPacketWrapper*
    }
    auto stream = mStreams[std::distance(mStreamContexts.begin(), streamIt)];
 
-   const auto nChannels = std::min(sc->CodecContext->GetChannels(), sc->InitialChannels);
+   // Not sc->CodecContext, which the decoding thread may be using
+   const auto channelsCount = decoded.Channels;
+   const auto format = decoded.Format;
+   if (channelsCount <= 0)
+      return;
+   const auto nChannels = std::min(channelsCount, sc->InitialChannels);
 
    // Write audio into WaveTracks
-   if (sc->SampleFormat == int16Sample)
+   if (format == int16Sample)
    {
-      auto data = sc->CodecContext->DecodeAudioPacketInt16(packet);
-      const auto channelsCount = sc->CodecContext->GetChannels();
+      const auto& data = decoded.Int16Data;
       const auto samplesPerChannel = data.size() / channelsCount;
 
       unsigned chn = 0;
@@ -597,19 +835,18 @@ void FFmpegImportFileHandle::WriteData(StreamContext *sc, const AVPacketWrapper*
             return;
 
          channel.AppendBuffer(
-            reinterpret_cast<samplePtr>(data.data() + chn),
-            sc->SampleFormat,
+            reinterpret_cast<constSamplePtr>(data.data() + chn),
+            format,
             samplesPerChannel,
-            sc->CodecContext->GetChannels(),
-            sc->SampleFormat
+            channelsCount,
+            format
          );
          ++chn;
       });
    }
-   else if (sc->SampleFormat == floatSample)
+   else if (format == floatSample)
    {
-      auto data = sc->CodecContext->DecodeAudioPacketFloat(packet);
-      const auto channelsCount = sc->CodecContext->GetChannels();
+      const auto& data = decoded.FloatData;
       const auto samplesPerChannel = data.size() / channelsCount;
 
       auto channelIndex = 0;
@@ -619,48 +856,15 @@ void FFmpegImportFileHandle::WriteData(StreamContext *sc, const AVPacketWrapper*
             return;
 
          channel.AppendBuffer(
-            reinterpret_cast<samplePtr>(data.data() + channelIndex),
-            sc->SampleFormat,
+            reinterpret_cast<constSamplePtr>(data.data() + channelIndex),
+            format,
             samplesPerChannel,
-            sc->CodecContext->GetChannels(),
-            sc->SampleFormat
+            channelsCount,
+            format
          );
          ++channelIndex;
       });
    }
-   const AVStreamWrapper* avStream = mAVFormatContext->GetStream(sc->StreamIndex);
-
-   int64_t filesize = mFFmpeg->avio_size(mAVFormatContext->GetAVIOContext()->GetWrappedValue());
-   // PTS (presentation time) is the proper way of getting current position
-   if (
-      packet->GetPresentationTimestamp() != AUDACITY_AV_NOPTS_VALUE &&
-      mAVFormatContext->GetDuration() != AUDACITY_AV_NOPTS_VALUE)
-   {
-      auto timeBase = avStream->GetTimeBase();
-
-      mProgressPos =
-         packet->GetPresentationTimestamp() * timeBase.num / timeBase.den;
-
-      mProgressLen =
-         (mAVFormatContext->GetDuration() > 0 ?
-             mAVFormatContext->GetDuration() / AUDACITY_AV_TIME_BASE :
-             1);
-   }
-   // When PTS is not set, use number of frames and number of current frame
-   else if (
-      avStream->GetFramesCount() > 0 && sc->CodecContext->GetFrameNumber() > 0 &&
-      sc->CodecContext->GetFrameNumber() <= avStream->GetFramesCount())
-   {
-      mProgressPos = sc->CodecContext->GetFrameNumber();
-      mProgressLen = avStream->GetFramesCount();
-   }
-   // When number of frames is unknown, use position in file
-   else if (
-      filesize > 0 && packet->GetPos() > 0 && packet->GetPos() <= filesize)
-   {
-      mProgressPos = packet->GetPos();
-      mProgressLen = filesize;
-   }
 }
 
 void FFmpegImportFileHandle::WriteMetadata(Tags *tags)
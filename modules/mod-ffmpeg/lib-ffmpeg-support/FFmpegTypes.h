@@ -82,6 +82,11 @@
 #define AUDACITY_AV_CODEC_FLAG_QSCALE (1 << 1)
 
 #define AUDACITY_AV_CODEC_CAP_SMALL_LAST_FRAME    (1 <<  6)
+#define AUDACITY_AV_CODEC_CAP_FRAME_THREADS       (1 << 12)
+#define AUDACITY_AV_CODEC_CAP_SLICE_THREADS       (1 << 13)
+
+#define AUDACITY_FF_THREAD_FRAME 1
+#define AUDACITY_FF_THREAD_SLICE 2
 
 
 //#define FF_LAMBDA_SHIFT 7
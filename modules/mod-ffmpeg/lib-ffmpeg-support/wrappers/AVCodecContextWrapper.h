@@ -103,6 +103,14 @@ public:
    virtual int GetStrictStdCompliance() const noexcept = 0;
    virtual void SetStrictStdCompliance(int value) noexcept = 0;
 
+   //! Zero lets the library choose, by the number of cores
+   virtual int GetThreadCount() const noexcept = 0;
+   virtual void SetThreadCount(int value) noexcept = 0;
+
+   //! A combination of AUDACITY_FF_THREAD_FRAME and AUDACITY_FF_THREAD_SLICE
+   virtual int GetThreadType() const noexcept = 0;
+   virtual void SetThreadType(int value) noexcept = 0;
+
    virtual struct AudacityAVRational GetTimeBase() const noexcept = 0;
    virtual void SetTimeBase(struct AudacityAVRational value) noexcept = 0;
 
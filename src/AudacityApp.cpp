@@ -40,6 +40,7 @@ It handles initialization and termination by subclassing wxApp.
 #include <wx/fs_zip.h>
 
 #include <wx/dir.h>
+#include <wx/ffile.h>
 #include <wx/file.h>
 #include <wx/filename.h>
 
@@ -68,6 +69,7 @@ It handles initialization and termination by subclassing wxApp.
 #include "AColor.h"
 #include "AudacityFileConfig.h"
 #include "AudioIO.h"
+#include "BatchProcessor.h"
 #include "Benchmark.h"
 #include "Clipboard.h"
 #include "CommandLineArgs.h"
@@ -95,6 +97,7 @@ It handles initialization and termination by subclassing wxApp.
 #include "TempDirectory.h"
 #include "LoadThemeResources.h"
 #include "Track.h"
+#include "Tracing.h"
 #include "prefs/PrefsDialog.h"
 #include "Theme.h"
 #include "Viewport.h"
@@ -102,6 +105,7 @@ It handles initialization and termination by subclassing wxApp.
 #include "AutoRecoveryDialog.h"
 #include "SplashDialog.h"
 #include "FFT.h"
+#include "HeadlessBasicUI.h"
 #include "AudacityMessageBox.h"
 #include "prefs/DirectoriesPrefs.h"
 #include "prefs/GUISettings.h"
@@ -157,6 +161,7 @@ It handles initialization and termination by subclassing wxApp.
 
 #include "../images/Audacity-splash.xpm"
 
+#include <chrono>
 #include <thread>
 
 #include "ExportPluginRegistry.h"
@@ -489,6 +494,9 @@ void InitCrashreports()
 static bool gInited = false;
 static bool gIsQuitting = false;
 
+//! Approximately when the program started, for measuring startup time
+static const auto sLaunchTime = std::chrono::steady_clock::now();
+
 //Config instance that is set as current instance of `wxConfigBase`
 //and used to initialize `SettingsWX` objects created by
 //`audacity::ApplicationSettings` hook.
@@ -1361,21 +1369,39 @@ bool AudacityApp::OnInit()
    }
 #endif
 
+   // Parse the command line once, before the preferences, which may be
+   // elsewhere; the usage is given later, if it is not valid
+   mParser = ParseCommandLine(false);
+   if (mParser) {
+      mHeadless =
+         mParser->Found(wxT("macro")) || mParser->Found(wxT("commands"));
+
+      // A worker process of a macro batch has its own copy of the
+      // configuration files, so that workers never write the same files at
+      // once
+      wxString configDir;
+      if (mParser->Found(wxT("config-dir"), &configDir))
+         FileNames::SetConfigDirOverride(configDir);
+   }
+
    // Initialize preferences and language
    {
       InitPreferences(audacity::ApplicationSettings::Call());
       PopulatePreferences();
    }
 
-   mThemeChangeSubscription = theTheme.Subscribe(OnThemeChange);
+   // A headless batch draws nothing
+   if (!mHeadless) {
+      mThemeChangeSubscription = theTheme.Subscribe(OnThemeChange);
 
-   {
-      wxBusyCursor busy;
-      theTheme.LoadPreferredTheme();
-   }
+      {
+         wxBusyCursor busy;
+         theTheme.LoadPreferredTheme();
+      }
 
-   // AColor depends on theTheme.
-   AColor::Init();
+      // AColor depends on theTheme.
+      AColor::Init();
+   }
 
    // If this fails, we must exit the program.
    if (!InitTempDir()) {
@@ -1383,7 +1409,27 @@ bool AudacityApp::OnInit()
       return false;
    }
 
-   ThemeResources::Load();
+   // A headless batch does not take the lock on the temporary directory,
+   // so it gets a private one, unless the parent of a worker process already
+   // chose it
+   if (mParser) {
+      wxString tempDir;
+      if (!mParser->Found(wxT("temp-dir"), &tempDir) && mHeadless)
+         tempDir = mBatchTempDir = wxFileName{ TempDirectory::TempDir(),
+            wxString::Format(wxT("Batch-%lu"), wxGetProcessId())
+         }.GetFullPath();
+      if (!tempDir.empty())
+         TempDirectory::SetTempDirOverride(tempDir);
+   }
+
+   if (mHeadless) {
+      // No dialogs may block a batch that nobody watches
+      static HeadlessBasicUI headlessServices{ *BasicUI::Get() };
+      (void)BasicUI::Install(&headlessServices);
+      ReportStartupTime(wxT("preferences"));
+   }
+   else
+      ThemeResources::Load();
 
 #ifdef __WXMAC__
    // Bug2437:  When files are opened from Finder and another instance of
@@ -1421,7 +1467,8 @@ bool AudacityApp::InitPart2()
       auto key =
          PreferenceKey(FileNames::Operation::Temp, FileNames::PathType::_None);
       auto temp = gPrefs->Read(key);
-      if (temp.empty() || !CreateSingleInstanceChecker(temp)) {
+      if (temp.empty() ||
+          (!mHeadless && !CreateSingleInstanceChecker(temp))) {
          FinishPreferences();
          return false;
       }
@@ -1445,10 +1492,13 @@ bool AudacityApp::InitPart2()
       );
    });
 
-   // Parse command line and handle options that might require
+   if (mHeadless)
+      ReportStartupTime(wxT("modules and plug-ins"));
+
+   // Handle options that might require
    // immediate exit...no need to initialize all of the audio
    // stuff to display the version string.
-   std::shared_ptr< wxCmdLineParser > parser{ ParseCommandLine() };
+   const auto parser = GetCommandLine();
    if (!parser)
    {
       // Either user requested help or a parsing error occurred
@@ -1481,9 +1531,49 @@ bool AudacityApp::InitPart2()
       Sequence::SetMaxDiskBlockSize(lval);
    }
 
+   if (parser->Found(wxT("trace"), &mTracePath)) {
+      Tracing::SetThreadName("Main");
+      Tracing::Start();
+   }
+
    if (playingJournal)
       Journal::SetInputFileName( journalFileName );
 
+   if (mHeadless)
+   {
+      // Skip the splash screen, plug-in registration, update checking,
+      // auto-recovery and journalling; initialize only what importing,
+      // applying commands and exporting need
+      InitDitherers();
+      AudioIO::Init();
+      Importer::Get().Initialize();
+      ExportPluginRegistry::Get().Initialize();
+
+      CallAfter( [this] {
+         const auto parser = mParser.get();
+         ReportStartupTime(wxT("ready"));
+
+         BatchProcessor::Commands commands;
+         parser->Found(wxT("macro"), &commands.macroName);
+         parser->Found(wxT("commands"), &commands.listPath);
+         long jobs = BatchProcessor::GetDefaultMaxJobs();
+         parser->Found(wxT("jobs"), &jobs);
+         wxString reportPath;
+         parser->Found(wxT("report"), &reportPath);
+         FilePaths files;
+         for (size_t i = 0, cnt = parser->GetParamCount(); i < cnt; i++)
+            files.push_back(parser->GetParam(i));
+
+         mExitCode = BatchProcessor::RunCommandLine(
+            commands, std::max(1L, jobs), files, reportPath);
+         ReportStartupTime(wxT("finished"));
+         QuitAudacity(true);
+      } );
+
+      gInited = true;
+      return true;
+   }
+
    // BG: Create a temporary window to set as the top window
    wxImage logoimage((const char **)Audacity_splash_xpm);
    logoimage.Scale(logoimage.GetWidth() * (2.0/3.0), logoimage.GetHeight() * (2.0/3.0), wxIMAGE_QUALITY_HIGH);
@@ -1734,6 +1824,14 @@ bool AudacityApp::InitPart2()
    return TRUE;
 }
 
+void AudacityApp::ReportStartupTime(const wxChar *phase) const
+{
+   using namespace std::chrono;
+   const auto seconds =
+      duration<double>{ steady_clock::now() - sLaunchTime }.count();
+   wxFprintf(stderr, wxT("Startup: %s after %.3f s\n"), phase, seconds);
+}
+
 int AudacityApp::OnRun()
 {
    // Returns 0 to the command line if the run completed normally
@@ -1741,6 +1839,8 @@ int AudacityApp::OnRun()
    if (result == 0)
       // If not otherwise abnormal, report any journal sync failure
       result = Journal::GetExitCode();
+   if (result == 0)
+      result = mExitCode;
    return result;
 }
 
@@ -1916,9 +2016,9 @@ bool AudacityApp::CreateSingleInstanceChecker(const wxString &dir)
          return false;
    }
    else if ( checker->IsAnotherRunning() ) {
-      // Parse the command line to ensure correct syntax, but
+      // Check the command line for correct syntax, but
       // ignore options other than -v, and only use the filenames, if any.
-      auto parser = ParseCommandLine();
+      const auto parser = GetCommandLine();
       if (!parser)
       {
          // Complaints have already been made
@@ -2233,9 +2333,9 @@ bool AudacityApp::CreateSingleInstanceChecker(const wxString &dir)
       return false;
    }
 
-   // Parse the command line to ensure correct syntax, but ignore
+   // Check the command line for correct syntax, but ignore
    // options other than -v, and only use the filenames, if any.
-   auto parser = ParseCommandLine();
+   const auto parser = GetCommandLine();
    if (!parser)
    {
       // Complaints have already been made
@@ -2337,7 +2437,15 @@ void AudacityApp::OnSocketEvent(wxSocketEvent & evt)
 
 #endif
 
-std::unique_ptr<wxCmdLineParser> AudacityApp::ParseCommandLine()
+const wxCmdLineParser *AudacityApp::GetCommandLine()
+{
+   if (!mParser)
+      // Parse again only to give the usage, now in the chosen language
+      ParseCommandLine();
+   return mParser.get();
+}
+
+std::unique_ptr<wxCmdLineParser> AudacityApp::ParseCommandLine(bool giveUsage)
 {
    auto parser = std::make_unique<wxCmdLineParser>(argc, argv);
    if (!parser)
@@ -2368,6 +2476,36 @@ std::unique_ptr<wxCmdLineParser> AudacityApp::ParseCommandLine()
    /*i18n-hint: This displays the Audacity version */
    parser->AddSwitch(wxT("v"), wxT("version"), _("display Audacity version"));
 
+   /*i18n-hint: This applies a macro to the given files, without showing
+    *           any windows, and then exits */
+   parser->AddLongOption(wxT("macro"),
+      _("apply the named macro to each file without showing windows, then exit"));
+
+   /*i18n-hint: This applies commands listed in a text file to the given
+    *           files, without showing any windows, and then exits */
+   parser->AddLongOption(wxT("commands"),
+      _("like --macro, but read the commands from the given file"));
+
+   /*i18n-hint: Option to --macro for processing several files at once */
+   parser->AddLongOption(wxT("jobs"),
+      _("number of files to process at once with --macro or --commands"),
+      wxCMD_LINE_VAL_NUMBER);
+
+   /*i18n-hint: Option to --macro for saving results and logs to a file */
+   parser->AddLongOption(wxT("report"),
+      _("write a report of the files processed with --macro or --commands"));
+
+   // Used by the worker processes of a macro batch
+   parser->AddLongOption(wxT("temp-dir"), {}, wxCMD_LINE_VAL_STRING,
+      wxCMD_LINE_HIDDEN);
+   parser->AddLongOption(wxT("config-dir"), {}, wxCMD_LINE_VAL_STRING,
+      wxCMD_LINE_HIDDEN);
+
+   /*i18n-hint: Option for profiling; the file can be viewed in a web browser
+    *           with chrome://tracing or ui.perfetto.dev */
+   parser->AddLongOption(wxT("trace"),
+      _("record timings of audio, disk and drawing, and write them to the given file on exit"));
+
    /*i18n-hint: This is a list of one or more files that Audacity
     *           should open upon startup */
    parser->AddParam(_("audio or project file name"),
@@ -2380,7 +2518,7 @@ std::unique_ptr<wxCmdLineParser> AudacityApp::ParseCommandLine()
 #endif
 
    // Run the parser
-   if (parser->Parse() == 0)
+   if (parser->Parse(giveUsage) == 0)
       return parser;
 
    return{};
@@ -2427,6 +2565,14 @@ int AudacityApp::OnExit()
       Dispatch();
    }
 
+   if (!mTracePath.empty() && Tracing::IsStarted()) {
+      // Not fopen, which can't take every path on Windows
+      wxFFile file{ mTracePath, wxT("w") };
+      const bool written = Tracing::Stop(file.fp());
+      if (!(file.Close() && written))
+         wxPrintf(_("Could not write the trace to %s\n"), mTracePath);
+   }
+
    Importer::Get().Terminate();
 
    if(gPrefs)
@@ -2456,6 +2602,11 @@ int AudacityApp::OnExit()
    // Terminate the PluginManager (must be done before deleting the locale)
    PluginManager::Get().Terminate();
 
+   // Remove the private temporary directory of a headless batch; one given
+   // with --temp-dir belongs to the parent process, which removes it
+   if (!mBatchTempDir.empty() && wxFileName::DirExists(mBatchTempDir))
+      wxFileName::Rmdir(mBatchTempDir, wxPATH_RMDIR_RECURSIVE);
+
    return 0;
 }
 
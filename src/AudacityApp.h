@@ -121,7 +121,26 @@ class AudacityApp final : public wxApp {
    bool InitTempDir();
    bool CreateSingleInstanceChecker(const wxString &dir);
 
-   std::unique_ptr<wxCmdLineParser> ParseCommandLine();
+   std::unique_ptr<wxCmdLineParser> ParseCommandLine(bool giveUsage = true);
+   //! The command line as OnInit() parsed it, or null after giving the
+   //! usage, if it was not valid
+   const wxCmdLineParser *GetCommandLine();
+
+   //! Parsed once, at the start of OnInit()
+   std::unique_ptr<wxCmdLineParser> mParser;
+
+   //! Whether the command line asks to apply commands without any windows
+   bool mHeadless{ false };
+   //! Reported by OnRun() if nothing else went wrong
+   int mExitCode{ 0 };
+   //! Where to write the trace begun at startup, if any
+   wxString mTracePath;
+   //! The private temporary directory of a headless batch, if this process
+   //! chose it, rather than being given it with --temp-dir
+   FilePath mBatchTempDir;
+
+   //! Report the time since launch, when headless
+   void ReportStartupTime(const wxChar *phase) const;
 
 #if defined(__WXMSW__)
    std::unique_ptr<IPCServ> mIPCServ;
@@ -156,14 +156,30 @@ wxString MacroCommands::ReadMacro(const wxString & macro, wxWindow *parent)
       name.Assign(fn);
    }
 
+   if (!ReadCommandList(name.GetFullPath()))
+      return wxEmptyString;
+
+   // Write to macro directory if importing
+   if (parent) {
+      return WriteMacro(name.GetName());
+   }
+
+   return name.GetName();
+}
+
+bool MacroCommands::ReadCommandList(const FilePath &path)
+{
+   // Clear any previous macro
+   ResetMacro();
+
    // Set the file name
-   wxTextFile tf(name.GetFullPath());
+   wxTextFile tf(path);
 
    // Open and check
    tf.Open();
    if (!tf.IsOpened()) {
       // wxTextFile will display any errors
-      return wxEmptyString;
+      return false;
    }
 
    // Load commands from the file
@@ -190,12 +206,7 @@ wxString MacroCommands::ReadMacro(const wxString & macro, wxWindow *parent)
    // Done with the file
    tf.Close();
 
-   // Write to macro directory if importing
-   if (parent) {
-      return WriteMacro(name.GetName());
-   }
-
-   return name.GetName();
+   return true;
 }
 
 wxString MacroCommands::WriteMacro(const wxString & macro, wxWindow *parent)
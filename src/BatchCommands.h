@@ -96,6 +96,9 @@ class MacroCommands final {
 
    void RestoreMacro(const wxString & name);
    wxString ReadMacro(const wxString & macro, wxWindow *parent = nullptr);
+   //! Replace the macro with the lines of a text file, in the format in
+   //! which macros are saved
+   bool ReadCommandList(const FilePath &path);
    wxString WriteMacro(const wxString & macro, wxWindow *parent = nullptr);
    bool AddMacro(const wxString & macro);
    bool DeleteMacro(const wxString & name);
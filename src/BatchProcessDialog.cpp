@@ -33,7 +33,9 @@
 #include <wx/button.h>
 #include <wx/imaglist.h>
 #include <wx/settings.h>
+#include <wx/spinctrl.h>
 
+#include "BatchProcessor.h"
 #include "Clipboard.h"
 #include "ShuttleGui.h"
 #include "MenuCreator.h"
@@ -170,6 +172,9 @@ void ApplyMacroDialog::PopulateOrExchange(ShuttleGui &S)
       // so that name can be set on a standard control
       btn->SetAccessible(safenew WindowAccessible(btn));
 #endif
+
+      mJobs = S.AddSpinCtrl(XXO("Files at &once:"),
+         BatchProcessor::GetDefaultMaxJobs(), 64, 1);
    }
    S.EndHorizontalLay();
 
@@ -337,6 +342,8 @@ void ApplyMacroDialog::OnApplyToFiles(wxCommandEvent & WXUNUSED(event))
 
    wxString name = mMacros->GetItemText(item);
    gPrefs->Write(wxT("/Batch/ActiveMacro"), name);
+   if (mJobs)
+      BatchMaxJobs.Write(mJobs->GetValue());
    gPrefs->Flush();
 
    AudacityProject *project = &mProject;
@@ -453,36 +460,42 @@ void ApplyMacroDialog::OnApplyToFiles(wxCommandEvent & WXUNUSED(event))
       Clipboard::Scope scope;
 
       wxWindowDisabler wd(&activityWin);
-      for (i = 0; i < (int)files.size(); i++) {
-         if (i > 0) {
-            //Clear the arrow in previous item.
-            fileList->SetItemImage(i - 1, 0, 0);
-         }
-         fileList->SetItemImage(i, 1, 1);
-         fileList->EnsureVisible(i);
-
-         auto success = GuardedCall< bool >([&] {
-            ProjectFileManager::Get(*project).Import(files[i]);
-            Viewport::Get(*project).ZoomFitHorizontallyAndShowTrack(nullptr);
-            SelectUtilities::DoSelectAll(*project);
-            if (!mMacroCommands.ApplyMacro(mCatalog))
-               return false;
-
-            if (!activityWin.IsShown() || mAbort)
-               return false;
-
-            return true;
-         });
+      const auto maxJobs = BatchProcessor::GetDefaultMaxJobs();
+      if (maxJobs > 1 && files.size() > 1) {
+         // Worker processes do the files, each in its own invisible project
+         BatchProcessor processor{ { name }, maxJobs };
+         auto results = processor.Run(files,
+            [&](size_t index, const BatchProcessor::FileResult *pResult){
+               fileList->SetItemImage(index, pResult ? 0 : 1, pResult ? 0 : 1);
+               if (!pResult)
+                  fileList->EnsureVisible(index);
+               return activityWin.IsShown() && !mAbort &&
+                  (!pResult || pResult->success);
+            });
+
+         for (const auto &result : results)
+            if (!result.success && !result.log.empty()) {
+               AudacityMessageBox(
+                  XO("Applying the macro to %s failed:\n\n%s")
+                     .Format(result.path, result.log));
+               break;
+            }
+      }
+      else {
+         for (i = 0; i < (int)files.size(); i++) {
+            if (i > 0) {
+               //Clear the arrow in previous item.
+               fileList->SetItemImage(i - 1, 0, 0);
+            }
+            fileList->SetItemImage(i, 1, 1);
+            fileList->EnsureVisible(i);
 
-         // Ensure project is completely reset
-         ProjectManager::Get(*project).ResetProjectToEmpty();
-         // Bug2567:
-         // Must also destroy the clipboard, to be sure sample blocks are
-         // all freed and their ids can be reused safely in the next pass
-         globalClipboard.Clear();
+            auto success = BatchProcessor::ProcessFile(
+               *project, mMacroCommands, mCatalog, files[i]);
 
-         if (!success)
-            break;
+            if (!success || !activityWin.IsShown() || mAbort)
+               break;
+         }
       }
    }
 
@@ -702,6 +715,9 @@ void MacrosWindow::PopulateOrExchange(ShuttleGui & S)
       // so that name can be set on a standard control
       btn->SetAccessible(safenew WindowAccessible(btn));
 #endif
+
+      mJobs = S.AddSpinCtrl(XXO("Files at &once:"),
+         BatchProcessor::GetDefaultMaxJobs(), 64, 1);
       S.AddSpace( 10,10,1 );
       // Bug 2524 OK button does much the same as cancel, so remove it.
       // OnCancel prompts you if there has been a change.
@@ -23,6 +23,7 @@ class wxTextCtrl;
 class wxListCtrl;
 class wxListEvent;
 class wxButton;
+class wxSpinCtrl;
 class wxTextCtrl;
 class AudacityProject;
 class ShuttleGui;
@@ -55,6 +56,7 @@ class ApplyMacroDialog : public wxDialogWrapper {
    MacroCommands mMacroCommands; /// Provides list of available commands.
 
    wxButton *mResize;
+   wxSpinCtrl *mJobs{};
    wxButton *mOK;
    wxButton *mCancel;
    wxTextCtrl *mResults;
@@ -0,0 +1,431 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BatchProcessor.cpp
+
+*******************************************************************//**
+
+\class BatchProcessor
+\brief Applies a macro to many files, possibly several at once in
+invisible worker processes.
+
+*//*******************************************************************/
+#include "BatchProcessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <wx/filename.h>
+#include <wx/process.h>
+#include <wx/stream.h>
+#include <wx/textfile.h>
+#include <wx/tokenzr.h>
+#include <wx/utils.h>
+#include <wx/wxcrtvararg.h>
+
+#include "ActiveProject.h"
+#include "AudacityLogger.h"
+#include "BasicUI.h"
+#include "BatchCommands.h"
+#include "Clipboard.h"
+#include "FileNames.h"
+#include "MenuCreator.h"
+#include "PlatformCompatibility.h"
+#include "Project.h"
+#include "ProjectFileIO.h"
+#include "ProjectFileManager.h"
+#include "ProjectHistory.h"
+#include "ProjectManager.h"
+#include "ProjectWindows.h"
+#include "SelectUtilities.h"
+#include "TempDirectory.h"
+#include "Track.h"
+#include "Viewport.h"
+#include "WaveTrack.h"
+
+IntSetting BatchMaxJobs{ L"/Batch/MaxJobs", 1 };
+
+namespace {
+
+//! Collects the output of one worker and remembers how it ended
+class BatchWorkerProcess final : public wxProcess
+{
+public:
+   BatchWorkerProcess()
+   {
+#if defined(__WXMAC__)
+      // Don't want to crash on broken pipe
+      signal(SIGPIPE, SIG_IGN);
+#endif
+      Redirect();
+   }
+
+   bool IsActive() const { return mActive; }
+   int GetStatus() const { return mStatus; }
+   const wxString &GetOutput() const { return mOutput; }
+
+   void Drain()
+   {
+      Drain(GetInputStream());
+      Drain(GetErrorStream());
+   }
+
+   void OnTerminate(int WXUNUSED(pid), int status) override
+   {
+      Drain();
+      mStatus = status;
+      mActive = false;
+   }
+
+private:
+   void Drain(wxInputStream *s)
+   {
+      if (!s)
+         return;
+      while (s->CanRead()) {
+         char buffer[4096];
+         s->Read(buffer, WXSIZEOF(buffer));
+         mOutput += wxString::FromUTF8(buffer, s->LastRead());
+      }
+   }
+
+   wxString mOutput;
+   bool mActive{ true };
+   int mStatus{ -1 };
+};
+
+struct Job {
+   size_t index;
+   long pid;
+   std::unique_ptr<BatchWorkerProcess> pProcess;
+   FilePath tempDir;
+   std::chrono::steady_clock::time_point start;
+   bool killed{ false };
+};
+
+double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+   using namespace std::chrono;
+   return duration<double>{ steady_clock::now() - start }.count();
+}
+
+//! Give a worker its own copy of the configuration files, which are not
+//! safe for several processes to write at once
+void CopyConfiguration(const FilePath &configDir)
+{
+   FileNames::MkDir(configDir);
+   for (const auto &path : { FileNames::Configuration(),
+      FileNames::PluginRegistry(), FileNames::PluginSettings() }
+   ) {
+      const wxFileName source{ path };
+      if (source.FileExists())
+         wxCopyFile(path,
+            wxFileName{ configDir, source.GetFullName() }.GetFullPath());
+   }
+}
+
+//! As ProjectManager::ResetProjectToEmpty(), but for a project without a
+//! window, which ProjectManager and TrackUtilities would make
+void ResetWindowlessProject(AudacityProject &project)
+{
+   TrackList::Get(project).Clear();
+   WaveTrackFactory::Reset(project);
+
+   // InitialState will reset UndoManager
+   auto &history = ProjectHistory::Get(project);
+   history.InitialState();
+   history.SetDirty(false);
+
+   auto &fileManager = ProjectFileManager::Get(project);
+   fileManager.CloseProject();
+   fileManager.OpenProject();
+}
+
+}
+
+bool BatchProcessor::Commands::Read(MacroCommands &macroCommands) const
+{
+   if (!listPath.empty())
+      return macroCommands.ReadCommandList(listPath);
+   return !macroCommands.ReadMacro(macroName).empty();
+}
+
+wxString BatchProcessor::Commands::GetCommandLineOptions() const
+{
+   if (!listPath.empty())
+      return wxString::Format(wxT("--commands \"%s\""), listPath);
+   return wxString::Format(wxT("--macro \"%s\""), macroName);
+}
+
+wxString BatchProcessor::Commands::GetDescription() const
+{
+   if (!listPath.empty())
+      return wxString::Format(wxT("Commands: %s"), listPath);
+   return wxString::Format(wxT("Macro: %s"), macroName);
+}
+
+size_t BatchProcessor::GetDefaultMaxJobs()
+{
+   const auto jobs = BatchMaxJobs.Read();
+   if (jobs > 0)
+      return jobs;
+   return std::max(1u, std::thread::hardware_concurrency());
+}
+
+bool BatchProcessor::ProcessFile(AudacityProject &project,
+   MacroCommands &macroCommands, const MacroCommandsCatalog &catalog,
+   const FilePath &file)
+{
+   auto success = GuardedCall< bool >([&] {
+      const wxFileName fn{ file };
+      if (fn.GetExt().IsSameAs(wxT("aup3"), false)) {
+         if (!ProjectFileManager::ImportProject(project, file))
+            return false;
+         // As ProjectFileManager::Import() does for other files, so that
+         // exports are named after this file and do not prompt for a name
+         project.SetProjectName(fn.GetName());
+         project.SetInitialImportPath(fn.GetPath());
+         ProjectFileIO::Get(project).SetProjectTitle();
+         ProjectHistory::Get(project).PushState(
+            XO("Imported '%s'").Format(file), XO("Import"));
+      }
+      else
+         ProjectFileManager::Get(project).Import(file);
+      Viewport::Get(project).ZoomFitHorizontallyAndShowTrack(nullptr);
+      SelectUtilities::DoSelectAll(project);
+      return macroCommands.ApplyMacro(catalog);
+   });
+
+   // Ensure project is completely reset
+   if (FindProjectFrame(&project))
+      ProjectManager::Get(project).ResetProjectToEmpty();
+   else
+      ResetWindowlessProject(project);
+   // Bug2567:
+   // Must also destroy the clipboard, to be sure sample blocks are
+   // all freed and their ids can be reused safely in the next pass
+   Clipboard::Get().Clear();
+
+   return success;
+}
+
+int BatchProcessor::RunCommandLine(const Commands &commands, size_t maxJobs,
+   const FilePaths &files, const FilePath &reportPath)
+{
+   FileResults results;
+   if (maxJobs > 1 && files.size() > 1) {
+      BatchProcessor processor{ commands, maxJobs };
+      results = processor.Run(files,
+         [](size_t, const FileResult *pResult){
+            if (pResult)
+               wxPrintf(wxT("%s\t%.3f\t%s\n"),
+                  pResult->success ? wxT("OK") : wxT("FAILED"),
+                  pResult->seconds, pResult->path);
+            return true;
+         });
+   }
+   else {
+      // The same sequence of steps as in ApplyMacroDialog, but in a project
+      // that has no window, and commands but no menus
+      InvisibleTemporaryProject temp;
+      auto &project = temp.Project();
+      MenuCreator::Get(project).CreateCommands();
+      if (!ProjectFileManager::Get(project).OpenProject()) {
+         wxFprintf(stderr, wxT("Could not open a temporary project.\n"));
+         return 1;
+      }
+      ProjectHistory::Get(project).InitialState();
+      SetActiveProject(&project);
+
+      MacroCommands macroCommands{ project };
+      if (!commands.Read(macroCommands)) {
+         wxFprintf(stderr, wxT("Could not read the commands. %s\n"),
+            commands.GetDescription());
+         return 1;
+      }
+      const MacroCommandsCatalog catalog{ &project };
+
+      // Move global clipboard contents aside temporarily
+      Clipboard::Scope scope;
+
+      const auto logger = AudacityLogger::Get();
+      for (const auto &file : files) {
+         auto &result = results.emplace_back();
+         result.path = file;
+         const auto logStart = logger ? logger->GetBuffer().length() : 0;
+         const auto start = std::chrono::steady_clock::now();
+         result.success =
+            ProcessFile(project, macroCommands, catalog, file);
+         result.seconds = SecondsSince(start);
+         if (logger)
+            result.log = logger->GetBuffer().Mid(logStart);
+
+         if (files.size() == 1)
+            // Presumably a worker; let the parent collect the log
+            wxPrintf(wxT("%s"), result.log);
+         else
+            wxPrintf(wxT("%s\t%.3f\t%s\n"),
+               result.success ? wxT("OK") : wxT("FAILED"),
+               result.seconds, result.path);
+      }
+   }
+
+   if (!reportPath.empty() &&
+       !WriteReport(reportPath, commands, results)) {
+      wxFprintf(stderr, wxT("Could not write report: %s\n"), reportPath);
+      return 1;
+   }
+
+   const auto allSucceeded = std::all_of(results.begin(), results.end(),
+      [](const FileResult &result){ return result.success; });
+   return allSucceeded ? 0 : 1;
+}
+
+bool BatchProcessor::WriteReport(const FilePath &reportPath,
+   const Commands &commands, const FileResults &results)
+{
+   wxTextFile tf(reportPath);
+   if (tf.Exists() ? !tf.Open() : !tf.Create())
+      return false;
+   tf.Clear();
+
+   size_t failures = 0;
+   for (const auto &result : results)
+      if (!result.success)
+         ++failures;
+
+   tf.AddLine(commands.GetDescription());
+   tf.AddLine(wxString::Format(wxT("Files: %zu, failed: %zu"),
+      results.size(), failures));
+   tf.AddLine({});
+   for (const auto &result : results)
+      tf.AddLine(wxString::Format(wxT("%s\t%.3f\t%s"),
+         result.success ? wxT("OK") : wxT("FAILED"),
+         result.seconds,
+         result.path));
+
+   for (const auto &result : results) {
+      if (result.log.empty())
+         continue;
+      tf.AddLine({});
+      tf.AddLine(wxString::Format(wxT("---- %s (status %d)"),
+         result.path, result.status));
+      wxStringTokenizer lines{ result.log, wxT("\r\n"), wxTOKEN_STRTOK };
+      while (lines.HasMoreTokens())
+         tf.AddLine(lines.GetNextToken());
+   }
+
+   const auto written = tf.Write();
+   tf.Close();
+   return written;
+}
+
+BatchProcessor::BatchProcessor(const Commands &commands, size_t maxJobs)
+   : mCommands{ commands }
+   , mMaxJobs{ std::max<size_t>(1, maxJobs) }
+{
+}
+
+auto BatchProcessor::Run(
+   const FilePaths &files, const ProgressCallback &callback) -> FileResults
+{
+   FileResults results(files.size());
+   for (size_t ii = 0; ii < files.size(); ++ii)
+      results[ii].path = files[ii];
+
+   // Each worker gets a private temporary directory, because names of
+   // unsaved projects are unique only within one process
+   const auto batchDir = wxFileName{ TempDirectory::TempDir(),
+      wxString::Format(wxT("Batch-%lu"), wxGetProcessId()) }.GetFullPath();
+
+   // Workers start from the preferences as they are now
+   gPrefs->Flush();
+
+   std::vector<Job> running;
+   size_t next = 0;
+   bool cancelled = false;
+
+   auto startJob = [&](size_t index) {
+      auto &result = results[index];
+      auto tempDir = wxFileName{ batchDir,
+         wxString::Format(wxT("%zu"), index) }.GetFullPath();
+
+      const auto configDir =
+         wxFileName{ tempDir, wxT("Config") }.GetFullPath();
+      CopyConfiguration(configDir);
+
+      const auto cmd = wxString::Format(
+         wxT("\"%s\" %s --temp-dir \"%s\" --config-dir \"%s\" \"%s\""),
+         PlatformCompatibility::GetExecutablePath(),
+         mCommands.GetCommandLineOptions(), tempDir, configDir, result.path);
+
+      auto pProcess = std::make_unique<BatchWorkerProcess>();
+      const auto start = std::chrono::steady_clock::now();
+      const auto pid =
+         wxExecute(cmd, wxEXEC_ASYNC | wxEXEC_HIDE_CONSOLE, pProcess.get());
+      if (pid == 0) {
+         pProcess->Detach();
+         pProcess->CloseOutput();
+         result.success = false;
+         result.log = XO("Could not start a worker process: %s")
+            .Format(cmd).Translation();
+         if (callback && !callback(index, &result))
+            cancelled = true;
+         return;
+      }
+      running.push_back(
+         { index, pid, std::move(pProcess), tempDir, start });
+   };
+
+   auto finishJob = [&](Job &job) {
+      auto &result = results[job.index];
+      auto &process = *job.pProcess;
+      result.status = process.GetStatus();
+      result.success = (result.status == 0);
+      result.seconds = SecondsSince(job.start);
+      result.log = process.GetOutput();
+      wxFileName::Rmdir(job.tempDir, wxPATH_RMDIR_RECURSIVE);
+      if (callback && !callback(job.index, &result))
+         cancelled = true;
+   };
+
+   while (!running.empty() || (!cancelled && next < files.size())) {
+      while (!cancelled && next < files.size() && running.size() < mMaxJobs) {
+         const auto index = next++;
+         if (callback && !callback(index, nullptr)) {
+            cancelled = true;
+            break;
+         }
+         startJob(index);
+      }
+
+      // Keep the pipes from filling, which would stall the workers
+      for (auto &job : running)
+         job.pProcess->Drain();
+
+      const auto end = std::partition(running.begin(), running.end(),
+         [](const Job &job){ return job.pProcess->IsActive(); });
+      for (auto iter = end; iter != running.end(); ++iter)
+         finishJob(*iter);
+      running.erase(end, running.end());
+
+      if (cancelled)
+         for (auto &job : running)
+            if (!job.killed) {
+               wxProcess::Kill(job.pid, wxSIGTERM, wxKILL_CHILDREN);
+               job.killed = true;
+            }
+
+      if (!running.empty()) {
+         using namespace std::chrono;
+         std::this_thread::sleep_for(10ms);
+         // Allows delivery of process termination events
+         BasicUI::Yield();
+      }
+   }
+
+   wxFileName::Rmdir(batchDir, wxPATH_RMDIR_RECURSIVE);
+   return results;
+}
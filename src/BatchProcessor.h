@@ -0,0 +1,115 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BatchProcessor.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_BATCH_PROCESSOR__
+#define __AUDACITY_BATCH_PROCESSOR__
+
+#include <functional>
+#include <vector>
+
+#include "Identifier.h" // for FilePath, FilePaths
+#include "Prefs.h"
+
+class AudacityProject;
+class MacroCommands;
+class MacroCommandsCatalog;
+
+//! Maximum number of files that one application of a macro processes at once
+extern IntSetting BatchMaxJobs;
+
+/*! @class BatchProcessor
+ @brief Applies a macro to a list of files, each in its own invisible
+ project
+
+ When more than one job is allowed, each file is handed to a worker
+ instance of Audacity (started with the `--macro` or `--commands` command line
+ option) with a private temporary directory, so that the projects are isolated from one
+ another and from the interactive one.  Each worker follows exactly the same
+ steps as ProcessFile(), so results do not depend on the number of jobs.
+ */
+class BatchProcessor final
+{
+public:
+   //! What to apply: a macro as saved by the Macros dialog, or else a text
+   //! file of commands in the same format
+   struct Commands {
+      wxString macroName;
+      FilePath listPath;
+
+      //! @return false if the macro or file could not be read
+      bool Read(MacroCommands &macroCommands) const;
+      //! Options that make a worker process apply the same commands
+      wxString GetCommandLineOptions() const;
+      wxString GetDescription() const;
+   };
+
+   //! Outcome of the macro for one file
+   struct FileResult {
+      FilePath path;
+      bool success{ false };
+      //! Exit status of the worker process, or 0 if processed in-process
+      int status{ 0 };
+      double seconds{ 0 };
+      //! Log output captured while the file was processed
+      wxString log;
+   };
+   using FileResults = std::vector<FileResult>;
+
+   //! Called on the main thread as each file starts (pResult null) and ends
+   /*! @return false to cancel the files not yet finished */
+   using ProgressCallback =
+      std::function<bool(size_t index, const FileResult *pResult)>;
+
+   //! Number of jobs given by preferences, in which 0 means one per core
+   static size_t GetDefaultMaxJobs();
+
+   //! Import one file into an empty project, apply the macro, and then
+   //! reset the project to empty again
+   /*!
+    This is the serial path, also followed by each worker process.  The
+    tracks of an .aup3 file are copied, leaving the file unchanged.
+    @return whether the macro succeeded
+    */
+   static bool ProcessFile(AudacityProject &project,
+      MacroCommands &macroCommands, const MacroCommandsCatalog &catalog,
+      const FilePath &file);
+
+   //! Carry out the `--macro` or `--commands` command line option, without
+   //! any windows
+   /*!
+    A worker process started by Run() is given one file and writes the log
+    of it to standard output.
+    @return exit code for the application
+    */
+   static int RunCommandLine(const Commands &commands, size_t maxJobs,
+      const FilePaths &files, const FilePath &reportPath);
+
+   //! Write a summary, then the log of each file
+   static bool WriteReport(const FilePath &reportPath,
+      const Commands &commands, const FileResults &results);
+
+   /*!
+    @param maxJobs at least one
+    */
+   BatchProcessor(const Commands &commands, size_t maxJobs);
+
+   //! Process all files in worker processes, at most maxJobs at a time
+   /*!
+    Does not return until all workers finish.  Files skipped because of
+    cancellation have results with success false and an empty log.
+    @return results in the order of `files`
+    */
+   FileResults Run(
+      const FilePaths &files, const ProgressCallback &callback = {});
+
+private:
+   const Commands mCommands;
+   const size_t mMaxJobs;
+};
+
+#endif
@@ -272,10 +272,11 @@ const ReservedCommandFlag&
    NotMinimizedFlag() { static ReservedCommandFlag flag{
       [](const AudacityProject &project){
          const wxWindow *focus = FindProjectFrame( &project );
-         if (focus) {
-            while (focus && focus->GetParent())
-               focus = focus->GetParent();
-         }
+         if (!focus)
+            // A project without a window, as in a headless batch
+            return true;
+         while (focus && focus->GetParent())
+            focus = focus->GetParent();
          return (focus &&
             !static_cast<const wxTopLevelWindow*>(focus)->IsIconized()
          );
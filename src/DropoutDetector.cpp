@@ -19,6 +19,7 @@ Paul Licameli split from ProjectAudioManager.cpp
 #include "widgets/Warning.h"
 #include <wx/app.h>
 #include <wx/frame.h>
+#include <wx/log.h>
 
 namespace {
 struct DropoutSubscription : ClientData::Base {
@@ -26,6 +27,12 @@ struct DropoutSubscription : ClientData::Base {
    {
       mSubscription = ProjectAudioManager::Get(project).Subscribe(
       [&project](const RecordingDropoutEvent &evt){
+         wxLogMessage(
+            wxT("Recording filled at most %.0f%% of the capture buffers"),
+            100 * evt.captureHighWater);
+         if (evt.intervals.empty())
+            return;
+
          // Make a track with labels for recording errors
          auto &tracks = TrackList::Get( project );
 
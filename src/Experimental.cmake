@@ -178,6 +178,11 @@ set( EXPERIMENTAL_OPTIONS_LIST
 
    # PRL 31 July 2018
    DRAGGABLE_PLAY_HEAD
+
+   # Report heap allocations on the audio threads during playback, and fail
+   # an assertion in debug builds, to prove that the realtime path does not
+   # allocate.  See RealtimeArena.h
+   #REALTIME_ALLOCATION_TRAP
 )
 
 # Some more flags that depend on other configuration options
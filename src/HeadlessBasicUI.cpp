@@ -0,0 +1,120 @@
+/*!********************************************************************
+
+Audacity: A Digital Audio Editor
+
+@file HeadlessBasicUI.cpp
+
+**********************************************************************/
+#include "HeadlessBasicUI.h"
+
+#include <wx/wxcrtvararg.h>
+
+#include "Internat.h"
+
+using namespace BasicUI;
+
+namespace {
+void Report(const TranslatableString &title, const TranslatableString &message)
+{
+   wxFprintf(stderr, wxT("%s: %s\n"),
+      title.Translation(), message.Translation());
+}
+
+class HeadlessProgressDialog final : public ProgressDialog
+{
+public:
+   ProgressResult Poll(unsigned long long, unsigned long long,
+      const TranslatableString &) override
+   {
+      return ProgressResult::Success;
+   }
+   void SetMessage(const TranslatableString &) override {}
+   void SetDialogTitle(const TranslatableString &) override {}
+   void Reinit() override {}
+};
+
+class HeadlessGenericProgressDialog final : public GenericProgressDialog
+{
+public:
+   void Pulse() override {}
+};
+}
+
+HeadlessBasicUI::HeadlessBasicUI(Services &services)
+   : mServices{ services }
+{
+}
+
+HeadlessBasicUI::~HeadlessBasicUI() = default;
+
+void HeadlessBasicUI::DoCallAfter(const Action &action)
+{
+   mServices.DoCallAfter(action);
+}
+
+void HeadlessBasicUI::DoYield()
+{
+   mServices.DoYield();
+}
+
+void HeadlessBasicUI::DoShowErrorDialog(const WindowPlacement &,
+   const TranslatableString &dlogTitle, const TranslatableString &message,
+   const ManualPageID &, const ErrorDialogOptions &options)
+{
+   Report(dlogTitle, message);
+   if (!options.log.empty())
+      wxFprintf(stderr, wxT("%s\n"), wxString{ options.log });
+}
+
+MessageBoxResult HeadlessBasicUI::DoMessageBox(
+   const TranslatableString &message, MessageBoxOptions options)
+{
+   Report(options.caption, message);
+   if (options.buttonStyle != Button::YesNo)
+      return MessageBoxResult::Ok;
+   // There is nobody to answer, so take the default
+   return options.yesOrOkDefaultButton
+      ? MessageBoxResult::Yes : MessageBoxResult::No;
+}
+
+std::unique_ptr<ProgressDialog> HeadlessBasicUI::DoMakeProgress(
+   const TranslatableString &, const TranslatableString &, unsigned,
+   const TranslatableString &)
+{
+   return std::make_unique<HeadlessProgressDialog>();
+}
+
+std::unique_ptr<GenericProgressDialog> HeadlessBasicUI::DoMakeGenericProgress(
+   const WindowPlacement &, const TranslatableString &,
+   const TranslatableString &)
+{
+   return std::make_unique<HeadlessGenericProgressDialog>();
+}
+
+int HeadlessBasicUI::DoMultiDialog(const TranslatableString &message,
+   const TranslatableString &title, const TranslatableStrings &,
+   const ManualPageID &, const TranslatableString &, bool)
+{
+   Report(title, message);
+   // Choose the first button, as a dialog would by default
+   return 0;
+}
+
+bool HeadlessBasicUI::DoOpenInDefaultBrowser(const wxString &)
+{
+   return false;
+}
+
+std::unique_ptr<WindowPlacement> HeadlessBasicUI::DoFindFocus()
+{
+   return std::make_unique<WindowPlacement>();
+}
+
+void HeadlessBasicUI::DoSetFocus(const WindowPlacement &)
+{
+}
+
+bool HeadlessBasicUI::IsUsingRtlLayout() const
+{
+   return mServices.IsUsingRtlLayout();
+}
@@ -0,0 +1,62 @@
+/*!********************************************************************
+
+Audacity: A Digital Audio Editor
+
+@file HeadlessBasicUI.h
+@brief BasicUI services for running without windows
+
+**********************************************************************/
+#ifndef __AUDACITY_HEADLESS_BASIC_UI__
+#define __AUDACITY_HEADLESS_BASIC_UI__
+
+#include "BasicUI.h"
+
+//! Decorates other BasicUI::Services so that no dialog is ever shown
+/*!
+ Messages and errors are written to standard error, questions take their
+ default answers, and progress indicators never cancel.  Event loop services
+ are delegated.
+ */
+class HeadlessBasicUI final : public BasicUI::Services {
+public:
+   explicit HeadlessBasicUI(BasicUI::Services &services);
+   ~HeadlessBasicUI() override;
+
+protected:
+   void DoCallAfter(const BasicUI::Action &action) override;
+   void DoYield() override;
+   void DoShowErrorDialog(const BasicUI::WindowPlacement &placement,
+      const TranslatableString &dlogTitle,
+      const TranslatableString &message,
+      const ManualPageID &helpPage,
+      const BasicUI::ErrorDialogOptions &options) override;
+   BasicUI::MessageBoxResult DoMessageBox(
+      const TranslatableString &message,
+      BasicUI::MessageBoxOptions options) override;
+   std::unique_ptr<BasicUI::ProgressDialog>
+   DoMakeProgress(const TranslatableString & title,
+      const TranslatableString &message,
+      unsigned flags,
+      const TranslatableString &remainingLabelText) override;
+   std::unique_ptr<BasicUI::GenericProgressDialog>
+   DoMakeGenericProgress(const BasicUI::WindowPlacement &placement,
+      const TranslatableString &title,
+      const TranslatableString &message) override;
+   int DoMultiDialog(const TranslatableString &message,
+      const TranslatableString &title,
+      const TranslatableStrings &buttons,
+      const ManualPageID &helpPage,
+      const TranslatableString &boxMsg, bool log) override;
+
+   bool DoOpenInDefaultBrowser(const wxString &url) override;
+
+   std::unique_ptr<BasicUI::WindowPlacement> DoFindFocus() override;
+   void DoSetFocus(const BasicUI::WindowPlacement &focus) override;
+
+   bool IsUsingRtlLayout() const override;
+
+private:
+   BasicUI::Services &mServices;
+};
+
+#endif
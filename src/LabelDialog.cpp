@@ -24,6 +24,8 @@
 #include <wx/settings.h>
 #include <wx/stattext.h>
 #include <wx/textdlg.h>
+#include <wx/txtstrm.h>
+#include <wx/wfstream.h>
 
 #include "ShuttleGui.h"
 #include "LabelTrack.h"
@@ -639,11 +641,9 @@ void LabelDialog::OnImport(wxCommandEvent & WXUNUSED(event))
 
    // They gave us one...
    if (!fileName.empty()) {
-      wxTextFile f;
-
-      // Get at the data
-      f.Open(fileName);
-      if (!f.IsOpened()) {
+      // Read one line at a time, not the whole file at once
+      wxFFileInputStream f{ fileName };
+      if (!f.IsOk()) {
          AudacityMessageBox(
             XO("Could not open file: %s").Format( fileName ) );
       }
@@ -689,8 +689,7 @@ void LabelDialog::OnExport(wxCommandEvent & WXUNUSED(event))
    if (fName.empty())
       return;
 
-   // Move existing files out of the way.  Otherwise wxTextFile will
-   // append to (rather than replace) the current file.
+   // Move existing files out of the way, keeping a backup.
 
    if (wxFileExists(fName)) {
 #ifdef __WXGTK__
@@ -705,18 +704,17 @@ void LabelDialog::OnExport(wxCommandEvent & WXUNUSED(event))
       wxRename(fName, safetyFileName);
    }
 
-   wxTextFile f(fName);
-#ifdef __WXMAC__
-   wxFile{}.Create(fName);
-#else
-   f.Create();
-#endif
-   f.Open();
-   if (!f.IsOpened()) {
+   wxFFileOutputStream stream{ fName };
+   if (!stream.IsOk()) {
       AudacityMessageBox(
          XO("Couldn't write to file: %s").Format( fName ) );
       return;
    }
+#ifdef __WXMAC__
+   wxTextOutputStream f{ stream, wxEOL_MAC };
+#else
+   wxTextOutputStream f{ stream };
+#endif
 
    // Transfer our collection to a temporary label track
    auto lt = std::make_shared<LabelTrack>();
@@ -731,12 +729,10 @@ void LabelDialog::OnExport(wxCommandEvent & WXUNUSED(event))
    // Export them and clean
    lt->Export(f);
 
-#ifdef __WXMAC__
-   f.Write(wxTextFileType_Mac);
-#else
-   f.Write();
-#endif
-   f.Close();
+   f.Flush();
+   if (!stream.Close())
+      AudacityMessageBox(
+         XO("Couldn't write to file: %s").Format( fName ) );
 }
 
 void LabelDialog::OnSelectCell(wxGridEvent &event)
@@ -32,11 +32,15 @@ for drawing different aspects of the label and its text box.
 #include "LabelTrack.h"
 
 #include <algorithm>
+#include <limits>
+#include <optional>
 #include <limits.h>
 #include <float.h>
 
 #include <wx/log.h>
+#include <wx/stream.h>
 #include <wx/tokenzr.h>
+#include <wx/txtstrm.h>
 
 #include "Prefs.h"
 #include "Project.h"
@@ -152,6 +156,7 @@ LabelTrack::DoGetInterval(size_t iInterval)
 
 void LabelTrack::SetLabel( size_t iLabel, const LabelStruct &newLabel )
 {
+   InvalidateIndex(iLabel, iLabel + 1);
    if( iLabel >= mLabels.size() ) {
       wxASSERT( false );
       mLabels.resize( iLabel + 1 );
@@ -163,8 +168,34 @@ LabelTrack::~LabelTrack()
 {
 }
 
+template<typename Pred>
+void LabelTrack::DeleteLabels(size_t first, const Pred &pred)
+{
+   InvalidateIndex(first);
+   std::vector<std::pair<int, wxString>> deleted;
+   auto dest = mLabels.begin() + first;
+   for (auto iter = dest, end = mLabels.end(); iter != end; ++iter) {
+      if (pred(*iter))
+         // Index as if the earlier ones were already deleted
+         deleted.emplace_back(
+            static_cast<int>((iter - mLabels.begin()) - deleted.size()),
+            iter->title);
+      else {
+         if (dest != iter)
+            *dest = std::move(*iter);
+         ++dest;
+      }
+   }
+   mLabels.erase(dest, mLabels.end());
+
+   for (auto &[index, title] : deleted)
+      Publish({ LabelTrackEvent::Deletion,
+         this->SharedPointer<LabelTrack>(), title, index, -1 });
+}
+
 void LabelTrack::MoveTo(double origin)
 {
+   InvalidateIndex();
    if (!mLabels.empty()) {
       const auto offset = origin - mLabels[0].selectedRegion.t0();
       for (auto &labelStruct: mLabels) {
@@ -179,6 +210,7 @@ void LabelTrack::DoOnProjectTempoChange(
    assert(IsLeader());
    if (!oldTempo.has_value())
       return;
+   InvalidateIndex();
    const auto ratio = *oldTempo / newTempo;
    for (auto& label : mLabels)
       label.selectedRegion.setTimes(
@@ -188,17 +220,16 @@ void LabelTrack::DoOnProjectTempoChange(
 void LabelTrack::Clear(double b, double e)
 {
    assert(IsLeader());
-   // May DELETE labels, so use subscripts to iterate
-   for (size_t i = 0; i < mLabels.size(); ++i) {
-      auto &labelStruct = mLabels[i];
+   // Labels ending before b are unaffected
+   const auto first = FindLabels(b, b).first;
+   const auto retainLabels = LabelStruct::RetainLabels();
+   DeleteLabels(first, [&](LabelStruct &labelStruct){
       LabelStruct::TimeRelations relation =
-                        labelStruct.RegionRelation(b, e, this);
+                        labelStruct.RegionRelation(b, e, retainLabels);
       if (relation == LabelStruct::BEFORE_LABEL)
          labelStruct.selectedRegion.move(- (e-b));
-      else if (relation == LabelStruct::SURROUNDS_LABEL) {
-         DeleteLabel( i );
-         --i;
-      }
+      else if (relation == LabelStruct::SURROUNDS_LABEL)
+         return true;
       else if (relation == LabelStruct::ENDS_IN_LABEL)
          labelStruct.selectedRegion.setTimes(
             b,
@@ -207,7 +238,8 @@ void LabelTrack::Clear(double b, double e)
          labelStruct.selectedRegion.setT1(b);
       else if (relation == LabelStruct::WITHIN_LABEL)
          labelStruct.selectedRegion.moveT1( - (e-b));
-   }
+      return false;
+   });
 }
 
 #if 0
@@ -237,9 +269,15 @@ bool LabelTrack::SplitDelete(double b, double e)
 
 void LabelTrack::ShiftLabelsOnInsert(double length, double pt)
 {
-   for (auto &labelStruct: mLabels) {
+   // Labels ending before pt are unaffected
+   const auto first = FindLabels(pt, pt).first;
+   InvalidateIndex(first);
+   const auto retainLabels = LabelStruct::RetainLabels();
+   for (auto iter = mLabels.begin() + first, end = mLabels.end();
+        iter != end; ++iter) {
+      auto &labelStruct = *iter;
       LabelStruct::TimeRelations relation =
-                        labelStruct.RegionRelation(pt, pt, this);
+                        labelStruct.RegionRelation(pt, pt, retainLabels);
 
       if (relation == LabelStruct::BEFORE_LABEL)
          labelStruct.selectedRegion.move(length);
@@ -250,8 +288,13 @@ void LabelTrack::ShiftLabelsOnInsert(double length, double pt)
 
 void LabelTrack::ChangeLabelsOnReverse(double b, double e)
 {
-   for (auto &labelStruct: mLabels) {
-      if (labelStruct.RegionRelation(b, e, this) ==
+   const auto [first, last] = FindLabels(b, e);
+   InvalidateIndex(first, last);
+   const auto retainLabels = LabelStruct::RetainLabels();
+   for (auto iter = mLabels.begin() + first, end = mLabels.begin() + last;
+        iter != end; ++iter) {
+      auto &labelStruct = *iter;
+      if (labelStruct.RegionRelation(b, e, retainLabels) ==
                                     LabelStruct::SURROUNDS_LABEL)
       {
          double aux     = b + (e - labelStruct.getT1());
@@ -265,7 +308,12 @@ void LabelTrack::ChangeLabelsOnReverse(double b, double e)
 
 void LabelTrack::ScaleLabels(double b, double e, double change)
 {
-   for (auto &labelStruct: mLabels) {
+   // Labels ending before b are unaffected
+   const auto first = FindLabels(b, b).first;
+   InvalidateIndex(first);
+   for (auto iter = mLabels.begin() + first, end = mLabels.end();
+        iter != end; ++iter) {
+      auto &labelStruct = *iter;
       labelStruct.selectedRegion.setTimes(
          AdjustTimeStampOnScale(labelStruct.getT0(), b, e, change),
          AdjustTimeStampOnScale(labelStruct.getT1(), b, e, change));
@@ -292,6 +340,7 @@ double LabelTrack::AdjustTimeStampOnScale(double t, double b, double e, double c
 // (If necessary this could be optimised by ignoring labels that occur before a
 // specified time, as in most cases they don't need to move.)
 void LabelTrack::WarpLabels(const TimeWarper &warper) {
+   InvalidateIndex();
    for (auto &labelStruct: mLabels) {
       labelStruct.selectedRegion.setTimes(
          warper.Warp(labelStruct.getT0()),
@@ -419,13 +468,39 @@ ImportExportPrefs::RegisteredControls reg{ wxT("LabelStyle"), AddControls };
 }
 
 LabelStruct LabelStruct::Import(wxTextFile &file, int &index)
+{
+   const auto firstLine = file.GetLine(index++);
+
+   // There may be additional continuation lines from future formats that
+   // we ignore.
+
+   // Advance index over all continuation lines first, before we might throw
+   // any exceptions.
+   int index2 = index;
+   while (index < (int)file.GetLineCount() &&
+          IsContinuation(file.GetLine(index)))
+      ++index;
+
+   if (index2 < index) {
+      const auto continuation = file.GetLine(index2);
+      return Import(firstLine, &continuation);
+   }
+   return Import(firstLine, nullptr);
+}
+
+bool LabelStruct::IsContinuation(const wxString &line)
+{
+   static const wxString continuation{ wxT("\\") };
+   return line.StartsWith(continuation);
+}
+
+LabelStruct LabelStruct::Import(
+   const wxString &firstLine, const wxString *pContinuation)
 {
    SelectedRegion sr;
    wxString title;
    static const wxString continuation{ wxT("\\") };
 
-   wxString firstLine = file.GetLine(index++);
-
    {
       // Assume tab is an impossible character within the exported text
       // of the label, so can be only a delimiter.  But other white space may
@@ -455,21 +530,9 @@ LabelStruct LabelStruct::Import(wxTextFile &file, int &index)
 
    // Newer selection fields are written on additional lines beginning with
    // '\' which is an impossible numerical character that older versions of
-   // audacity will ignore.  Test for the presence of such a line and then
-   // parse it if we can.
-
-   // There may also be additional continuation lines from future formats that
-   // we ignore.
-
-   // Advance index over all continuation lines first, before we might throw
-   // any exceptions.
-   int index2 = index;
-   while (index < (int)file.GetLineCount() &&
-          file.GetLine(index).StartsWith(continuation))
-      ++index;
-
-   if (index2 < index) {
-      wxStringTokenizer toker { file.GetLine(index2++), wxT("\t") };
+   // audacity will ignore.  Parse such a line if we can.
+   if (pContinuation) {
+      wxStringTokenizer toker { *pContinuation, wxT("\t") };
       auto token = toker.GetNextToken();
       if (token != continuation)
          throw BadFormatException{};
@@ -490,17 +553,19 @@ LabelStruct LabelStruct::Import(wxTextFile &file, int &index)
    return LabelStruct{ sr, title };
 }
 
-void LabelStruct::Export(wxTextFile &file) const
+namespace {
+template<typename AddLine>
+void ExportLabel(const LabelStruct &label, const AddLine &addLine)
 {
-   file.AddLine(wxString::Format(wxT("%s\t%s\t%s"),
-      Internat::ToString(getT0(), FLT_DIG),
-      Internat::ToString(getT1(), FLT_DIG),
-      title
+   addLine(wxString::Format(wxT("%s\t%s\t%s"),
+      Internat::ToString(label.getT0(), FLT_DIG),
+      Internat::ToString(label.getT1(), FLT_DIG),
+      label.title
    ));
 
    // Do we need more lines?
-   auto f0 = selectedRegion.f0();
-   auto f1 = selectedRegion.f1();
+   auto f0 = label.selectedRegion.f0();
+   auto f1 = label.selectedRegion.f1();
    if ((f0 == SelectedRegion::UndefinedFrequency &&
       f1 == SelectedRegion::UndefinedFrequency) ||
       LabelStyleSetting.ReadEnum())
@@ -508,22 +573,46 @@ void LabelStruct::Export(wxTextFile &file) const
 
    // Write a \ character at the start of a second line,
    // so that earlier versions of Audacity ignore it.
-   file.AddLine(wxString::Format(wxT("\\\t%s\t%s"),
+   addLine(wxString::Format(wxT("\\\t%s\t%s"),
       Internat::ToString(f0, FLT_DIG),
       Internat::ToString(f1, FLT_DIG)
    ));
 
    // Additional lines in future formats should also start with '\'.
 }
+}
+
+void LabelStruct::Export(wxTextFile &file) const
+{
+   ExportLabel(*this, [&](const wxString &line){ file.AddLine(line); });
+}
+
+void LabelStruct::Export(wxTextOutputStream &stream) const
+{
+   ExportLabel(*this, [&](const wxString &line){
+      stream.WriteString(line);
+      stream.WriteString(wxT("\n"));
+   });
+}
+
+bool LabelStruct::RetainLabels()
+{
+   bool retainLabels = false;
+   gPrefs->Read(wxT("/GUI/RetainLabels"), &retainLabels);
+   return retainLabels;
+}
 
 auto LabelStruct::RegionRelation(
       double reg_t0, double reg_t1, const LabelTrack * WXUNUSED(parent)) const
 -> TimeRelations
 {
-   bool retainLabels = false;
+   return RegionRelation(reg_t0, reg_t1, RetainLabels());
+}
 
+auto LabelStruct::RegionRelation(
+   double reg_t0, double reg_t1, bool retainLabels) const -> TimeRelations
+{
    wxASSERT(reg_t0 <= reg_t1);
-   gPrefs->Read(wxT("/GUI/RetainLabels"), &retainLabels);
 
    if(retainLabels) {
 
@@ -590,11 +679,29 @@ void LabelTrack::Export(wxTextFile & f) const
       labelStruct.Export(f);
 }
 
+void LabelTrack::Export(wxTextOutputStream & out) const
+{
+   for (auto &labelStruct: mLabels)
+      labelStruct.Export(out);
+}
+
+namespace {
+// Sort by start times in one step; labels of a newly read file have no
+// listeners interested in permutations
+void SortImported(LabelArray &labels)
+{
+   std::stable_sort(labels.begin(), labels.end(),
+      [](const LabelStruct &a, const LabelStruct &b){
+         return a.getT0() < b.getT0(); });
+}
+}
+
 /// Import labels, handling files with or without end-times.
 void LabelTrack::Import(wxTextFile & in)
 {
    int lines = in.GetLineCount();
 
+   InvalidateIndex();
    mLabels.clear();
    mLabels.reserve(lines);
 
@@ -612,7 +719,44 @@ void LabelTrack::Import(wxTextFile & in)
    }
    if (error)
       ::AudacityMessageBox( XO("One or more saved labels could not be read.") );
-   SortLabels();
+   SortImported(mLabels);
+}
+
+void LabelTrack::Import(wxInputStream & in)
+{
+   InvalidateIndex();
+   mLabels.clear();
+
+   wxTextInputStream text{ in };
+   auto readLine = [&]() -> std::optional<wxString> {
+      if (in.Eof())
+         return std::nullopt;
+      auto line = text.ReadLine();
+      if (line.empty() && in.Eof())
+         // Don't treat a final newline as an empty label
+         return std::nullopt;
+      return line;
+   };
+
+   // Read one line ahead, to find the continuation lines of each label
+   bool error = false;
+   auto line = readLine();
+   while (line) {
+      const auto firstLine = std::move(*line);
+      std::optional<wxString> continuation;
+      while ((line = readLine()) && LabelStruct::IsContinuation(*line))
+         // Ignore continuation lines after the first, from future formats
+         if (!continuation)
+            continuation = std::move(*line);
+      try {
+         mLabels.push_back(LabelStruct::Import(
+            firstLine, continuation ? &*continuation : nullptr));
+      }
+      catch(const LabelStruct::BadFormatException&) { error = true; }
+   }
+   if (error)
+      ::AudacityMessageBox( XO("One or more saved labels could not be read.") );
+   SortImported(mLabels);
 }
 
 bool LabelTrack::HandleXMLTag(const std::string_view& tag, const AttributesList &attrs)
@@ -645,6 +789,7 @@ bool LabelTrack::HandleXMLTag(const std::string_view& tag, const AttributesList
       //   selectedRegion.collapseToT0();
 
       LabelStruct l { selectedRegion, title };
+      InvalidateIndex(mLabels.size());
       mLabels.push_back(l);
 
       return true;
@@ -665,6 +810,7 @@ bool LabelTrack::HandleXMLTag(const std::string_view& tag, const AttributesList
                wxLogWarning(wxT("Project shows negative number of labels: %d"), nValue);
                return false;
             }
+            InvalidateIndex();
             mLabels.clear();
             mLabels.reserve(nValue);
          }
@@ -783,11 +929,10 @@ TrackListHolder LabelTrack::Copy(double t0, double t1, bool) const
 bool LabelTrack::PasteOver(double t, const Track &src)
 {
    auto result = src.TypeSwitch<bool>([&](const LabelTrack &sl) {
-      int len = mLabels.size();
-      int pos = 0;
-
-      while (pos < len && mLabels[pos].getT0() < t)
-         pos++;
+      auto pos = std::partition_point(mLabels.begin(), mLabels.end(),
+         [t](const LabelStruct &label){ return label.getT0() < t; })
+            - mLabels.begin();
+      InvalidateIndex(pos);
 
       for (auto &labelStruct: sl.mLabels) {
          LabelStruct l {
@@ -837,11 +982,16 @@ bool LabelTrack::Repeat(double t0, double t1, int n)
    // Insert space for the repetitions
    ShiftLabelsOnInsert(tLen * n, t1);
 
+   // Labels ending before t0 are unaffected
+   const auto first = FindLabels(t0, t0).first;
+   InvalidateIndex(first);
+   const auto retainLabels = LabelStruct::RetainLabels();
+
    // mLabels may resize as we iterate, so use subscripting
-   for (unsigned int i = 0; i < mLabels.size(); ++i)
+   for (size_t i = first; i < mLabels.size(); ++i)
    {
       LabelStruct::TimeRelations relation =
-                        mLabels[i].RegionRelation(t0, t1, this);
+                        mLabels[i].RegionRelation(t0, t1, retainLabels);
       if (relation == LabelStruct::SURROUNDS_LABEL)
       {
          // Label is completely inside the selection; duplicate it in each
@@ -901,10 +1051,15 @@ void LabelTrack::Silence(double t0, double t1, ProgressReporter)
    assert(IsLeader());
    int len = mLabels.size();
 
+   // Labels ending before t0 are unaffected
+   const int first = FindLabels(t0, t0).first;
+   InvalidateIndex(first);
+   const auto retainLabels = LabelStruct::RetainLabels();
+
    // mLabels may resize as we iterate, so use subscripting
-   for (int i = 0; i < len; ++i) {
+   for (int i = first; i < len; ++i) {
       LabelStruct::TimeRelations relation =
-                        mLabels[i].RegionRelation(t0, t1, this);
+                        mLabels[i].RegionRelation(t0, t1, retainLabels);
       if (relation == LabelStruct::WITHIN_LABEL)
       {
          // Split label around the selection
@@ -946,7 +1101,12 @@ void LabelTrack::Silence(double t0, double t1, ProgressReporter)
 void LabelTrack::InsertSilence(double t, double len)
 {
    assert(IsLeader());
-   for (auto &labelStruct: mLabels) {
+   // Labels ending before t are unaffected
+   const auto first = FindLabels(t, t).first;
+   InvalidateIndex(first);
+   for (auto iter = mLabels.begin() + first, end = mLabels.end();
+        iter != end; ++iter) {
+      auto &labelStruct = *iter;
       double t0 = labelStruct.getT0();
       double t1 = labelStruct.getT1();
       if (t0 >= t)
@@ -973,11 +1133,10 @@ int LabelTrack::AddLabel(const SelectedRegion &selectedRegion,
 {
    LabelStruct l { selectedRegion, title };
 
-   int len = mLabels.size();
-   int pos = 0;
-
-   while (pos < len && mLabels[pos].getT0() < selectedRegion.t0())
-      pos++;
+   int pos = std::partition_point(mLabels.begin(), mLabels.end(),
+      [&](const LabelStruct &label){
+         return label.getT0() < selectedRegion.t0(); }) - mLabels.begin();
+   InvalidateIndex(pos);
 
    mLabels.insert(mLabels.begin() + pos, l);
 
@@ -990,6 +1149,7 @@ int LabelTrack::AddLabel(const SelectedRegion &selectedRegion,
 void LabelTrack::DeleteLabel(int index)
 {
    wxASSERT((index < (int)mLabels.size()));
+   InvalidateIndex(index);
    auto iter = mLabels.begin() + index;
    const auto title = iter->title;
    mLabels.erase(iter);
@@ -1022,6 +1182,7 @@ void LabelTrack::SortLabels()
       ++j;
 
       // Now fix the disorder
+      InvalidateIndex(j, i + 1);
       std::rotate(
          begin + j,
          begin + i,
@@ -1034,12 +1195,97 @@ void LabelTrack::SortLabels()
    }
 }
 
+void LabelTimeIndex::Invalidate(size_t first, size_t last)
+{
+   mFirstChanged = std::min(mFirstChanged, first);
+   mLastChanged = std::max(mLastChanged, last);
+}
+
+void LabelTimeIndex::Update(const LabelArray &labels)
+{
+   const auto size = labels.size();
+   auto first = mFirstChanged, last = mLastChanged;
+   if (size != mSize)
+      // Positions from the first insertion or removal onward all shifted
+      first = std::min({ first, size, mSize }), last = npos;
+   if (first >= last)
+      return;
+   mFirstChanged = npos, mLastChanged = 0;
+
+   constexpr auto none = -std::numeric_limits<double>::infinity();
+   if (size > mCapacity) {
+      // Grow by doubling, and rebuild
+      mCapacity = std::max<size_t>(2 * mCapacity, 1);
+      while (mCapacity < size)
+         mCapacity *= 2;
+      mMaxEnds.assign(2 * mCapacity, none);
+      first = 0;
+   }
+   // Leaves of removed labels must be cleared too
+   const auto end = std::min(last, std::max(size, mSize));
+
+   // Leaves, then their ancestors, level by level
+   for (auto ii = first; ii < end; ++ii)
+      mMaxEnds[mCapacity + ii] = ii < size ? labels[ii].getT1() : none;
+   if (first < end)
+      for (auto lo = (mCapacity + first) / 2, hi = (mCapacity + end - 1) / 2;
+         lo > 0; lo /= 2, hi /= 2
+      )
+         for (auto node = lo; node <= hi; ++node)
+            mMaxEnds[node] =
+               std::max(mMaxEnds[2 * node], mMaxEnds[2 * node + 1]);
+
+   // A change of a label may change its order with either neighbor
+   const auto begin = std::max<size_t>(first, 1);
+   for (auto ii = begin, oldEnd = std::min(end + 1, mSize); ii < oldEnd; ++ii)
+      mNDescents -= mDescents[ii];
+   mDescents.resize(size);
+   for (auto ii = begin, newEnd = std::min(end + 1, size); ii < newEnd; ++ii)
+      mNDescents +=
+         (mDescents[ii] = labels[ii - 1].getT0() > labels[ii].getT0());
+   mSize = size;
+}
+
+std::pair<size_t, size_t>
+LabelTimeIndex::Find(const LabelArray &labels, double t0, double t1)
+{
+   Update(labels);
+   const auto size = labels.size();
+   if (mNDescents > 0)
+      // Perhaps in the middle of dragging
+      return { 0, size };
+
+   // Labels before first end before t0; descend to the leftmost leaf that
+   // does not
+   size_t first = size;
+   if (size > 0 && mMaxEnds[1] >= t0) {
+      size_t node = 1;
+      while (node < mCapacity)
+         node = mMaxEnds[2 * node] >= t0 ? 2 * node : 2 * node + 1;
+      first = node - mCapacity;
+   }
+   // Labels from last onward begin after t1
+   const size_t last = std::partition_point(
+      labels.begin() + first, labels.end(),
+      [t1](const LabelStruct &label){ return label.getT0() <= t1; })
+         - labels.begin();
+   return { first, last };
+}
+
+std::pair<size_t, size_t> LabelTrack::FindLabels(double t0, double t1) const
+{
+   return mIndex.Find(mLabels, t0, t1);
+}
+
 wxString LabelTrack::GetTextOfLabels(double t0, double t1) const
 {
    bool firstLabel = true;
    wxString retVal;
 
-   for (auto &labelStruct: mLabels) {
+   const auto [first, last] = FindLabels(t0, t1);
+   for (auto iter = mLabels.begin() + first, end = mLabels.begin() + last;
+        iter != end; ++iter) {
+      auto &labelStruct = *iter;
       if (labelStruct.getT0() >= t0 &&
           labelStruct.getT1() <= t1)
       {
@@ -1066,12 +1312,11 @@ int LabelTrack::FindNextLabel(const SelectedRegion& currentRegion)
       }
       else {
          i = 0;
-         if (currentRegion.t0() < mLabels[len - 1].getT0()) {
-            while (i < len &&
-                  mLabels[i].getT0() <= currentRegion.t0()) {
-               i++;
-            }
-         }
+         if (currentRegion.t0() < mLabels[len - 1].getT0())
+            i = std::partition_point(mLabels.begin(), mLabels.end(),
+               [&](const LabelStruct &label){
+                  return label.getT0() <= currentRegion.t0(); })
+               - mLabels.begin();
       }
    }
 
@@ -1092,12 +1337,11 @@ int LabelTrack::FindNextLabel(const SelectedRegion& currentRegion)
       }
       else {
          i = len - 1;
-         if (currentRegion.t0() > mLabels[0].getT0()) {
-            while (i >=0  &&
-                  mLabels[i].getT0() >= currentRegion.t0()) {
-               i--;
-            }
-         }
+         if (currentRegion.t0() > mLabels[0].getT0())
+            i = std::partition_point(mLabels.begin(), mLabels.end(),
+               [&](const LabelStruct &label){
+                  return label.getT0() < currentRegion.t0(); })
+               - mLabels.begin() - 1;
       }
    }
 
@@ -13,10 +13,16 @@
 #ifndef _LABELTRACK_
 #define _LABELTRACK_
 
+#include <limits>
+#include <utility>
+#include <vector>
+
 #include "SelectedRegion.h"
 #include "Track.h"
 
+class wxInputStream;
 class wxTextFile;
+class wxTextOutputStream;
 
 class AudacityProject;
 class TimeWarper;
@@ -44,8 +50,15 @@ public:
 
    struct BadFormatException {};
    static LabelStruct Import(wxTextFile &file, int &index);
+   //! Parse the first line of a label, and the first of the continuation
+   //! lines after it, if there are any
+   static LabelStruct Import(
+      const wxString &firstLine, const wxString *pContinuation);
+   //! Whether the line continues the description of the label before it
+   static bool IsContinuation(const wxString &line);
 
    void Export(wxTextFile &file) const;
+   void Export(wxTextOutputStream &stream) const;
 
    /// Relationships between selection region and labels
    enum TimeRelations
@@ -64,6 +77,11 @@ public:
    /// it possible to DELETE capture all labels with a Select All).
    TimeRelations RegionRelation(double reg_t0, double reg_t1,
                                 const LabelTrack *parent = NULL) const;
+   //! For loops over many labels, given the value of RetainLabels()
+   TimeRelations RegionRelation(
+      double reg_t0, double reg_t1, bool retainLabels) const;
+   //! Preference for keeping labels when the selection snaps to them
+   static bool RetainLabels();
 
 public:
    SelectedRegion selectedRegion;
@@ -81,6 +99,43 @@ public:
 
 using LabelArray = std::vector<LabelStruct>;
 
+//! Finds the labels of a LabelArray that may intersect an interval
+/*!
+ A complete binary tree over the positions of the labels holds the greatest
+ end time under each node.  The index also counts the places where start
+ times decrease.  Changes only mark positions; the next query updates them
+ and their ancestors, so a change of k labels costs O(k + log n).
+ */
+class AUDACITY_DLL_API LabelTimeIndex final
+{
+public:
+   static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+   //! Labels from first up to last may change; by default, labels from first
+   //! onward may also move, or be added or removed
+   void Invalidate(size_t first = 0, size_t last = npos);
+
+   //! Find labels that may intersect the closed interval from t0 to t1
+   std::pair<size_t, size_t> Find(
+      const LabelArray &labels, double t0, double t1);
+
+private:
+   void Update(const LabelArray &labels);
+
+   //! The tree, with the root at 1 and the end time of label i at
+   //! mCapacity + i
+   std::vector<double> mMaxEnds;
+   //! Whether label i starts before label i - 1
+   std::vector<char> mDescents;
+   size_t mCapacity{ 0 };
+   //! How many labels there were at the last update
+   size_t mSize{ 0 };
+   size_t mNDescents{ 0 };
+   //! The range of positions to update; all of them at first
+   size_t mFirstChanged{ 0 };
+   size_t mLastChanged{ npos };
+};
+
 class AUDACITY_DLL_API LabelTrack final
    : public UniqueChannelTrack<>
    , public Observer::Publisher<struct LabelTrackEvent>
@@ -139,12 +194,23 @@ public:
    void InsertSilence(double t, double len) override;
 
    void Import(wxTextFile & f);
+   //! Reads one line at a time, not holding the whole file in memory
+   void Import(wxInputStream & in);
    void Export(wxTextFile & f) const;
+   void Export(wxTextOutputStream & out) const;
 
    int GetNumLabels() const;
    const LabelStruct *GetLabel(int index) const;
    const LabelArray &GetLabels() const { return mLabels; }
 
+   //! Find labels that may intersect the closed interval from t0 to t1
+   /*!
+    Takes logarithmic time, plus time proportional to the number of labels
+    changed since the last call.
+    @return a range of indices; labels outside it do not intersect
+    */
+   std::pair<size_t, size_t> FindLabels(double t0, double t1) const;
+
    void OnLabelAdded( const wxString &title, int pos );
    //This returns the index of the label we just added.
    int AddLabel(const SelectedRegion &region, const wxString &title);
@@ -200,8 +266,18 @@ private:
    std::shared_ptr<WideChannelGroupInterval> DoGetInterval(size_t iInterval)
       override;
 
+   //! Call before any change of mLabels, as for LabelTimeIndex::Invalidate()
+   void InvalidateIndex(size_t first = 0, size_t last = LabelTimeIndex::npos)
+   { mIndex.Invalidate(first, last); }
+   //! Remove labels from index first onward that satisfy pred, in one pass
+   /*! Publishes the same events as repeated calls of DeleteLabel() */
+   template<typename Pred> void DeleteLabels(size_t first, const Pred &pred);
+
    LabelArray mLabels;
 
+   //! For FindLabels()
+   mutable LabelTimeIndex mIndex;
+
    // Set in copied label tracks
    double mClipLen;
 
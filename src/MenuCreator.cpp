@@ -429,6 +429,25 @@ void MenuItemVisitor::EndOccultCommands()
    mTempMenuBar.reset();
 }
 
+//! Registers the same commands as MenuItemVisitor, but makes no menus
+struct CommandVisitor final : CommandManager::Populator {
+   explicit CommandVisitor(AudacityProject &proj)
+   : CommandManager::Populator { proj,
+      // leaf visit
+      [this](const auto &item, const auto&) {
+         TypeSwitch::VDispatch<void, LeafTypes>(item,
+            // Special items append to menus that do not exist
+            [](const SpecialItem &) {},
+            [this](auto &item){ DoVisit(item); }
+         );
+      },
+
+      [this]{ DoSeparator(); }
+   }
+   {
+      MenuRegistry::Visit(*this, mProject);
+   }
+};
 }
 
 void MenuCreator::CreateMenusAndCommands()
@@ -444,6 +463,15 @@ void MenuCreator::CreateMenusAndCommands()
 #endif
 }
 
+void MenuCreator::CreateCommands()
+{
+   {
+      CommandVisitor visitor{ mProject };
+   }
+
+   mLastFlags = AlwaysEnabledFlag;
+}
+
 // Get hackcess to a protected method
 class wxFrameEx : public wxFrame
 {
@@ -491,7 +519,8 @@ void MenuCreator::ExecuteCommand(const CommandContext &context,
 // get multiple effect preview working
 bool MenuCreator::ReallyDoQuickCheck()
 {
-   return !GetProjectFrame(mProject).IsActive();
+   const auto pFrame = FindProjectFrame(&mProject);
+   return !(pFrame && pFrame->IsActive());
 }
 
 /// The following method moves to the previous track
@@ -47,6 +47,8 @@ public:
    MenuCreator(AudacityProject &project);
    ~MenuCreator() override;
    void CreateMenusAndCommands();
+   //! Register the commands of the menus, for a project without a window
+   void CreateCommands();
    void RebuildMenuBar();
    static void RebuildAllMenuBars();
 
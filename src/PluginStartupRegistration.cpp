@@ -10,6 +10,7 @@
 
 #include "PluginStartupRegistration.h"
 
+#include <algorithm>
 #include <thread>
 
 #include <wx/log.h>
@@ -127,29 +128,28 @@ namespace
    };
 }
 
-PluginStartupRegistration::PluginStartupRegistration(const std::map<wxString, std::vector<wxString>>& pluginsToProcess)
+PluginStartupRegistration::Slot::Slot(PluginStartupRegistration& owner)
+   : mOwner(owner)
 {
-   for(auto& p : pluginsToProcess)
-      mPluginsToProcess.push_back(p);
 }
 
-void PluginStartupRegistration::OnInternalError(const wxString& error)
+void PluginStartupRegistration::Slot::OnInternalError(const wxString& error)
 {
-   StopWithError(error);
+   mOwner.StopWithError(error);
 }
 
-void PluginStartupRegistration::OnPluginFound(const PluginDescriptor& desc)
+void PluginStartupRegistration::Slot::OnPluginFound(const PluginDescriptor& desc)
 {
-   if(!mValidProviderFound)
-      mFailedPluginsCache.clear();
+   if(!validProviderFound)
+      failedPluginsCache.clear();
 
-   mValidProviderFound = true;
+   validProviderFound = true;
    if(!desc.IsValid())
-      mFailedPluginsCache.push_back(desc);
+      failedPluginsCache.push_back(desc);
    PluginManager::Get().RegisterPlugin(PluginDescriptor { desc });
 }
 
-void PluginStartupRegistration::OnPluginValidationFailed(const wxString& providerId, const wxString& path)
+void PluginStartupRegistration::Slot::OnPluginValidationFailed(const wxString& providerId, const wxString& path)
 {
    PluginID ID = providerId + wxT("_") + path;
    PluginDescriptor pluginDescriptor;
@@ -162,44 +162,59 @@ void PluginStartupRegistration::OnPluginValidationFailed(const wxString& provide
 
    //Multiple providers can report same module paths
    //do not register until all associated providers have tried to load the module
-   mFailedPluginsCache.push_back(std::move(pluginDescriptor));
+   failedPluginsCache.push_back(std::move(pluginDescriptor));
+}
+
+void PluginStartupRegistration::Slot::OnValidationFinished()
+{
+   mOwner.OnValidationFinished(*this);
 }
 
+PluginStartupRegistration::PluginStartupRegistration(const std::map<wxString, std::vector<wxString>>& pluginsToProcess)
+{
+   for(auto& p : pluginsToProcess)
+      mPluginsToProcess.push_back(p);
+}
 
-void PluginStartupRegistration::OnValidationFinished()
+void PluginStartupRegistration::OnValidationFinished(Slot& slot)
 {
-   ++mCurrentPluginProviderIndex;
-   if(mValidProviderFound ||
-      mPluginsToProcess[mCurrentPluginIndex].second.size() == mCurrentPluginProviderIndex)
+   if(!slot.pluginIndex)
+      return;
+
+   const auto& providers = mPluginsToProcess[*slot.pluginIndex].second;
+   ++slot.providerIndex;
+   if(slot.validProviderFound || providers.size() == slot.providerIndex)
    {
-      if(!mFailedPluginsCache.empty())
+      auto& failedPluginsCache = slot.failedPluginsCache;
+      if(!failedPluginsCache.empty())
       {
          //we've tried all providers associated with same module path...
-         if(!mValidProviderFound)
+         if(!slot.validProviderFound)
          {
             //...but none of them succeeded
-            mFailedPluginsPaths.push_back(mFailedPluginsCache[0].GetPath());
+            mFailedPluginsPaths.push_back(failedPluginsCache[0].GetPath());
 
             //Same plugin path, but different providers, we need to register all of them
-            for(auto& desc : mFailedPluginsCache)
+            for(auto& desc : failedPluginsCache)
                PluginManager::Get().RegisterPlugin(std::move(desc));
          }
          //plugin type was detected, but plugin instance validation has failed
          else
          {
-            for(auto& desc : mFailedPluginsCache)
+            for(auto& desc : failedPluginsCache)
             {
                if(desc.GetPluginType() != PluginTypeStub)
                   mFailedPluginsPaths.push_back(desc.GetPath());
             }
          }
       }
-      ++mCurrentPluginIndex;
-      mCurrentPluginProviderIndex = 0;
-      mValidProviderFound = false;
-      mFailedPluginsCache.clear();
+      slot.pluginIndex.reset();
+      slot.providerIndex = 0;
+      slot.validProviderFound = false;
+      failedPluginsCache.clear();
+      ++mProcessedCount;
    }
-   ProcessNext();
+   ProcessNext(slot);
 }
 
 const std::vector<wxString>& PluginStartupRegistration::GetFailedPluginsPaths() const noexcept
@@ -207,39 +222,55 @@ const std::vector<wxString>& PluginStartupRegistration::GetFailedPluginsPaths()
    return mFailedPluginsPaths;
 }
 
-void PluginStartupRegistration::Run(std::chrono::seconds timeout)
+void PluginStartupRegistration::Run(std::chrono::seconds timeout, size_t hostCount)
 {
    PluginScanDialog dialog(nullptr, wxID_ANY, XO("Searching for plugins"));
    wxTimer timeoutTimer(&dialog, OnPluginScanTimeout);
    mScanDialog = &dialog;
    mTimeoutTimer = &timeoutTimer;
    mTimeout = timeout;
+   mStopped = false;
+
+   if(hostCount == 0)
+      hostCount = std::max(1u, std::thread::hardware_concurrency());
+   hostCount = std::max<size_t>(1, std::min(hostCount, mPluginsToProcess.size()));
+   mSlots.clear();
+   for(size_t i = 0; i < hostCount; ++i)
+      mSlots.push_back(std::make_unique<Slot>(*this));
 
    dialog.Bind(wxEVT_BUTTON, [this](wxCommandEvent& evt) {
       evt.Skip();
       if(evt.GetId() == wxID_IGNORE)
-         Skip();
+      {
+         if(auto slot = GetOldestBusySlot())
+            Skip(*slot);
+      }
    });
    dialog.Bind(wxEVT_TIMER, [this](wxTimerEvent& evt) {
       if(evt.GetId() == OnPluginScanTimeout)
-      {
-         if(mValidator && mValidator->InactiveSince() < mRequestStartTime)
-            Skip();
-         //else
-         //   wxMessageBox("Please check for plugin popups!");
-      }
+         SkipTimedOut();
       else
          evt.Skip();
    });
    dialog.Bind(wxEVT_CLOSE_WINDOW, [this](wxCloseEvent& evt) {
       evt.Skip();
-      mValidator.reset();
+      mStopped = true;
+      if(auto timer = mTimeoutTimer.get())
+         timer->Stop();
+      for(auto& slot : mSlots)
+         slot->validator.reset();
       PluginManager::Get().Save();
       PluginManager::Get().NotifyPluginsChanged();
    });
 
    dialog.CenterOnScreen();
-   ProcessNext();
+   if(timeout.count() > 0)
+      //Each slot has its own deadline, check them periodically
+      timeoutTimer.Start(
+         std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::min<std::chrono::system_clock::duration>(timeout, std::chrono::seconds(1))).count());
+   for(auto& slot : mSlots)
+      ProcessNext(*slot);
    dialog.ShowModal();
 }
 
@@ -249,34 +280,56 @@ void PluginStartupRegistration::Stop()
       dialog->Close();
 }
 
-void PluginStartupRegistration::Skip()
+void PluginStartupRegistration::Skip(Slot& slot)
 {
-   //Drop current validator, no more callbacks will be received from now
-   mValidator->SetDelegate(nullptr);
-   //While on Linux and MacOS socket `shutdown()` wakes up `select()` almost
-   //immediately, on Windows it sometimes get delayed on unspecified amount
-   //of time. As we do not expect any data we can safely move remaining
-   //operations to another thread.
-   std::thread([validator = std::shared_ptr<AsyncPluginValidator>(std::move(mValidator))]{ }).detach();
-
-   if(!mValidProviderFound)
+   if(!slot.pluginIndex)
+      return;
+
+   if(slot.validator)
+   {
+      //Drop the slot's validator, no more callbacks will be received from it.
+      //The host process goes away with it, while other slots keep running
+      slot.validator->SetDelegate(nullptr);
+      //While on Linux and MacOS socket `shutdown()` wakes up `select()` almost
+      //immediately, on Windows it sometimes get delayed on unspecified amount
+      //of time. As we do not expect any data we can safely move remaining
+      //operations to another thread.
+      std::thread([validator = std::shared_ptr<AsyncPluginValidator>(std::move(slot.validator))]{ }).detach();
+   }
+
+   const auto& [path, providers] = mPluginsToProcess[*slot.pluginIndex];
+   if(!slot.validProviderFound)
    {
       // Validator didn't report anything yet or it tried
       // one or more providers that didn't recognize the plugin.
       // In that case we assume that none of the remaining providers
       // can recognize that plugin.
       // Note: create stub `PluginDescriptors` for each associated provider
-      for(;mCurrentPluginProviderIndex < mPluginsToProcess[mCurrentPluginIndex].second.size(); ++mCurrentPluginProviderIndex)
-         OnPluginValidationFailed(
-            mPluginsToProcess[mCurrentPluginIndex].second[mCurrentPluginProviderIndex],
-            mPluginsToProcess[mCurrentPluginIndex].first);
-      mCurrentPluginProviderIndex = mPluginsToProcess[mCurrentPluginIndex].second.size() - 1;
+      for(;slot.providerIndex < providers.size(); ++slot.providerIndex)
+         slot.OnPluginValidationFailed(providers[slot.providerIndex], path);
+      slot.providerIndex = providers.size() - 1;
    }
    //else
    //    Don't assume that `OnValidationFinished()` and `OnPluginFound()`
    //    aren't deferred within run loop
 
-   OnValidationFinished();
+   OnValidationFinished(slot);
+}
+
+void PluginStartupRegistration::SkipTimedOut()
+{
+   const auto now = std::chrono::system_clock::now();
+   for(auto& slot : mSlots)
+   {
+      if(mStopped)
+         return;
+      if(slot->pluginIndex && slot->validator &&
+         now - slot->requestStartTime >= mTimeout &&
+         slot->validator->InactiveSince() < slot->requestStartTime)
+         Skip(*slot);
+      //else
+      //   wxMessageBox("Please check for plugin popups!");
+   }
 }
 
 void PluginStartupRegistration::StopWithError(const wxString& msg)
@@ -286,33 +339,32 @@ void PluginStartupRegistration::StopWithError(const wxString& msg)
    Stop();
 }
 
-void PluginStartupRegistration::ProcessNext()
+void PluginStartupRegistration::ProcessNext(Slot& slot)
 {
-   if(mCurrentPluginIndex == mPluginsToProcess.size())
-   {
-      Stop();
+   if(mStopped)
       return;
-   }
 
-   try
+   if(!slot.pluginIndex)
    {
-      if(auto dialog = static_cast<PluginScanDialog*>(mScanDialog.get()))
+      if(mNextPluginIndex == mPluginsToProcess.size())
       {
-         const auto progress = static_cast<float>(mCurrentPluginIndex) / static_cast<float>(mPluginsToProcess.size());
-         dialog->UpdateProgress(
-            mPluginsToProcess[mCurrentPluginIndex].first,
-            progress);
+         UpdateProgress();
+         if(GetOldestBusySlot() == nullptr)
+            Stop();
+         return;
       }
-      if(!mValidator)
-         mValidator = std::make_unique<AsyncPluginValidator>(*this);
-
-      mValidator->Validate(
-         mPluginsToProcess[mCurrentPluginIndex].second[mCurrentPluginProviderIndex],
-         mPluginsToProcess[mCurrentPluginIndex].first
-      );
-      mRequestStartTime = std::chrono::system_clock::now();
-      if(auto timer = mTimeoutTimer.get())
-         timer->StartOnce(std::chrono::duration_cast<std::chrono::milliseconds>(mTimeout).count());
+      slot.pluginIndex = mNextPluginIndex++;
+   }
+
+   try
+   {
+      if(!slot.validator)
+         slot.validator = std::make_unique<AsyncPluginValidator>(slot);
+
+      const auto& [path, providers] = mPluginsToProcess[*slot.pluginIndex];
+      slot.validator->Validate(providers[slot.providerIndex], path);
+      slot.requestStartTime = std::chrono::system_clock::now();
+      UpdateProgress();
    }
    catch(std::exception& e)
    {
@@ -324,3 +376,27 @@ void PluginStartupRegistration::ProcessNext()
    }
 }
 
+auto PluginStartupRegistration::GetOldestBusySlot() const -> Slot*
+{
+   Slot* oldest{};
+   for(auto& slot : mSlots)
+   {
+      if(slot->pluginIndex &&
+         (oldest == nullptr || slot->requestStartTime < oldest->requestStartTime))
+         oldest = slot.get();
+   }
+   return oldest;
+}
+
+void PluginStartupRegistration::UpdateProgress()
+{
+   auto dialog = static_cast<PluginScanDialog*>(mScanDialog.get());
+   if(dialog == nullptr || mPluginsToProcess.empty())
+      return;
+
+   const auto progress = static_cast<float>(mProcessedCount) / static_cast<float>(mPluginsToProcess.size());
+   const auto slot = GetOldestBusySlot();
+   dialog->UpdateProgress(
+      slot != nullptr ? mPluginsToProcess[*slot->pluginIndex].first : wxString{},
+      progress);
+}
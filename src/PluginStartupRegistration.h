@@ -13,6 +13,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <optional>
 #include <chrono>
 #include <wx/string.h>
 #include <wx/timer.h>
@@ -20,22 +21,43 @@
 #include "wxPanelWrapper.h"
 
 ///Helper class that passes plugins provided in constructor
-///to plugin validator, then "good" plugins are registered in
-///PluginManager. 
-class PluginStartupRegistration final :
-   public AsyncPluginValidator::Delegate
+///to plugin validators, then "good" plugins are registered in
+///PluginManager. Several plugins are validated at once, each in
+///its own host process.
+class PluginStartupRegistration final
 {
-   std::unique_ptr<AsyncPluginValidator> mValidator;
+   ///Validates one module path at a time in its own host process.
+   ///If the host crashes or hangs, only the plugin being validated
+   ///there is affected, and the next request starts a new host.
+   class Slot final : public AsyncPluginValidator::Delegate
+   {
+      PluginStartupRegistration& mOwner;
+   public:
+      std::unique_ptr<AsyncPluginValidator> validator;
+      ///Index into mPluginsToProcess, if busy
+      std::optional<size_t> pluginIndex;
+      size_t providerIndex{0};
+      bool validProviderFound{false};
+      std::vector<PluginDescriptor> failedPluginsCache;
+      std::chrono::system_clock::time_point requestStartTime{};
+
+      explicit Slot(PluginStartupRegistration& owner);
+
+      void OnInternalError(const wxString& error) override;
+      void OnPluginFound(const PluginDescriptor& desc) override;
+      void OnPluginValidationFailed(const wxString& providerId, const wxString& path) override;
+      void OnValidationFinished() override;
+   };
+
    std::vector<std::pair<wxString, std::vector<wxString>>> mPluginsToProcess;
-   size_t mCurrentPluginIndex{0};
-   size_t mCurrentPluginProviderIndex{0};
-   bool mValidProviderFound{false};
+   std::vector<std::unique_ptr<Slot>> mSlots;
+   size_t mNextPluginIndex{0};
+   size_t mProcessedCount{0};
    std::vector<wxString> mFailedPluginsPaths;
-   std::vector<PluginDescriptor> mFailedPluginsCache;
    wxWeakRef<wxDialogWrapper> mScanDialog;
    wxWeakRef<wxTimer> mTimeoutTimer;
    std::chrono::system_clock::duration mTimeout{};
-   std::chrono::system_clock::time_point mRequestStartTime{};
+   bool mStopped{false};
 public:
 
    PluginStartupRegistration(const std::map<wxString, std::vector<wxString>>& pluginsToProcess);
@@ -44,20 +66,25 @@ public:
    ///process is complete or canceled
    ///@param timeout Time allowed to spend on a single plugin validation.
    ///Pass 0 to disable timeout.
-   void Run(std::chrono::seconds timeout = std::chrono::seconds(30));
+   ///@param hostCount Number of plugins validated at once.
+   ///Pass 0 to use one host process per core.
+   void Run(std::chrono::seconds timeout = std::chrono::seconds(30),
+      size_t hostCount = 0);
 
    ///Returns list of paths of plugins that didn't pass validation for some reason
    const std::vector<wxString>& GetFailedPluginsPaths() const noexcept;
 
-   void OnInternalError(const wxString& error) override;
-   void OnPluginFound(const PluginDescriptor& desc) override;
-   void OnPluginValidationFailed(const wxString& providerId, const wxString& path) override;
-   void OnValidationFinished() override;
-
 private:
-   
+
+   void OnValidationFinished(Slot& slot);
+
    void Stop();
-   void Skip();
+   void Skip(Slot& slot);
+   ///Skips slots waiting longer than the timeout for a reply
+   void SkipTimedOut();
    void StopWithError(const wxString& msg);
-   void ProcessNext();
+   void ProcessNext(Slot& slot);
+   ///The busy slot that has waited longest for a reply
+   Slot* GetOldestBusySlot() const;
+   void UpdateProgress();
 };
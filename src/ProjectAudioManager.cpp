@@ -1103,9 +1103,9 @@ void ProjectAudioManager::OnAudioIOStopRecording()
          // Now, we may add a label track to give information about
          // dropouts.  We allow failure of this.
          auto gAudioIO = AudioIO::Get();
-         auto &intervals = gAudioIO->LostCaptureIntervals();
-         if (intervals.size())
-            Publish( RecordingDropoutEvent{ intervals } );
+         Publish( RecordingDropoutEvent{
+            gAudioIO->LostCaptureIntervals(),
+            gAudioIO->CaptureHighWater() } );
       }
    }
 }
@@ -43,18 +43,22 @@ struct TransportSequences;
 enum StatusBarField : int;
 enum class ProjectFileIOMessage : int;
 
-//! Notification, after recording has stopped, when dropouts have been detected
+//! Notification, after recording has stopped, of any dropouts and of how
+//! near the recording came to dropping out
 struct RecordingDropoutEvent {
    //! Start time and duration
    using Interval = std::pair<double, double>;
    using Intervals = std::vector<Interval>;
 
-   explicit RecordingDropoutEvent(const Intervals &intervals)
+   RecordingDropoutEvent(const Intervals &intervals, double highWater)
       : intervals{ intervals }
+      , captureHighWater{ highWater }
    {}
 
-   //! Disjoint and sorted increasingly
+   //! Disjoint and sorted increasingly; may be empty
    const Intervals &intervals;
+   //! Greatest fraction of the capture buffers that was filled
+   const double captureHighWater;
 };
 
 class AUDACITY_DLL_API ProjectAudioManager final
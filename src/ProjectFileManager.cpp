@@ -51,6 +51,7 @@ Paul Licameli split from AudacityProject.cpp
 #include "TrackPanel.h"
 #include "TrackPanelAx.h"
 #include "UndoManager.h"
+#include "ViewInfo.h"
 #include "WaveClip.h"
 #include "WaveTrack.h"
 #include "XMLFileReader.h"
@@ -204,6 +205,15 @@ auto ProjectFileManager::ReadProjectFile(
          }
 
          parseResult->Commit();
+
+         // The track structure is known; read what the first drawing of the
+         // tracks needs while the window comes up
+         {
+            const auto &viewInfo = ViewInfo::Get(project);
+            projectFileIO.PrefetchSummaries(viewInfo.h,
+               viewInfo.GetScreenEndTime(), viewInfo.GetZoom());
+         }
+
          if (discardAutosave)
             // REVIEW: Failure OK?
             projectFileIO.AutoSaveDelete();
@@ -1219,8 +1229,8 @@ ProjectFileManager::AddImportedTracks(const FilePath &fileName,
    //   HandleResize();
 }
 
-namespace {
-bool ImportProject(AudacityProject &dest, const FilePath &fileName)
+bool ProjectFileManager::ImportProject(
+   AudacityProject &dest, const FilePath &fileName)
 {
    InvisibleTemporaryProject temp;
    auto &project = temp.Project();
@@ -1237,6 +1247,7 @@ bool ImportProject(AudacityProject &dest, const FilePath &fileName)
    return true;
 }
 
+namespace {
 class ImportProgress final
    : public ImportProgressListener
 {
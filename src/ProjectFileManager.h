@@ -97,6 +97,10 @@ public:
    bool Import(const FilePath &fileName,
                bool addToHistory = true);
 
+   //! Copy the tracks and tags of an .aup3 file into a project, leaving the
+   //! file unchanged
+   static bool ImportProject(AudacityProject &dest, const FilePath &fileName);
+
    void Compact();
 
    void AddImportedTracks(const FilePath &fileName,
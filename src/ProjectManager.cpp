@@ -311,7 +311,7 @@ void InitProjectWindow( ProjectWindow &window )
    ProjectManager::Get( project ).SetStatusText( msg, mainStatusBarField );
 }
 
-AudacityProject *ProjectManager::New()
+AudacityProject *ProjectManager::New(bool show)
 {
    wxRect wndRect;
    bool bMaximized = false;
@@ -370,7 +370,8 @@ AudacityProject *ProjectManager::New()
    
    ModuleManager::Get().Dispatch(ProjectInitialized);
    
-   window.Show(true);
+   if (show)
+      window.Show(true);
    
    return p;
 }
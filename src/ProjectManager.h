@@ -44,7 +44,9 @@ public:
    ~ProjectManager() override;
 
    // This is the factory for projects:
-   static AudacityProject *New();
+   //! @param show whether to show the window; a project in a windowless
+   //! macro batch never does
+   static AudacityProject *New(bool show = true);
 
    // The function that imports files can act as a factory too, and for that
    // reason remains in this class, not in ProjectFileManager
@@ -0,0 +1,183 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  RealtimeAllocationHook.cpp
+
+*******************************************************************//**
+
+\file RealtimeAllocationHook.cpp
+\brief Replaces the global allocation functions, to report heap allocations
+on threads armed with RealtimeAllocationTrap::Scope
+
+Enabled by EXPERIMENTAL_REALTIME_ALLOCATION_TRAP.  The replacement in the
+executable also serves the shared libraries, except on Windows, where each
+module has its own.
+
+*//*******************************************************************/
+#include "RealtimeArena.h"
+
+#ifdef EXPERIMENTAL_REALTIME_ALLOCATION_TRAP
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+void *TryAllocate(std::size_t size) noexcept
+{
+   if (RealtimeAllocationTrap::IsArmed())
+      RealtimeAllocationTrap::Report(size);
+   return std::malloc(size ? size : 1);
+}
+
+void *Allocate(std::size_t size)
+{
+   if (auto p = TryAllocate(size))
+      return p;
+   throw std::bad_alloc{};
+}
+
+void *TryAllocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+{
+   if (RealtimeAllocationTrap::IsArmed())
+      RealtimeAllocationTrap::Report(size);
+   // posix_memalign wants at least the alignment of a pointer
+   const auto align =
+      std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+#ifdef _WIN32
+   return _aligned_malloc(size ? size : 1, align);
+#else
+   void *p = nullptr;
+   if (posix_memalign(&p, align, size ? size : 1) != 0)
+      return nullptr;
+   return p;
+#endif
+}
+
+void *AllocateAligned(std::size_t size, std::align_val_t alignment)
+{
+   if (auto p = TryAllocateAligned(size, alignment))
+      return p;
+   throw std::bad_alloc{};
+}
+
+//! Memory of TryAllocateAligned() must be freed differently on Windows
+void FreeAligned(void *p) noexcept
+{
+#ifdef _WIN32
+   _aligned_free(p);
+#else
+   std::free(p);
+#endif
+}
+}
+
+void *operator new(std::size_t size)
+{
+   return Allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+   return Allocate(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+   return TryAllocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+   return TryAllocate(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+   return AllocateAligned(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+   return AllocateAligned(size, alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment,
+   const std::nothrow_t &) noexcept
+{
+   return TryAllocateAligned(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment,
+   const std::nothrow_t &) noexcept
+{
+   return TryAllocateAligned(size, alignment);
+}
+
+void operator delete(void *p) noexcept
+{
+   std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+   std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+   std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+   std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+   std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+   std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+   FreeAligned(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept
+{
+   FreeAligned(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+   FreeAligned(p);
+}
+
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept
+{
+   FreeAligned(p);
+}
+
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept
+{
+   FreeAligned(p);
+}
+
+void operator delete[](
+   void *p, std::align_val_t, const std::nothrow_t &) noexcept
+{
+   FreeAligned(p);
+}
+
+#endif
@@ -38,6 +38,7 @@
 #include "effects/EffectUI.h"
 #include "effects/EffectManager.h"
 #include "RealtimeEffectList.h"
+#include "RealtimeEffectManager.h"
 #include "RealtimeEffectState.h"
 #include "effects/RealtimeEffectStateUI.h"
 #include "UndoManager.h"
@@ -357,6 +358,10 @@ namespace
          optionsButton->SetForegroundColorIndex(clrTrackPanelText);
          optionsButton->SetButtonType(AButton::TextButton);
          optionsButton->Bind(wxEVT_BUTTON, &RealtimeEffectControl::OnOptionsClicked, this);
+         optionsButton->Bind(wxEVT_ENTER_WINDOW, [this](wxMouseEvent& evt) {
+            evt.Skip();
+            UpdateToolTip();
+         });
 
          //Remove/replace effect
          auto changeButton = safenew ThemedAButtonWrapper<AButton>(this);
@@ -400,6 +405,36 @@ namespace
                .Format(PluginManager::GetEffectNameFromID(ID).GET());
       }
 
+      //! Show the name, and the processing times if the effect has played
+      void UpdateToolTip()
+      {
+         if (!mEffectState || !mOptionsButton)
+            return;
+         auto tip = GetEffectName();
+         const auto timings = mEffectState->GetTimings().Summarize();
+         if (timings.count > 0) {
+            const auto ms = [](RealtimeEffectTimings::Duration time) {
+               return std::chrono::duration<double, std::milli>(time).count();
+            };
+            tip.Join(
+               /*! i18n-hint: times taken by a realtime effect to process each
+                buffer of audio, in milliseconds: median, 99th percentile, and
+                maximum; then how often it took longer than the audio lasts */
+               XO("Processing: %.2f ms typical, %.2f ms 99%%, %.2f ms max; %llu overruns")
+                  .Format(ms(timings.p50), ms(timings.p99), ms(timings.max),
+                     static_cast<unsigned long long>(timings.overruns)),
+               "\n");
+            if (mProject)
+               tip.Join(
+                  /*! i18n-hint: percentage of time spent processing all
+                   realtime effects */
+                  XO("All effects: %.0f%% load")
+                     .Format(100 * RealtimeEffectManager::Get(*mProject).GetLoad()),
+                  "\n");
+         }
+         mOptionsButton->SetToolTip(tip);
+      }
+
       void SetEffect(AudacityProject& project,
          const std::shared_ptr<SampleTrack>& track,
          const std::shared_ptr<RealtimeEffectState> &pState)
@@ -83,6 +83,7 @@ is time to refresh some aspect of the screen.
 #include "WaveTrack.h"
 
 #include "FrameStatistics.h"
+#include "Tracing.h"
 
 #include "tracks/ui/TrackControls.h"
 #include "tracks/ui/ChannelView.h"
@@ -491,6 +492,7 @@ void TrackPanel::OnPaint(wxPaintEvent & /* event */)
 
    auto sw =
       FrameStatistics::CreateStopwatch(FrameStatistics::SectionID::TrackPanel);
+   TRACE_SCOPE("ui", "TrackPanel::OnPaint");
 
    {
       wxPaintDC dc(this);
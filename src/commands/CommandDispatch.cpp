@@ -60,7 +60,8 @@ bool CommandDispatch::DoAudacityCommand(
    const PluginID & ID, const CommandContext & context, unsigned flags )
 {
    auto &project = context.project;
-   auto &window = GetProjectFrame(project);
+   // Null for a project without a window
+   const auto pWindow = FindProjectFrame(&project);
    const PluginDescriptor *plug = PluginManager::Get().GetPlugin(ID);
    if (!plug)
       return false;
@@ -74,7 +75,7 @@ bool CommandDispatch::DoAudacityCommand(
    EffectManager & em = EffectManager::Get();
    bool success = em.DoAudacityCommand(ID,
       context,
-      &window,
+      pWindow,
       (flags & EffectManager::kConfigured) == 0);
 
    if (!success)
@@ -17,6 +17,7 @@ This class now lists
 - Clips
 - Labels
 - Boxes
+- Realtime effects, with their processing times
 
 *//*******************************************************************/
 
@@ -42,6 +43,9 @@ This class now lists
 #include "NoteTrack.h"
 #include "TimeTrack.h"
 #include "Envelope.h"
+#include "RealtimeEffectList.h"
+#include "RealtimeEffectManager.h"
+#include "RealtimeEffectState.h"
 
 #include "SelectCommand.h"
 #include "ShuttleGui.h"
@@ -71,6 +75,7 @@ enum {
    kEnvelopes,
    kLabels,
    kBoxes,
+   kRealtimeEffects,
    nTypes
 };
 
@@ -85,6 +90,7 @@ static const EnumValueSymbol kTypes[nTypes] =
    { XO("Envelopes") },
    { XO("Labels") },
    { XO("Boxes") },
+   { wxT("RealtimeEffects"), XO("Realtime Effects") },
 };
 
 enum {
@@ -170,6 +176,7 @@ bool GetInfoCommand::ApplyInner(const CommandContext &context)
       case kEnvelopes    : return SendEnvelopes( context );
       case kLabels       : return SendLabels( context );
       case kBoxes        : return SendBoxes( context );
+      case kRealtimeEffects : return SendRealtimeEffects( context );
       default:
          context.Status( "Command options not recognised" );
    }
@@ -467,6 +474,63 @@ bool GetInfoCommand::SendBoxes(const CommandContext &context)
    return true;
 }
 
+namespace {
+void AddTimings(
+   const CommandContext &context, const RealtimeEffectTimings::Summary &timings)
+{
+   const auto ms = [](RealtimeEffectTimings::Duration time) {
+      return std::chrono::duration<double, std::milli>(time).count();
+   };
+   context.AddItem( (double)timings.count, "count" );
+   context.AddItem( ms(timings.p50), "p50_ms" );
+   context.AddItem( ms(timings.p99), "p99_ms" );
+   context.AddItem( ms(timings.max), "max_ms" );
+   context.AddItem( (double)timings.overruns, "overruns" );
+}
+}
+
+bool GetInfoCommand::SendRealtimeEffects(const CommandContext &context)
+{
+   auto &project = context.project;
+   const auto &manager = RealtimeEffectManager::Get( project );
+   context.StartStruct();
+   context.AddItem( manager.GetLoad(), "load" );
+   context.StartField( "chain" );
+   context.StartStruct();
+   AddTimings( context, manager.GetChainTimings() );
+   context.EndStruct();
+   context.EndField();
+
+   context.StartField( "effects" );
+   context.StartArray();
+   auto sendList = [&](const RealtimeEffectList &list, double track) {
+      list.Visit([&](const RealtimeEffectState &state, bool) {
+         context.StartStruct();
+         // Master effects have track -1
+         context.AddItem( track, "track" );
+         context.AddItem(
+            PluginManager::GetEffectNameFromID( state.GetID() ).GET(),
+            "name" );
+         context.AddBool( state.IsEnabled(), "enabled" );
+         AddTimings( context, state.GetTimings().Summarize() );
+         context.EndStruct();
+      });
+   };
+   sendList( RealtimeEffectList::Get( project ), -1 );
+   int i = 0;
+   for (auto t : TrackList::Get( project )) {
+      t->TypeSwitch( [&](const WaveTrack &waveTrack) {
+         sendList( RealtimeEffectList::Get( waveTrack ), i );
+      } );
+      // Per track numbering counts all tracks
+      i++;
+   }
+   context.EndArray();
+   context.EndField();
+   context.EndStruct();
+   return true;
+}
+
 bool GetInfoCommand::SendTracks(const CommandContext & context)
 {
    auto &tracks = TrackList::Get( context.project );
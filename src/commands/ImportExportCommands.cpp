@@ -33,6 +33,7 @@
 #include "ExportUtils.h"
 #include "ProjectRate.h"
 #include "ExportPluginRegistry.h"
+#include "SharedExportMix.h"
 #include "export/ExportProgressUI.h"
 
 
@@ -84,6 +85,7 @@ bool ExportCommand::VisitSettings( SettingsVisitorBase<Const> & S ){
    fn.SetName("exported.wav");
    S.Define(mFileName, wxT("Filename"), fn.GetFullPath());
    S.Define( mnChannels, wxT("NumChannels"),  1 );
+   S.Define( mMoreFileNames, wxT("MoreFilenames"), wxString{} );
    return true;
 }
 
@@ -106,6 +108,7 @@ void ExportCommand::PopulateOrExchange(ShuttleGui & S)
    {
       S.TieTextBox(XXO("File Name:"),mFileName);
       S.TieTextBox(XXO("Number of Channels:"),mnChannels);
+      S.TieTextBox(XXO("More File Names (separated by |):"),mMoreFileNames);
    }
    S.EndMultiColumn();
 }
@@ -117,45 +120,106 @@ bool ExportCommand::Apply(const CommandContext & context)
    t0 = selectedRegion.t0();
    t1 = selectedRegion.t1();
 
-   // Find the extension and check it's valid
-   int splitAt = mFileName.Find(wxUniChar('.'), true);
-   if (splitAt < 0)
+   // More files may be given, to write the same mix in several formats
+   FilePaths fileNames;
+   fileNames.push_back(mFileName);
+   for (const auto &fileName : wxSplit(mMoreFileNames, '|', '\0'))
+      if (!fileName.empty())
+         fileNames.push_back(fileName);
+   // All of the exports run at once, each with its own buffers and encoder
+   if (fileNames.size() > MaxFiles)
    {
-      context.Error(wxT("Export filename must have an extension!"));
+      context.Error(wxString::Format(
+         wxT("Could not export to more than %d files at once!"), int(MaxFiles)));
       return false;
    }
-   wxString extension = mFileName.Mid(splitAt+1).MakeUpper();
 
-   auto [plugin, formatIndex] = ExportPluginRegistry::Get().FindFormat(extension);
+   struct Target {
+      wxString fileName;
+      wxString extension;
+      const ExportPlugin* plugin;
+      int formatIndex;
+   };
+   std::vector<Target> targets;
+   for (const auto &fileName : fileNames)
+   {
+      // Find the extension and check it's valid
+      int splitAt = fileName.Find(wxUniChar('.'), true);
+      if (splitAt < 0)
+      {
+         context.Error(wxT("Export filename must have an extension!"));
+         return false;
+      }
+      wxString extension = fileName.Mid(splitAt+1).MakeUpper();
+
+      auto [plugin, formatIndex] = ExportPluginRegistry::Get().FindFormat(extension);
+      if (plugin == nullptr)
+      {
+         context.Error(wxString::Format(wxT("Could not export to %s format!"), extension));
+         return false;
+      }
+      targets.push_back({ fileName, extension, plugin, formatIndex });
+   }
+
+   const auto rate = ProjectRate::Get(context.project).GetRate();
+   // The mix, with its effects, is rendered once for all of the files
+   const auto sharedMix = targets.size() > 1
+      ? SharedExportMix::Create(rate)
+      : nullptr;
 
-   if(plugin != nullptr)
+   auto makeBuilder = [&](const Target &target)
    {
-      auto editor = plugin->CreateOptionsEditor(formatIndex, nullptr);
+      auto editor = target.plugin->CreateOptionsEditor(target.formatIndex, nullptr);
       editor->Load(*gPrefs);
 
-      auto builder = ExportTaskBuilder{}
+      return ExportTaskBuilder{}
          .SetParameters(ExportUtils::ParametersFromEditor(*editor))
          .SetNumChannels(std::max(0, mnChannels))
-         .SetSampleRate(ProjectRate::Get(context.project).GetRate())
-         .SetPlugin(plugin)
-         .SetFileName(mFileName)
-         .SetRange(t0, t1, true);
-
-      auto result = ExportResult::Error;
+         .SetSampleRate(rate)
+         .SetPlugin(target.plugin)
+         .SetFileName(target.fileName)
+         .SetRange(t0, t1, true)
+         .SetSharedMix(sharedMix);
+   };
+
+   std::vector<ExportResult> results(targets.size(), ExportResult::Error);
+   if (targets.size() == 1)
+   {
+      auto builder = makeBuilder(targets[0]);
       ExportProgressUI::ExceptionWrappedCall([&]
       {
-         result = ExportProgressUI::Show(builder.Build(context.project));
+         results[0] = ExportProgressUI::Show(builder.Build(context.project));
       });
-      if (result == ExportResult::Success || result == ExportResult::Stopped)
-      {
+   }
+   else
+   {
+      // Build all of the tasks before any runs, so that each reads the
+      // shared mix from its start
+      std::vector<ExportTask> tasks(targets.size());
+      for (size_t i = 0; i < targets.size(); ++i)
+         ExportProgressUI::ExceptionWrappedCall([&]
+         {
+            tasks[i] = makeBuilder(targets[i]).Build(context.project);
+         });
+      ExportProgressUI::Show(tasks.size(), tasks.size(),
+         [&](size_t index) { return std::move(tasks[index]); },
+         [&](size_t index, ExportResult result) { results[index] = result; });
+   }
+
+   auto success = true;
+   for (size_t i = 0; i < targets.size(); ++i)
+   {
+      const auto &target = targets[i];
+      if (results[i] == ExportResult::Success || results[i] == ExportResult::Stopped)
          context.Status(wxString::Format(wxT("Exported to %s format: %s"),
-                                         extension, mFileName));
-         return true;
+                                         target.extension, target.fileName));
+      else
+      {
+         context.Error(wxString::Format(wxT("Could not export to %s format!"), target.extension));
+         success = false;
       }
    }
-
-   context.Error(wxString::Format(wxT("Could not export to %s format!"), extension));
-   return false;
+   return success;
 }
 
 namespace {
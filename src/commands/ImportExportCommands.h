@@ -60,6 +60,12 @@ public:
    // AudacityCommand overrides
    ManualPageID ManualPage() override {return L"Extra_Menu:_Scriptables_II#export";}
 public:
+   //! Most files that one command exports at once
+   static constexpr size_t MaxFiles = 8;
+
    wxString mFileName;
    int mnChannels;
+   //! Further files, separated by '|', written at once from the same mix
+   //! as mFileName, which is rendered only once
+   wxString mMoreFileNames;
 };
@@ -0,0 +1,104 @@
+/**********************************************************************
+
+   Audacity - A Digital Audio Editor
+   License: wxwidgets
+
+******************************************************************//**
+
+\file TraceCommand.cpp
+\brief Definitions for TraceCommand class
+
+*//*******************************************************************/
+
+
+#include "TraceCommand.h"
+
+#include <wx/ffile.h>
+
+#include "CommandDispatch.h"
+#include "MenuRegistry.h"
+#include "../CommonCommandFlags.h"
+#include "LoadCommands.h"
+#include "CommandContext.h"
+#include "SettingsVisitor.h"
+#include "ShuttleGui.h"
+#include "Tracing.h"
+
+const ComponentInterfaceSymbol TraceCommand::Symbol
+{ XO("Trace") };
+
+namespace{ BuiltinCommandsModule::Registration< TraceCommand > reg; }
+
+enum {
+   kStart,
+   kStop,
+   nActions
+};
+
+static const EnumValueSymbol kActions[nActions] =
+{
+   { XO("Start") },
+   { XO("Stop") },
+};
+
+template<bool Const>
+bool TraceCommand::VisitSettings( SettingsVisitorBase<Const> & S ){
+   S.DefineEnum( mAction, wxT("Action"), kStart, kActions, nActions );
+   S.Define( mFileName, wxT("Filename"), wxString{"trace.json"} );
+   return true;
+}
+
+bool TraceCommand::VisitSettings( SettingsVisitor & S )
+   { return VisitSettings<false>(S); }
+
+bool TraceCommand::VisitSettings( ConstSettingsVisitor & S )
+   { return VisitSettings<true>(S); }
+
+void TraceCommand::PopulateOrExchange(ShuttleGui & S)
+{
+   S.AddSpace(0, 5);
+
+   S.StartMultiColumn(2, wxALIGN_CENTER);
+   {
+      S.TieChoice( XXO("Action:"),
+         mAction, Msgids( kActions, nActions ));
+      S.TieTextBox(XXO("File Name:"),mFileName);
+   }
+   S.EndMultiColumn();
+}
+
+bool TraceCommand::Apply(const CommandContext & context){
+   if (mAction == kStart) {
+      Tracing::Start();
+      context.Status(wxT("Tracing started"));
+      return true;
+   }
+
+   if (!Tracing::IsStarted()) {
+      context.Error(wxT("Tracing was not started"));
+      return false;
+   }
+   // Not fopen, which can't take every path on Windows
+   wxFFile file{ mFileName, wxT("w") };
+   const bool written = Tracing::Stop(file.fp());
+   if (!(file.Close() && written)) {
+      context.Error(wxString::Format(
+         wxT("Could not write the trace to %s"), mFileName));
+      return false;
+   }
+   context.Status(wxString::Format(wxT("Trace written to %s"), mFileName));
+   return true;
+}
+
+namespace {
+using namespace MenuRegistry;
+
+// Register menu items
+
+AttachedItem sAttachment{
+   Command( wxT("Trace"), XXO("Trace..."),
+      CommandDispatch::OnAudacityCommand, AlwaysEnabledFlag ),
+   wxT("Optional/Extra/Part2/Scriptables2")
+};
+
+}
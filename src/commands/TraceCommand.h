@@ -0,0 +1,47 @@
+/**********************************************************************
+
+   Audacity - A Digital Audio Editor
+   License: wxwidgets
+
+******************************************************************//**
+
+\file TraceCommand.h
+\brief Contains definition of TraceCommand class.
+
+*//***************************************************************//**
+
+\class TraceCommand
+\brief Command to start tracing hot paths, or to stop and write the trace
+
+*//*******************************************************************/
+
+#ifndef __TRACE_COMMAND__
+#define __TRACE_COMMAND__
+
+#include "CommandType.h"
+#include "Command.h"
+
+class TraceCommand : public AudacityCommand
+{
+public:
+   static const ComponentInterfaceSymbol Symbol;
+
+   // ComponentInterface overrides
+   ComponentInterfaceSymbol GetSymbol() const override {return Symbol;};
+   TranslatableString GetDescription() const override
+   {return XO("Starts recording a trace, or stops and writes it as a Chrome trace file.");};
+   template<bool Const> bool VisitSettings( SettingsVisitorBase<Const> &S );
+   bool VisitSettings( SettingsVisitor & S ) override;
+   bool VisitSettings( ConstSettingsVisitor & S ) override;
+   void PopulateOrExchange(ShuttleGui & S) override;
+   bool Apply(const CommandContext & context) override;
+
+   // AudacityCommand overrides
+   ManualPageID ManualPage() override {return L"Extra_Menu:_Scriptables_II#trace";}
+public:
+   int mAction;
+   wxString mFileName;
+};
+
+
+#endif /* End of include guard: __TRACE_COMMAND__ */
@@ -1153,7 +1153,8 @@ DialogFactoryResults EffectUI::DialogFactory(wxWindow &parent,
    auto &selectedRegion = ViewInfo::Get( project ).selectedRegion;
    auto &commandManager = CommandManager::Get( project );
    auto &viewport = Viewport::Get(project);
-   auto &window = GetProjectFrame(project);
+   // Null for a project without a window, which cannot prompt
+   const auto pWindow = FindProjectFrame(&project);
 
    const PluginDescriptor *plug = PluginManager::Get().GetPlugin(ID);
 
@@ -1214,7 +1215,7 @@ DialogFactoryResults EffectUI::DialogFactory(wxWindow &parent,
          const auto pAccess =
             std::make_shared<SimpleEffectSettingsAccess>(*pSettings);
          const auto finder =
-         [effect, &window, pAccess, flags] (EffectSettings &settings)
+         [effect, pWindow, pAccess, flags] (EffectSettings &settings)
             -> std::optional<std::shared_ptr<EffectInstanceEx>>
          {
             // Prompting will be bypassed when applying an effect that has
@@ -1224,9 +1225,9 @@ DialogFactoryResults EffectUI::DialogFactory(wxWindow &parent,
             std::shared_ptr<EffectInstanceEx> pInstanceEx;
             if ((flags & EffectManager::kConfigured) == 0 && pAccess) {
                const auto pServices = dynamic_cast<EffectUIServices *>(effect);
-               if (!pServices ||
+               if (!pWindow || !pServices ||
                    !pServices->ShowHostInterface(*effect,
-                  window, DialogFactory, pInstance, *pAccess, true)
+                  *pWindow, DialogFactory, pInstance, *pAccess, true)
                )
                   return {};
                else if (!(pInstanceEx =
@@ -12,7 +12,9 @@
 
 #include "ExportAudioDialog.h"
 
+#include <algorithm>
 #include <numeric>
+#include <thread>
 
 #include "Export.h"
 #include "ExportUtils.h"
@@ -29,6 +31,7 @@
 #include <wx/textctrl.h>
 #include <wx/button.h>
 #include <wx/radiobut.h>
+#include <wx/spinctrl.h>
 #include <wx/stattext.h>
 #include <wx/event.h>
 
@@ -86,6 +89,8 @@ StringSetting ExportAudioDefaultFormat{ L"/ExportAudioDialog/Format", L"WAV" };
 
 StringSetting ExportAudioDefaultPath{ L"ExportAudioDialog/DefaultPath", L"" };
 
+IntSetting ExportAudioMaxJobs { L"/ExportAudioDialog/MaxJobs", 1 };
+
 enum {
    ExportFilePanelID = 10000,//to avoid IDs collision with ExportFilePanel items
 
@@ -367,6 +372,13 @@ void ExportAudioDialog::PopulateOrExchange(ShuttleGui& S)
          mOverwriteExisting = S
             .Id(OverwriteExistingFilesID)
             .TieCheckBox(XO("Overwrite existing files"), ExportAudioOverwriteExisting);
+
+         S.StartHorizontalLay(wxALIGN_LEFT);
+         {
+            mMaxJobs = S.TieSpinCtrl(XO("Files at &once:"), ExportAudioMaxJobs,
+               std::max<int>(1, std::thread::hardware_concurrency()), 1);
+         }
+         S.EndHorizontalLay();
       }
       S.EndPanel();
       
@@ -676,6 +688,63 @@ unsigned GetNumExportChannels( const TrackList &tracks )
       : 2;
 }
 
+//! The file written for one of several exports, and where the file it
+//! replaces was moved, if any
+struct ExportTarget
+{
+   wxString fullPath;
+   wxFileName backup;
+};
+
+ExportTarget PrepareExportTarget(const wxFileName& filename, bool overwrite)
+{
+   wxFileName name;
+   wxFileName backup;
+   if (overwrite) {
+      name = filename;
+      backup.Assign(name);
+
+      int suffix = 0;
+      do {
+         backup.SetName(name.GetName() +
+                           wxString::Format(wxT("%d"), suffix));
+         ++suffix;
+      }
+      while (backup.FileExists());
+      ::wxRenameFile(filename.GetFullPath(), backup.GetFullPath());
+   }
+   else {
+      name = filename;
+      int i = 2;
+      wxString base(name.GetName());
+      while (name.FileExists()) {
+         name.SetName(wxString::Format(wxT("%s-%d"), base, i++));
+      }
+   }
+   return { name.GetFullPath(), backup };
+}
+
+void FinishExportTarget(const ExportTarget& target, bool success)
+{
+   if (target.fullPath.empty())
+      return;
+   if (target.backup.IsOk()) {
+      if ( success )
+         // Remove backup
+         ::wxRemoveFile(target.backup.GetFullPath());
+      else {
+         // Restore original
+         ::wxRemoveFile(target.fullPath);
+         ::wxRenameFile(target.backup.GetFullPath(), target.fullPath);
+      }
+   }
+   else {
+      if ( ! success )
+         // Remove any new, and only partially written, file.
+         ::wxRemoveFile(target.fullPath);
+   }
+}
+
 }
 
 
@@ -873,6 +942,11 @@ ExportResult ExportAudioDialog::DoExportSplitByLabels(const ExportPlugin& plugin
                                                       const ExportProcessor::Parameters& parameters,
                                                       FilePaths& exporterFiles)
 {
+   const auto maxJobs = static_cast<size_t>(mMaxJobs->GetValue());
+   if(maxJobs > 1)
+      return DoExportConcurrently(plugin, formatIndex, parameters, false, {},
+         maxJobs, exporterFiles);
+
    auto ok = ExportResult::Success;   // did it work?
    /* Go round again and do the exporting (so this run is slow but
     * non-interactive) */
@@ -926,6 +1000,20 @@ ExportResult ExportAudioDialog::DoExportSplitByTracks(const ExportPlugin& plugin
    for (auto tr : tracks.Selected<WaveTrack>())
       tr->SetSelected(false);
 
+   const auto maxJobs = static_cast<size_t>(mMaxJobs->GetValue());
+   if(maxJobs > 1)
+   {
+      // Each mixer takes its inputs from the selection when its task is
+      // built, so select just one track before each build
+      const std::vector<WaveTrack*> exportTracks(waveTracks.begin(), waveTracks.end());
+      return DoExportConcurrently(plugin, formatIndex, parameters, true,
+         [&](size_t index) {
+            for(size_t i = 0; i < exportTracks.size(); ++i)
+               exportTracks[i]->SetSelected(i == index);
+         },
+         maxJobs, exporterFiles);
+   }
+
    auto ok = ExportResult::Success;
 
    int count = 0;
@@ -979,8 +1067,6 @@ ExportResult ExportAudioDialog::DoExport(const ExportPlugin& plugin,
                                          const Tags& tags,
                                          FilePaths& exportedFiles)
 {
-   wxFileName name;
-
    wxLogDebug(wxT("Doing multiple Export: File name \"%s\""), (filename.GetFullName()));
    wxLogDebug(wxT("Channels: %i, Start: %lf, End: %lf "), channels, t0, t1);
    if (selectedOnly)
@@ -988,48 +1074,12 @@ ExportResult ExportAudioDialog::DoExport(const ExportPlugin& plugin,
    else
       wxLogDebug(wxT("Whole Project"));
 
-   wxFileName backup;
-   if (mOverwriteExisting->GetValue()) {
-      name = filename;
-      backup.Assign(name);
-
-      int suffix = 0;
-      do {
-         backup.SetName(name.GetName() +
-                           wxString::Format(wxT("%d"), suffix));
-         ++suffix;
-      }
-      while (backup.FileExists());
-      ::wxRenameFile(filename.GetFullPath(), backup.GetFullPath());
-   }
-   else {
-      name = filename;
-      int i = 2;
-      wxString base(name.GetName());
-      while (name.FileExists()) {
-         name.SetName(wxString::Format(wxT("%s-%d"), base, i++));
-      }
-   }
-
    bool success{false};
-   const wxString fullPath{name.GetFullPath()};
+   const auto target = PrepareExportTarget(filename, mOverwriteExisting->GetValue());
+   const wxString& fullPath{target.fullPath};
 
    auto cleanup = finally( [&] {
-      if (backup.IsOk()) {
-         if ( success )
-            // Remove backup
-            ::wxRemoveFile(backup.GetFullPath());
-         else {
-            // Restore original
-            ::wxRemoveFile(fullPath);
-            ::wxRenameFile(backup.GetFullPath(), fullPath);
-         }
-      }
-      else {
-         if ( ! success )
-            // Remove any new, and only partially written, file.
-            ::wxRemoveFile(fullPath);
-      }
+      FinishExportTarget(target, success);
    } );
    
    auto result = ExportResult::Error;
@@ -1054,3 +1104,76 @@ ExportResult ExportAudioDialog::DoExport(const ExportPlugin& plugin,
 }
 
 
+
+ExportResult ExportAudioDialog::DoExportConcurrently(const ExportPlugin& plugin,
+                                                     int formatIndex,
+                                                     const ExportProcessor::Parameters& parameters,
+                                                     bool selectedOnly,
+                                                     const std::function<void(size_t)>& select,
+                                                     size_t maxJobs,
+                                                     FilePaths& exportedFiles)
+{
+   const auto count = mExportSettings.size();
+   std::vector<ExportTarget> targets(count);
+   std::vector<bool> exported(count, false);
+
+   auto ok = ExportResult::Success;
+   size_t first = 0;
+   while(first < count)
+   {
+      auto next = first;
+      ok = ExportProgressUI::Show(count - first, maxJobs,
+         [&](size_t index)
+         {
+            const auto settingIndex = first + index;
+            next = settingIndex + 1;
+
+            auto& activeSetting = mExportSettings[settingIndex];
+            // Bug 1440 fix.
+            if( activeSetting.filename.GetName().empty() )
+               return ExportTask{};
+
+            auto& target = targets[settingIndex];
+            target = PrepareExportTarget(activeSetting.filename, mOverwriteExisting->GetValue());
+            if(select)
+               select(settingIndex);
+
+            return ExportTaskBuilder{}.SetPlugin(&plugin, formatIndex)
+               .SetParameters(parameters)
+               .SetRange(activeSetting.t0, activeSetting.t1, selectedOnly)
+               .SetTags(&activeSetting.tags)
+               .SetNumChannels(activeSetting.channels)
+               .SetFileName(target.fullPath)
+               .SetSampleRate(mExportOptionsPanel->GetSampleRate())
+               .Build(mProject);
+         },
+         [&](size_t index, ExportResult result)
+         {
+            const auto settingIndex = first + index;
+            const auto success = result == ExportResult::Success || result == ExportResult::Stopped;
+            FinishExportTarget(targets[settingIndex], success);
+            exported[settingIndex] = success;
+         });
+
+      if (ok != ExportResult::Stopped)
+         break;
+
+      AudacityMessageDialog dlgMessage(
+         nullptr,
+         XO("Continue to export remaining files?"),
+         XO("Export"),
+         wxYES_NO | wxNO_DEFAULT | wxICON_WARNING);
+      if (dlgMessage.ShowModal() != wxID_YES ) {
+         // User decided not to continue - bail out!
+         break;
+      }
+      first = next;
+   }
+
+   // Report the files in the same order as the serial export would
+   for(size_t i = 0; i < count; ++i)
+      if(exported[i])
+         exportedFiles.push_back(targets[i].fullPath);
+
+   return ok;
+}
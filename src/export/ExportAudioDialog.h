@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "wxPanelWrapper.h"
 #include "ExportTypes.h"
 #include <wx/filename.h>
@@ -33,6 +35,7 @@ class wxButton;
 class wxChoice;
 class wxRadioButton;
 class wxCheckBox;
+class wxSpinCtrl;
 
 namespace MixerOptions
 {
@@ -103,6 +106,18 @@ private:
                          double t0, double t1, bool selectedOnly,
                          const Tags& tags,
                          FilePaths& exportedFiles);
+
+   //! Export the files of mExportSettings, up to maxJobs at once
+   /*!
+    @param select called before building the task for each setting
+    */
+   ExportResult DoExportConcurrently(const ExportPlugin& plugin,
+                                     int formatIndex,
+                                     const ExportProcessor::Parameters& parameters,
+                                     bool selectedOnly,
+                                     const std::function<void(size_t)>& select,
+                                     size_t maxJobs,
+                                     FilePaths& exportedFiles);
    
    AudacityProject& mProject;
 
@@ -125,6 +140,7 @@ private:
    wxRadioButton* mSplitUseNumAndPrefix{};
    wxCheckBox* mOverwriteExisting{};
    wxCheckBox* mSkipSilenceAtBeginning{};
+   wxSpinCtrl* mMaxJobs{};
 
    std::vector<ExportSetting> mExportSettings;
    bool mExportSettingsDirty{true};
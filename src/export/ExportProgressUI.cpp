@@ -10,6 +10,10 @@
 
 #include "ExportProgressUI.h"
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 #include "Export.h"
 #include "ExportPlugin.h"
 #include "Internat.h"
@@ -76,6 +80,47 @@ namespace
       
    };
 
+   //! Shares the Cancel and Stop requests of one dialog among several tasks
+   class JobExportProgressDelegate : public ExportProcessorDelegate
+   {
+      const std::atomic<bool>& mCancelled;
+      const std::atomic<bool>& mStopped;
+      std::atomic<double> mProgress {};
+   public:
+
+      JobExportProgressDelegate(const std::atomic<bool>& cancelled,
+                                const std::atomic<bool>& stopped)
+         : mCancelled(cancelled)
+         , mStopped(stopped)
+      {
+      }
+
+      bool IsCancelled() const override
+      {
+         return mCancelled;
+      }
+
+      bool IsStopped() const override
+      {
+         return mStopped;
+      }
+
+      void SetStatusString(const TranslatableString&) override
+      {
+         //The dialog counts files instead
+      }
+
+      void OnProgress(double progress) override
+      {
+         mProgress = progress;
+      }
+
+      double GetProgress() const
+      {
+         return mProgress;
+      }
+   };
+
 }
 
 ExportResult ExportProgressUI::Show(ExportTask exportTask)
@@ -101,3 +146,116 @@ ExportResult ExportProgressUI::Show(ExportTask exportTask)
 
    return result;
 }
+
+ExportResult ExportProgressUI::Show(size_t count, size_t maxJobs,
+   const TaskFactory& factory, const TaskCompletion& completion)
+{
+   struct Job
+   {
+      size_t index;
+      std::future<ExportResult> future;
+      std::unique_ptr<JobExportProgressDelegate> delegate;
+   };
+
+   constexpr long long ProgressSteps = 1000ul;
+
+   maxJobs = std::max<size_t>(1, maxJobs);
+
+   std::atomic<bool> cancelled {false};
+   std::atomic<bool> stopped {false};
+   auto progressDialog = BasicUI::MakeProgress(XO("Export"), {});
+
+   std::vector<Job> running;
+   size_t next = 0;
+   size_t finished = 0;
+   auto result = ExportResult::Success;
+
+   auto finish = [&](size_t index, ExportResult jobResult)
+   {
+      ++finished;
+      completion(index, jobResult);
+      if(result == ExportResult::Success)
+         result = jobResult;
+      if(jobResult == ExportResult::Error)
+         cancelled = true;
+   };
+
+   while(!running.empty() || (next < count && !cancelled && !stopped))
+   {
+      while(next < count && running.size() < maxJobs && !cancelled && !stopped)
+      {
+         const auto index = next++;
+         ExportTask task;
+         auto built = false;
+         ExceptionWrappedCall([&]
+         {
+            task = factory(index);
+            built = true;
+         });
+         if(!built)
+         {
+            finish(index, ExportResult::Error);
+            continue;
+         }
+         if(!task.valid())
+         {
+            ++finished;
+            continue;
+         }
+         auto delegate = std::make_unique<JobExportProgressDelegate>(cancelled, stopped);
+         auto future = task.get_future();
+         std::thread(std::move(task), std::ref(*delegate)).detach();
+         running.push_back({ index, std::move(future), std::move(delegate) });
+      }
+
+      if(running.empty())
+         continue;
+
+      running.front().future.wait_for(std::chrono::milliseconds(50));
+
+      const auto end = std::partition(running.begin(), running.end(),
+         [](const Job& job) {
+            return job.future.wait_for(std::chrono::seconds(0)) !=
+               std::future_status::ready;
+         });
+      for(auto iter = end; iter != running.end(); ++iter)
+      {
+         auto jobResult = ExportResult::Error;
+         ExceptionWrappedCall([&] { jobResult = iter->future.get(); });
+         finish(iter->index, jobResult);
+      }
+      running.erase(end, running.end());
+
+      auto progress = static_cast<double>(finished);
+      for(const auto& job : running)
+         progress += job.delegate->GetProgress();
+
+      progressDialog->SetMessage(XO("Exported %lld of %lld files")
+         .Format(static_cast<long long>(finished), static_cast<long long>(count)));
+      const auto pollResult = progressDialog->Poll(
+         static_cast<long long>(progress * ProgressSteps / count), ProgressSteps);
+
+      if(pollResult == BasicUI::ProgressResult::Cancelled)
+      {
+         if(!stopped)
+            cancelled = true;
+      }
+      else if(pollResult == BasicUI::ProgressResult::Stopped)
+      {
+         if(!cancelled)
+            stopped = true;
+      }
+   }
+
+   progressDialog.reset();
+
+   if(result == ExportResult::Error)
+   {
+      BasicUI::ShowErrorDialog(
+         {}, XO("Export error"),
+         XO("Export completed with error."), {},
+         BasicUI::ErrorDialogOptions { BasicUI::ErrorDialogType::ModalError });
+   }
+
+   return result;
+}
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <functional>
 #include <future>
 
 #include "Export.h"
@@ -25,6 +26,24 @@ namespace ExportProgressUI
 {
    ExportResult Show(ExportTask exportTask);
 
+   //! Builds the task for one of several files, or returns an invalid task
+   //! to skip that file
+   using TaskFactory = std::function<ExportTask(size_t index)>;
+   //! Receives the result of each task that was built
+   using TaskCompletion = std::function<void(size_t index, ExportResult result)>;
+
+   //! Runs the tasks for `count` files, at most `maxJobs` at once, with one
+   //! progress dialog for all of them
+   /*!
+    Tasks are built in order of index, on the main thread, only when a job
+    is free, so that no more than `maxJobs` processors exist at once.
+    Stop and Cancel apply to all running tasks, and no more tasks are
+    built after them; an error in one task cancels the others.
+    @return Success if all tasks succeeded, else the first other result
+    */
+   ExportResult Show(size_t count, size_t maxJobs,
+      const TaskFactory& factory, const TaskCompletion& completion);
+
    template<typename Callable>
    void ExceptionWrappedCall(Callable callable)
    {
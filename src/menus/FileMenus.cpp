@@ -34,6 +34,8 @@
 #include <wx/app.h>
 #include <wx/menu.h>
 #include <wx/frame.h>
+#include <wx/txtstrm.h>
+#include <wx/wfstream.h>
 
 #include "ExportPluginRegistry.h"
 #include "ProjectRate.h"
@@ -326,8 +328,7 @@ void OnExportLabels(const CommandContext &context)
    if (fName.empty())
       return;
 
-   // Move existing files out of the way.  Otherwise wxTextFile will
-   // append to (rather than replace) the current file.
+   // Move existing files out of the way, keeping a backup.
 
    if (wxFileExists(fName)) {
 #ifdef __WXGTK__
@@ -342,20 +343,23 @@ void OnExportLabels(const CommandContext &context)
       wxRename(fName, safetyFileName);
    }
 
-   wxTextFile f(fName);
-   f.Create();
-   f.Open();
-   if (!f.IsOpened()) {
+   // Write one label at a time, so that very many labels need not be held
+   // in memory as lines of text
+   wxFFileOutputStream stream{ fName };
+   if (!stream.IsOk()) {
       AudacityMessageBox(
          XO( "Couldn't write to file: %s" ).Format( fName ) );
       return;
    }
+   wxTextOutputStream f{ stream };
 
    for (auto lt : trackRange)
       lt->Export(f);
 
-   f.Write();
-   f.Close();
+   f.Flush();
+   if (!stream.Close())
+      AudacityMessageBox(
+         XO( "Couldn't write to file: %s" ).Format( fName ) );
 }
 
 void OnImport(const CommandContext &context)
@@ -382,10 +386,9 @@ void OnImportLabels(const CommandContext &context)
          &window);    // Parent
 
    if (!fileName.empty()) {
-      wxTextFile f;
+      wxFFileInputStream f{ fileName };
 
-      f.Open(fileName);
-      if (!f.IsOpened()) {
+      if (!f.IsOk()) {
          AudacityMessageBox(
             XO("Could not open file: %s").Format( fileName ) );
          return;
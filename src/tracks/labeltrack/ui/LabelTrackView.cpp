@@ -417,9 +417,28 @@ void LabelTrackView::ComputeTextPosition(const wxRect & r, int index) const
    labelStruct.xText = xText;
 }
 
+namespace {
+// Labels that begin up to one width to the left of the rectangle are also laid
+// out, because their text may reach into it, and so that rows are assigned
+// much as if all of the labels were laid out
+std::pair<double, double> LayoutTimes(
+   const wxRect &r, const ZoomInfo &zoomInfo)
+{
+   return { zoomInfo.PositionToTime(r.x - r.width, r.x),
+      zoomInfo.PositionToTime(r.x + r.width, r.x) };
+}
+}
+
+std::pair<size_t, size_t>
+LabelTrackView::LaidOutLabels(const LabelTrack &track) const
+{
+   return track.FindLabels(mLaidOutT0, mLaidOutT1);
+}
+
 /// ComputeLayout determines which row each label
 /// should be placed on, and reserves space for it.
 /// Function assumes that the labels are sorted.
+/// Only labels near the visible times are laid out.
 void LabelTrackView::ComputeLayout(const wxRect & r, const ZoomInfo &zoomInfo) const
 {
    int xUsed[MAX_NUM_ROWS];
@@ -453,7 +472,12 @@ void LabelTrackView::ComputeLayout(const wxRect & r, const ZoomInfo &zoomInfo) c
    const auto pTrack = FindLabelTrack();
    const auto &mLabels = pTrack->GetLabels();
 
-   { int i = -1; for (const auto &labelStruct : mLabels) { ++i;
+   const auto layoutTimes = LayoutTimes(r, zoomInfo);
+   mLaidOutT0 = layoutTimes.first;
+   mLaidOutT1 = layoutTimes.second;
+   const auto [first, last] = LaidOutLabels(*pTrack);
+   for (int i = first; i < (int)last; ++i) {
+      const auto &labelStruct = mLabels[i];
       const int x = zoomInfo.TimeToPosition(labelStruct.getT0(), r.x);
       const int x1 = zoomInfo.TimeToPosition(labelStruct.getT1(), r.x);
       int y = r.y;
@@ -506,7 +530,7 @@ void LabelTrackView::ComputeLayout(const wxRect & r, const ZoomInfo &zoomInfo) c
          if( xUsed[iRow] < x1 ) xUsed[iRow]=x1;
          ComputeTextPosition( r, i );
       }
-   }}
+   }
 }
 
 /// Draw vertical lines that go exactly through the position
@@ -801,12 +825,18 @@ void LabelTrackView::Draw
 
    wxCoord textWidth, textHeight;
 
+   // Measure, lay out, and draw only the labels near the visible times
+   const auto [layoutT0, layoutT1] = LayoutTimes(r, zoomInfo);
+   const auto [first, last] = pTrack->FindLabels(layoutT0, layoutT1);
+   const auto labelsBegin = mLabels.begin() + first,
+      labelsEnd = mLabels.begin() + last;
+
    // Get the text widths.
    // TODO: Make more efficient by only re-computing when a
    // text label title changes.
-   for (const auto &labelStruct : mLabels) {
-      dc.GetTextExtent(labelStruct.title, &textWidth, &textHeight);
-      labelStruct.width = textWidth;
+   for (auto iter = labelsBegin; iter != labelsEnd; ++iter) {
+      dc.GetTextExtent(iter->title, &textWidth, &textHeight);
+      iter->width = textWidth;
    }
 
    // TODO: And this only needs to be done once, but we
@@ -829,11 +859,12 @@ void LabelTrackView::Draw
    // so that the correct things overpaint each other.
 
    // Draw vertical lines that show where the end positions are.
-   for (const auto &labelStruct : mLabels)
-      DrawLines( dc, labelStruct, r );
+   for (auto iter = labelsBegin; iter != labelsEnd; ++iter)
+      DrawLines( dc, *iter, r );
 
    // Draw the end glyphs.
-   { int i = -1; for (const auto &labelStruct : mLabels) { ++i;
+   { int i = (int)first - 1; for (auto iter = labelsBegin; iter != labelsEnd; ++iter) {
+      const auto &labelStruct = *iter; ++i;
       GlyphLeft=0;
       GlyphRight=1;
       if( pHit && i == pHit->mMouseOverLabelLeft )
@@ -854,7 +885,8 @@ void LabelTrackView::Draw
          target->FindChannel().get() ==
             static_cast<const LabelTrack*>(FindTrack().get());
 #endif
-      int i = -1; for (const auto &labelStruct : mLabels) { ++i;
+      int i = (int)first - 1; for (auto iter = labelsBegin; iter != labelsEnd; ++iter) {
+         const auto &labelStruct = *iter; ++i;
          bool highlight = false;
 #ifdef EXPERIMENTAL_TRACK_PANEL_HIGHLIGHTING
          highlight = highlightTrack && target->GetLabelNum() == i;
@@ -888,7 +920,8 @@ void LabelTrackView::Draw
    }
 
    // Draw the text and the label boxes.
-   { int i = -1; for (const auto &labelStruct : mLabels) { ++i;
+   { int i = (int)first - 1; for (auto iter = labelsBegin; iter != labelsEnd; ++iter) {
+      const auto &labelStruct = *iter; ++i;
       if(mTextEditIndex == i )
          dc.SetBrush(AColor::labelTextEditBrush);
       DrawText( dc, labelStruct, r );
@@ -1235,7 +1268,9 @@ void LabelTrackView::OverGlyph(
 
    const auto pTrack = &track;
    const auto &mLabels = pTrack->GetLabels();
-   { int i = -1; for (const auto &labelStruct : mLabels) { ++i;
+   const auto [first, last] = Get(track).LaidOutLabels(track);
+   for (int i = first; i < (int)last; ++i) {
+      const auto &labelStruct = mLabels[i];
       // give text box better priority for selecting
       // reset selection state
       if (OverTextBox(&labelStruct, x, y))
@@ -1283,7 +1318,7 @@ void LabelTrackView::OverGlyph(
          hit.mMouseOverLabel = i;
          result = 3;
       }
-   }}
+   }
    hit.mEdge = result;
 }
 
@@ -1291,7 +1326,8 @@ int LabelTrackView::OverATextBox( const LabelTrack &track, int xx, int yy )
 {
    const auto pTrack = &track;
    const auto &mLabels = pTrack->GetLabels();
-   for (int nn = (int)mLabels.size(); nn--;) {
+   const auto [first, last] = Get(track).LaidOutLabels(track);
+   for (int nn = (int)last; nn-- > (int)first;) {
       const auto &labelStruct = mLabels[nn];
       if ( OverTextBox( &labelStruct, xx, yy ) )
          return nn;
@@ -13,6 +13,7 @@ Paul Licameli split from class LabelTrack
 
 #include "../../ui/CommonChannelView.h"
 #include "Observer.h"
+#include <limits>
 
 class LabelGlyphHandle;
 class LabelTextHandle;
@@ -208,6 +209,13 @@ private:
 
    void ComputeTextPosition(const wxRect & r, int index) const;
    void ComputeLayout(const wxRect & r, const ZoomInfo &zoomInfo) const;
+   //! Indices of the labels of track that were laid out for the last drawing;
+   //! only those may be hit
+   std::pair<size_t, size_t> LaidOutLabels(const LabelTrack &track) const;
+
+   //! Times bounding the labels that the last drawing laid out
+   mutable double mLaidOutT0{ -std::numeric_limits<double>::infinity() };
+   mutable double mLaidOutT1{ std::numeric_limits<double>::infinity() };
    static void DrawLines( wxDC & dc, const LabelStruct &ls, const wxRect & r);
    static void DrawGlyphs( wxDC & dc, const LabelStruct &ls, const wxRect & r,
       int GlyphLeft, int GlyphRight);
@@ -59,16 +59,22 @@ struct MinMaxSumsq
    float sumsq;
 };
 
+// Index of the block containing pos, which must be in range
+size_t FindBlock(const BlockArray &blocks, sampleCount pos)
+{
+   const auto iter = std::upper_bound(blocks.begin(), blocks.end(), pos,
+      [](sampleCount pos, const SeqBlock &block){ return pos < block.start; });
+   return std::max<size_t>(1, iter - blocks.begin()) - 1;
 }
 
-bool GetWaveDisplay(const Sequence &sequence,
+bool DoGetWaveDisplay(const BlockArray &blocks,
+   sampleCount numSamples, size_t maxSamples,
    float *min, float *max, float *rms,
    size_t len, const sampleCount *where)
 {
    wxASSERT(len > 0);
    const auto s0 = std::max(sampleCount(0), where[0]);
-   const auto numSamples = sequence.GetNumSamples();
-   if (s0 >= numSamples)
+   if (s0 >= numSamples || blocks.empty())
       // None of the samples asked for are in range. Abandon.
       return false;
 
@@ -76,7 +82,6 @@ bool GetWaveDisplay(const Sequence &sequence,
    // so we load at least one pixel for column len - 1
    // ... unless the mNumSamples ceiling applies, and then there are other defenses
    const auto s1 = std::clamp(where[len], 1 + where[len - 1], numSamples);
-   const auto maxSamples = sequence.GetMaxBlockSize();
    Floats temp{ maxSamples };
 
    decltype(len) pixel = 0;
@@ -89,9 +94,8 @@ bool GetWaveDisplay(const Sequence &sequence,
    decltype(whereNow) whereNext = 0;
    // Loop over block files, opening and reading and closing each
    // not more than once
-   const auto &blocks = sequence.GetBlockArray();
    unsigned nBlocks = blocks.size();
-   const unsigned int block0 = sequence.FindBlock(s0);
+   const unsigned int block0 = FindBlock(blocks, s0);
    for (unsigned int b = block0; b < nBlocks; ++b) {
       if (b > block0)
          srcX = nextSrcX;
@@ -167,8 +171,10 @@ bool GetWaveDisplay(const Sequence &sequence,
       default:
       case 1:
          // Read samples
+         // Not through a view of the block, which would read all of it; this
+         // reads only the samples of the columns, straight into temp
          // no-throw for display operations!
-         sequence.Read(
+         Sequence::Read(
             (samplePtr)temp.get(), floatSample, seqBlock, startPosition, num, false);
          break;
       case 256:
@@ -257,3 +263,41 @@ bool GetWaveDisplay(const Sequence &sequence,
 
    return true;
 }
+
+}
+
+WaveDisplaySource WaveDisplaySource::Make(const Sequence &sequence,
+   size_t len, const sampleCount *where)
+{
+   WaveDisplaySource result;
+   result.numSamples = sequence.GetNumSamples();
+   result.maxBlockSize = sequence.GetMaxBlockSize();
+   const auto &blocks = sequence.GetBlockArray();
+   const auto s0 = std::max(sampleCount(0), where[0]);
+   if (len == 0 || s0 >= result.numSamples || blocks.empty())
+      return result;
+   // The same bounds as in DoGetWaveDisplay
+   const auto s1 = std::clamp(where[len], 1 + where[len - 1], result.numSamples);
+   const auto first = FindBlock(blocks, s0);
+   const auto last = FindBlock(blocks, s1 - 1);
+   result.blocks.assign(blocks.begin() + first, blocks.begin() + last + 1);
+   return result;
+}
+
+bool GetWaveDisplay(const Sequence &sequence,
+   float *min, float *max, float *rms,
+   size_t len, const sampleCount *where)
+{
+   return DoGetWaveDisplay(sequence.GetBlockArray(),
+      sequence.GetNumSamples(), sequence.GetMaxBlockSize(),
+      min, max, rms, len, where);
+}
+
+bool GetWaveDisplay(const WaveDisplaySource &source,
+   float *min, float *max, float *rms,
+   size_t len, const sampleCount *where)
+{
+   return DoGetWaveDisplay(source.blocks,
+      source.numSamples, source.maxBlockSize,
+      min, max, rms, len, where);
+}
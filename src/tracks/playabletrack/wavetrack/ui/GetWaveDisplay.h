@@ -12,8 +12,24 @@
 #define __AUDACITY_GET_WAVE_DISPLAY__
 
 #include <cstddef>
-class Sequence;
-class sampleCount;
+#include "SampleCount.h"
+#include "Sequence.h" // for BlockArray
+
+//! The blocks of a Sequence that a range of display columns reads
+/*!
+ Shares the sample blocks, so it can be read on another thread while the
+ Sequence itself is edited
+ */
+struct WaveDisplaySource {
+   //! Copy only the blocks that GetWaveDisplay() needs for the given columns
+   /*! Arguments are as for GetWaveDisplay() */
+   static WaveDisplaySource Make(const Sequence &sequence,
+      size_t len, const sampleCount *where);
+
+   BlockArray blocks;
+   sampleCount numSamples{ 0 };
+   size_t maxBlockSize{ 0 };
+};
 
 // where is input, assumed to be nondecreasing, and its size is len + 1.
 // min, max, rms, bl are outputs, and their lengths are len.
@@ -25,4 +41,9 @@ bool GetWaveDisplay(const Sequence &sequence,
    float *min, float *max, float *rms,
    size_t len, const sampleCount *where);
 
+//! Same as above, but reads a copy of the blocks, made on the main thread
+bool GetWaveDisplay(const WaveDisplaySource &source,
+   float *min, float *max, float *rms,
+   size_t len, const sampleCount *where);
+
 #endif
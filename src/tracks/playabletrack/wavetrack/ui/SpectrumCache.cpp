@@ -138,8 +138,8 @@ bool SpecCache::CalculateOneSpectrum(
 
       // We can avoid copying memory when ComputeSpectrum is used below
       bool copy = !autocorrelation || (padding > 0) || reassignment;
-      std::vector<float> floats;
-      float* useBuffer = 0;
+      // Samples of the cached blocks, if they can be used where they are
+      const float *inPlace = nullptr;
       float *adj = scratch + padding;
 
       {
@@ -167,24 +167,24 @@ bool SpecCache::CalculateOneSpectrum(
          }
 
          if (myLen > 0) {
-            constexpr auto iChannel = 0u;
             constexpr auto mayThrow = false; // Don't throw just for display
             mSampleCacheHolder.emplace(
                clip.GetSampleView(from, myLen, mayThrow));
-            floats.resize(myLen);
-            mSampleCacheHolder->Copy(floats.data(), myLen);
-            useBuffer = floats.data();
-            if (copy) {
-               if (useBuffer)
-                  memcpy(adj, useBuffer, myLen * sizeof(float));
-               else
-                  memset(adj, 0, myLen * sizeof(float));
+            if (!copy) {
+               // Usable in place only if within one block
+               size_t nSpans = 0;
+               mSampleCacheHolder->ForEachSpan(
+                  [&](const float *data, size_t) { inPlace = data; ++nSpans; });
+               if (nSpans != 1)
+                  inPlace = nullptr;
             }
+            // Else copy once, straight into the scratch buffer
+            if (!inPlace)
+               mSampleCacheHolder->Copy(adj, myLen);
          }
       }
 
-      if (copy || !useBuffer)
-         useBuffer = scratch;
+      float *const useBuffer = scratch;
 
       if (autocorrelation) {
          // not reassignment, xx is surely within bounds.
@@ -192,7 +192,8 @@ bool SpecCache::CalculateOneSpectrum(
          float *const results = &out[nBins * xx];
          // This function does not mutate useBuffer
          ComputeSpectrum(
-            useBuffer, windowSizeSetting, windowSizeSetting, results,
+            inPlace ? inPlace : useBuffer, windowSizeSetting,
+            windowSizeSetting, results,
             autocorrelation, settings.windowType);
       }
       else if (reassignment) {
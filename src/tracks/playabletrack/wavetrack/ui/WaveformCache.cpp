@@ -11,9 +11,11 @@
 #include "WaveformCache.h"
 
 #include <cmath>
+#include <limits>
 #include "Sequence.h"
 #include "GetWaveDisplay.h"
 #include "WaveClipUtilities.h"
+#include "WaveformWorker.h"
 #include "WaveTrack.h"
 
 class WaveCache {
@@ -40,6 +42,7 @@ public:
       , min(len)
       , max(len)
       , rms(len)
+      , requested(len)
    {
    }
 
@@ -56,8 +59,99 @@ public:
    std::vector<float> min;
    std::vector<float> max;
    std::vector<float> rms;
+   //! Which placeholder columns were given to the worker
+   std::vector<bool> requested;
 };
 
+namespace {
+//! Limits the columns of one job, so that results arrive a few at a time
+constexpr size_t MaxColumnsPerJob = 64;
+
+constexpr auto Placeholder = std::numeric_limits<float>::quiet_NaN();
+
+//! Compute placeholder columns here, when the worker is not used, as after
+//! the preference to use it was turned off
+void FillMissing(WaveCache &cache, const Sequence &sequence)
+{
+   const auto len = cache.len;
+   for (size_t a = 0; a < len;) {
+      if (!std::isnan(cache.min[a])) {
+         ++a;
+         continue;
+      }
+      auto b = a + 1;
+      while (b < len && std::isnan(cache.min[b]))
+         ++b;
+      if (!::GetWaveDisplay(sequence, &cache.min[a], &cache.max[a],
+         &cache.rms[a], b - a, &cache.where[a])) {
+         std::fill(&cache.min[a], &cache.min[b], 0.0f);
+         std::fill(&cache.max[a], &cache.max[b], 0.0f);
+         std::fill(&cache.rms[a], &cache.rms[b], 0.0f);
+      }
+      a = b;
+   }
+}
+}
+
+void WaveClipWaveformCache::RequestMissing(
+   const std::shared_ptr<WaveCache> &pCache, const Sequence &sequence,
+   WaveformWorker &worker, const std::function<void()> &onReady)
+{
+   auto &cache = *pCache;
+   const auto len = cache.len;
+   for (size_t a = 0; a < len;) {
+      if (!(std::isnan(cache.min[a]) && !cache.requested[a])) {
+         ++a;
+         continue;
+      }
+      auto b = a + 1;
+      while (b < len && b - a < MaxColumnsPerJob &&
+         std::isnan(cache.min[b]) && !cache.requested[b])
+         ++b;
+      std::fill(cache.requested.begin() + a, cache.requested.begin() + b, true);
+
+      const auto pWhere = &cache.where[a];
+      WaveformWorker::Job job{ pCache,
+         WaveDisplaySource::Make(sequence, b - a, pWhere),
+         { pWhere, pWhere + (b - a) + 1 },
+         [wCache = std::weak_ptr{ pCache }, a, onReady](
+            const WaveformWorker::Columns &columns){
+            auto pCache = wCache.lock();
+            if (!pCache)
+               return;
+            const auto count = columns.min.size();
+            if (columns.ok) {
+               std::copy(columns.min.begin(), columns.min.end(),
+                  pCache->min.begin() + a);
+               std::copy(columns.max.begin(), columns.max.end(),
+                  pCache->max.begin() + a);
+               std::copy(columns.rms.begin(), columns.rms.end(),
+                  pCache->rms.begin() + a);
+            }
+            else {
+               // Don't ask again; draw these columns as silence
+               std::fill_n(pCache->min.begin() + a, count, 0.0f);
+               std::fill_n(pCache->max.begin() + a, count, 0.0f);
+               std::fill_n(pCache->rms.begin() + a, count, 0.0f);
+            }
+            if (onReady)
+               onReady();
+         }
+      };
+      const auto columns = job.where.size() - 1;
+      if (!worker.Submit(std::move(job))) {
+         // The worker is stopped; do the work here after all
+         if (!::GetWaveDisplay(sequence, &cache.min[a], &cache.max[a],
+            &cache.rms[a], columns, pWhere)) {
+            std::fill(&cache.min[a], &cache.min[b], 0.0f);
+            std::fill(&cache.max[a], &cache.max[b], 0.0f);
+            std::fill(&cache.rms[a], &cache.rms[b], 0.0f);
+         }
+      }
+      a = b;
+   }
+}
+
 //
 // Getting high-level data from the track for screen display and
 // clipping calculations
@@ -65,13 +159,16 @@ public:
 
 bool WaveClipWaveformCache::GetWaveDisplay(
    const WaveChannelInterval &clip, WaveDisplay &display,
-   double t0, double pixelsPerSecond)
+   double t0, double pixelsPerSecond,
+   WaveformWorker *pWorker, std::function<void()> onReady)
 {
    auto &waveCache = mWaveCaches[clip.GetChannelIndex()];
 
    t0 += clip.GetTrimLeft();
 
    const bool allocated = (display.where != 0);
+   if (allocated)
+      pWorker = nullptr;
 
    const size_t numPixels = (int)display.width;
 
@@ -110,7 +207,12 @@ bool WaveClipWaveformCache::GetWaveDisplay(
          waveCache->start == t0 &&
          waveCache->len >= numPixels) {
 
-         // Satisfy the request completely from the cache
+         // Satisfy the request completely from the cache, though some of it
+         // may still be on the way
+         if (pWorker)
+            RequestMissing(waveCache, clip.GetSequence(), *pWorker, onReady);
+         else
+            FillMissing(*waveCache, clip.GetSequence());
          display.min = &waveCache->min[0];
          display.max = &waveCache->max[0];
          display.rms = &waveCache->rms[0];
@@ -118,7 +220,7 @@ bool WaveClipWaveformCache::GetWaveDisplay(
          return true;
       }
 
-      std::unique_ptr<WaveCache> oldCache(std::move(waveCache));
+      std::shared_ptr<WaveCache> oldCache(std::move(waveCache));
 
       int oldX0 = 0;
       double correction = 0.0;
@@ -138,7 +240,7 @@ bool WaveClipWaveformCache::GetWaveDisplay(
       if (!(copyEnd > copyBegin))
          oldCache.reset(0);
 
-      waveCache = std::make_unique<WaveCache>(
+      waveCache = std::make_shared<WaveCache>(
          numPixels, samplesPerPixel, sampleRate, t0, mDirty);
       min = &waveCache->min[0];
       max = &waveCache->max[0];
@@ -249,14 +351,26 @@ bool WaveClipWaveformCache::GetWaveDisplay(
       // Done with append buffer, now fetch the rest of the cache miss
       // from the sequence
       if (p1 > p0) {
-         if (!::GetWaveDisplay(sequence, &min[p0], &max[p0], &rms[p0], p1 - p0,
-            &where[p0]))
+         if (pWorker) {
+            // Leave placeholders, for RequestMissing to find
+            std::fill(&min[p0], &min[p1], Placeholder);
+            std::fill(&max[p0], &max[p1], 0.0f);
+            std::fill(&rms[p0], &rms[p1], 0.0f);
+         }
+         else if (!::GetWaveDisplay(sequence, &min[p0], &max[p0], &rms[p0],
+            p1 - p0, &where[p0]))
          {
             return false;
          }
       }
    }
 
+   // Placeholders copied from an older cache need requests too
+   if (pWorker)
+      RequestMissing(waveCache, clip.GetSequence(), *pWorker, onReady);
+   else if (!allocated)
+      FillMissing(*waveCache, clip.GetSequence());
+
    if (!allocated) {
       // Now report the results
       display.min = min;
@@ -273,7 +387,7 @@ WaveClipWaveformCache::WaveClipWaveformCache(size_t nChannels)
    : mWaveCaches(std::max<size_t>(2, nChannels))
 {
    for (auto &pCache : mWaveCaches)
-      pCache = std::make_unique<WaveCache>();
+      pCache = std::make_shared<WaveCache>();
 }
 
 WaveClipWaveformCache::~WaveClipWaveformCache()
@@ -299,5 +413,5 @@ void WaveClipWaveformCache::Invalidate()
 {
    // Invalidate wave display caches
    for (auto &pCache : mWaveCaches)
-      pCache = std::make_unique<WaveCache>();
+      pCache = std::make_shared<WaveCache>();
 }
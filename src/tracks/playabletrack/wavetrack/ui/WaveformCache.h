@@ -11,10 +11,13 @@
 #ifndef __AUDACITY_WAVEFORM_CACHE__
 #define __AUDACITY_WAVEFORM_CACHE__
 
+#include <functional>
 #include "WaveClip.h"
 
+class Sequence;
 class WaveCache;
 class WaveChannelInterval;
+class WaveformWorker;
 
 struct WaveClipWaveformCache final : WaveClipListener
 {
@@ -22,7 +25,8 @@ struct WaveClipWaveformCache final : WaveClipListener
    ~WaveClipWaveformCache() override;
 
    // Cache of values for drawing the waveform
-   std::vector<std::unique_ptr<WaveCache>> mWaveCaches;
+   // Shared only so that results of the worker can find them if still there
+   std::vector<std::shared_ptr<WaveCache>> mWaveCaches;
    int mDirty { 0 };
 
    static WaveClipWaveformCache &Get( const WaveClip &clip );
@@ -34,8 +38,21 @@ struct WaveClipWaveformCache final : WaveClipListener
    void Clear();
 
    /** Getting high-level data for screen display */
+   /*!
+    If pWorker is not null, columns that would read sample blocks are not
+    computed here, but by the worker.  Until they are ready, their min values
+    are NaN; then onReady is called on the main thread.
+    The worker is not used for a display with its own storage.
+    */
    bool GetWaveDisplay(const WaveChannelInterval &clip,
-      WaveDisplay &display, double t0, double pixelsPerSecond);
+      WaveDisplay &display, double t0, double pixelsPerSecond,
+      WaveformWorker *pWorker = nullptr, std::function<void()> onReady = {});
+
+private:
+   //! Submit jobs for all columns that are placeholders and not yet submitted
+   static void RequestMissing(const std::shared_ptr<WaveCache> &pCache,
+      const Sequence &sequence,
+      WaveformWorker &worker, const std::function<void()> &onReady);
 };
 
 #endif
@@ -13,6 +13,7 @@ Paul Licameli split from WaveChannelView.cpp
 
 #include "WaveformCache.h"
 #include "WaveformVRulerControls.h"
+#include "WaveformWorker.h"
 #include "WaveChannelView.h"
 #include "WaveChannelViewConstants.h"
 
@@ -27,6 +28,7 @@ Paul Licameli split from WaveChannelView.cpp
 #include "SyncLock.h"
 #include "../../../../TrackArt.h"
 #include "../../../../TrackArtist.h"
+#include "../../../../TrackPanel.h"
 #include "../../../../TrackPanelDrawingContext.h"
 #include "../../../../TrackPanelMouseEvent.h"
 #include "ViewInfo.h"
@@ -37,8 +39,10 @@ Paul Licameli split from WaveChannelView.cpp
 
 #include "FrameStatistics.h"
 
+#include <cmath>
 #include <wx/graphics.h>
 #include <wx/dc.h>
+#include <wx/weakref.h>
 
 static WaveChannelSubView::Type sType{
    WaveChannelViewConstants::Waveform,
@@ -367,6 +371,19 @@ void DrawMinMaxRMS(
    dc.SetPen(muted ? muteSamplePen : samplePen);
    for (int x0 = 0; x0 < rect.width; ++x0) {
       int xx = rect.x + x0;
+      if (std::isnan(min[x0])) {
+         // This column is still being computed in the background.
+         // Mark the zero level, and don't join it to its neighbors.
+         h1 = h2 = GetWaveYPos(0.0, zoomMin, zoomMax,
+                          rect.height, dB, true, dBRange, true);
+         r1[x0] = r2[x0] = h1;
+         lasth1 = std::numeric_limits<int>::max();
+         lasth2 = std::numeric_limits<int>::min();
+         dc.SetPen(muteSamplePen);
+         AColor::Line(dc, xx, rect.y + h2, xx, rect.y + h1);
+         dc.SetPen(muted ? muteSamplePen : samplePen);
+         continue;
+      }
       double v;
       v = min[x0] * env[x0];
       if (clipped && bShowClipping && (v <= -MAX_AUDIO))
@@ -390,7 +407,7 @@ void DrawMinMaxRMS(
 
       // JKC: This adjustment to h1 and h2 ensures that the drawn
       // waveform is continuous.
-      if (x0 > 0) {
+      if (lasth1 != std::numeric_limits<int>::max()) {
          if (h1 < lasth2) {
             h1 = lasth2 - 1;
          }
@@ -743,6 +760,25 @@ void DrawClipWaveform(TrackPanelDrawingContext &context,
 
    auto &clipCache = WaveClipWaveformCache::Get(clip.GetClip());
 
+   // Don't wait for sample blocks to be read; draw placeholders for columns
+   // not yet computed, and repaint the track as they arrive
+   WaveformWorker *pWorker = nullptr;
+   std::function<void()> onReady;
+   if (const auto pPanel = artist->parent;
+      pPanel && WaveformWorker::Enabled.Read())
+   {
+      if (const auto pProject = pPanel->GetProject()) {
+         pWorker = &WaveformWorker::Get(*pProject);
+         onReady = [wPanel = wxWeakRef<TrackPanel>{ pPanel },
+            id = track.GetId()
+         ]{
+            if (wPanel)
+               if (const auto pTrack = wPanel->GetTracks()->FindById(id))
+                  wPanel->RefreshTrack(pTrack);
+         };
+      }
+   }
+
    {
       bool showIndividualSamples = false;
       for (unsigned ii = 0; !showIndividualSamples && ii < nPortions; ++ii) {
@@ -763,7 +799,7 @@ void DrawClipWaveform(TrackPanelDrawingContext &context,
          // redrawing.
 
          if (!clipCache.GetWaveDisplay(clip,
-            display, t0, averagePixelsPerSecond))
+            display, t0, averagePixelsPerSecond, pWorker, onReady))
             return;
       }
    }
@@ -0,0 +1,131 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file WaveformWorker.cpp
+
+**********************************************************************/
+
+#include "WaveformWorker.h"
+
+#include "BasicUI.h"
+#include "Prefs.h"
+#include "Project.h"
+#include "../../../../ProjectWindow.h"
+
+BoolSetting WaveformWorker::Enabled{ L"/GUI/AsyncWaveform", true };
+
+static const AudacityProject::AttachedObjects::RegisteredFactory key{
+   [](AudacityProject &project){
+      return std::make_shared<WaveformWorker>(project); }
+};
+
+WaveformWorker &WaveformWorker::Get(AudacityProject &project)
+{
+   return project.AttachedObjects::Get<WaveformWorker>(key);
+}
+
+WaveformWorker::WaveformWorker(AudacityProject &project)
+{
+   // Pending jobs share sample blocks, which must all be released before the
+   // project file is closed
+   if (auto pWindow = ProjectWindow::Find(&project))
+      mSubscription = pWindow->Subscribe(
+         [this](ProjectWindowDestroyedMessage){ Stop(); });
+}
+
+WaveformWorker::~WaveformWorker()
+{
+   Stop();
+}
+
+bool WaveformWorker::Submit(Job job)
+{
+   std::lock_guard<std::mutex> lock{ mMutex };
+   if (mStopping)
+      return false;
+   if (!mThread.joinable())
+      mThread = std::thread{ [this]{ Run(); } };
+   mPending.push_back(std::move(job));
+   mCondition.notify_one();
+   return true;
+}
+
+void WaveformWorker::Stop()
+{
+   std::deque<Job> pending;
+   std::vector<std::pair<Job, Columns>> done;
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      mStopping = true;
+      pending.swap(mPending);
+      mCondition.notify_one();
+   }
+   if (mThread.joinable())
+      mThread.join();
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      done.swap(mDone);
+   }
+   // The jobs, and their blocks, are destroyed here, on the main thread
+}
+
+void WaveformWorker::Run()
+{
+   while (true) {
+      Job job;
+      {
+         std::unique_lock<std::mutex> lock{ mMutex };
+         mCondition.wait(lock, [this]{ return mStopping || !mPending.empty(); });
+         if (mStopping)
+            return;
+         job = std::move(mPending.front());
+         mPending.pop_front();
+      }
+
+      Columns columns;
+      // A job made stale by scrolling or editing still goes back to the main
+      // thread, only to be destroyed there
+      if (!job.owner.expired() && job.where.size() > 1) {
+         const auto len = job.where.size() - 1;
+         columns.min.resize(len);
+         columns.max.resize(len);
+         columns.rms.resize(len);
+         try {
+            columns.ok = ::GetWaveDisplay(job.source,
+               columns.min.data(), columns.max.data(), columns.rms.data(),
+               len, job.where.data());
+         }
+         catch (...) {
+            // Display is no-fail; leave the placeholders for this job
+            columns.ok = false;
+         }
+      }
+
+      std::lock_guard<std::mutex> lock{ mMutex };
+      mDone.emplace_back(std::move(job), std::move(columns));
+      if (mStopping)
+         // Let Stop() destroy the job on the main thread
+         return;
+      if (!mDeliveryPosted) {
+         mDeliveryPosted = true;
+         BasicUI::CallAfter([wThis = weak_from_this()]{
+            if (auto pThis = wThis.lock())
+               pThis->Deliver();
+         });
+      }
+   }
+}
+
+void WaveformWorker::Deliver()
+{
+   std::vector<std::pair<Job, Columns>> done;
+   {
+      std::lock_guard<std::mutex> lock{ mMutex };
+      done.swap(mDone);
+      mDeliveryPosted = false;
+   }
+   for (auto &[job, columns] : done)
+      if (!job.owner.expired() && job.onDone)
+         job.onDone(columns);
+}
@@ -0,0 +1,92 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  @file WaveformWorker.h
+
+  Computes waveform display columns away from the main thread
+
+**********************************************************************/
+
+#ifndef __AUDACITY_WAVEFORM_WORKER__
+#define __AUDACITY_WAVEFORM_WORKER__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ClientData.h"
+#include "GetWaveDisplay.h"
+#include "Observer.h"
+
+class AudacityProject;
+class BoolSetting;
+
+//! A background thread of a project, reading sample blocks for waveform columns
+/*!
+ Painting submits the columns it could not find in the cache, and draws
+ placeholders for them.  Results are handed back on the main thread, which is
+ also where the jobs, and so their shares of the sample blocks, are destroyed.
+
+ All pending work is discarded when the project window closes, before the
+ project file is closed.
+ */
+class WaveformWorker final
+   : public ClientData::Base
+   , public std::enable_shared_from_this<WaveformWorker>
+{
+public:
+   //! Whether painting should use the worker at all
+   static BoolSetting Enabled;
+
+   static WaveformWorker &Get(AudacityProject &project);
+
+   //! Results for the columns of one job
+   struct Columns {
+      std::vector<float> min, max, rms;
+      //! False if GetWaveDisplay() failed
+      bool ok{ false };
+   };
+
+   struct Job {
+      //! The job is skipped if this has expired before it starts
+      std::weak_ptr<const void> owner;
+      WaveDisplaySource source;
+      //! Column boundaries, one more than the number of columns
+      std::vector<sampleCount> where;
+      //! Called on the main thread, unless owner has expired
+      std::function<void(const Columns &)> onDone;
+   };
+
+   explicit WaveformWorker(AudacityProject &project);
+   ~WaveformWorker() override;
+
+   //! Call on the main thread
+   /*! @return false if the worker is stopped, and the caller must do the job */
+   bool Submit(Job job);
+
+   //! Discard all pending work and results, and join the thread
+   /*! Call on the main thread.  No further jobs are accepted. */
+   void Stop();
+
+private:
+   void Run();
+   //! Main thread part of the work:  report results and drop the jobs
+   void Deliver();
+
+   std::mutex mMutex;
+   std::condition_variable mCondition;
+   std::deque<Job> mPending;
+   std::vector<std::pair<Job, Columns>> mDone;
+   bool mDeliveryPosted{ false };
+   bool mStopping{ false };
+
+   std::thread mThread;
+   Observer::Subscription mSubscription;
+};
+
+#endif
@@ -6,4 +6,5 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include <catch2/catch.hpp>
@@ -0,0 +1,142 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BenchmarkProject.cpp
+
+**********************************************************************/
+#include "BenchmarkProject.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include <wx/filename.h>
+#include <wx/utils.h>
+
+#include "DBTuning.h"
+#include "Project.h"
+#include "ProjectFileIO.h"
+#include "SampleBlock.h"
+#include "Sequence.h"
+#include "TempDirectory.h"
+#include "Track.h"
+#include "WaveClip.h"
+#include "WaveTrack.h"
+
+std::vector<float> BenchmarkData::MakeSine(size_t length, unsigned seed)
+{
+   std::vector<float> samples(length);
+   const auto frequency = 0.01 * (seed + 1);
+   for (size_t i = 0; i < length; ++i)
+      samples[i] = 0.5 * std::sin(frequency * i);
+   return samples;
+}
+
+std::vector<SampleBlockPtr> BenchmarkData::Blocks(const WaveTrack& track)
+{
+   std::vector<SampleBlockPtr> result;
+   for (const auto& pClip : track.GetClips())
+      for (size_t ii = 0, width = pClip->GetWidth(); ii < width; ++ii)
+         for (const auto& block : *pClip->GetSequenceBlockArray(ii))
+            result.push_back(block.sb);
+   return result;
+}
+
+namespace
+{
+//! Removes the directory, and the databases left in it, at exit
+struct TemporaryDirectory
+{
+   ~TemporaryDirectory()
+   {
+      if (wxFileName::DirExists(path))
+         wxFileName::Rmdir(path, wxPATH_RMDIR_RECURSIVE);
+   }
+   const FilePath path;
+};
+}
+
+FilePath BenchmarkProject::Directory()
+{
+   static const TemporaryDirectory directory{ []{
+      wxFileName name{ wxFileName::GetTempDir(), wxT("") };
+      // One for each process, so that test programs may run concurrently
+      name.AppendDir(wxString::Format(
+         wxT("audacity-benchmarks-%lu"), wxGetProcessId()));
+      const auto path = name.GetPath();
+      wxFileName::Mkdir(path, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+      TempDirectory::SetTempDirOverride(path);
+      ProjectFileIO::InitializeSQL();
+      return path;
+   }() };
+   return directory.path;
+}
+
+BenchmarkProject::BenchmarkProject()
+{
+   OpenNew(nullptr);
+}
+
+BenchmarkProject::BenchmarkProject(const DBTuning &tuning)
+{
+   OpenNew(&tuning);
+}
+
+BenchmarkProject::BenchmarkProject(SavedTag, const FilePath &path)
+{
+   Directory();
+   mProject = AudacityProject::Create();
+   auto &projectFileIO = ProjectFileIO::Get(*mProject);
+   auto conn = projectFileIO.LoadProject(path, true);
+   if (!conn) {
+      // Release any blocks decoded so far while the database is open
+      TrackList::Get(*mProject).Clear();
+      projectFileIO.CloseProject();
+      throw std::runtime_error("Could not open a saved project");
+   }
+   conn->Commit();
+   // The factory of the loaded tracks
+   mFactory = WaveTrackFactory::Get(*mProject).GetSampleBlockFactory();
+}
+
+BenchmarkProject BenchmarkProject::OpenSaved(const FilePath &path)
+{
+   return { SavedTag{}, path };
+}
+
+void BenchmarkProject::OpenNew(const DBTuning *pTuning)
+{
+   Directory();
+   mProject = AudacityProject::Create();
+   auto &projectFileIO = ProjectFileIO::Get(*mProject);
+   if (pTuning)
+      projectFileIO.SetTuning(*pTuning);
+   if (!projectFileIO.OpenProject())
+      throw std::runtime_error("Could not open a temporary project");
+   mFactory = SampleBlockFactory::New(*mProject);
+}
+
+BenchmarkProject::~BenchmarkProject()
+{
+   // Sample blocks must be released while the database is still open
+   TrackList::Get(*mProject).Clear();
+   mFactory.reset();
+   ProjectFileIO::Get(*mProject).CloseProject();
+}
+
+WaveTrack& BenchmarkProject::AddTrack(size_t nChannels, double seconds)
+{
+   const auto length = static_cast<size_t>(seconds * BenchmarkData::Rate);
+   auto holder = WaveTrackFactory::Get(*mProject)
+      .Create(nChannels, floatSample, BenchmarkData::Rate);
+   auto& track = **holder->Any<WaveTrack>().begin();
+   for (size_t iChannel = 0; iChannel < nChannels; ++iChannel) {
+      const auto samples = BenchmarkData::MakeSine(length, iChannel);
+      track.Append(reinterpret_cast<constSamplePtr>(samples.data()),
+         floatSample, length, 1, floatSample, iChannel);
+   }
+   track.Flush();
+   TrackList::Get(*mProject).Append(std::move(*holder));
+   return track;
+}
@@ -0,0 +1,77 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BenchmarkProject.h
+
+**********************************************************************/
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Identifier.h"
+
+class AudacityProject;
+class SampleBlock;
+class SampleBlockFactory;
+class WaveTrack;
+struct DBTuning;
+
+namespace BenchmarkData
+{
+constexpr double Rate = 44100.0;
+
+//! A sine of the given length, different for each seed
+std::vector<float> MakeSine(size_t length, unsigned seed = 0);
+
+//! The sample blocks of every clip and channel of a track, in order
+std::vector<std::shared_ptr<SampleBlock>> Blocks(const WaveTrack &track);
+}
+
+//! A project with a temporary database, as a new project window has
+/*!
+ Sample blocks are written to and read from SQLite exactly as in the
+ application.  Everything goes in a directory of its own under the system's
+ temporary directory, one for each process, removed when the process exits.
+
+ The headless tests use it too.
+ */
+class BenchmarkProject final
+{
+public:
+   BenchmarkProject();
+   //! Open the database with the given tuning, so that no commit happens
+   //! before it applies
+   explicit BenchmarkProject(const DBTuning &tuning);
+   ~BenchmarkProject();
+
+   //! Load a saved project, as LoadProject() does, ignoring any autosave
+   /*! @throws std::runtime_error if it can't */
+   static BenchmarkProject OpenSaved(const FilePath &path);
+
+   BenchmarkProject(const BenchmarkProject&) = delete;
+   BenchmarkProject& operator=(const BenchmarkProject&) = delete;
+
+   AudacityProject& Project() { return *mProject; }
+   const std::shared_ptr<SampleBlockFactory>& Factory() const
+   {
+      return mFactory;
+   }
+
+   //! Append a track to the project, each channel filled for some seconds
+   WaveTrack& AddTrack(size_t nChannels, double seconds);
+
+   //! Where projects may be saved
+   static FilePath Directory();
+
+private:
+   struct SavedTag{};
+   BenchmarkProject(SavedTag, const FilePath &path);
+   //! @param pTuning if null, the project's default
+   void OpenNew(const DBTuning *pTuning);
+
+   std::shared_ptr<AudacityProject> mProject;
+   std::shared_ptr<SampleBlockFactory> mFactory;
+};
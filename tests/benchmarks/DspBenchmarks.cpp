@@ -0,0 +1,201 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  DspBenchmarks.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "FFT.h"
+#include "Mix.h"
+#include "RealFFTf.h"
+#include "Resample.h"
+#include "SpectrumTransformer.h"
+#include "StaffPadTimeAndPitch.h"
+#include "StretchingSequence.h"
+#include "Track.h"
+#include "WaveTrack.h"
+
+#include "BenchmarkProject.h"
+#include "MockedPrefs.h"
+
+namespace
+{
+constexpr size_t Length = 10 * 44100;
+constexpr size_t BlockLength = 1024;
+
+//! Plays the same samples into every channel, over and over
+class LoopingSource final : public TimeAndPitchSource
+{
+public:
+   explicit LoopingSource(const std::vector<float>& samples)
+      : mSamples{ samples }
+   {}
+
+   void Pull(float* const* buffers, size_t samplesPerChannel) override
+   {
+      for (size_t done = 0; done < samplesPerChannel;) {
+         const auto count =
+            std::min(samplesPerChannel - done, mSamples.size() - mPosition);
+         for (size_t iChannel = 0; iChannel < NumChannels; ++iChannel)
+            std::copy_n(mSamples.data() + mPosition, count,
+               buffers[iChannel] + done);
+         done += count;
+         mPosition = (mPosition + count) % mSamples.size();
+      }
+   }
+
+   static constexpr size_t NumChannels = 2;
+
+private:
+   const std::vector<float>& mSamples;
+   size_t mPosition{ 0 };
+};
+
+//! Transforms without changing the spectrum, and discards the output
+class PassThroughTransformer final : public SpectrumTransformer
+{
+public:
+   PassThroughTransformer()
+      : SpectrumTransformer{ true, eWinFuncHann, eWinFuncHann, 2048, 4,
+         false, false }
+   {}
+
+   void DoOutput(const float*, size_t) override {}
+};
+}
+
+// Hidden; run with the tag [benchmark]
+TEST_CASE("Mixer benchmark", "[.][benchmark]")
+{
+   MockedPrefs prefs;
+   BenchmarkProject project;
+   for (unsigned ii = 0; ii < 4; ++ii)
+      project.AddTrack(2, 10.0);
+   const auto& tracks = TrackList::Get(project.Project());
+
+   BENCHMARK("Mixer::Process 4 stereo tracks 10 s")
+   {
+      Mixer::Inputs inputs;
+      for (auto pTrack : tracks.Any<const WaveTrack>())
+         inputs.emplace_back(
+            StretchingSequence::Create(*pTrack, pTrack->GetClipInterfaces()));
+      Mixer mixer{ std::move(inputs), true, Mixer::WarpOptions{ 1.0, 1.0 },
+         0.0, 10.0, 2, BlockLength, true, BenchmarkData::Rate, floatSample };
+      size_t total = 0;
+      while (const auto count = mixer.Process())
+         total += count;
+      return total;
+   };
+}
+
+// Many tracks at once, each reading its blocks through sample views
+TEST_CASE("Mixer many tracks benchmark", "[.][benchmark]")
+{
+   MockedPrefs prefs;
+   BenchmarkProject project;
+   for (unsigned ii = 0; ii < 100; ++ii)
+      project.AddTrack(1, 3.0);
+   const auto& tracks = TrackList::Get(project.Project());
+
+   BENCHMARK("Mixer::Process 100 mono tracks 3 s")
+   {
+      Mixer::Inputs inputs;
+      for (auto pTrack : tracks.Any<const WaveTrack>())
+         inputs.emplace_back(
+            StretchingSequence::Create(*pTrack, pTrack->GetClipInterfaces()));
+      Mixer mixer{ std::move(inputs), true, Mixer::WarpOptions{ 1.0, 1.0 },
+         0.0, 3.0, 2, BlockLength, true, BenchmarkData::Rate, floatSample };
+      size_t total = 0;
+      while (const auto count = mixer.Process())
+         total += count;
+      return total;
+   };
+}
+
+TEST_CASE("Resample 10 s benchmark", "[.][benchmark]")
+{
+   MockedPrefs prefs;
+   const auto input = BenchmarkData::MakeSine(Length);
+   const auto factor = 48000.0 / 44100.0;
+   std::vector<float> output(static_cast<size_t>(Length * factor) + BlockLength);
+
+   BENCHMARK("Resample 10 s 44100 Hz to 48000 Hz")
+   {
+      Resample resample{ true, factor, factor };
+      size_t consumed = 0;
+      size_t produced = 0;
+      while (consumed < Length) {
+         const auto len = std::min(BlockLength, Length - consumed);
+         const auto last = consumed + len == Length;
+         const auto results = resample.Process(factor,
+            const_cast<float*>(input.data()) + consumed, len, last,
+            output.data() + produced, output.size() - produced);
+         consumed += results.first;
+         produced += results.second;
+         if (last && results.first == 0)
+            break;
+      }
+      return produced;
+   };
+}
+
+TEST_CASE("FFT benchmark", "[.][benchmark]")
+{
+   constexpr size_t WindowSize = 2048;
+   const auto input = BenchmarkData::MakeSine(Length);
+   const auto hFFT = GetFFT(WindowSize);
+   std::vector<float> buffer(WindowSize);
+
+   BENCHMARK("RealFFTf 10 s in windows of 2048")
+   {
+      for (size_t start = 0; start + WindowSize <= Length; start += WindowSize)
+      {
+         std::copy_n(input.data() + start, WindowSize, buffer.data());
+         RealFFTf(buffer.data(), hFFT.get());
+      }
+      return buffer[0];
+   };
+}
+
+TEST_CASE("StaffPadTimeAndPitch benchmark", "[.][benchmark]")
+{
+   const auto input = BenchmarkData::MakeSine(Length);
+   constexpr auto NumChannels = LoopingSource::NumChannels;
+   std::vector<std::vector<float>> output(
+      NumChannels, std::vector<float>(BlockLength));
+   float* buffers[NumChannels]{ output[0].data(), output[1].data() };
+
+   BENCHMARK("StaffPadTimeAndPitch 10 s stereo output at ratio 1.5")
+   {
+      LoopingSource source{ input };
+      StaffPadTimeAndPitch stretcher{ static_cast<int>(BenchmarkData::Rate),
+         NumChannels, source, { 1.5, 1.0 } };
+      for (size_t done = 0; done < Length; done += BlockLength)
+         stretcher.GetSamples(buffers, BlockLength);
+      return output[0][0];
+   };
+}
+
+TEST_CASE("SpectrumTransformer benchmark", "[.][benchmark]")
+{
+   const auto input = BenchmarkData::MakeSine(Length);
+   const SpectrumTransformer::WindowProcessor processor =
+      [](SpectrumTransformer&){ return true; };
+
+   BENCHMARK("SpectrumTransformer 10 s window 2048 overlap 4")
+   {
+      PassThroughTransformer transformer;
+      transformer.Start(1);
+      for (size_t start = 0; start < Length; start += BlockLength)
+         transformer.ProcessSamples(processor, input.data() + start,
+            std::min(BlockLength, Length - start));
+      return transformer.Finish(processor);
+   };
+}
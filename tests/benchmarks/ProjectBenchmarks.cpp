@@ -0,0 +1,47 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ProjectBenchmarks.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include <wx/filename.h>
+
+#include "Project.h"
+#include "ProjectFileIO.h"
+#include "Track.h"
+
+#include "BenchmarkProject.h"
+#include "MockedPrefs.h"
+
+// Hidden; run with the tag [benchmark]
+TEST_CASE("Project benchmark", "[.][benchmark]")
+{
+   MockedPrefs prefs;
+   const auto path =
+      wxFileName{ BenchmarkProject::Directory(), wxT("benchmark.aup3") }
+         .GetFullPath();
+
+   {
+      BenchmarkProject project;
+      for (unsigned ii = 0; ii < 8; ++ii)
+         project.AddTrack(2, 30.0);
+      auto& projectFileIO = ProjectFileIO::Get(project.Project());
+      // The first save only moves the temporary database
+      REQUIRE(projectFileIO.SaveProject(path, nullptr));
+
+      BENCHMARK("Project save 8 stereo tracks 30 s")
+      {
+         return projectFileIO.SaveProject(path, nullptr);
+      };
+   }
+
+   BENCHMARK("Project open 8 stereo tracks 30 s")
+   {
+      auto project = BenchmarkProject::OpenSaved(path);
+      return TrackList::Get(project.Project()).Size();
+   };
+}
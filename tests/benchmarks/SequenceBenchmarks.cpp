@@ -0,0 +1,235 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  SequenceBenchmarks.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <vector>
+
+#include "MemoryX.h"
+#include "ProjectFileIO.h"
+#include "SampleBlock.h"
+#include "Sequence.h"
+#include "WaveTrack.h"
+
+#include "BenchmarkProject.h"
+#include "MockedPrefs.h"
+
+namespace
+{
+constexpr size_t Length = 10 * 44100;
+
+std::unique_ptr<Sequence> MakeSequence(const SampleBlockFactoryPtr& pFactory)
+{
+   return std::make_unique<Sequence>(
+      pFactory, SampleFormats{ floatSample, floatSample });
+}
+
+void Fill(Sequence& sequence, const std::vector<float>& samples)
+{
+   sequence.Append(reinterpret_cast<constSamplePtr>(samples.data()),
+      floatSample, samples.size(), 1, floatSample);
+   sequence.Flush();
+}
+}
+
+// Hidden; run with the tag [benchmark]
+TEST_CASE("Sequence benchmark", "[.][benchmark]")
+{
+   MockedPrefs prefs;
+   BenchmarkProject project;
+   const auto& pFactory = project.Factory();
+   const auto samples = BenchmarkData::MakeSine(Length);
+
+   auto source = MakeSequence(pFactory);
+   Fill(*source, samples);
+   const sampleCount middle = Length / 2;
+   const sampleCount second = 44100;
+
+   BENCHMARK_ADVANCED("Sequence append 10 s")(
+      Catch::Benchmark::Chronometer meter)
+   {
+      std::vector<std::unique_ptr<Sequence>> sequences(meter.runs());
+      for (auto& pSequence : sequences)
+         pSequence = MakeSequence(pFactory);
+      meter.measure([&](int run){ Fill(*sequences[run], samples); });
+   };
+
+   // Copies share the blocks of the source, so preparing each run is cheap
+   BENCHMARK_ADVANCED("Sequence cut 1 s")(Catch::Benchmark::Chronometer meter)
+   {
+      std::vector<std::unique_ptr<Sequence>> sequences(meter.runs());
+      for (auto& pSequence : sequences)
+         pSequence = source->Copy(pFactory, 0, Length);
+      meter.measure([&](int run){
+         auto& sequence = *sequences[run];
+         auto clipboard = sequence.Copy(pFactory, middle, middle + second);
+         sequence.Delete(middle, second);
+         return clipboard->GetNumSamples();
+      });
+   };
+
+   BENCHMARK_ADVANCED("Sequence paste 1 s")(Catch::Benchmark::Chronometer meter)
+   {
+      const auto clipboard = source->Copy(pFactory, 0, second);
+      std::vector<std::unique_ptr<Sequence>> sequences(meter.runs());
+      for (auto& pSequence : sequences)
+         pSequence = source->Copy(pFactory, 0, Length);
+      meter.measure([&](int run){
+         sequences[run]->Paste(middle + 1, clipboard.get());
+      });
+   };
+
+   // Each run has new source blocks, so none is shared with an earlier copy
+   BENCHMARK_ADVANCED("Sequence paste 10 s between projects")(
+      Catch::Benchmark::Chronometer meter)
+   {
+      BenchmarkProject other;
+      const auto& pOtherFactory = other.Factory();
+      std::vector<std::unique_ptr<Sequence>> clipboards(meter.runs());
+      std::vector<std::unique_ptr<Sequence>> sequences(meter.runs());
+      for (auto& pClipboard : clipboards) {
+         pClipboard = MakeSequence(pFactory);
+         Fill(*pClipboard, samples);
+      }
+      for (auto& pSequence : sequences)
+         pSequence = MakeSequence(pOtherFactory);
+      meter.measure([&](int run){
+         sequences[run]->Paste(0, clipboards[run].get());
+      });
+   };
+}
+
+TEST_CASE("SqliteSampleBlock benchmark", "[.][benchmark]")
+{
+   MockedPrefs prefs;
+   BenchmarkProject project;
+   const auto& pFactory = project.Factory();
+   const auto blockSize = Sequence::GetMaxDiskBlockSize() / sizeof(float);
+   const auto samples = BenchmarkData::MakeSine(blockSize);
+   constexpr size_t BlockCount = 16;
+
+   BENCHMARK_ADVANCED("SqliteSampleBlock write 16 blocks")(
+      Catch::Benchmark::Chronometer meter)
+   {
+      std::vector<std::vector<SampleBlockPtr>> blocks(meter.runs());
+      for (auto& run : blocks)
+         run.reserve(BlockCount);
+      meter.measure([&](int run){
+         for (size_t ii = 0; ii < BlockCount; ++ii)
+            blocks[run].push_back(pFactory->Create(
+               reinterpret_cast<constSamplePtr>(samples.data()),
+               blockSize, floatSample));
+      });
+   };
+
+   std::vector<SampleBlockPtr> stored;
+   for (size_t ii = 0; ii < BlockCount; ++ii)
+      stored.push_back(pFactory->Create(
+         reinterpret_cast<constSamplePtr>(samples.data()),
+         blockSize, floatSample));
+   std::vector<float> buffer(blockSize);
+
+   BENCHMARK("SqliteSampleBlock read 16 blocks")
+   {
+      size_t total = 0;
+      for (const auto& pBlock : stored)
+         total += pBlock->GetSamples(reinterpret_cast<samplePtr>(buffer.data()),
+            floatSample, 0, blockSize);
+      return total;
+   };
+
+   // Reads of blocks of these sizes go through an incremental blob handle,
+   // and the next benchmarks compare them with reads that go through the
+   // cached statement
+   BENCHMARK("SqliteSampleBlock read 256 samples of 16 blocks")
+   {
+      size_t total = 0;
+      for (const auto& pBlock : stored)
+         total += pBlock->GetSamples(reinterpret_cast<samplePtr>(buffer.data()),
+            floatSample, blockSize / 2, 256);
+      return total;
+   };
+
+   BENCHMARK("SqliteSampleBlock view of 16 blocks")
+   {
+      // The views are released, so that each run reads the database again
+      size_t total = 0;
+      for (const auto& pBlock : stored)
+         total += pBlock->GetFloatSampleView(true)->size();
+      return total;
+   };
+
+   // Too small to gain by a blob handle
+   constexpr size_t SmallBlockSize = 1024;
+   constexpr size_t SmallBlockCount = 256;
+   std::vector<SampleBlockPtr> small;
+   for (size_t ii = 0; ii < SmallBlockCount; ++ii)
+      small.push_back(pFactory->Create(
+         reinterpret_cast<constSamplePtr>(samples.data()),
+         SmallBlockSize, floatSample));
+
+   BENCHMARK("SqliteSampleBlock read 256 blocks of 1024 samples")
+   {
+      size_t total = 0;
+      for (const auto& pBlock : small)
+         total += pBlock->GetSamples(reinterpret_cast<samplePtr>(buffer.data()),
+            floatSample, 0, SmallBlockSize);
+      return total;
+   };
+
+   // After the first, each block shares the row of the first.  The factory
+   // reads the preference when it is made, so use another project.
+   SQLiteSettings::DeduplicateBlocks.Write(true);
+   auto resetDeduplicate =
+      finally([]{ SQLiteSettings::DeduplicateBlocks.Reset(); });
+   BenchmarkProject deduplicating;
+   const auto& pDeduplicatingFactory = deduplicating.Factory();
+   const auto first = pDeduplicatingFactory->Create(
+      reinterpret_cast<constSamplePtr>(samples.data()), blockSize, floatSample);
+   REQUIRE(pDeduplicatingFactory->Create(
+      reinterpret_cast<constSamplePtr>(samples.data()), blockSize, floatSample)
+         ->GetBlockID() == first->GetBlockID());
+
+   BENCHMARK_ADVANCED("SqliteSampleBlock write 16 duplicate blocks")(
+      Catch::Benchmark::Chronometer meter)
+   {
+      std::vector<std::vector<SampleBlockPtr>> blocks(meter.runs());
+      for (auto& run : blocks)
+         run.reserve(BlockCount);
+      meter.measure([&](int run){
+         for (size_t ii = 0; ii < BlockCount; ++ii)
+            blocks[run].push_back(pDeduplicatingFactory->Create(
+               reinterpret_cast<constSamplePtr>(samples.data()),
+               blockSize, floatSample));
+      });
+   };
+}
+
+// Queries of many regions, as analysis scripts make
+TEST_CASE("WaveChannel levels benchmark", "[.][benchmark]")
+{
+   MockedPrefs prefs;
+   BenchmarkProject project;
+   auto& track = project.AddTrack(1, 60.0);
+   const auto& channel = *track.GetChannel(0);
+   constexpr size_t Regions = 1000;
+
+   BENCHMARK("WaveChannel::GetRMS and GetMinMax 1000 regions of 60 s")
+   {
+      float total = 0;
+      for (size_t ii = 0; ii < Regions; ++ii) {
+         // Regions of varied lengths, not aligned to blocks
+         const double t0 = 0.05 * ii;
+         const double t1 = t0 + 0.5 + 0.0045 * ii;
+         total += channel.GetRMS(t0, t1);
+         total += channel.GetMinMax(t0, t1).second;
+      }
+      return total;
+   };
+}
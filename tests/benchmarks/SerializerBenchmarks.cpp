@@ -0,0 +1,89 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  SerializerBenchmarks.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "BufferedStreamReader.h"
+#include "Envelope.h"
+#include "ProjectSerializer.h"
+
+namespace
+{
+constexpr size_t NumPoints = 1000000;
+
+//! Reads the bytes of a dictionary and a document, like the project blobs
+class VectorStream final : public BufferedStreamReader
+{
+public:
+   explicit VectorStream(const std::vector<char>& bytes)
+      : BufferedStreamReader(32 * 1024)
+      , mBytes{ bytes }
+   {}
+
+protected:
+   bool HasMoreData() const override
+   {
+      return mPosition < mBytes.size();
+   }
+
+   size_t ReadData(void* buffer, size_t maxBytes) override
+   {
+      const auto count = std::min(maxBytes, mBytes.size() - mPosition);
+      std::memcpy(buffer, mBytes.data() + mPosition, count);
+      mPosition += count;
+      return count;
+   }
+
+private:
+   const std::vector<char>& mBytes;
+   size_t mPosition{ 0 };
+};
+
+void Append(std::vector<char>& bytes, const MemoryStream& stream)
+{
+   const auto data = static_cast<const char*>(stream.GetData());
+   bytes.insert(bytes.end(), data, data + stream.GetSize());
+}
+}
+
+// Hidden; run with the tag [benchmark]
+TEST_CASE("ProjectSerializer benchmark", "[.][benchmark]")
+{
+   ProjectSerializer serializer;
+   serializer.StartTag(wxT("envelope"));
+   serializer.WriteAttr(wxT("numpoints"), NumPoints);
+   for (size_t ii = 0; ii < NumPoints; ++ii) {
+      serializer.StartTag(wxT("controlpoint"));
+      serializer.WriteAttr(wxT("t"), ii / 1000.0, 12);
+      serializer.WriteAttr(wxT("val"), 1.0, 12);
+      serializer.EndTag(wxT("controlpoint"));
+   }
+   serializer.EndTag(wxT("envelope"));
+
+   std::vector<char> bytes;
+   Append(bytes, serializer.GetDict());
+   Append(bytes, serializer.GetData());
+
+   Envelope envelope{ false, 0.0, 2.0, 1.0 };
+   {
+      VectorStream stream{ bytes };
+      REQUIRE(ProjectSerializer::Decode(stream, &envelope));
+      REQUIRE(envelope.GetNumberOfPoints() == NumPoints);
+   }
+
+   BENCHMARK("ProjectSerializer::Decode 1M elements")
+   {
+      VectorStream stream{ bytes };
+      ProjectSerializer::Decode(stream, &envelope);
+      return envelope.GetNumberOfPoints();
+   };
+}
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+#  SPDX-License-Identifier: GPL-2.0-or-later
+
+"""Run the hidden Catch2 benchmarks of a test executable, write their mean
+times as JSON, and fail if any of them is slower than allowed.
+
+A benchmark is slower than allowed if its mean exceeds "max_mean_ms" in the
+thresholds file, or, given a baseline written by an earlier run on the same
+machine, if it exceeds the baseline mean by more than the tolerance.
+"""
+
+import argparse
+import json
+import subprocess
+import sys
+import xml.etree.ElementTree as ElementTree
+
+
+def run_benchmarks(executable, tags, samples):
+    command = [executable, tags, '--reporter', 'xml',
+               '--benchmark-samples', str(samples)]
+    completed = subprocess.run(command, stdout=subprocess.PIPE)
+    if completed.returncode != 0:
+        sys.stdout.write(completed.stdout.decode('utf-8', 'replace'))
+        raise RuntimeError('{} exited with {}'.format(
+            executable, completed.returncode))
+    return completed.stdout
+
+
+def parse_results(xml):
+    results = {}
+    root = ElementTree.fromstring(xml)
+    for benchmark in root.iter('BenchmarkResults'):
+        mean = benchmark.find('mean')
+        deviation = benchmark.find('standardDeviation')
+        # Catch2 reports nanoseconds
+        results[benchmark.get('name')] = {
+            'mean_ms': float(mean.get('value')) / 1e6,
+            'stddev_ms': float(deviation.get('value')) / 1e6
+                if deviation is not None else None,
+            'samples': int(benchmark.get('samples', 0)),
+        }
+    return results
+
+
+def check(results, thresholds, baseline):
+    failures = []
+    tolerance = thresholds.get('tolerance', 0.25)
+    for name, limits in thresholds.get('benchmarks', {}).items():
+        if name not in results:
+            failures.append('{}: no result'.format(name))
+            continue
+        mean = results[name]['mean_ms']
+        limit = limits.get('max_mean_ms')
+        if limit is not None and mean > limit:
+            failures.append('{}: {:.3f} ms exceeds the limit of {:.3f} ms'
+                            .format(name, mean, limit))
+    for name, previous in baseline.items():
+        if name not in results:
+            continue
+        mean = results[name]['mean_ms']
+        limit = previous['mean_ms'] * (1 + tolerance)
+        if mean > limit:
+            failures.append(
+                '{}: {:.3f} ms is more than {:.0%} slower than the baseline '
+                '{:.3f} ms'.format(name, mean, tolerance, previous['mean_ms']))
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('executable', help='Catch2 executable to run')
+    parser.add_argument('--tags', default='[benchmark]',
+                        help='test spec selecting the benchmarks')
+    parser.add_argument('--samples', type=int, default=20,
+                        help='samples per benchmark')
+    parser.add_argument('--thresholds', required=True,
+                        help='JSON file of limits on mean times')
+    parser.add_argument('--baseline',
+                        help='JSON file written by an earlier run')
+    parser.add_argument('--output', help='JSON file for the results')
+    args = parser.parse_args()
+
+    with open(args.thresholds) as file:
+        thresholds = json.load(file)
+    baseline = {}
+    if args.baseline:
+        with open(args.baseline) as file:
+            baseline = json.load(file)['benchmarks']
+
+    results = parse_results(
+        run_benchmarks(args.executable, args.tags, args.samples))
+    failures = check(results, thresholds, baseline)
+
+    summary = {'benchmarks': results, 'failures': failures}
+    if args.output:
+        with open(args.output, 'w') as file:
+            json.dump(summary, file, indent=2, sort_keys=True)
+
+    for name in sorted(results):
+        print('{:<60} {:>12.3f} ms'.format(name, results[name]['mean_ms']))
+    for failure in failures:
+        print('FAILED: ' + failure)
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
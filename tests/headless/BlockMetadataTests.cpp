@@ -0,0 +1,146 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BlockMetadataTests.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include "DBConnection.h"
+#include "MemoryX.h"
+#include "Project.h"
+#include "ProjectFileIO.h"
+#include "SampleBlock.h"
+#include "Track.h"
+#include "WaveTrack.h"
+
+#include "BenchmarkProject.h"
+#include "MockedPrefs.h"
+
+namespace
+{
+using BenchmarkData::Blocks;
+
+//! What SqliteSampleBlock would load for each block
+void RequireMetadata(
+   DBConnection& conn, const std::vector<SampleBlockPtr>& blocks)
+{
+   for (const auto& pBlock : blocks) {
+      const auto pMetadata = conn.FindBlockMetadata(pBlock->GetBlockID());
+      // Silent blocks have no rows
+      if (pBlock->GetBlockID() <= 0) {
+         REQUIRE(pMetadata == nullptr);
+         continue;
+      }
+      REQUIRE(pMetadata != nullptr);
+      REQUIRE(pMetadata->blockID == pBlock->GetBlockID());
+      REQUIRE(pMetadata->sampleFormat == floatSample);
+      REQUIRE(pMetadata->sampleBytes ==
+         pBlock->GetSampleCount() * SAMPLE_SIZE(floatSample));
+      const auto levels = pBlock->GetMinMaxRMS();
+      REQUIRE(pMetadata->sumMin == Approx(levels.min));
+      REQUIRE(pMetadata->sumMax == Approx(levels.max));
+      REQUIRE(pMetadata->sumRms == Approx(levels.RMS));
+   }
+}
+}
+
+TEST_CASE("Block metadata preload", "[DBConnection]")
+{
+   MockedPrefs prefs;
+   BenchmarkProject project;
+   auto& track = project.AddTrack(2, 10.0);
+   track.InsertSilence(1.0, 2.0);
+   const auto blocks = Blocks(track);
+   REQUIRE(std::any_of(blocks.begin(), blocks.end(),
+      [](const auto& pBlock){ return pBlock->GetBlockID() <= 0; }));
+   const auto firstID = blocks.front()->GetBlockID();
+
+   auto& projectFileIO = ProjectFileIO::Get(project.Project());
+   auto& conn = projectFileIO.GetConnection();
+   REQUIRE(conn.FindBlockMetadata(firstID) == nullptr);
+
+   SECTION("Synchronous")
+   {
+      REQUIRE(conn.PreloadBlockMetadata());
+      RequireMetadata(conn, blocks);
+      conn.DiscardBlockMetadata();
+      REQUIRE(conn.FindBlockMetadata(firstID) == nullptr);
+   }
+
+   SECTION("On a worker")
+   {
+      conn.StartBlockMetadataPreload();
+      RequireMetadata(conn, blocks);
+      conn.DiscardBlockMetadata();
+      REQUIRE(conn.FindBlockMetadata(firstID) == nullptr);
+   }
+
+   SECTION("On a worker that can't open the database")
+   {
+      // The worker opens the file by name; this connection keeps it open
+      const auto path = projectFileIO.GetFileName();
+      const auto moved = path + wxT(".moved");
+      if (!wxRenameFile(path, moved)) {
+         WARN("Can't rename an open database here");
+         return;
+      }
+      Finally Do{[&]{ wxRenameFile(moved, path); }};
+
+      conn.StartBlockMetadataPreload();
+      RequireMetadata(conn, blocks);
+      conn.DiscardBlockMetadata();
+   }
+}
+
+TEST_CASE("Reopened project loads blocks from preloaded metadata",
+   "[DBConnection]")
+{
+   MockedPrefs prefs;
+   const auto path =
+      wxFileName{ BenchmarkProject::Directory(), wxT("metadata.aup3") }
+         .GetFullPath();
+
+   std::vector<SampleBlockID> ids;
+   std::vector<MinMaxRMS> levels;
+   std::vector<float> firstSamples;
+   {
+      BenchmarkProject project;
+      auto& track = project.AddTrack(1, 10.0);
+      track.InsertSilence(1.0, 2.0);
+      for (const auto& pBlock : Blocks(track)) {
+         ids.push_back(pBlock->GetBlockID());
+         levels.push_back(pBlock->GetMinMaxRMS());
+      }
+      const auto& pFirst = Blocks(track).front();
+      firstSamples.resize(pFirst->GetSampleCount());
+      pFirst->GetSamples(reinterpret_cast<samplePtr>(firstSamples.data()),
+         floatSample, 0, firstSamples.size());
+      REQUIRE(ProjectFileIO::Get(project.Project()).SaveProject(path, nullptr));
+   }
+
+   auto project = BenchmarkProject::OpenSaved(path);
+   const auto& tracks = TrackList::Get(project.Project());
+   REQUIRE(tracks.Size() == 1);
+   const auto blocks = Blocks(**tracks.Any<const WaveTrack>().begin());
+   REQUIRE(blocks.size() == ids.size());
+   for (size_t ii = 0; ii < blocks.size(); ++ii) {
+      REQUIRE(blocks[ii]->GetBlockID() == ids[ii]);
+      const auto blockLevels = blocks[ii]->GetMinMaxRMS();
+      REQUIRE(blockLevels.min == levels[ii].min);
+      REQUIRE(blockLevels.max == levels[ii].max);
+      REQUIRE(blockLevels.RMS == levels[ii].RMS);
+   }
+   std::vector<float> samples(firstSamples.size());
+   blocks.front()->GetSamples(reinterpret_cast<samplePtr>(samples.data()),
+      floatSample, 0, samples.size());
+   REQUIRE(samples == firstSamples);
+}
@@ -0,0 +1,129 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  DBTuningTests.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "Project.h"
+#include "ProjectFileIO.h"
+#include "SampleBlock.h"
+#include "Track.h"
+#include "WaveTrack.h"
+
+#include "BenchmarkProject.h"
+#include "MockedPrefs.h"
+
+namespace
+{
+// Far more frames than the writes of these tests make
+constexpr int NoCheckpoints = 1 << 30;
+
+void Append(WaveTrack& track, double seconds)
+{
+   const auto length = static_cast<size_t>(seconds * BenchmarkData::Rate);
+   const auto samples = BenchmarkData::MakeSine(length, 0);
+   track.Append(reinterpret_cast<constSamplePtr>(samples.data()),
+      floatSample, length, 1, floatSample);
+   track.Flush();
+}
+
+//! The checkpoint thread runs on its own; give it a few seconds
+template<typename Predicate> bool Eventually(const Predicate& predicate)
+{
+   using namespace std::chrono;
+   const auto deadline = steady_clock::now() + 5s;
+   while (!predicate()) {
+      if (steady_clock::now() > deadline)
+         return false;
+      std::this_thread::sleep_for(10ms);
+   }
+   return true;
+}
+}
+
+TEST_CASE("Database tuning and statistics", "[DBConnection]")
+{
+   MockedPrefs prefs;
+
+   // Tune before opening, so that no commit can start a checkpoint
+   DBTuning tuning;
+   tuning.cacheSizeKB = 4000;
+   tuning.checkpointFrames = NoCheckpoints;
+   BenchmarkProject project{ tuning };
+   auto& projectFileIO = ProjectFileIO::Get(project.Project());
+   auto& tracks = TrackList::Get(project.Project());
+
+   const auto& applied = projectFileIO.GetTuning();
+   REQUIRE(applied.cacheSizeKB == tuning.cacheSizeKB);
+   REQUIRE(applied.checkpointFrames == tuning.checkpointFrames);
+   REQUIRE(applied.checkpointMode == tuning.checkpointMode);
+
+   auto holder = WaveTrackFactory::Get(project.Project())
+      .Create(1, floatSample, BenchmarkData::Rate);
+   auto& track = **holder->Any<WaveTrack>().begin();
+   tracks.Append(std::move(*holder));
+
+   SECTION("The WAL grows below the threshold")
+   {
+      const auto before = projectFileIO.GetDBStats();
+      Append(track, 5.0);
+      const auto after = projectFileIO.GetDBStats();
+      REQUIRE(after.walFrames > before.walFrames);
+      REQUIRE(after.walBytes > before.walBytes);
+      REQUIRE(after.checkpoints == 0);
+   }
+
+   for (const auto mode : {
+      DBTuning::CheckpointMode::Passive, DBTuning::CheckpointMode::Full,
+      DBTuning::CheckpointMode::Restart, DBTuning::CheckpointMode::Truncate
+   }) {
+      DYNAMIC_SECTION("Checkpoints start at the threshold, mode "
+         << static_cast<int>(mode))
+      {
+         Append(track, 1.0);
+         const auto frames = projectFileIO.GetDBStats().walFrames;
+         REQUIRE(frames > 0);
+
+         tuning.checkpointFrames = frames + 1;
+         tuning.checkpointMode = mode;
+         projectFileIO.SetTuning(tuning);
+         REQUIRE(projectFileIO.GetTuning().checkpointMode == mode);
+         REQUIRE(projectFileIO.GetTuning().checkpointFrames == frames + 1);
+
+         Append(track, 5.0);
+         REQUIRE(Eventually(
+            [&]{ return projectFileIO.GetDBStats().checkpoints > 0; }));
+         // Nothing reads the project meanwhile, so the last checkpoint
+         // gets every frame, in any mode
+         REQUIRE(Eventually(
+            [&]{ return projectFileIO.GetDBStats().walFrames == 0; }));
+         if (mode == DBTuning::CheckpointMode::Truncate)
+            REQUIRE(Eventually(
+               [&]{ return projectFileIO.GetDBStats().walBytes == 0; }));
+      }
+   }
+
+   SECTION("Resetting zeroes the cache counters")
+   {
+      Append(track, 5.0);
+      projectFileIO.GetDBStats(true);
+      std::vector<float> samples(track.GetVisibleSampleCount().as_size_t());
+      REQUIRE(track.GetChannel(0)->GetFloats(samples.data(), 0,
+         samples.size()));
+      const auto stats = projectFileIO.GetDBStats(true);
+      REQUIRE(stats.cacheHits + stats.cacheMisses > 0);
+      REQUIRE(stats.cacheBytes > 0);
+      const auto reset = projectFileIO.GetDBStats();
+      REQUIRE(reset.cacheHits == 0);
+      REQUIRE(reset.cacheMisses == 0);
+      REQUIRE(reset.cacheWrites == 0);
+   }
+}
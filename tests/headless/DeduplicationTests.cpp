@@ -0,0 +1,161 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  DeduplicationTests.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+#include <wx/filename.h>
+
+#include "DBConnection.h"
+#include "MemoryX.h"
+#include "Project.h"
+#include "ProjectFileIO.h"
+#include "SampleBlock.h"
+#include "Track.h"
+#include "WaveTrack.h"
+
+#include "BenchmarkProject.h"
+#include "MockedPrefs.h"
+
+namespace
+{
+// Small blocks, so that a pattern repeated in a track makes duplicates
+constexpr size_t BlockSize = 1024;
+constexpr size_t MaxDiskBlockSize = BlockSize * sizeof(float);
+constexpr size_t Repeats = 8;
+
+bool RowExists(AudacityProject& project, SampleBlockID id)
+{
+   auto& conn = ProjectFileIO::Get(project).GetConnection();
+   REQUIRE(conn.PreloadBlockMetadata());
+   const auto result = conn.FindBlockMetadata(id) != nullptr;
+   conn.DiscardBlockMetadata();
+   return result;
+}
+
+SampleBlockPtr Create(SampleBlockFactory& factory,
+   const std::vector<float>& samples)
+{
+   return factory.Create(reinterpret_cast<constSamplePtr>(samples.data()),
+      samples.size(), floatSample);
+}
+
+using BenchmarkData::Blocks;
+
+//! The pattern, Repeats times, then a block of zeros, then the pattern
+std::vector<float> MakeTrackSamples(const std::vector<float>& pattern)
+{
+   std::vector<float> samples;
+   for (size_t ii = 0; ii < Repeats; ++ii)
+      samples.insert(samples.end(), pattern.begin(), pattern.end());
+   samples.resize(samples.size() + BlockSize);
+   samples.insert(samples.end(), pattern.begin(), pattern.end());
+   return samples;
+}
+
+//! Blocks of a track made of MakeTrackSamples() share the pattern's row
+void RequireSharing(const WaveTrack& track)
+{
+   const auto blocks = Blocks(track);
+   REQUIRE(blocks.size() == Repeats + 2);
+   const auto& pFirst = blocks.front();
+   REQUIRE(pFirst->GetBlockID() > 0);
+   for (size_t ii = 1; ii < blocks.size(); ++ii) {
+      if (ii == Repeats)
+         // Zeros take no row
+         REQUIRE(blocks[ii]->GetBlockID() <= 0);
+      else
+         REQUIRE(blocks[ii] == pFirst);
+   }
+}
+}
+
+TEST_CASE("Deduplicated blocks keep their rows while in use",
+   "[SqliteSampleBlock]")
+{
+   MockedPrefs prefs;
+   Sequence::SetMaxDiskBlockSize(MaxDiskBlockSize);
+   auto resetBlockSize =
+      finally([]{ Sequence::SetMaxDiskBlockSize(1048576); });
+   // The factory reads the preference when the project makes it
+   SQLiteSettings::DeduplicateBlocks.Write(true);
+   auto resetDeduplicate =
+      finally([]{ SQLiteSettings::DeduplicateBlocks.Reset(); });
+
+   const auto pattern = BenchmarkData::MakeSine(BlockSize);
+   const std::vector<float> zeros(BlockSize);
+
+   SECTION("Releasing the last user deletes the row")
+   {
+      BenchmarkProject project;
+      auto& factory = *project.Factory();
+      std::vector<SampleBlockPtr> users;
+      for (size_t ii = 0; ii < Repeats; ++ii)
+         users.push_back(Create(factory, pattern));
+      const auto id = users.front()->GetBlockID();
+      REQUIRE(id > 0);
+      for (const auto& pUser : users)
+         REQUIRE(pUser->GetBlockID() == id);
+      REQUIRE(Create(factory, zeros)->GetBlockID() <= 0);
+
+      users.resize(1);
+      REQUIRE(RowExists(project.Project(), id));
+      REQUIRE(factory.GetActiveBlockIDs().count(id) == 1);
+
+      users.clear();
+      REQUIRE(!RowExists(project.Project(), id));
+      REQUIRE(factory.GetActiveBlockIDs().count(id) == 0);
+
+      // The same contents again make a new row, not one that is gone
+      const auto pAgain = Create(factory, pattern);
+      REQUIRE(pAgain->GetBlockID() != id);
+      REQUIRE(RowExists(project.Project(), pAgain->GetBlockID()));
+   }
+
+   SECTION("Sharing survives saving and reopening")
+   {
+      const auto samples = MakeTrackSamples(pattern);
+      const auto path =
+         wxFileName{ BenchmarkProject::Directory(), wxT("deduplicated.aup3") }
+            .GetFullPath();
+      {
+         BenchmarkProject project;
+         auto holder = WaveTrackFactory::Get(project.Project())
+            .Create(1, floatSample, BenchmarkData::Rate);
+         auto& track = **holder->Any<WaveTrack>().begin();
+         track.Append(reinterpret_cast<constSamplePtr>(samples.data()),
+            floatSample, samples.size(), 1, floatSample);
+         track.Flush();
+         TrackList::Get(project.Project()).Append(std::move(*holder));
+         RequireSharing(track);
+         REQUIRE(ProjectFileIO::Get(project.Project())
+            .SaveProject(path, nullptr));
+      }
+
+      auto project = BenchmarkProject::OpenSaved(path);
+      const auto& tracks = TrackList::Get(project.Project());
+      REQUIRE(tracks.Size() == 1);
+      const auto& track = **tracks.Any<const WaveTrack>().begin();
+      RequireSharing(track);
+      const auto id = Blocks(track).front()->GetBlockID();
+      REQUIRE(RowExists(project.Project(), id));
+
+      std::vector<float> reopened(samples.size());
+      REQUIRE(track.GetChannel(0)->GetFloats(
+         reopened.data(), 0, reopened.size()));
+      REQUIRE(reopened == samples);
+
+      // New contents equal to a stored block share its row
+      const auto pAgain = Create(*project.Factory(), pattern);
+      REQUIRE(pAgain->GetBlockID() == id);
+      // Other contents of the same length don't
+      REQUIRE(Create(*project.Factory(), BenchmarkData::MakeSine(BlockSize, 1))
+         ->GetBlockID() != id);
+   }
+}
@@ -0,0 +1,70 @@
+#  SPDX-License-Identifier: GPL-2.0-or-later
+
+#[[
+   Applies commands to two .aup3 projects in one headless batch, with one
+   process and then with two, and checks that each project is exported
+   under its own name, without any prompt for a name.
+
+   Arguments: AUDACITY, the executable; SAMPLE, an audio file to make the
+   projects from; WORK_DIR, a scratch directory; TIMEOUT, in seconds.
+]]
+
+foreach( variable AUDACITY SAMPLE WORK_DIR TIMEOUT )
+   if( NOT DEFINED ${variable} )
+      message( FATAL_ERROR "${variable} is not defined" )
+   endif()
+endforeach()
+
+file( REMOVE_RECURSE "${WORK_DIR}" )
+file( MAKE_DIRECTORY "${WORK_DIR}/config" )
+
+set( output_dir "${WORK_DIR}/out" )
+
+# A private configuration, so that no preference of the user changes where
+# exports go, and no first run dialog appears
+file( WRITE "${WORK_DIR}/config/audacity.cfg"
+   "[Locale]\n"
+   "Language=en\n"
+   "[Directories/MacrosOut]\n"
+   "Default=${output_dir}\n"
+)
+
+function( run_batch commands jobs )
+   file( WRITE "${WORK_DIR}/commands.txt" "${commands}" )
+   execute_process(
+      COMMAND
+         "${AUDACITY}"
+            --config-dir "${WORK_DIR}/config"
+            --commands "${WORK_DIR}/commands.txt"
+            --jobs ${jobs}
+            ${ARGN}
+      RESULT_VARIABLE result
+      TIMEOUT ${TIMEOUT}
+   )
+   if( NOT result EQUAL 0 )
+      message( FATAL_ERROR "Batch of ${ARGN} with ${jobs} jobs: ${result}" )
+   endif()
+endfunction()
+
+# Make the two projects from the sample, one batch for each name
+foreach( name first second )
+   run_batch( "SaveProject2: Filename=\"${WORK_DIR}/${name}.aup3\"\n" 1
+      "${SAMPLE}" )
+   if( NOT EXISTS "${WORK_DIR}/${name}.aup3" )
+      message( FATAL_ERROR "${name}.aup3 was not saved" )
+   endif()
+endforeach()
+
+# Before the fix, the second export overwrote the first, or a single
+# process waited for a name in a dialog
+foreach( jobs 1 2 )
+   file( REMOVE_RECURSE "${output_dir}" )
+   run_batch( "ExportWav:\n" ${jobs}
+      "${WORK_DIR}/first.aup3" "${WORK_DIR}/second.aup3" )
+   foreach( name first second )
+      if( NOT EXISTS "${output_dir}/macro-output/${name}.wav" )
+         message( FATAL_ERROR
+            "${name}.wav was not exported with ${jobs} jobs" )
+      endif()
+   endforeach()
+endforeach()
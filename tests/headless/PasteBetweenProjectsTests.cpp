@@ -0,0 +1,158 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  PasteBetweenProjectsTests.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "MemoryX.h"
+#include "SampleBlock.h"
+#include "Sequence.h"
+
+#include "BenchmarkProject.h"
+#include "MockedPrefs.h"
+
+namespace
+{
+// Small blocks, so that a few seconds make many, each with several frames
+// of 256-sample summaries
+constexpr size_t MaxDiskBlockSize = 1024 * sizeof(float);
+constexpr size_t Length = 20000;
+constexpr size_t SilenceLength = 3000;
+
+std::vector<float> GetAll(const Sequence& sequence)
+{
+   std::vector<float> samples(sequence.GetNumSamples().as_size_t());
+   REQUIRE(sequence.Get(reinterpret_cast<samplePtr>(samples.data()),
+      floatSample, 0, samples.size(), true));
+   return samples;
+}
+
+std::vector<float> Summary256(SampleBlock& block)
+{
+   const auto frames = (block.GetSampleCount() + 255) / 256;
+   std::vector<float> summary(3 * frames);
+   REQUIRE(block.GetSummary256(summary.data(), 0, frames));
+   return summary;
+}
+
+std::vector<float> Summary64k(SampleBlock& block)
+{
+   const auto frames = (block.GetSampleCount() + 65535) / 65536;
+   std::vector<float> summary(3 * frames);
+   REQUIRE(block.GetSummary64k(summary.data(), 0, frames));
+   return summary;
+}
+
+std::vector<SampleBlockID> IDs(const Sequence& sequence)
+{
+   std::vector<SampleBlockID> ids;
+   for (const auto& block : sequence.GetBlockArray())
+      ids.push_back(block.sb->GetBlockID());
+   return ids;
+}
+
+//! Blocks of a paste into an empty sequence correspond to those of the source
+void RequireSameBlocks(const Sequence& source, const Sequence& pasted,
+   double margin)
+{
+   const auto& sourceBlocks = source.GetBlockArray();
+   const auto& pastedBlocks = pasted.GetBlockArray();
+   REQUIRE(pastedBlocks.size() == sourceBlocks.size());
+   for (size_t ii = 0; ii < sourceBlocks.size(); ++ii) {
+      const auto& sourceBlock = *sourceBlocks[ii].sb;
+      const auto& pastedBlock = *pastedBlocks[ii].sb;
+      REQUIRE(pastedBlocks[ii].start == sourceBlocks[ii].start);
+      REQUIRE(pastedBlock.GetSampleCount() == sourceBlock.GetSampleCount());
+      // Silent blocks stay silent, without rows
+      REQUIRE((pastedBlock.GetBlockID() <= 0) ==
+         (sourceBlock.GetBlockID() <= 0));
+      const auto sourceLevels = sourceBlock.GetMinMaxRMS();
+      const auto pastedLevels = pastedBlock.GetMinMaxRMS();
+      REQUIRE(pastedLevels.min == Approx(sourceLevels.min).margin(margin));
+      REQUIRE(pastedLevels.max == Approx(sourceLevels.max).margin(margin));
+      REQUIRE(pastedLevels.RMS == Approx(sourceLevels.RMS).margin(margin));
+   }
+}
+}
+
+TEST_CASE("Paste between projects", "[Sequence][SqliteSampleBlock]")
+{
+   MockedPrefs prefs;
+   Sequence::SetMaxDiskBlockSize(MaxDiskBlockSize);
+   auto cleanup = finally([]{ Sequence::SetMaxDiskBlockSize(1048576); });
+
+   BenchmarkProject sourceProject;
+   BenchmarkProject destProject;
+
+   Sequence source{ sourceProject.Factory(),
+      SampleFormats{ floatSample, floatSample } };
+   const auto samples = BenchmarkData::MakeSine(Length, 0);
+   source.Append(reinterpret_cast<constSamplePtr>(samples.data()),
+      floatSample, samples.size(), 1, floatSample);
+   source.Flush();
+   source.InsertSilence(Length / 2, SilenceLength);
+   REQUIRE(source.GetBlockArray().size() > 10);
+   REQUIRE(std::any_of(
+      source.GetBlockArray().begin(), source.GetBlockArray().end(),
+      [](const SeqBlock& block){ return block.sb->GetBlockID() <= 0; }));
+   const auto sourceSamples = GetAll(source);
+
+   const auto paste = [&](sampleFormat format) {
+      auto pDest = std::make_unique<Sequence>(
+         destProject.Factory(), SampleFormats{ format, format });
+      pDest->Paste(0, &source);
+      return pDest;
+   };
+
+   SECTION("Stored contents are copied as they are")
+   {
+      const auto pDest = paste(floatSample);
+      const auto& dest = *pDest;
+      REQUIRE(GetAll(dest) == sourceSamples);
+      RequireSameBlocks(source, dest, 0);
+      const auto& sourceBlocks = source.GetBlockArray();
+      const auto& destBlocks = dest.GetBlockArray();
+      for (size_t ii = 0; ii < sourceBlocks.size(); ++ii) {
+         auto& sourceBlock = *sourceBlocks[ii].sb;
+         auto& destBlock = *destBlocks[ii].sb;
+         REQUIRE(Summary256(destBlock) == Summary256(sourceBlock));
+         REQUIRE(Summary64k(destBlock) == Summary64k(sourceBlock));
+      }
+
+      SECTION("Pasting again shares the earlier copies")
+      {
+         const auto pAgain = paste(floatSample);
+         REQUIRE(IDs(*pAgain) == IDs(dest));
+         REQUIRE(GetAll(*pAgain) == sourceSamples);
+      }
+   }
+
+   SECTION("Different formats fall back to conversion of samples")
+   {
+      const auto pDest = paste(int16Sample);
+      const auto& dest = *pDest;
+      // Quantization to 16 bits
+      const auto margin = 1.0 / 32768;
+      const auto destSamples = GetAll(dest);
+      REQUIRE(destSamples.size() == sourceSamples.size());
+      for (size_t ii = 0; ii < destSamples.size(); ++ii)
+         REQUIRE(destSamples[ii] == Approx(sourceSamples[ii]).margin(margin));
+      RequireSameBlocks(source, dest, margin);
+
+      // Conversions are not remembered, so each paste makes new rows
+      const auto pAgain = paste(int16Sample);
+      const auto ids = IDs(dest), againIds = IDs(*pAgain);
+      for (size_t ii = 0; ii < ids.size(); ++ii)
+         if (ids[ii] > 0)
+            REQUIRE(againIds[ii] != ids[ii]);
+      REQUIRE(GetAll(*pAgain) == destSamples);
+   }
+}
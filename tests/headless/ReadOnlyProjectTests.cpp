@@ -0,0 +1,129 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ReadOnlyProjectTests.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+#include <wx/filename.h>
+
+#include "Project.h"
+#include "ProjectFileIO.h"
+#include "SampleBlock.h"
+#include "Track.h"
+#include "WaveTrack.h"
+
+#include "BenchmarkProject.h"
+#include "MockedPrefs.h"
+
+namespace
+{
+constexpr double Duration = 5.0;
+constexpr size_t NChannels = 2;
+const auto Length = static_cast<size_t>(Duration * BenchmarkData::Rate);
+
+FilePath SaveProject()
+{
+   const auto path =
+      wxFileName{ BenchmarkProject::Directory(), wxT("read-only.aup3") }
+         .GetFullPath();
+   BenchmarkProject project;
+   project.AddTrack(NChannels, Duration);
+   REQUIRE(ProjectFileIO::Get(project.Project()).SaveProject(path, nullptr));
+   return path;
+}
+
+//! Samples as BenchmarkProject::AddTrack made them
+void RequireSamples(const TrackList& tracks)
+{
+   REQUIRE(tracks.Size() == 1);
+   const auto& track = **tracks.Any<const WaveTrack>().begin();
+   REQUIRE(track.NChannels() == NChannels);
+   std::vector<float> samples(Length);
+   for (size_t iChannel = 0; iChannel < NChannels; ++iChannel) {
+      REQUIRE(track.GetChannel(iChannel)->GetFloats(
+         samples.data(), 0, samples.size()));
+      REQUIRE(samples == BenchmarkData::MakeSine(Length, iChannel));
+   }
+}
+
+//! A write fails by returning false or by throwing
+template<typename Write> bool Fails(const Write& write)
+{
+   try {
+      return !write();
+   }
+   catch (...) {
+      return true;
+   }
+}
+}
+
+TEST_CASE("ReadOnlyProject", "[ProjectFileIO]")
+{
+   MockedPrefs prefs;
+   // Catch runs the case again for each section; save only once
+   static const auto path = SaveProject();
+
+   for (const auto immutable : { false, true }) {
+      DYNAMIC_SECTION((immutable ? "Immutable" : "Read-only") << " open")
+      {
+         TranslatableString error;
+         const auto pProject = ReadOnlyProject::Open(path, immutable, &error);
+         REQUIRE(pProject != nullptr);
+         REQUIRE(ProjectFileIO::Get(pProject->Project()).IsReadOnly());
+         RequireSamples(pProject->GetTracks());
+
+         SECTION("Another reader of the same file at once")
+         {
+            const auto pOther = ReadOnlyProject::Open(path, immutable);
+            REQUIRE(pOther != nullptr);
+            RequireSamples(pOther->GetTracks());
+            RequireSamples(pProject->GetTracks());
+         }
+
+         SECTION("Writes fail")
+         {
+            auto& project = pProject->Project();
+            auto& projectFileIO = ProjectFileIO::Get(project);
+            const auto& tracks = pProject->GetTracks();
+            REQUIRE(Fails([&]{ return projectFileIO.UpdateSaved(&tracks); }));
+            // Would delete every block if it could
+            REQUIRE(Fails([&]{ return projectFileIO.DeleteBlocks({}, true); }));
+            const auto pFactory = SampleBlockFactory::New(project);
+            const std::vector<float> samples(100);
+            REQUIRE_THROWS(pFactory->Create(
+               reinterpret_cast<constSamplePtr>(samples.data()),
+               samples.size(), floatSample));
+            // Nothing changed
+            RequireSamples(tracks);
+         }
+      }
+   }
+
+   SECTION("The file is unchanged for a writer afterward")
+   {
+      {
+         const auto pProject = ReadOnlyProject::Open(path);
+         REQUIRE(pProject != nullptr);
+      }
+      auto project = BenchmarkProject::OpenSaved(path);
+      REQUIRE(!ProjectFileIO::Get(project.Project()).IsReadOnly());
+      RequireSamples(TrackList::Get(project.Project()));
+   }
+
+   SECTION("Opening a missing file fails")
+   {
+      TranslatableString error;
+      const auto missing =
+         wxFileName{ BenchmarkProject::Directory(), wxT("missing.aup3") }
+            .GetFullPath();
+      REQUIRE(ReadOnlyProject::Open(missing, false, &error) == nullptr);
+      REQUIRE(!error.empty());
+   }
+}
@@ -0,0 +1,132 @@
+/*  SPDX-License-Identifier: GPL-2.0-or-later */
+/*!********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  SharedExportMixTests.cpp
+
+**********************************************************************/
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "ExportPluginHelpers.h"
+#include "Mix.h"
+#include "SharedExportMix.h"
+#include "Track.h"
+
+#include "BenchmarkProject.h"
+#include "MockedPrefs.h"
+
+namespace
+{
+// Longer than the render may get ahead of its slowest reader
+constexpr double Duration = 30.0;
+constexpr unsigned NChannels = 2;
+constexpr size_t BufferSize = 4096;
+
+std::unique_ptr<Mixer> MakeMixer(
+   const TrackList& tracks, SharedExportMix* pShared)
+{
+   SharedExportMix::Scope scope{ pShared };
+   return ExportPluginHelpers::CreateMixer(tracks, false, 0, Duration,
+      NChannels, BufferSize, true, BenchmarkData::Rate, floatSample, nullptr);
+}
+
+//! Interleaved samples of all that the mixer produces
+std::vector<float> MixAll(Mixer& mixer)
+{
+   std::vector<float> result;
+   while (const auto count = mixer.Process()) {
+      const auto pSamples =
+         reinterpret_cast<const float*>(mixer.GetBuffer());
+      result.insert(result.end(), pSamples, pSamples + count * NChannels);
+   }
+   return result;
+}
+}
+
+TEST_CASE("SharedExportMix", "[SharedExportMix]")
+{
+   MockedPrefs prefs;
+   BenchmarkProject project;
+   project.AddTrack(NChannels, Duration);
+   project.AddTrack(1, Duration / 2);
+   const auto& tracks = TrackList::Get(project.Project());
+
+   // What each export would mix for itself
+   const auto expected = MixAll(*MakeMixer(tracks, nullptr));
+   REQUIRE(expected.size() ==
+      size_t(Duration * BenchmarkData::Rate) * NChannels);
+
+   const auto pShared = SharedExportMix::Create(BenchmarkData::Rate);
+
+   SECTION("Each reader gets the same samples")
+   {
+      std::vector<std::unique_ptr<Mixer>> mixers;
+      for (size_t ii = 0; ii < 3; ++ii)
+         mixers.push_back(MakeMixer(tracks, pShared.get()));
+
+      // Readers run at once, as the exports do
+      std::vector<std::future<std::vector<float>>> results;
+      for (auto& pMixer : mixers)
+         results.push_back(std::async(std::launch::async,
+            [&mixer = *pMixer]{ return MixAll(mixer); }));
+      for (auto& result : results)
+         REQUIRE(result.get() == expected);
+   }
+
+   SECTION("Stopping one reader early does not stop the others")
+   {
+      auto pStopped = MakeMixer(tracks, pShared.get());
+      auto pOther = MakeMixer(tracks, pShared.get());
+
+      // Starts the render
+      REQUIRE(pStopped->Process() > 0);
+      // The other reader soon waits for this one, which is far behind
+      auto result = std::async(std::launch::async,
+         [&mixer = *pOther]{ return MixAll(mixer); });
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      pStopped.reset();
+
+      REQUIRE(result.get() == expected);
+   }
+
+   SECTION("A reader that comes after the render began mixes for itself")
+   {
+      const auto pFirst = MakeMixer(tracks, pShared.get());
+      // Starts the render
+      REQUIRE(pFirst->Process() > 0);
+      REQUIRE(!pShared->CreateMixer(tracks, false, 0, Duration,
+         NChannels, BufferSize, true,
+         BenchmarkData::Rate, floatSample, nullptr));
+
+      // So it still gets the render from the start
+      const auto pLate = MakeMixer(tracks, pShared.get());
+      REQUIRE(pLate);
+      REQUIRE(MixAll(*pLate) == expected);
+   }
+
+   SECTION("Requests that can't share the render")
+   {
+      REQUIRE(!pShared->CreateMixer(tracks, false, 0, Duration,
+         SharedExportMix::MaxChannels + 1, BufferSize, true,
+         BenchmarkData::Rate, floatSample, nullptr));
+
+      // The first request fixes the range
+      const auto pMixer = MakeMixer(tracks, pShared.get());
+      REQUIRE(!pShared->CreateMixer(tracks, false, 0, Duration / 2,
+         NChannels, BufferSize, true,
+         BenchmarkData::Rate, floatSample, nullptr));
+
+      // Those mix for themselves
+      SharedExportMix::Scope scope{ pShared.get() };
+      const auto pOwn = ExportPluginHelpers::CreateMixer(tracks, false,
+         0, Duration, SharedExportMix::MaxChannels + 1, BufferSize, true,
+         BenchmarkData::Rate, floatSample, nullptr);
+      REQUIRE(pOwn);
+   }
+}